@@ -22,9 +22,14 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <sstream>
+#include <cstring>
+#include <algorithm>
 
 #include <dal_config.h>
 #include <data_hl/TBBraw.h>
+#include <data_hl/TBB_FileIngest.h>
+#include <data_hl/TBB_UDPIngest.h>
+#include <data_hl/TBB_FrameRing.h>
 
 //includes for networking
 #include <unistd.h>
@@ -122,11 +127,31 @@ namespace bpo = boost::program_options;
       <td> Check the CRCs of the frames:
       (0): do not check the CRCs
       (1): check the header CRCs and discard broken frames (default)
+      (2): check the header and data CRCs and discard broken frames
       </td>
       <tr>
     <td>-B [--bufferSize] arg</td>
-      <td> Size of the input buffer (in frames) when reading from a socket. The default is 
-      50000, which is about 100MByte. </td>
+      <td> Size of the input buffer (in frames) when reading from a socket, split evenly
+      between the ports. The default is 50000, which is about 100MByte. A full buffer
+      is never overwritten: the frames then wait in the receive buffer of the socket. </td>
+    </tr>
+    <tr>
+      <td>--writeBuffer arg</td>
+      <td> Size of the write-combining buffer per dipole (in kByte) in which frames are
+      collected before being written to the output file. The default is 1024; 0 writes
+      every frame as soon as it has been received. </td>
+    </tr>
+    <tr>
+      <td>--socketBuffer arg</td>
+      <td> Size of the kernel receive buffer (in kByte) requested for every UDP port, which
+      bridges short stalls of the reader threads. The default is 32768; 0 keeps the system
+      default. Beyond net.core.rmem_max the size is only granted to privileged users. </td>
+    </tr>
+    <tr>
+      <td>--stationBuffer arg</td>
+      <td> Size of the queue (in frames) of every station writer when processing data
+      from multiple stations (-M). Each station is written by a thread of its own; the
+      default is 10000 frames, about 20MByte per station. </td>
     </tr>
     <tr>
       <td>-K [--keepRunning]</td>
@@ -152,28 +177,40 @@ DAL::TBBraw *tbb;
 // (the vBuf of the system on the storage nodes can store ca. 800 frames)
 //#define INPUT_BUFFER_SIZE 50000
 int input_buffer_size;
-
-//!pointers (array indices) for the last buffer processed and the last buffer written
-int inBufProcessID,inBufStorID;
-//!the Input Buffer
-char * inputBuffer_p;
+//!size of the write-combining buffer per dipole in the output file [kByte]
+int write_buffer_size;
+//!size of the kernel receive buffer per UDP port [kByte]
+int socket_buffer_size;
+//!number of frames in the queue of each station writer
+int station_buffer_size;
+
+//!the input buffers, one frame ring per port, filled by the reader-threads
+std::vector<DAL::TBB_FrameRing*> inputRings;
 //!end all running reader threads
 bool terminateThreads;
-//!maximum number of frames waiting in the vBuf while reading
+//!maximum number of frames fetched from the vBuf by a single receive call
 int maxWaitingFrames;
-//!maximum number of frames in the buffer
-int maxCachedFrames;
-//!number of frames dropped due to buffer overflow
-int noFramesDropped;
+//!number of frames dropped by the kernel, as the receive buffer of a socket was full
+unsigned int noKernelDrops;
 //!number of running reader-threads
 int noRunning;
-//!mutex for writing into the buffer
+//!mutex for the statistics shared by the reader-threads
 boost::mutex writeMutex;
 
+//!serialize the calls of the station writers into the HDF5 library, unless
+//!that library does so itself
+#ifdef H5_HAVE_THREADSAFE
+pthread_mutex_t *hdf5Mutex = NULL;
+#else
+pthread_mutex_t hdf5MutexStorage = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t *hdf5Mutex = &hdf5MutexStorage;
+#endif
+
 // -----------------------------------------------------------------
 /*!
-  \brief Thread that creates and then reads from a socket into the buffer
+  \brief Thread that creates and then reads from a socket into its input buffer
 
+  \param ring -- Input buffer to fill, the thread is its only producer
   \param port -- UDP port number to read data from
   \param ip -- Hostname (ip-address) to bind to (not used)
   \param startTimeout -- Timeout when opening socket connection [in sec]
@@ -181,133 +218,89 @@ boost::mutex writeMutex;
   \param verbose -- Produce more output
   \param stayConnected -- stay connected even after readTimeout ran out.
 
-  \return \t true if successful
+  If the input buffer is full, the thread waits for the processing to catch up
+  and leaves the frames in the receive buffer of the socket; only once that
+  overflows are frames lost, which the kernel reports for every port.
 */
-void socketReaderThread (int port,
+void socketReaderThread (DAL::TBB_FrameRing *ring,
+			 int port,
 			 string ip,
 			 double startTimeout,
 			 double readTimeout,
 			 bool verbose,
 			 bool stayConnected=false)
 {
-  // Create the main socket
-  int main_socket = 0;
-  fd_set readSet;
-  struct timeval TimeoutWait, TimeoutRead, NullTimeout;
-
-  TimeoutRead.tv_sec  = floor(readTimeout);
-  TimeoutRead.tv_usec = (readTimeout-TimeoutRead.tv_sec)*1e6;
-  NullTimeout.tv_sec  = NullTimeout.tv_usec =0;
-  main_socket         = socket(PF_INET, SOCK_DGRAM, 0);
-
-  if (main_socket<0) {
-    cerr << "[TBBraw2h5::socketReaderThread] " << port
-	 << " : Failed to create the main socket."<<endl;
-    boost::mutex::scoped_lock lock(writeMutex);
-    noRunning--;
-    return;
-  };
-  
-  //Create a sockaddr_in to describe the local port
-  sockaddr_in local_info;
-  local_info.sin_family = AF_INET;
-  local_info.sin_addr.s_addr = htonl(INADDR_ANY);
-  local_info.sin_port = htons(port);
-  //Bind the socket to the port
-  int erg = bind(main_socket, (sockaddr *) &local_info, sizeof(local_info));
-  if (erg<0)
+  // Create the socket and bind it to the port
+  DAL::TBB_UDPIngest ingest;
+  if (!ingest.open(port, socket_buffer_size*1024))
     {
       cerr << "TBBraw2h5::socketReaderThread:"<<port<<": Failed to bind to port"
            << "(with ip: " << ip <<")"<< endl;
+      ring->close();
       boost::mutex::scoped_lock lock(writeMutex);
       noRunning--;
       return;
     };
+  if (verbose) {
+    cout << "TBBraw2h5::socketReaderThread:"<<port<<": Receive buffer: "
+	 << ingest.receiveBufferSize() << " bytes." << endl;
+  };
   //Wait for the first data to arrive
   cout << "TBBraw2h5::socketReaderThread:"<<port<<": Waiting for data." << endl;
-  FD_ZERO(&readSet);
   if (startTimeout > 0) {
     while (!terminateThreads && (startTimeout>0)){
-      if (startTimeout>5) {
-	TimeoutWait.tv_sec = 5;
-	TimeoutWait.tv_usec = 0;
-	startTimeout -= 5;
-      } else {
-	TimeoutWait.tv_sec = floor(startTimeout);
-	TimeoutWait.tv_usec = (startTimeout-TimeoutWait.tv_sec)*1e6;
-	startTimeout = 0;
-      };
-      FD_SET(main_socket, &readSet);
-      if (select( main_socket + 1, &readSet, NULL, NULL, &TimeoutWait ) != 0){
+      double wait = (startTimeout>5) ? 5 : startTimeout;
+      startTimeout -= wait;
+      if (ingest.waitForData(wait)){
 	break;
       };
     }
   } else {
     while (!terminateThreads){
-      TimeoutWait.tv_sec = 5;
-      TimeoutWait.tv_usec = 0;
-      FD_SET(main_socket, &readSet);
-      if (select( main_socket + 1, &readSet, NULL, NULL, &TimeoutWait ) != 0){
+      if (ingest.waitForData(5)){
 	break;
       };
     };
   };
   bool ImRunning=true;
-  int status, numWaiting=0, newBufID;
-  struct sockaddr_in incoming_addr;
-  socklen_t socklen = sizeof(incoming_addr);
+  unsigned int nofSlots;
+  int nofReceived;
+  char *slots;
+  int *sizes;
   while (ImRunning && !terminateThreads)
     {
-      if (verbose)
+      if (ingest.waitForData(readTimeout))
         {
-          FD_ZERO(&readSet);
-          FD_SET(main_socket, &readSet);
-          if ((status = select(main_socket + 1, &readSet, NULL, NULL, &NullTimeout)) )
+          //there are frames waiting in the vBuffer
+          nofSlots = ring->writable(slots, sizes);
+          if (nofSlots == 0)
             {
-              numWaiting++;
-            }
-          else
+              //input buffer full: keep the frames in the vBuffer until there is space
+              ring->waitWritable(readTimeout);
+              continue;
+            };
+          //fetch the waiting frames straight into the free, contiguous slots
+          nofReceived = ingest.receive(slots, UDP_PACKET_BUFFER_SIZE, nofSlots, 0);
+          if (nofReceived <= 0)
             {
-              boost::mutex::scoped_lock lock(writeMutex);
-              if (numWaiting > maxWaitingFrames)
+              continue;
+            };
+          for (int n=0; n<nofReceived; n++)
+            {
+              sizes[n] = ingest.datagramSize(n);
+              if (verbose && (sizes[n] != DAL::TBBraw::frameSize(slots+n*UDP_PACKET_BUFFER_SIZE)))
                 {
-                  maxWaitingFrames=numWaiting;
+                  cout << "TBBraw2h5::socketReaderThread:"<<port
+                       << ": Received strange packet size: " << sizes[n] <<endl;
                 };
-              numWaiting=0;
             };
-        };
-      FD_ZERO(&readSet);
-      FD_SET(main_socket, &readSet);
-      TimeoutWait = TimeoutRead;
-      if ((status = select(main_socket + 1, &readSet, NULL, NULL, &TimeoutWait)) )
-        {
-          //there is a frame waiting in the vBuffer
-          {
-            //  make sure that we are the only ones writing to the input buffer
-            //  (concurrent reading is O.K.)
-            boost::mutex::scoped_lock lock(writeMutex);
-            newBufID = inBufStorID+1;
-            if (newBufID >= input_buffer_size)
-              {
-                newBufID =0;
-              }
-            if (newBufID == inBufProcessID)
-              {
-                noFramesDropped++;
-                newBufID = inBufStorID;
-              };
-            //perform the actual read
-            erg = recvfrom( main_socket, (inputBuffer_p + (newBufID*UDP_PACKET_BUFFER_SIZE)),
-                            UDP_PACKET_BUFFER_SIZE, 0, (sockaddr *) &incoming_addr, &socklen);
-            inBufStorID = newBufID;
-          }
-          ;// writeMutex lock is released here
-          if (verbose)
+          ring->commit(nofReceived);
+          if (nofReceived > maxWaitingFrames)
             {
-              if (erg != 2140)
+              boost::mutex::scoped_lock lock(writeMutex);
+              if (nofReceived > maxWaitingFrames)
                 {
-                  cout << "TBBraw2h5::socketReaderThread:"<<port
-                       << ": Received strange packet size: " << erg <<endl;
+                  maxWaitingFrames = nofReceived;
                 };
             };
         }
@@ -323,14 +316,171 @@ void socketReaderThread (int port,
   if (verbose && ImRunning && terminateThreads ) {
     cout << "TBBraw2h5::socketReaderThread:"<<port<<": stopped because terminateThreads was set!" << endl;
   };
+  ring->close();
   {
     boost::mutex::scoped_lock lock(writeMutex);
     noRunning--;
+    noKernelDrops += ingest.nofKernelDrops();
+  };
+  if (verbose) {
+    ingest.summary();
   };
-  close(main_socket);
   return;
 };
 
+//_______________________________________________________________________________
+//                                                                  startReaders
+
+/*!
+  \brief Allocate the input buffers and start a reader-thread for every port
+
+  \param ports         -- Vector with UDP port numbers to read data from
+  \param ip            -- Hostname (ip-address) to bind to (not used!)
+  \param startTimeout  -- Timeout when opening socket connection [in sec]
+  \param readTimeout   -- Timeout while reading from the socket [in sec]
+  \param verbose       -- Produce more output
+  \param stayConnected -- Keep the threads running after readTimeout ran out
+
+  \return readerThreads -- The started threads, to be passed on to
+          stopReaders(); empty if a thread could not be started.
+
+  The frames given by \e input_buffer_size are split between the ports, each of
+  which gets an input buffer with at least 100 frames.
+*/
+std::vector<boost::thread*> startReaders (std::vector<int> const &ports,
+					  string const &ip,
+					  float startTimeout,
+					  float readTimeout,
+					  bool verbose,
+					  bool stayConnected)
+{
+  std::vector<boost::thread*> readerThreads;
+  unsigned int nofFrames = std::max(input_buffer_size/int(ports.size()), 100);
+
+  terminateThreads = false;
+  maxWaitingFrames = 0;
+  noKernelDrops    = 0;
+  noRunning        = 0;
+
+  for (unsigned int i=0; i<ports.size(); i++) {
+    inputRings.push_back(new DAL::TBB_FrameRing(nofFrames, UDP_PACKET_BUFFER_SIZE));
+  };
+  if (verbose) {
+    cout << "TBBraw2h5::startReaders: Allocated " << ports.size() << " x "
+	 << nofFrames*UDP_PACKET_BUFFER_SIZE << " bytes for the input buffers." << endl;
+  };
+
+  for (unsigned int i=0; i < ports.size(); i++) {
+    readerThreads.push_back(new boost::thread(boost::bind(socketReaderThread,
+							  inputRings[i],
+							  ports[i],
+							  ip,
+							  startTimeout,
+							  readTimeout,
+							  verbose,
+							  stayConnected)));
+    if (readerThreads[i]->joinable() ) {
+      boost::mutex::scoped_lock lock(writeMutex);
+      noRunning++;
+    } else {
+      cout << "TBBraw2h5::startReaders: Failed to start reader thread for port :" << ports[i] << endl;
+      cout << "  Aborting!!! " << endl;
+      terminateThreads=true;
+      readerThreads.clear();
+      break;
+    };
+  };
+
+  return readerThreads;
+}
+
+//_______________________________________________________________________________
+//                                                                   stopReaders
+
+/*!
+  \brief Stop and join the reader-threads, then release the input buffers
+
+  \param readerThreads -- The threads returned by startReaders()
+  \param ports         -- Vector with the UDP port numbers of the threads
+  \param verbose       -- Print the statistics of the input buffers
+*/
+void stopReaders (std::vector<boost::thread*> &readerThreads,
+		  std::vector<int> const &ports,
+		  bool verbose)
+{
+  terminateThreads = true;
+  for (unsigned int i=0; i<readerThreads.size(); i++) {
+    readerThreads[i]->join();
+    delete readerThreads[i];
+  };
+  readerThreads.clear();
+
+  if (verbose) {
+    cout << "Socket and Buffer Stats: Maximum # of waiting frames:" << maxWaitingFrames << endl;
+    cout << "   Number of frames dropped by the kernel (socket):" << noKernelDrops << endl;
+    for (unsigned int i=0; i<inputRings.size(); i++) {
+      cout << "   Port " << ports[i]
+	   << ": Maximum # of frames in buffer:" << inputRings[i]->highWaterMark()
+	   << " , # of times buffer was full:" << inputRings[i]->nofFull() << endl;
+    };
+  };
+  for (unsigned int i=0; i<inputRings.size(); i++) {
+    delete inputRings[i];
+  };
+  inputRings.clear();
+}
+
+//_______________________________________________________________________________
+//                                                                    fetchFrames
+
+/*!
+  \brief Get the next batch of frames from the input buffers
+
+  \retval ring  -- Index of the input buffer the frames belong to; the next
+          call continues with the following one, so that no port is starved.
+  \retval slots -- The first of the frames
+  \retval sizes -- The sizes of the frames
+
+  \return nofFrames -- Number of frames, which have to be handed back with
+          <tt>inputRings[ring]->release()</tt>; 0 if all buffers are empty.
+*/
+unsigned int fetchFrames (unsigned int &ring,
+			  char *&slots,
+			  int *&sizes)
+{
+  unsigned int nofFrames;
+  for (unsigned int i=0; i<inputRings.size(); i++) {
+    ring = (ring+1) % inputRings.size();
+    nofFrames = inputRings[ring]->readable(slots, sizes);
+    if (nofFrames > 0) {
+      return nofFrames;
+    };
+  };
+  return 0;
+}
+
+//_______________________________________________________________________________
+//                                                                    readersDone
+
+/*!
+  \brief Have all reader-threads ended and all input buffers been processed?
+*/
+bool readersDone ()
+{
+  {
+    boost::mutex::scoped_lock lock(writeMutex);
+    if (noRunning > 0) {
+      return false;
+    };
+  }
+  for (unsigned int i=0; i<inputRings.size(); i++) {
+    if (!inputRings[i]->empty()) {
+      return false;
+    };
+  };
+  return true;
+}
+
 //_______________________________________________________________________________
 //                                                                readFromSockets
 
@@ -355,92 +505,160 @@ bool readFromSockets (std::vector<int> ports,
 		      bool verbose=false,
 		      bool waitForAllPorts=false)
 {
-  unsigned int i = 0;
-
-  //________________________________________________________
-  // initialize the buffer
-
-  terminateThreads = false;
-  maxCachedFrames  = maxWaitingFrames = 0;
-  inBufProcessID   = inBufStorID =0;
-  noRunning        = 0;
-  inputBuffer_p    = new char[(input_buffer_size*UDP_PACKET_BUFFER_SIZE)];
-
-  if (inputBuffer_p == NULL) {
-    cerr << "TBBraw2h5::readFromSockets: Failed to allocate input buffer!" <<endl;
+  // start the reader-threads
+  std::vector<boost::thread*> readerThreads = startReaders(ports, ip, startTimeout,
+							   readTimeout, verbose, false);
+  if (readerThreads.empty()) {
     return false;
-  } else if (verbose) {
-    cout << "TBBraw2h5::readFromSockets: Allocated " << input_buffer_size*UDP_PACKET_BUFFER_SIZE
-	 << " bytes for the input buffer." << endl;
   };
 
-  // start the reader-threads
-  boost::thread **readerThreads;
-  readerThreads = new boost::thread*[ports.size()];
-  for (i=0; i < ports.size(); i++) {
-    readerThreads[i] = new boost::thread(boost::bind(socketReaderThread,
-						     ports[i],
-						     ip,
-						     startTimeout,
-						     readTimeout,
-						     verbose,
-						     false));
-    if (readerThreads[i]->boost::thread::joinable() ) {
-      noRunning++;
-    } else {
-      cout << "TBBraw2h5::readFromSockets: Failed to start reader thread for port :" << ports[i] << endl;
-      cout << "  Aborting!!! " << endl;
-      terminateThreads=true;
-      return false;
-    };
-  };
-  int processingID, tmpint;
-  int amWaiting=0;
-  while ((noRunning>0) || (inBufStorID != inBufProcessID) )  {
-    if (inBufStorID == inBufProcessID)  {
-      if (verbose && ((amWaiting%100)==1) ) {
+  unsigned int ring  = 0;
+  unsigned int round = 0;
+  unsigned int nofFrames;
+  unsigned long long nofProcessed = 0;
+  double idleSince  = DAL::wallTime();
+  double lastReport = idleSince;
+  char *slots;
+  int *sizes;
+
+  while (true) {
+    nofFrames = fetchFrames(ring, slots, sizes);
+    if (nofFrames == 0) {
+      if (readersDone()) {
+	break;
+      };
+      if (idleSince < 0) {
+	idleSince = DAL::wallTime();
+      };
+      double now = DAL::wallTime();
+      if (verbose && (now-lastReport > 10)) {
 	cout << "TBBraw2h5::readFromSockets: Status report: Buffer is empty! waiting." << endl;
-	cout << "  Status: inBufStorID:" << inBufStorID << " inBufProcessID: " << inBufProcessID
-	     << " noRunning: " << noRunning << " waiting for: " << amWaiting*0.10 << " sec."<< endl;
+	cout << "  Status: noRunning: " << noRunning << " waiting for: "
+	     << now-idleSince << " sec."<< endl;
+	lastReport = now;
       };
-      amWaiting++;
-      usleep(100000);
-      if (!waitForAllPorts && maxCachedFrames>0 && (amWaiting*0.10 > readTimeout)){
+      if (!waitForAllPorts && nofProcessed>0 && (now-idleSince > readTimeout)){
 	if (verbose && ! terminateThreads) {
 	  cout << "TBBraw2h5::readFromSockets: Stopping all other reader-threads." << endl;
 	};
 	terminateThreads = true;
       };
+      DAL::TBB_FrameRing::backoff(round);
       continue;
     };
-    amWaiting=0;
-    tmpint = (inBufStorID-inBufProcessID+input_buffer_size)%input_buffer_size;
-    if (tmpint > maxCachedFrames) {
-      maxCachedFrames = tmpint;
-    };
-    processingID = inBufProcessID+1;
-    if (processingID >= input_buffer_size) {
-      processingID -= input_buffer_size;
+    round     = 0;
+    idleSince = -1;
+    for (unsigned int i=0; i<nofFrames; i++) {
+      tbb->processTBBrawBlock(slots + i*UDP_PACKET_BUFFER_SIZE, sizes[i]);
     };
-    tbb->processTBBrawBlock( (inputBuffer_p + (processingID*UDP_PACKET_BUFFER_SIZE)),
-			     UDP_PACKET_BUFFER_SIZE);
-    inBufProcessID = processingID;
-  };
-  terminateThreads = true;
-  for (i=0;  i< ports.size(); i++){
-    readerThreads[i]->join();
-    delete readerThreads[i];
-  };
-  delete [] readerThreads;
-  delete inputBuffer_p;
-  if (verbose) {
-    cout << "Socket and Buffer Stats: Maximum # of waiting frames:" << maxWaitingFrames << endl;
-    cout << "                        Maximum # of frames in cache:" << maxCachedFrames << endl;
-    cout << "     Number of frames dropped due to buffer overflow:" << noFramesDropped << endl;
+    inputRings[ring]->release(nofFrames);
+    nofProcessed += nofFrames;
   };
+
+  stopReaders(readerThreads, ports, verbose);
   return true;
 };
 
+//_______________________________________________________________________________
+//                                                            stationWriterThread
+
+/*!
+  \brief Thread that writes the frames of a single station into its own files
+
+  \param ring        -- Queue with the frames of the station, the thread is
+         its only consumer
+  \param stationId   -- ID of the station
+  \param outFileBase -- Base of the output filenames; the files of the station
+         are called <tt>outFileBase-stationId-runnumber.h5</tt>
+  \param readTimeout -- A file is closed after no data arrived for this long,
+         the next frame then starts a new file [in sec]
+  \param verbose     -- Produce more output
+
+  Every station has a file and an HDF5 writer of its own, so that the stations
+  are processed in parallel. Unless the HDF5 library is built thread-safe, the
+  calls into it are serialized: the file is created here under
+  <tt>hdf5Mutex</tt>, which is then handed to the TBBraw object to be held
+  while it creates dipoles, writes runs of frames and closes the file.
+*/
+void stationWriterThread (DAL::TBB_FrameRing *ring,
+			  unsigned char stationId,
+			  std::string outFileBase,
+			  float readTimeout,
+			  bool verbose)
+{
+  DAL::TBBraw *file = NULL;
+  int runnumber     = 0;
+  int lasttime      = 0;
+  bool failed       = false;
+  unsigned int nofFrames;
+  char *slots;
+  int *sizes;
+  char *bufferPointer;
+  std::ostringstream outfile;
+
+  while (true) {
+    if (!ring->waitReadable(readTimeout)) {
+      if (ring->isClosed() && ring->empty()) {
+	break;
+      };
+      // no data for readTimeout: close the current file
+      if (file != NULL) {
+	if (verbose) {
+	  file->summary();
+	};
+	delete file;
+	file = NULL;
+      };
+      continue;
+    };
+    nofFrames = ring->readable(slots, sizes);
+    // after a failed file creation the frames are only drained
+    for (unsigned int n=0; (n<nofFrames) && !failed; n++) {
+      bufferPointer = slots + n*UDP_PACKET_BUFFER_SIZE;
+      if ( (file == NULL) || 
+	   (DAL::TBBraw::getDataTime(bufferPointer) > (lasttime+ceil(readTimeout)) ) ){
+	if (file != NULL) {
+	  if (verbose) {
+	    file->summary();
+	  };
+	  delete file;
+	};
+	outfile.str("");
+	outfile << outFileBase << "-" << int(stationId) << "-" << runnumber << ".h5";
+	runnumber++;
+	{
+	  DAL::TBBraw::HDF5Lock lock (hdf5Mutex);
+	  file = new DAL::TBBraw(outfile.str());
+	  if ( !file->isConnected() ) {
+	    delete file;
+	    file = NULL;
+	  };
+	}
+	if (file == NULL) {
+	  cout << "TBBraw2h5::stationWriterThread: Failed to open output file:" 
+	       << outfile.str() << endl;
+	  terminateThreads=true;
+	  failed=true;
+	  break;
+	};       
+	file->setHDF5Mutex(hdf5Mutex);
+	file->setFrameBufferSize(size_t(write_buffer_size)*1024);
+      };
+      if ( file->processTBBrawBlock(bufferPointer, sizes[n]) ){ 
+	lasttime = DAL::TBBraw::getDataTime(bufferPointer);
+      };
+    };
+    ring->release(nofFrames);
+  };
+
+  if (file != NULL) {
+    if (verbose) {
+      file->summary();
+    };
+    delete file;
+  };
+}
+
 //_______________________________________________________________________________
 //                                                        readStationsFromSockets
 
@@ -455,6 +673,12 @@ bool readFromSockets (std::vector<int> ports,
 
   \return \t false if something went wrong
 
+  The frames of all ports are sorted by the ID of the station that sent them
+  into per-station queues; each queue is drained by a stationWriterThread,
+  started as soon as the first frame of its station arrives. If a writer
+  cannot keep up, its queue fills and the sorting waits, so that the frames
+  pile up in the input buffers and then in the socket buffers.
+
   Compared to \t readFromSockets() this function generates less (usefull)
   debug output. So the other (old) version should stay around.
 */
@@ -468,136 +692,106 @@ bool readStationsFromSockets (std::vector<int> ports,
   unsigned int i = 0;
 
   //________________________________________________________
-  // Initialize the buffer
-
-  terminateThreads = false;
-  maxCachedFrames  = 0;
-  maxWaitingFrames = 0;
-  inBufProcessID   = 0;
-  inBufStorID      = 0;
-  noRunning        = 0;
-  inputBuffer_p    = new char[(input_buffer_size*UDP_PACKET_BUFFER_SIZE)];
-  
-  if (inputBuffer_p == NULL) {
-    std::cerr << "TBBraw2h5::readStationsFromSockets: Failed to allocate input buffer!"
-	      << std::endl;
-    return false;
-  } else if (verbose) {
-    cout << "TBBraw2h5::readStationsFromSockets: Allocated "
-	 << input_buffer_size*UDP_PACKET_BUFFER_SIZE
-	 << " bytes for the input buffer." << endl;
-  };
-
-  //________________________________________________________
-  // Get and initialize memory for the TBB pointers
+  // Per-station queues and writers, created on demand
 
-  unsigned int nofTBBfiles = 256;
-  int lasttimes[nofTBBfiles];  
-  int runnumbers[nofTBBfiles];  
-  DAL::TBBraw **TBBfiles = new DAL::TBBraw* [nofTBBfiles]; 
-
-  for (i=0; i<nofTBBfiles; i++) {
-    TBBfiles[i]   = NULL;
-    runnumbers[i] = 0;
-  }
+  unsigned int nofStations = 256;
+  std::vector<DAL::TBB_FrameRing*> stationRings (nofStations, NULL);
+  std::vector<boost::thread*> writerThreads (nofStations, NULL);
 
   //________________________________________________________
   // Start the reader-threads
 
-  boost::thread **readerThreads = new boost::thread*[ports.size()];
-
-  for (i=0; i < ports.size(); i++) {
-    readerThreads[i] = new boost::thread (boost::bind(socketReaderThread,
-						      ports[i],
-						      ip,
-						      startTimeout,
-						      readTimeout,
-						      verbose,
-						      true));
-    if (readerThreads[i]->joinable() ) {
-      noRunning++;
-    } else {
-      cout << "TBBraw2h5::readStationsFromSockets: Failed to start reader thread for port :" << ports[i] << endl;
-      cout << "  Aborting!!! " << endl;
-      terminateThreads=true;
-      return false;
-    };
+  std::vector<boost::thread*> readerThreads = startReaders(ports, ip, startTimeout,
+							   readTimeout, verbose, true);
+  if (readerThreads.empty()) {
+    return false;
   };
 
   //________________________________________________________
-  // Look for and process incoming data
+  // Look for incoming data and hand it to the station writers
 
-  int processingID = 0;
-  int tmpint       = 0;
-  int amWaiting    = 0;
+  unsigned int ring  = 0;
+  unsigned int round = 0;
+  unsigned int nofFrames;
+  double idleSince   = DAL::wallTime();
+  double lastReport  = idleSince;
   unsigned char stationId;
+  DAL::TBB_FrameRing *stationRing;
   char * bufferPointer;
-  std::ostringstream outfile;
+  char * stationSlot;
+  int * sizes;
+  int * stationSize;
+  char * slots;
   
-  while ((noRunning>0) || (inBufStorID != inBufProcessID) )  {
-    if (inBufStorID == inBufProcessID)  {
-      if (verbose && ((amWaiting%100)==1) ) {
+  while (true) {
+    nofFrames = fetchFrames(ring, slots, sizes);
+    if (nofFrames == 0) {
+      if (readersDone()) {
+	break;
+      };
+      if (idleSince < 0) {
+	idleSince = DAL::wallTime();
+      };
+      double now = DAL::wallTime();
+      if (verbose && (now-lastReport > 10)) {
 	std::cout << "[TBBraw2h5::readStationsFromSockets]"
 		  << " Status report: Buffer is empty! waiting." << std::endl;
-	std::cout << "-- inBufStorID       = " << inBufStorID    << std::endl;
-	std::cout << "-- inBufProcessID    = " << inBufProcessID << std::endl;
 	std::cout << "-- noRunning         = " << noRunning      << std::endl;
-	std::cout << "-- Wait interval [s] = " << amWaiting*0.10 << std::endl;
-      };
-      amWaiting++;
-      usleep(100000);
-      if (amWaiting*0.10 > readTimeout){
-	for (i=0; i<256; i++) {
-	  if (TBBfiles[i] != NULL) {
-	    if (verbose) {
-	      TBBfiles[i]->summary();
-	    };
-	    delete TBBfiles[i];
-	    TBBfiles[i] = NULL;
-	  };
-	};	
+	std::cout << "-- Wait interval [s] = " << now-idleSince  << std::endl;
+	lastReport = now;
       };
+      DAL::TBB_FrameRing::backoff(round);
       continue;
     };
-    amWaiting=0;
-    tmpint = (inBufStorID-inBufProcessID+input_buffer_size)%input_buffer_size;
-    if (tmpint > maxCachedFrames) {
-      maxCachedFrames = tmpint;
-    };
-    processingID = inBufProcessID+1;
-    if (processingID >= input_buffer_size) {
-      processingID -= input_buffer_size;
-    };
-    bufferPointer = (inputBuffer_p + (processingID*UDP_PACKET_BUFFER_SIZE));
-    stationId = DAL::TBBraw::getStationId(bufferPointer);
-    if ( (TBBfiles[stationId] == NULL) || 
-	 (DAL::TBBraw::getDataTime(bufferPointer) > (lasttimes[stationId]+ceil(readTimeout)) ) ){
-      if (TBBfiles[stationId] != NULL) {
+    round     = 0;
+    idleSince = -1;
+    for (unsigned int n=0; n<nofFrames; n++) {
+      bufferPointer = slots + n*UDP_PACKET_BUFFER_SIZE;
+      stationId     = DAL::TBBraw::getStationId(bufferPointer);
+      stationRing   = stationRings[stationId];
+      if (stationRing == NULL) {
 	if (verbose) {
-	  TBBfiles[stationId]->summary();
+	  cout << "TBBraw2h5::readStationsFromSockets: Starting writer for station "
+	       << int(stationId) << endl;
 	};
-	delete TBBfiles[stationId];
-	TBBfiles[stationId] = NULL;
+	stationRing = stationRings[stationId]
+	  = new DAL::TBB_FrameRing(station_buffer_size, UDP_PACKET_BUFFER_SIZE,
+				   DAL::TBB_FrameRing::BlockingWait);
+	writerThreads[stationId] = new boost::thread(boost::bind(stationWriterThread,
+								 stationRing,
+								 stationId,
+								 outFileBase,
+								 readTimeout,
+								 verbose));
       };
-      outfile << outFileBase << "-" << int(stationId) << "-" << runnumbers[stationId] << ".h5";
-      runnumbers[stationId]++;
-      TBBfiles[stationId] = new DAL::TBBraw(outfile.str());
-      if ( !TBBfiles[stationId]->isConnected() ) {
-	cout << "TBBraw2h5::readStationsFromSockets: Failed to open output file:" 
-	     << outfile.str() << endl;
-	terminateThreads=true;
-      };       
-    };
-    if ( TBBfiles[stationId]->processTBBrawBlock(bufferPointer, UDP_PACKET_BUFFER_SIZE) ){ 
-      lasttimes[stationId] = DAL::TBBraw::getDataTime(bufferPointer);
+      while (stationRing->writable(stationSlot, stationSize) == 0) {
+	stationRing->waitWritable(readTimeout);
+      };
+      memcpy(stationSlot, bufferPointer, sizes[n]);
+      *stationSize = sizes[n];
+      stationRing->commit(1);
     };
-    inBufProcessID = processingID;    
+    inputRings[ring]->release(nofFrames);
   };
 
-  // Release allocated memory
-  delete [] TBBfiles;
-
-  terminateThreads = true;
+  //________________________________________________________
+  // Let the writers finish and release allocated memory
+
+  stopReaders(readerThreads, ports, verbose);
+
+  for (i=0; i<nofStations; i++) {
+    if (stationRings[i] != NULL) {
+      stationRings[i]->close();
+      writerThreads[i]->join();
+      if (verbose) {
+	cout << "   Station " << i
+	     << ": Maximum # of frames in queue:" << stationRings[i]->highWaterMark()
+	     << " , # of times queue was full:" << stationRings[i]->nofFull() << endl;
+      };
+      delete writerThreads[i];
+      delete stationRings[i];
+    };
+  };
 
   return true;
 }
@@ -616,44 +810,51 @@ bool readStationsFromSockets (std::vector<int> ports,
 bool readFromFile (string infile,
 		   bool verbose=false)
 {
-  int i         = 0;
   int numblocks = 0;
   int size      = 0;
-  struct stat filestat;
+  char *header;
+  char *payload;
   char buffer[TBB_FRAME_SIZE];
+  DAL::TBB_FileIngest ingest;
 
-  stat(infile.c_str(), &filestat);
-  numblocks = filestat.st_size / TBB_FRAME_SIZE;
-  if (numblocks < 1)
-    {
-      cerr << "TBBraw2h5::readFromFile " << infile << " too small (smaller than one blocksize)." <<endl;
-      return false;
-    };
-  if (verbose)
-    {
-      cout << "TBBraw2h5::readFromFile reading in " << numblocks << " blocks." << endl;
-    };
-  FILE *fd = fopen(infile.c_str(),"r");
-  if (fd == NULL)
+  if (!ingest.open(infile))
     {
       cerr << "TBBraw2h5::readFromFile: Can't open file: " << infile << endl;
       return false;
     };
-  for (i=0; i<numblocks; i++)
+  //the size of every frame follows from its header: spectral frames are smaller
+  while ((header = ingest.read(TBB_HEADER_SIZE)) != NULL)
     {
-      size = fread(buffer, 1, TBB_FRAME_SIZE, fd);
-      if ( (size != TBB_FRAME_SIZE )  )
+      size = DAL::TBBraw::frameSize(header);
+      if (size > TBB_FRAME_SIZE)
+        {
+          cerr << "TBBraw2h5::readFromFile: Invalid frame size " << size
+               << " of block: " << numblocks << endl;
+          return false;
+        };
+      memcpy(buffer, header, TBB_HEADER_SIZE);
+      payload = ingest.read(size-TBB_HEADER_SIZE);
+      if (payload == NULL)
         {
           if (verbose)
             {
-              cout << "TBBraw2h5::readFromFile Cannot read in block: " << i << endl;
+              cout << "TBBraw2h5::readFromFile Cannot read in block: " << numblocks << endl;
             };
-          fclose(fd);
           return false;
         };
+      memcpy(buffer+TBB_HEADER_SIZE, payload, size-TBB_HEADER_SIZE);
       tbb->processTBBrawBlock(buffer, size);
+      numblocks++;
+    };
+  if (numblocks < 1)
+    {
+      cerr << "TBBraw2h5::readFromFile " << infile << " too small (smaller than one blocksize)." <<endl;
+      return false;
+    };
+  if (verbose)
+    {
+      cout << "TBBraw2h5::readFromFile read in " << numblocks << " blocks." << endl;
     };
-  fclose(fd);
   return true;
 };
 
@@ -678,7 +879,10 @@ int main(int argc, char *argv[])
   bool multipeStations  = false;
   int runNumber         = 0;
 
-  input_buffer_size = 50000;
+  input_buffer_size  = 50000;
+  write_buffer_size  = 1024;
+  socket_buffer_size = DEFAULT_RECEIVE_BUFFER_SIZE/1024;
+  station_buffer_size = 10000;
 
   bpo::options_description desc ("[TBBraw2h5] Available command line options");
 
@@ -701,8 +905,11 @@ int main(int argc, char *argv[])
     ("timeoutStart,S", bpo::value<float>(), "Time-out when opening socket connection, [sec].")
     ("timeoutRead,R", bpo::value<float>(), "Time-out when while reading from socket, [sec].")
     ("fixTimes,F", bpo::value<int>(), "Fix broken time-stamps old style (1), new style (2, default), or not (0)")
-    ("doCheckCRC,C", bpo::value<int>(), "Check the CRCs: (0) no check, (1,default) check header.")
-    ("bufferSize,B", bpo::value<int>(), "Size of the input buffer, [frames] (default=50000, about 100MB).")
+    ("doCheckCRC,C", bpo::value<int>(), "Check the CRCs: (0) no check, (1,default) check header, (2) check header and data.")
+    ("bufferSize,B", bpo::value<int>(), "Size of the input buffer, [frames] shared by all ports (default=50000, about 100MB).")
+    ("writeBuffer", bpo::value<int>(), "Size of the write buffer per dipole, [kB] (default=1024, 0 disables).")
+    ("socketBuffer", bpo::value<int>(), "Size of the kernel receive buffer per port, [kB] (default=32768, 0 system default).")
+    ("stationBuffer", bpo::value<int>(), "Size of the queue of every station writer, [frames] (default=10000).")
     ("keepRunning,K", "Keep running, i.e. process more than one event by restarting the procedure.")
     ("waitForAll,W", "Wait until (some) data was received on all ports.")
     ("multipeStations,M", "Process data from multiple stations into seperate files. (implies -K)")
@@ -788,6 +995,21 @@ int main(int argc, char *argv[])
       input_buffer_size = vm["bufferSize"].as<int>();
     }
   
+  if (vm.count("writeBuffer"))
+    {
+      write_buffer_size = vm["writeBuffer"].as<int>();
+    }
+  
+  if (vm.count("socketBuffer"))
+    {
+      socket_buffer_size = vm["socketBuffer"].as<int>();
+    }
+  
+  if (vm.count("stationBuffer"))
+    {
+      station_buffer_size = vm["stationBuffer"].as<int>();
+    }
+  
 
   // -----------------------------------------------------------------
   // Check the provided input
@@ -812,6 +1034,24 @@ int main(int argc, char *argv[])
       input_buffer_size = 50000;
     };
 
+  if (write_buffer_size < 0)
+    {
+      cout << "[TBBraw2h5] Write buffer size negative, setting to default value" << endl;
+      write_buffer_size = 1024;
+    };
+
+  if (station_buffer_size < 100) 
+    {
+      cout << "[TBBraw2h5] Station buffer size too small ("<< station_buffer_size << "<100), setting to default value" << endl;
+      station_buffer_size = 10000;
+    };
+
+  if (socket_buffer_size < 0)
+    {
+      cout << "[TBBraw2h5] Socket buffer size negative, keeping the system default" << endl;
+      socket_buffer_size = 0;
+    };
+
   if (keepRunning && !socketmode)
     {
       cout << "[TBBraw2h5] KeepRunning only usefull in socketmode, option disabled!" << endl;
@@ -828,15 +1068,18 @@ int main(int argc, char *argv[])
       std::cout << "-- Output file  = " << outfile             << std::endl;
       std::cout << "-- CRC checking = " << doCheckCRC          << std::endl;
       std::cout << "-- Fix Times    = " << fixTransientTimes   << std::endl;
+      std::cout << "-- Write buffer = " << write_buffer_size   << std::endl;
       if (socketmode) {
 	std::cout << "-- IP address      = " << ip             << std::endl;
 	//	std::cout << "-- Port number     = " << port           << std::endl;
 	std::cout << "-- Port numbers    = " << ports          << std::endl;
 	std::cout << "-- Timeout (start) = " << timeoutStart   << std::endl;
 	std::cout << "-- Timeout (read)  = " << timeoutRead    << std::endl;
+	std::cout << "-- Socket buffer   = " << socket_buffer_size << std::endl;
 	std::cout << "-- Wait for ports  = " << waitForAll     << std::endl;
 	std::cout << "-- Keep Running    = " << keepRunning    << std::endl;
 	std::cout << "-- Multipe Stations= " << multipeStations    << std::endl;
+	std::cout << "-- Station buffer  = " << station_buffer_size << std::endl;
       }
       else {
 	std::cout << "-- Input file   = " << infile  << std::endl;
@@ -887,7 +1130,9 @@ int main(int argc, char *argv[])
     else {
       tbb->doHeaderCRC(false);
     };
+    tbb->doDataCRC(doCheckCRC>1);
     tbb->setFixTimes(fixTransientTimes);
+    tbb->setFrameBufferSize(size_t(write_buffer_size)*1024);
     
     // -----------------------------------------------------------------
     // call the conversion routines
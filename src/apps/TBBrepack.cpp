@@ -0,0 +1,444 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dal_config.h>
+#include <core/dalCommon.h>
+
+//includes for the commandline options
+#include <boost/program_options.hpp>
+#include <boost/program_options/cmdline.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/detail/cmdline.hpp>
+namespace bpo = boost::program_options;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+/*!
+  \file TBBrepack.cpp
+
+  \ingroup DAL
+  \ingroup dal_apps
+
+  \brief Rewrite a finished TBB dump with contiguously stored dipole datasets.
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Prerequisite</h3>
+
+  - DAL::TBB_DipoleDataset -- Container for the data of a single dipole.
+
+  <h3>Synopsis</h3>
+
+  While a dump is being recorded, \t TBBraw2h5 and \t tbb2h5 store the samples
+  of each dipole in an extendible, chunked dataset. Once the dump is complete
+  the datasets no longer change in size; rewriting them with contiguous layout
+  allows DAL::TBB_DipoleDataset::mapData() to serve reads straight from a
+  memory mapping of the file.
+
+  The structure of the input file is copied to the output file: groups and
+  attributes are recreated, all one-dimensional datasets of 16-bit integers --
+  i.e. the dipole datasets -- are written contiguously, unfiltered and with
+  fixed size, copying the samples in blocks; any other object is copied as it
+  is.
+
+  <h3>Usage</h3>
+
+  <table border="0">
+    <tr>
+    <td class="indexkey">Command line</td>
+    <td class="indexkey">Decription</td>
+    </tr>
+    <tr>
+      <td>-H [--help]</td>
+      <td>Show help messages</td>
+    </tr>
+    <tr>
+      <td>-I [--infile] arg</td>
+      <td>Name of the finished dump (HDF5 file).</td>
+    </tr>
+    <tr>
+      <td>-O [--outfile] arg</td>
+      <td>Name of the output file; an existing file is overwritten.</td>
+    </tr>
+    <tr>
+      <td>-B [--blocksize] arg</td>
+      <td>Number of samples copied at once (default 1048576).</td>
+    </tr>
+  </table>
+
+  <h3>Examples</h3>
+
+  \verbatim
+  TBBrepack -I dump.h5 -O dump-contiguous.h5
+  \endverbatim
+*/
+
+//! Statistics of a repack run
+struct RepackStatistics {
+  //! Number of groups created
+  unsigned int nofGroups;
+  //! Number of datasets rewritten contiguously
+  unsigned int nofRepacked;
+  //! Number of objects copied as they are
+  unsigned int nofCopied;
+  //! Number of bytes of sample data rewritten
+  unsigned long long nofBytes;
+};
+
+//! Arguments passed along while walking through the input file
+struct RepackContext {
+  //! Group in the output file corresponding to the one being walked
+  hid_t target;
+  //! Number of samples copied at once
+  hsize_t blocksize;
+  //! Statistics of the run
+  RepackStatistics *statistics;
+  //! Status of the run
+  bool status;
+};
+
+//_______________________________________________________________________________
+//                                                                 copyAttributes
+
+/*!
+  \param source -- Object whose attributes are copied.
+  \param target -- Object to which the attributes are attached.
+
+  \return status -- Status of the operation; returns \e false in case an error
+          was encountered.
+*/
+bool copyAttributes (hid_t const &source,
+		     hid_t const &target)
+{
+  bool status (true);
+  H5O_info_t info;
+
+  if (H5Oget_info (source, &info) < 0) {
+    return false;
+  }
+
+  for (hsize_t n=0; n<info.num_attrs; ++n) {
+    hid_t attribute = H5Aopen_by_idx (source, ".", H5_INDEX_NAME, H5_ITER_INC,
+				      n, H5P_DEFAULT, H5P_DEFAULT);
+    if (attribute < 0) {
+      status = false;
+      continue;
+    }
+
+    ssize_t nameLength = H5Aget_name (attribute, 0, NULL);
+    std::vector<char> name (nameLength+1);
+    H5Aget_name (attribute, name.size(), &name[0]);
+
+    hid_t datatype  = H5Aget_type (attribute);
+    hid_t dataspace = H5Aget_space (attribute);
+    hssize_t nofElements = H5Sget_simple_extent_npoints (dataspace);
+    std::vector<char> buffer (nofElements*H5Tget_size(datatype) + 1);
+    hid_t copy = H5Acreate (target, &name[0], datatype, dataspace,
+			    H5P_DEFAULT, H5P_DEFAULT);
+
+    if (copy < 0
+	|| H5Aread (attribute, datatype, &buffer[0]) < 0
+	|| H5Awrite (copy, datatype, &buffer[0]) < 0) {
+      cerr << "[TBBrepack::copyAttributes] Failed to copy attribute "
+	   << &name[0] << endl;
+      status = false;
+    } else if (H5Tdetect_class (datatype, H5T_VLEN) > 0
+	       || (H5Tget_class (datatype) == H5T_STRING && H5Tis_variable_str (datatype) > 0)) {
+      H5Dvlen_reclaim (datatype, dataspace, H5P_DEFAULT, &buffer[0]);
+    }
+
+    if (copy >= 0) {
+      H5Aclose (copy);
+    }
+    H5Sclose (dataspace);
+    H5Tclose (datatype);
+    H5Aclose (attribute);
+  }
+
+  return status;
+}
+
+//_______________________________________________________________________________
+//                                                                     isDipole
+
+/*!
+  \param dataset -- Identifier of the dataset.
+
+  \return isDipole -- \e true if the dataset is a one-dimensional array of
+          16-bit integers, as are the dipole datasets.
+*/
+bool isDipole (hid_t const &dataset)
+{
+  hid_t datatype  = H5Dget_type (dataset);
+  hid_t dataspace = H5Dget_space (dataset);
+  bool status     = H5Tget_class (datatype) == H5T_INTEGER
+    && H5Tget_size (datatype) == 2
+    && H5Sget_simple_extent_ndims (dataspace) == 1;
+
+  H5Sclose (dataspace);
+  H5Tclose (datatype);
+
+  return status;
+}
+
+//_______________________________________________________________________________
+//                                                                 repackDataset
+
+/*!
+  \param source    -- Identifier of the dataset in the input file.
+  \param target    -- Group in the output file in which to create the dataset.
+  \param name      -- Name of the dataset.
+  \param blocksize -- Number of samples copied at once.
+  \retval nofBytes -- Number of bytes of sample data written.
+
+  \return status -- Status of the operation; returns \e false in case an error
+          was encountered.
+*/
+bool repackDataset (hid_t const &source,
+		    hid_t const &target,
+		    std::string const &name,
+		    hsize_t const &blocksize,
+		    unsigned long long &nofBytes)
+{
+  bool status (true);
+  hsize_t length (0);
+  hid_t datatype  = H5Dget_type (source);
+  hid_t fileSpace = H5Dget_space (source);
+  hid_t plist     = H5Pcreate (H5P_DATASET_CREATE);
+
+  H5Sget_simple_extent_dims (fileSpace, &length, NULL);
+
+  /* Fixed size, contiguous and allocated right away, so it can be mapped */
+  hid_t targetSpace = H5Screate_simple (1, &length, NULL);
+  H5Pset_layout (plist, H5D_CONTIGUOUS);
+  H5Pset_alloc_time (plist, H5D_ALLOC_TIME_EARLY);
+
+  hid_t dataset = H5Dcreate (target, name.c_str(), datatype, targetSpace,
+			     H5P_DEFAULT, plist, H5P_DEFAULT);
+
+  if (dataset < 0) {
+    cerr << "[TBBrepack::repackDataset] Failed to create dataset "
+	 << name << endl;
+    status = false;
+  } else {
+    std::vector<char> buffer (blocksize*H5Tget_size(datatype));
+    for (hsize_t start=0; start<length && status; start+=blocksize) {
+      hsize_t count    = std::min (blocksize, length-start);
+      hid_t memorySpace = H5Screate_simple (1, &count, NULL);
+      H5Sselect_hyperslab (fileSpace, H5S_SELECT_SET, &start, NULL, &count, NULL);
+      H5Sselect_hyperslab (targetSpace, H5S_SELECT_SET, &start, NULL, &count, NULL);
+      if (H5Dread (source, datatype, memorySpace, fileSpace, H5P_DEFAULT, &buffer[0]) < 0
+	  || H5Dwrite (dataset, datatype, memorySpace, targetSpace, H5P_DEFAULT, &buffer[0]) < 0) {
+	cerr << "[TBBrepack::repackDataset] Failed to copy samples of dataset "
+	     << name << endl;
+	status = false;
+      }
+      H5Sclose (memorySpace);
+    }
+    nofBytes += length*H5Tget_size(datatype);
+    if (!copyAttributes (source, dataset)) {
+      status = false;
+    }
+    H5Dclose (dataset);
+  }
+
+  H5Pclose (plist);
+  H5Sclose (targetSpace);
+  H5Sclose (fileSpace);
+  H5Tclose (datatype);
+
+  return status;
+}
+
+//_______________________________________________________________________________
+//                                                                    repackLink
+
+/*!
+  \brief Process an object of a group of the input file; called by H5Literate
+
+  \param group -- Group of the input file being walked.
+  \param name  -- Name of the link to the object.
+  \param info  -- Information on the link.
+  \param data  -- The RepackContext of the group.
+
+  \return status -- 0 to continue walking the group.
+*/
+herr_t repackLink (hid_t group,
+		   const char *name,
+		   const H5L_info_t *info,
+		   void *data)
+{
+  RepackContext *context = static_cast<RepackContext*>(data);
+  H5O_info_t object;
+
+  /* Soft and external links are not followed */
+  if (info->type != H5L_TYPE_HARD
+      || H5Oget_info_by_name (group, name, &object, H5P_DEFAULT) < 0) {
+    return 0;
+  }
+
+  if (object.type == H5O_TYPE_GROUP) {
+    hid_t source = H5Gopen (group, name, H5P_DEFAULT);
+    hid_t target = H5Gcreate (context->target, name,
+			      H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (source < 0 || target < 0) {
+      cerr << "[TBBrepack::repackLink] Failed to create group " << name << endl;
+      context->status = false;
+    } else {
+      RepackContext embedded = *context;
+      embedded.target = target;
+      if (!copyAttributes (source, target)) {
+	context->status = false;
+      }
+      H5Literate (source, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, repackLink, &embedded);
+      if (!embedded.status) {
+	context->status = false;
+      }
+      ++context->statistics->nofGroups;
+    }
+    if (target >= 0) H5Gclose (target);
+    if (source >= 0) H5Gclose (source);
+  } else if (object.type == H5O_TYPE_DATASET) {
+    hid_t source = H5Dopen (group, name, H5P_DEFAULT);
+    if (isDipole (source)) {
+      if (!repackDataset (source,
+			  context->target,
+			  name,
+			  context->blocksize,
+			  context->statistics->nofBytes)) {
+	context->status = false;
+      }
+      ++context->statistics->nofRepacked;
+    } else {
+      if (H5Ocopy (group, name, context->target, name, H5P_DEFAULT, H5P_DEFAULT) < 0) {
+	context->status = false;
+      }
+      ++context->statistics->nofCopied;
+    }
+    H5Dclose (source);
+  } else {
+    if (H5Ocopy (group, name, context->target, name, H5P_DEFAULT, H5P_DEFAULT) < 0) {
+      context->status = false;
+    }
+    ++context->statistics->nofCopied;
+  }
+
+  return 0;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main (int argc, char *argv[])
+{
+  std::string infile;
+  std::string outfile;
+  hsize_t blocksize = 1048576;
+
+  bpo::options_description desc ("[TBBrepack] Available command line options");
+
+  desc.add_options ()
+    ("help,H", "Show help messages")
+    ("infile,I", bpo::value<std::string>(), "Name of the finished dump")
+    ("outfile,O", bpo::value<std::string>(), "Name of the output file")
+    ("blocksize,B", bpo::value<int>(), "Number of samples copied at once (default 1048576)")
+    ;
+
+  bpo::variables_map vm;
+  bpo::store (bpo::parse_command_line(argc,argv,desc), vm);
+
+  if (vm.count("help") || argc == 1) {
+    cout << "\n" << desc << endl;
+    return 0;
+  }
+  if (vm.count("infile"))    infile    = vm["infile"].as<std::string>();
+  if (vm.count("outfile"))   outfile   = vm["outfile"].as<std::string>();
+  if (vm.count("blocksize")) blocksize = vm["blocksize"].as<int>();
+
+  if (infile.empty() || outfile.empty()) {
+    cout << "[TBBrepack] Provide both an input and an output file!" << endl;
+    cout << endl << desc << endl;
+    return 1;
+  }
+  if (infile == outfile) {
+    cout << "[TBBrepack] Input and output file must be different!" << endl;
+    return 1;
+  }
+  if (vm.count("blocksize") && vm["blocksize"].as<int>() < 1) {
+    cout << "[TBBrepack] Block size must be positive!" << endl;
+    return 1;
+  }
+
+  hid_t input = H5Fopen (infile.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (input < 0) {
+    cerr << "[TBBrepack] Failed to open file " << infile << endl;
+    return 1;
+  }
+  hid_t output = H5Fcreate (outfile.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (output < 0) {
+    cerr << "[TBBrepack] Failed to create file " << outfile << endl;
+    H5Fclose (input);
+    return 1;
+  }
+
+  RepackStatistics statistics = {0, 0, 0, 0};
+  clock_t start_t = clock();
+  hid_t source    = H5Gopen (input, "/", H5P_DEFAULT);
+  hid_t target    = H5Gopen (output, "/", H5P_DEFAULT);
+  RepackContext context;
+
+  context.target     = target;
+  context.blocksize  = blocksize;
+  context.statistics = &statistics;
+  context.status     = copyAttributes (source, target);
+
+  H5Literate (source, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, repackLink, &context);
+
+  H5Gclose (target);
+  H5Gclose (source);
+  H5Fclose (output);
+  H5Fclose (input);
+
+  double seconds = double(clock()-start_t)/CLOCKS_PER_SEC;
+
+  cout << "[TBBrepack] Summary of the repacked file " << outfile << endl;
+  cout << "-- Groups created          = " << statistics.nofGroups   << endl;
+  cout << "-- Datasets repacked       = " << statistics.nofRepacked << endl;
+  cout << "-- Other objects copied    = " << statistics.nofCopied   << endl;
+  cout << "-- Sample data [MB]        = " << statistics.nofBytes/1048576.0 << endl;
+  cout << "-- CPU time [s]            = " << seconds                << endl;
+
+  if (!context.status) {
+    cerr << "[TBBrepack] Errors were encountered while repacking " << infile << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,496 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <dal_config.h>
+#include <core/dalCommon.h>
+#include <data_hl/TBBraw.h>
+#include <data_hl/TBB_UDPIngest.h>
+
+//includes for the commandline options
+#include <boost/program_options.hpp>
+#include <boost/program_options/cmdline.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/detail/cmdline.hpp>
+namespace bpo = boost::program_options;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+/*!
+  \file TBBreplay.cpp
+
+  \ingroup DAL
+  \ingroup dal_apps
+
+  \brief Replay a recorded TBB dump to an UDP port at a configurable rate.
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Prerequisite</h3>
+
+  - DAL::TBB_UDPIngest -- Batched reception of TBB frames from an UDP port.
+
+  <h3>Synopsis</h3>
+
+  Load generator for the network readers \t TBBraw2h5 and \t tbb2h5: the frames
+  of a recorded dump (as written to disk by the TBBs, i.e. plain 2140-byte frames
+  one after the other) are sent as UDP datagrams, batched by \t sendmmsg(), with
+  a given frame rate. Instead of a recorded dump a synthetic one, with valid
+  header and payload CRCs, can be generated.
+
+  With \t --loopback the program binds the target port itself and forks the
+  sender, so that the drop-free throughput of the receive path can be measured
+  without any further setup: at the end the number of frames sent, received,
+  and dropped by the kernel is reported, together with the rate as seen by the
+  receiver.
+
+  <h3>Usage</h3>
+
+  <table border="0">
+    <tr>
+    <td class="indexkey">Command line</td>
+    <td class="indexkey">Decription</td>
+    </tr>
+    <tr>
+      <td>-H [--help]</td>
+      <td>Show help messages</td>
+    </tr>
+    <tr>
+      <td>-I [--infile] arg</td>
+      <td>Name of the recorded dump. Mutually exclusive to the --synthetic option.</td>
+    </tr>
+    <tr>
+      <td>--synthetic arg</td>
+      <td>Number of frames of a synthetic dump to send instead.</td>
+    </tr>
+    <tr>
+      <td>--stations arg</td>
+      <td>Number of stations in the synthetic dump (default 1).</td>
+    </tr>
+    <tr>
+      <td>--ip arg</td>
+      <td>Host to send the frames to (default 127.0.0.1).</td>
+    </tr>
+    <tr>
+      <td>-P [--port] arg</td>
+      <td>UDP port to send the frames to (default 31664).</td>
+    </tr>
+    <tr>
+      <td>-r [--rate] arg</td>
+      <td>Frame rate [frames/s]; 0 (default) sends as fast as possible. A station
+      dumping at full speed sends about 55000 frames per second.</td>
+    </tr>
+    <tr>
+      <td>-n [--loops] arg</td>
+      <td>Number of times the dump is replayed (default 1).</td>
+    </tr>
+    <tr>
+      <td>--batch arg</td>
+      <td>Number of frames per \t sendmmsg() call (default 32).</td>
+    </tr>
+    <tr>
+      <td>-L [--loopback]</td>
+      <td>Receive the frames in this program as well and report the losses.</td>
+    </tr>
+    <tr>
+      <td>--socketBuffer arg</td>
+      <td>Size of the kernel receive buffer in loopback mode [kB] (default 32768).</td>
+    </tr>
+  </table>
+
+  <h3>Examples</h3>
+
+  Measure the throughput of the receive path at the rate of two stations:
+  \verbatim
+  TBBreplay --synthetic 200000 --rate 110000 --loopback
+  \endverbatim
+
+  Feed a recorded dump to a running instance of TBBraw2h5:
+  \verbatim
+  TBBraw2h5 -P 31664 -O test.h5 &
+  TBBreplay -I dump.dat -P 31664 -r 55000
+  \endverbatim
+*/
+
+//_______________________________________________________________________________
+//                                                                       loadDump
+
+/*!
+  \param infile -- Name of the recorded dump.
+  \retval frames -- Frames of the dump.
+
+  \return status -- \e true if at least one frame could be read.
+*/
+bool loadDump (std::string const &infile,
+	       std::vector<char> &frames)
+{
+  FILE *fd = fopen (infile.c_str(), "rb");
+  if (fd == NULL) {
+    cerr << "[TBBreplay::loadDump] Can't open file: " << infile << endl;
+    return false;
+  }
+
+  std::vector<char> frame (TBB_FRAME_SIZE);
+  frames.clear();
+  while (fread (&frame[0], 1, TBB_FRAME_SIZE, fd) == TBB_FRAME_SIZE) {
+    frames.insert (frames.end(), frame.begin(), frame.end());
+  }
+  fclose (fd);
+
+  if (frames.empty()) {
+    cerr << "[TBBreplay::loadDump] " << infile
+	 << " too small (smaller than one blocksize)." << endl;
+    return false;
+  }
+  return true;
+}
+
+//_______________________________________________________________________________
+//                                                                     makeFrames
+
+/*!
+  \param nofFrames   -- Number of frames to generate; they are distributed over
+         16 dipoles per station in the order in which a station sends them.
+  \param nofStations -- Number of stations, with IDs starting at 1, whose
+         frames are interleaved as if they arrived on the same port.
+  \retval frames -- The generated frames.
+*/
+void makeFrames (int const &nofFrames,
+		 int const &nofStations,
+		 std::vector<char> &frames)
+{
+  const int nofDipoles = 16;
+  const int nofSamples = 1024;
+  const int headerSize = 88;
+
+  frames.assign (size_t(nofFrames)*TBB_FRAME_SIZE, 0);
+
+  for (int n=0; n<nofFrames; ++n) {
+    char *frame       = &frames[size_t(n)*TBB_FRAME_SIZE];
+    int station       = n%nofStations;
+    int m             = n/nofStations;
+    int rcu           = m%nofDipoles;
+    uint32_t time     = 1300000000;
+    uint32_t sampleNr = (m/nofDipoles)*nofSamples;
+    uint16_t nofSamplesPerFrame = nofSamples;
+
+    frame[0] = 1+station;
+    frame[1] = rcu/8;
+    frame[2] = rcu;
+    frame[3] = (char)200;
+    memcpy (frame+8,  &time, 4);
+    memcpy (frame+12, &sampleNr, 4);
+    memcpy (frame+16, &nofSamplesPerFrame, 2);
+
+    uint16_t *header = reinterpret_cast<uint16_t*>(frame);
+    header[headerSize/2-1] = DAL::crc16 (header, headerSize/2);
+
+    uint16_t *payload = reinterpret_cast<uint16_t*>(frame+headerSize);
+    for (int i=0; i<nofSamples; ++i) {
+      payload[i] = uint16_t((sampleNr+i+7*rcu)%4096);
+    }
+    uint32_t crc = DAL::crc32 (payload, nofSamples+2);
+    memcpy (frame+headerSize+2*nofSamples, &crc, 4);
+  }
+}
+
+//_______________________________________________________________________________
+//                                                                        seconds
+
+//! Seconds on the monotonic clock
+double seconds ()
+{
+  struct timespec now;
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return now.tv_sec + 1e-9*now.tv_nsec;
+}
+
+//_______________________________________________________________________________
+//                                                                     sendFrames
+
+/*!
+  \param frames -- Frames to send.
+  \param ip     -- Host to send the frames to.
+  \param port   -- UDP port to send the frames to.
+  \param rate   -- Frame rate [frames/s], 0 for as fast as possible.
+  \param loops  -- Number of times the frames are sent.
+  \param batch  -- Number of frames per system call.
+
+  \return status -- \e true if all frames could be handed to the kernel.
+*/
+bool sendFrames (std::vector<char> &frames,
+		 std::string const &ip,
+		 int const &port,
+		 double const &rate,
+		 int const &loops,
+		 int const &batch)
+{
+  int sock = socket (PF_INET, SOCK_DGRAM, 0);
+  if (sock < 0) {
+    cerr << "[TBBreplay::sendFrames] Failed to create socket: " << strerror(errno) << endl;
+    return false;
+  }
+
+  sockaddr_in remote;
+  memset (&remote, 0, sizeof(remote));
+  remote.sin_family = AF_INET;
+  remote.sin_port   = htons(port);
+  if (inet_aton (ip.c_str(), &remote.sin_addr) == 0) {
+    hostent *record = gethostbyname (ip.c_str());
+    if (record == NULL) {
+      cerr << "[TBBreplay::sendFrames] Unknown host: " << ip << endl;
+      close (sock);
+      return false;
+    }
+    memcpy (&remote.sin_addr, record->h_addr, sizeof(remote.sin_addr));
+  }
+  unsigned long long nofFrames = frames.size()/TBB_FRAME_SIZE;
+  unsigned long long nofTotal  = nofFrames*loops;
+  unsigned long long nofSent   = 0;
+  std::vector<struct mmsghdr> messages (batch);
+  std::vector<struct iovec> iov (batch);
+  bool status = true;
+
+  double start = seconds();
+  while (nofSent < nofTotal) {
+    int nofMessages = std::min<unsigned long long> (batch, nofTotal-nofSent);
+    for (int n=0; n<nofMessages; ++n) {
+      iov[n].iov_base = &frames[((nofSent+n)%nofFrames)*TBB_FRAME_SIZE];
+      iov[n].iov_len  = TBB_FRAME_SIZE;
+      memset (&messages[n], 0, sizeof(messages[n]));
+      messages[n].msg_hdr.msg_name    = &remote;
+      messages[n].msg_hdr.msg_namelen = sizeof(remote);
+      messages[n].msg_hdr.msg_iov     = &iov[n];
+      messages[n].msg_hdr.msg_iovlen  = 1;
+    }
+    /* Pace the batches: sleep for longer waits, spin for the last bit */
+    if (rate > 0) {
+      double wait = start + nofSent/rate - seconds();
+      if (wait > 2e-4) {
+	usleep ((useconds_t) ((wait-1e-4)*1e6));
+      }
+      while (seconds() < start + nofSent/rate) {}
+    }
+#ifdef __linux__
+    int nofDone = sendmmsg (sock, &messages[0], nofMessages, 0);
+#else
+    int nofDone = 0;
+    while (nofDone < nofMessages
+	   && sendmsg (sock, &messages[nofDone].msg_hdr, 0) >= 0) {
+      ++nofDone;
+    }
+    if (nofDone == 0) {
+      nofDone = -1;
+    }
+#endif
+    if (nofDone < 0) {
+      cerr << "[TBBreplay::sendFrames] " << strerror(errno) << endl;
+      status = false;
+      break;
+    }
+    nofSent += nofDone;
+  }
+  double elapsed = seconds()-start;
+  close (sock);
+
+  cout << "[TBBreplay] Sender" << endl;
+  cout << "-- nof. frames sent ....... : " << nofSent << endl;
+  cout << "-- Elapsed time [s] ....... : " << elapsed << endl;
+  cout << "-- Send rate [frames/s] ... : " << nofSent/elapsed << endl;
+  cout << "-- Send rate [Gbit/s] ..... : " << 8e-9*nofSent*TBB_FRAME_SIZE/elapsed << endl;
+
+  return status;
+}
+
+//_______________________________________________________________________________
+//                                                                receiveFrames
+
+/*!
+  \param ingest   -- Socket the frames are received from.
+  \param expected -- Number of frames sent.
+  \param sender   -- Process ID of the sender.
+  \retval senderStatus -- Exit status of the sender, once it has terminated.
+
+  \return nofReceived -- Number of frames received.
+*/
+unsigned long long receiveFrames (DAL::TBB_UDPIngest &ingest,
+				  unsigned long long const &expected,
+				  pid_t const &sender,
+				  int &senderStatus)
+{
+  const unsigned int nofSlots = 4096;
+  // one byte larger than the frame size, so that oversized packets show up
+  const size_t slotSize = TBB_FRAME_SIZE+1;
+  std::vector<char> slots (nofSlots*slotSize);
+  unsigned long long nofReceived = 0;
+  unsigned int slot = 0;
+  bool senderDone   = false;
+  struct timespec first, last;
+
+  first.tv_sec = first.tv_nsec = last.tv_sec = last.tv_nsec = 0;
+
+  while (nofReceived < expected) {
+    int n = ingest.receive (&slots[slot*slotSize],
+			    slotSize,
+			    nofSlots-slot,
+			    senderDone ? 0.2 : 1.0);
+    if (n < 0) {
+      break;
+    } else if (n == 0) {
+      /* Time-out: stop once the sender has finished */
+      if (senderDone || waitpid (sender, &senderStatus, WNOHANG) == sender) {
+	if (senderDone) {
+	  break;
+	}
+	senderDone = true;
+      }
+      continue;
+    }
+    if (nofReceived == 0) {
+      first = ingest.timestamp(0);
+    }
+    last = ingest.timestamp(n-1);
+    nofReceived += n;
+    slot = (slot+n)%nofSlots;
+  }
+
+  double span = (last.tv_sec-first.tv_sec) + 1e-9*(last.tv_nsec-first.tv_nsec);
+
+  cout << "[TBBreplay] Receiver" << endl;
+  cout << "-- nof. frames expected ... : " << expected << endl;
+  cout << "-- nof. frames received ... : " << nofReceived << endl;
+  cout << "-- nof. frames lost ....... : " << expected-nofReceived << endl;
+  cout << "-- Kernel drops ........... : " << ingest.nofKernelDrops() << endl;
+  cout << "-- Receive calls .......... : " << ingest.nofBatches() << endl;
+  cout << "-- Max. frames per call ... : " << ingest.maxBatch() << endl;
+  if (span > 0) {
+    cout << "-- Receive rate [frames/s]  : " << (nofReceived-1)/span << endl;
+  }
+
+  return nofReceived;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main (int argc, char *argv[])
+{
+  std::string infile;
+  std::string ip     = "127.0.0.1";
+  int port           = 31664;
+  int synthetic      = 0;
+  int stations       = 1;
+  double rate        = 0;
+  int loops          = 1;
+  int batch          = 32;
+  bool loopback      = false;
+  int socketBuffer   = DEFAULT_RECEIVE_BUFFER_SIZE/1024;
+
+  bpo::options_description desc ("[TBBreplay] Available command line options");
+
+  desc.add_options ()
+    ("help,H", "Show help messages")
+    ("infile,I", bpo::value<std::string>(), "Name of the recorded dump")
+    ("synthetic", bpo::value<int>(), "Number of frames of a synthetic dump to send instead")
+    ("stations", bpo::value<int>(), "Number of stations in the synthetic dump (default 1)")
+    ("ip", bpo::value<std::string>(), "Host to send the frames to (default 127.0.0.1)")
+    ("port,P", bpo::value<int>(), "UDP port to send the frames to (default 31664)")
+    ("rate,r", bpo::value<double>(), "Frame rate, [frames/s] (default 0: as fast as possible)")
+    ("loops,n", bpo::value<int>(), "Number of times the dump is replayed (default 1)")
+    ("batch", bpo::value<int>(), "Number of frames per system call (default 32)")
+    ("loopback,L", "Receive the frames in this program as well and report the losses")
+    ("socketBuffer", bpo::value<int>(), "Size of the kernel receive buffer in loopback mode, [kB]")
+    ;
+
+  bpo::variables_map vm;
+  bpo::store (bpo::parse_command_line(argc,argv,desc), vm);
+
+  if (vm.count("help") || argc == 1) {
+    cout << "\n" << desc << endl;
+    return 0;
+  }
+  if (vm.count("infile"))       infile       = vm["infile"].as<std::string>();
+  if (vm.count("synthetic"))    synthetic    = vm["synthetic"].as<int>();
+  if (vm.count("stations"))     stations     = vm["stations"].as<int>();
+  if (vm.count("ip"))           ip           = vm["ip"].as<std::string>();
+  if (vm.count("port"))         port         = vm["port"].as<int>();
+  if (vm.count("rate"))         rate         = vm["rate"].as<double>();
+  if (vm.count("loops"))        loops        = vm["loops"].as<int>();
+  if (vm.count("batch"))        batch        = vm["batch"].as<int>();
+  if (vm.count("loopback"))     loopback     = true;
+  if (vm.count("socketBuffer")) socketBuffer = vm["socketBuffer"].as<int>();
+
+  if (infile.empty() == (synthetic <= 0)) {
+    cout << "[TBBreplay] Provide either an input file or the number of synthetic frames!" << endl;
+    cout << endl << desc << endl;
+    return 1;
+  }
+  if (loops < 1 || batch < 1 || rate < 0 || stations < 1 || stations > 255) {
+    cout << "[TBBreplay] Number of loops, stations, batch size and rate must be positive!" << endl;
+    return 1;
+  }
+
+  std::vector<char> frames;
+  if (synthetic > 0) {
+    makeFrames (synthetic, stations, frames);
+  } else if (!loadDump (infile, frames)) {
+    return 1;
+  }
+  unsigned long long expected = (frames.size()/TBB_FRAME_SIZE)*loops;
+
+  if (!loopback) {
+    return sendFrames (frames, ip, port, rate, loops, batch) ? 0 : 1;
+  }
+
+  /* Bind the port before forking, so that no frame is sent into the void */
+  DAL::TBB_UDPIngest ingest;
+  if (!ingest.open (port, socketBuffer*1024, true)) {
+    return 1;
+  }
+  cout << "[TBBreplay] Receive buffer: " << ingest.receiveBufferSize() << " bytes" << endl;
+
+  pid_t sender = fork();
+  if (sender < 0) {
+    cerr << "[TBBreplay] fork failed: " << strerror(errno) << endl;
+    return 1;
+  } else if (sender == 0) {
+    ingest.close();
+    _exit (sendFrames (frames, "127.0.0.1", port, rate, loops, batch) ? 0 : 1);
+  }
+
+  int status = -1;
+  receiveFrames (ingest, expected, sender, status);
+  if (status == -1) {
+    waitpid (sender, &status, 0);
+  }
+
+  return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
@@ -19,14 +19,18 @@
  ***************************************************************************/
 
 #include <iostream>
+#include <sstream>
+#include <cstring>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include <core/dalCommon.h>
 #include "Bf2h5Calculator.h"
 #include "bf2h5.h"
 
 using std::cout;
 using std::cerr;
 using std::endl;
-using std::real;
-using std::imag;
 using std::bad_alloc;
 
 namespace DAL { // Namespace DAL -- begin
@@ -41,38 +45,49 @@ namespace DAL { // Namespace DAL -- begin
     \param its_parent         -- Pointer to the parent object from which the 
     calculator is called.
     \param nofSubbands        -- The number of subbands.
-    \param nr_samples_subband -- 
+    \param nr_samples_subband -- The number of samples per subband in a block.
+    \param nofThreads         -- The number of calculation threads.
+    \param nofOutputBuffers   -- The number of sets of output buffers, i.e. the
+    number of blocks which can be calculated ahead of the writer.
   */
   Bf2h5Calculator::Bf2h5Calculator (BF2H5 *its_parent,
 				    uint8_t nofSubbands,
-				    uint32_t nr_samples_subband)
-    : level(0),
-      itsParent(its_parent),
+				    uint32_t nr_samples_subband,
+				    unsigned int nofThreads,
+				    unsigned int nofOutputBuffers)
+    : itsParent(its_parent),
+      itsKernels(its_parent->getStokesProducts(), its_parent->getDownSampleFactor()),
       nrOfSubbands(nofSubbands), 
       nrSamplesPerSubband(nr_samples_subband),
-      checking_completeness(false),
+      itsNofOutputBuffers(nofOutputBuffers>0 ? nofOutputBuffers : 1),
+      dataBlockOutput(0),
+      itsNofPending(0),
+      itsNofReady(0),
       itsStopProcessing(false),
-      currentBlockNr(0)
+      itsNofBlocksWritten(0),
+      itsNofBlocksCompleted(0),
+      itsStartTime(0)
   {
-    pthread_mutex_init(&calculationMapMutex, 0);
-    pthread_cond_init(&condition, 0);
+    pthread_mutex_init(&itsPoolMutex, 0);
+    pthread_cond_init(&itsPoolCondition, 0);
+    pthread_mutex_init(&itsBlockMutex, 0);
+    pthread_cond_init(&itsBlockCondition, 0);
     
     itsDownSampleFactor = itsParent->getDownSampleFactor();
     itsSingleSubbandNrOutputSamples = nr_samples_subband / itsDownSampleFactor;
     
-    for (unsigned short i = 0; i < NUM_CALCULATION_THREADS; ++i) {
-      thread_data_array[i].busy                = false;
-      //		thread_data_array[i].threadID = 0;
-      thread_data_array[i].blockNr             = 0;
-      thread_data_array[i].subbandNr           = 0;
-      thread_data_array[i].input_data          = 0;
-      thread_data_array[i].subband_output_data = 0;
-      thread_data_array[i].This                = this;
+    if (nofThreads == 0) {
+      nofThreads = 1;
     }
-    
-    subbandReady = new bool [nrOfSubbands];
-    for (uint8_t i=0; i < nrOfSubbands; ++i) {
-      subbandReady[i] = false;
+    for (unsigned int i = 0; i < nofThreads; ++i) {
+      thread_data *worker    = new thread_data;
+      worker->id             = i;
+      worker->busy           = false;
+      worker->nofSteals      = 0;
+      worker->nofSamples     = 0;
+      worker->This           = this;
+      pthread_mutex_init(&worker->mutex, 0);
+      itsWorkers.push_back(worker);
     }
     
     allocateMemory();
@@ -85,17 +100,20 @@ namespace DAL { // Namespace DAL -- begin
   // ==============================================================================
   
   Bf2h5Calculator::~Bf2h5Calculator() {
-    pthread_mutex_destroy(&calculationMapMutex);
-    pthread_cond_destroy(&condition);
-    //	cout << "destructor Bf2h5Calculator executing" << endl;
-    delete [] subbandReady;
-    //	cout << "deleted subbandReady array" << endl;
-    for (uint8_t i=0; i < nrOfSubbands; ++i) {
-      delete [] dataBlockOutput[i];
-      //			cout << "deleted dataBlockOutput[" << static_cast<int>(i) << "]" << endl;
+    pthread_mutex_destroy(&itsPoolMutex);
+    pthread_cond_destroy(&itsPoolCondition);
+    pthread_mutex_destroy(&itsBlockMutex);
+    pthread_cond_destroy(&itsBlockCondition);
+    for (unsigned int i=0; i < itsWorkers.size(); ++i) {
+      pthread_mutex_destroy(&itsWorkers[i]->mutex);
+      delete itsWorkers[i];
+    }
+    if (dataBlockOutput) {
+      for (unsigned int i=0; i < itsNofOutputBuffers * nrOfSubbands; ++i) {
+	delete [] dataBlockOutput[i];
+      }
+      delete [] dataBlockOutput;
     }
-    delete [] dataBlockOutput;
-    //	cout << "deleted dataBlockOutput array" << endl;
   }
   
   // ==============================================================================
@@ -104,17 +122,24 @@ namespace DAL { // Namespace DAL -- begin
   //
   // ==============================================================================
   
+  //_______________________________________________________________________________
+  //                                                                 allocateMemory
+  
+  /*!
+    The buffers are not initialized here: this is done by the worker which owns
+    the subband, so that the pages are placed on the memory node of that worker.
+  */
   void Bf2h5Calculator::allocateMemory(void) {
     // allocate memory for output data buffers
     try {
 #ifdef DAL_DEBUGGING_MESSAGES
-      std::cout << "Allocating " << nrOfSubbands * itsSingleSubbandNrOutputSamples * sizeof(float) << " bytes for downsampled data..." << std::endl;
+      std::cout << "Allocating " << itsNofOutputBuffers * nrOfSubbands * itsSingleSubbandNrOutputSamples * itsKernels.nofProducts() * sizeof(float) << " bytes for downsampled data..." << std::endl;
 #endif
       
-      dataBlockOutput = new float * [nrOfSubbands];
-      for (uint8_t i = 0; i < nrOfSubbands; ++i) {
-	dataBlockOutput[i] = new float [itsSingleSubbandNrOutputSamples];
-	memset(dataBlockOutput[i], 0, itsSingleSubbandNrOutputSamples * sizeof(float));
+      uint32_t nofOutputValues = itsSingleSubbandNrOutputSamples * itsKernels.nofProducts();
+      dataBlockOutput = new float * [itsNofOutputBuffers * nrOfSubbands];
+      for (unsigned int i = 0; i < itsNofOutputBuffers * nrOfSubbands; ++i) {
+	dataBlockOutput[i] = new float [nofOutputValues];
       }
     }
     catch (bad_alloc)
@@ -125,79 +150,98 @@ namespace DAL { // Namespace DAL -- begin
     return;
   }
   
-  /*
-    void Bf2h5Calculator::wakeUpCall(void) {
-    pthread_mutex_lock (&calculationMapMutex);
-    pthread_cond_broadcast(&condition);
-    pthread_mutex_unlock(&calculationMapMutex);
-    }
-  */
-  
   //_______________________________________________________________________________
   //                                                             calculateDataBlock
   
-  // CalculateDataBlock adds a datablock for writing
+  /*!
+    Distributes the subbands of the block over the queues of the workers. If
+    all sets of output buffers are in use, this waits until the writer has
+    finished the oldest block and all of its subbands have been calculated:
+    the writer may have filled a late subband with zeros, while a worker is
+    still writing it into the set.
+
+    Once the calculator has been stopped, the block is no longer queued.
+
+    \param blockNr    -- Number of the data block.
+    \param sampleData -- [nofSubbands,nr_samples_subband] Input samples of the
+    block.
+  */
   void Bf2h5Calculator::calculateDataBlock (long int blockNr,
 					    BFRawFormat::Sample *sampleData)
   {
-    std::pair<unsigned int, BFRawFormat::Sample *> dataPair;
-    pthread_mutex_lock (&calculationMapMutex);
-    for (uint8_t subband = 0; subband < nrOfSubbands; ++subband) {
-      dataPair.first = subband;
-      dataPair.second = &(sampleData[ subband * nrSamplesPerSubband]);
-      //	itsData.insert(std::pair<unsigned int, std::pair<unsigned int, BFRawFormat::Sample *> >(blockNr, dataPair));
-      itsData[blockNr].push_back(dataPair);
-    }
-    level += nrOfSubbands;
-    pthread_cond_broadcast(&condition);
-    pthread_mutex_unlock(&calculationMapMutex);
-    return;
-  }
-  
-  /*
-    bool Bf2h5Calculator::unscheduledDataLeft(void) {
-    pthread_mutex_lock (&calculationMapMutex);
-    for (calculationMap::const_iterator it = itsData.begin(); it != itsData.end(); ++it) {
-    if (!(it->second.empty())) {
-    pthread_mutex_unlock(&calculationMapMutex);
-    return true;
-    }
+    double now = wallTime();
+    
+    pthread_mutex_lock (&itsBlockMutex);
+    while (((blockNr - itsNofBlocksWritten >= long(itsNofOutputBuffers))
+	    || (!itsRemaining.empty()
+		&& (itsRemaining.begin()->first <= blockNr - long(itsNofOutputBuffers))))
+	   && (!itsStopProcessing)) {
+      pthread_cond_wait(&itsBlockCondition, &itsBlockMutex);
     }
-    pthread_mutex_unlock(&calculationMapMutex);
-    return false;
+    if (itsStopProcessing) {
+      // the workers are finishing, and the set of output buffers may be in use
+      pthread_mutex_unlock (&itsBlockMutex);
+      return;
     }
+    itsRemaining[blockNr]  = nrOfSubbands;
+    itsBlockStart[blockNr] = now;
+    pthread_mutex_unlock (&itsBlockMutex);
     
+    float **output = dataBlockOutput + (blockNr % itsNofOutputBuffers) * nrOfSubbands;
+    Task task;
+    task.blockNr    = blockNr;
+    task.submitTime = now;
     
-    bool Bf2h5Calculator::stillProcessing(void) {
-    if (unscheduledDataLeft()) {
-    return true;
-    }
-    // now also check if all threads are finished processing
-    for (unsigned short i = 0; i < NUM_CALCULATION_THREADS; ++i) { 
-    if (thread_data_array[i].busy == true) {
-    return true;
-    }
-    }
-    return false;
+    for (uint8_t subband = 0; subband < nrOfSubbands; ++subband) {
+      thread_data *worker      = itsWorkers[subband % itsWorkers.size()];
+      task.subbandNr           = subband;
+      task.input_data          = &(sampleData[ subband * nrSamplesPerSubband]);
+      task.subband_output_data = output[subband];
+      pthread_mutex_lock (&worker->mutex);
+      worker->queue.push_back(task);
+      pthread_mutex_unlock (&worker->mutex);
     }
+    
+    pthread_mutex_lock (&itsPoolMutex);
+    itsNofPending += nrOfSubbands;
+    pthread_cond_broadcast(&itsPoolCondition);
+    pthread_mutex_unlock (&itsPoolMutex);
+  }
+  
+  //_______________________________________________________________________________
+  //                                                                   blockWritten
+  
+  /*!
+    \param blockNr -- Number of the block of which all subbands have been
+    written; its set of output buffers may be reused.
   */
+  void Bf2h5Calculator::blockWritten (long int blockNr)
+  {
+    pthread_mutex_lock (&itsBlockMutex);
+    if (blockNr >= itsNofBlocksWritten) {
+      itsNofBlocksWritten = blockNr + 1;
+    }
+    pthread_cond_broadcast(&itsBlockCondition);
+    pthread_mutex_unlock (&itsBlockMutex);
+  }
   
   //_______________________________________________________________________________
   //                                                                stillProcessing
   
   bool Bf2h5Calculator::stillProcessing(void)
   {
-    /* This should actually be done while mutex is locked, but because the answer
-       may lag a bit with reality it's no problem, and speeds up the processing at
-       the end (when the reader is already done, see bf2h5.cpp) 
-    */
-    return ((level > 0));
+    pthread_mutex_lock (&itsBlockMutex);
+    bool busy = !itsRemaining.empty();
+    pthread_mutex_unlock (&itsBlockMutex);
+    return busy;
   }
   
   //_______________________________________________________________________________
   //                                                                           stop
   
   /*!
+    Tasks still queued are calculated before the threads finish.
+
     \return status -- Status of the operation; returns \e false in case an error
     was encountered while trying to stop the processing.
   */
@@ -209,14 +253,18 @@ namespace DAL { // Namespace DAL -- begin
 #ifdef DAL_DEBUGGING_MESSAGES
     cout << "Stopping the calculator" << endl;
 #endif 
-    pthread_mutex_lock (&calculationMapMutex);
+    // the flag is read under either mutex, hence it is set holding both
+    pthread_mutex_lock (&itsBlockMutex);
+    pthread_mutex_lock (&itsPoolMutex);
     itsStopProcessing = true;
-    level = 10;
-    pthread_cond_broadcast(&condition);
-    pthread_mutex_unlock (&calculationMapMutex);
-    //	cout << "trying to join calculator threads" << endl;
-    for (unsigned short threadIdx = 0; threadIdx < NUM_CALCULATION_THREADS; ++threadIdx) {
-      status = pthread_join (itsCalculationThread[threadIdx], &thread_result);
+    pthread_cond_broadcast(&itsPoolCondition);
+    pthread_mutex_unlock (&itsPoolMutex);
+    // release a reader waiting for free output buffers
+    pthread_cond_broadcast(&itsBlockCondition);
+    pthread_mutex_unlock (&itsBlockMutex);
+    
+    for (unsigned int threadIdx = 0; threadIdx < itsWorkers.size(); ++threadIdx) {
+      status = pthread_join (itsWorkers[threadIdx]->thread, &thread_result);
       if (status != 0) {
 	std::cerr << "[Bf2h5Calculator::stop]" << " Calculator thread "
 		  << threadIdx << " returned " << status
@@ -224,7 +272,6 @@ namespace DAL { // Namespace DAL -- begin
 	bResult = false;
       }
       if (thread_result != NULL) {
-	//			cout << "calculator thread " << threadIdx << " non NULL result value" << endl;
 	bResult = false;
       }
     }
@@ -236,194 +283,283 @@ namespace DAL { // Namespace DAL -- begin
   
   std::string Bf2h5Calculator::whatAreYouDoing(void)
   {
-    //	pthread_mutex_lock (&calculationMapMutex);
-    for (calculationMap::const_iterator it = itsData.begin(); it != itsData.end(); ++it) {
-      if (!(it->second.empty())) {
-	char buf[10];
-	std::string ss("Calculator says: I am still processing block ");
-	sprintf(buf, "%ld, ", it->first);
-	ss += buf;
-	ss += " and subband(s) ";
-	
-	for (std::deque<std::pair<uint8_t, BFRawFormat::Sample *> >::const_iterator cit = it->second.begin();
-	     cit != it->second.end(); ++cit) {
-	  sprintf(buf, "%u, ", cit->first);
-	  ss += buf;
-	}
-	pthread_mutex_unlock(&calculationMapMutex);
-	return ss;
+    std::ostringstream ss;
+    
+    pthread_mutex_lock (&itsBlockMutex);
+    if (!itsRemaining.empty()) {
+      ss << "Calculator says: I am still processing block(s) ";
+      for (std::map<long int, unsigned int>::const_iterator it = itsRemaining.begin();
+	   it != itsRemaining.end(); ++it) {
+	ss << it->first << " (" << it->second << " subbands left), ";
       }
     }
-    //	pthread_mutex_unlock(&calculationMapMutex);
+    pthread_mutex_unlock (&itsBlockMutex);
     
-    for (unsigned short i = 0; i < NUM_CALCULATION_THREADS; ++i) {
-      if (thread_data_array[i].busy == true) {
-	char buf[10];
-	std::string ss("Calculator says: my thread ");
-	sprintf(buf, "%d", i);
-	ss += buf;
-	ss += " is still processing block ";
-	sprintf(buf, "%ld", thread_data_array[i].blockNr);
-	ss += buf;
-	ss += " and subband ";
-	sprintf(buf, "%u", thread_data_array[i].subbandNr);
-	ss += buf;
-	return ss;
+    for (unsigned int i = 0; i < itsWorkers.size(); ++i) {
+      pthread_mutex_lock (&itsWorkers[i]->mutex);
+      if (itsWorkers[i]->busy == true) {
+	ss << "my thread " << i << " is processing block " << itsWorkers[i]->current.blockNr
+	   << " and subband " << static_cast<int>(itsWorkers[i]->current.subbandNr) << ", ";
       }
+      pthread_mutex_unlock (&itsWorkers[i]->mutex);
     }
-    return std::string("Calculator says: I don't know what I am doing, but I'm surely busy with something...");
+    
+    if (ss.str().empty()) {
+      return std::string("Calculator says: I don't know what I am doing, but I'm surely busy with something...");
+    }
+    return ss.str();
   }
   
   //_______________________________________________________________________________
   //                                                                startProcessing
   
+  /*!
+    Returns once all workers have initialized their output buffers.
+  */
   void Bf2h5Calculator::startProcessing(void)
   {
-  // start the calculation threads
-  for (unsigned short threadIdx = 0; threadIdx < NUM_CALCULATION_THREADS; ++threadIdx) {
-    if (pthread_create(&itsCalculationThread[threadIdx], NULL, startInternalThread, (void *) &thread_data_array[threadIdx]) != 0) {
-      cerr << "Bf2h5Calculator::startProcessing, ERROR, could not start calculation thread " << static_cast<int>(threadIdx) << endl;
+    unsigned int nofStarted (0);
+    
+    itsStartTime = wallTime();
+    
+    // start the calculation threads
+    for (unsigned int threadIdx = 0; threadIdx < itsWorkers.size(); ++threadIdx) {
+      if (pthread_create(&itsWorkers[threadIdx]->thread, NULL, startInternalThread, (void *) itsWorkers[threadIdx]) != 0) {
+	cerr << "Bf2h5Calculator::startProcessing, ERROR, could not start calculation thread " << threadIdx << endl;
+      }
+      else {
+	++nofStarted;
+      }
     }
+    
+    pthread_mutex_lock (&itsPoolMutex);
+    while (itsNofReady < nofStarted) {
+      pthread_cond_wait(&itsPoolCondition, &itsPoolMutex);
+    }
+    pthread_mutex_unlock (&itsPoolMutex);
   }
-}
-
-//_______________________________________________________________________________
-//                                                      doDownSampleSingleSubband
-
-void * Bf2h5Calculator::doDownSampleSingleSubband (void *threaddata)
-{
-  thread_data *tdata(0);
   
-  while(!itsStopProcessing) {
-    
-    pthread_mutex_lock(&calculationMapMutex);
-    while ((level < 1) && (!itsStopProcessing))
-      pthread_cond_wait(&condition, &calculationMapMutex);
+  //_______________________________________________________________________________
+  //                                                      doDownSampleSingleSubband
+  
+  void * Bf2h5Calculator::doDownSampleSingleSubband (thread_data *worker)
+  {
+    unsigned int nofWorkers  = itsWorkers.size();
+    uint32_t nofOutputValues = itsSingleSubbandNrOutputSamples * itsKernels.nofProducts();
+    uint32_t nofInputSamples = itsSingleSubbandNrOutputSamples * itsDownSampleFactor;
+    Task task;
     
-    if ((level > 0) && (!itsStopProcessing)) {
-      // grab one subband of the data
-      tdata = reinterpret_cast<thread_data *>(threaddata);
-      calculationMap::iterator firstBlock = itsData.find(currentBlockNr);
-      if (firstBlock != itsData.end()) {
-	std::deque<std::pair<uint8_t, BFRawFormat::Sample *> > &blockDeque = firstBlock->second;
-	tdata->busy = true;
-	tdata->blockNr = firstBlock->first;
-	tdata->subbandNr = blockDeque.front().first;
-	tdata->input_data = blockDeque.front().second;
-	tdata->subband_output_data = dataBlockOutput[tdata->subbandNr];
-	blockDeque.pop_front();
-	if (blockDeque.empty()) {
-	  itsData.erase(itsData.begin());
-	}
-	--level;
-	pthread_mutex_unlock(&calculationMapMutex);
-	
-	// do the actual processing of the data (mutex is unlocked)
-	uint32_t xx_intensity(0), yy_intensity(0);
-	uint64_t start(0);
-	
-	for ( uint32_t count = 0; count < itsSingleSubbandNrOutputSamples; ++count ) // count loops over all output samples
-	  {
-	    tdata->subband_output_data[count] = 0;
-	    for ( uint64_t idx = start; idx < (start + itsDownSampleFactor); ++idx ) // loop over nr of samples defined by downsampling factor
-	      {
-		xx_intensity = (uint32_t)(real(tdata->input_data[ idx ].xx) * real(tdata->input_data[ idx ].xx) +
-					  imag(tdata->input_data[ idx ].xx) * imag(tdata->input_data[ idx ].xx) ); // this will be max 33 bits integer
-		yy_intensity = (uint32_t)(real(tdata->input_data[ idx ].yy) * real(tdata->input_data[ idx ].yy) +
-					  imag(tdata->input_data[ idx ].yy) * imag(tdata->input_data[ idx ].yy) );
-		tdata->subband_output_data[count] += (float)xx_intensity + (float)yy_intensity;
-		//TODO: check if this intensity data needs to be divided by itsDownSampleFactor to get averaged value
-	      }
-	    start += itsDownSampleFactor;
+#ifdef __linux__
+    /* Bind the worker to a processor of its own, if there are enough of them:
+       worker n gets the n-th processor the process is allowed to run on. */
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) == 0
+	&& CPU_COUNT(&allowed) >= int(nofWorkers)) {
+      unsigned int n = 0;
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+	if (CPU_ISSET(cpu, &allowed) && (n++ == worker->id)) {
+	  cpu_set_t cpuset;
+	  CPU_ZERO(&cpuset);
+	  CPU_SET(cpu, &cpuset);
+	  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+	    cerr << "[Bf2h5Calculator::doDownSampleSingleSubband]"
+		 << " Failed to bind thread " << worker->id
+		 << " to processor " << cpu << endl;
 	  }
-	
-	//  keep track of finished subbands
-	itsParent->calculatorDataReady(tdata->blockNr, tdata->subbandNr, tdata->subband_output_data); // signal itsParent app to write the data
-	subbandReady[tdata->subbandNr] = true;
-	checkIfBlockComplete(); // TODO: do this somewhere else?
-	tdata->busy = false;
+	  break;
+	}
       }
-      else { // didn't find data for current block
-        pthread_mutex_unlock(&calculationMapMutex);
-        return 0;
+    }
+#endif
+    
+    // first touch of the output buffers of the subbands in the own queue
+    for (unsigned int slot = 0; slot < itsNofOutputBuffers; ++slot) {
+      for (unsigned int sb = worker->id; sb < nrOfSubbands; sb += nofWorkers) {
+	memset(dataBlockOutput[slot * nrOfSubbands + sb], 0, nofOutputValues * sizeof(float));
       }
     }
-    else {
-      pthread_mutex_unlock(&calculationMapMutex);
-      return 0;
+    pthread_mutex_lock (&itsPoolMutex);
+    ++itsNofReady;
+    pthread_cond_broadcast(&itsPoolCondition);
+    pthread_mutex_unlock (&itsPoolMutex);
+    
+    while (getTask(worker, task)) {
+      // do the actual processing of the data (no mutex is locked)
+      double start = wallTime();
+      itsKernels.process(task.input_data,
+			 nofInputSamples,
+			 task.subband_output_data);
+      double end = wallTime();
+      
+      pthread_mutex_lock (&worker->mutex);
+      worker->busy        = false;
+      worker->nofSamples += nofInputSamples;
+      worker->computeLatency.add(end - start);
+      pthread_mutex_unlock (&worker->mutex);
+      
+      // signal itsParent app to write the data
+      itsParent->calculatorDataReady(task.blockNr, task.subbandNr, task.subband_output_data);
+      subbandDone(task);
     }
+    
+    return 0;
   }
-  return 0;
-}
-
-//_______________________________________________________________________________
-//                                                           checkIfBlockComplete
+  
+  //_______________________________________________________________________________
+  //                                                                        getTask
+  
+  /*!
+    \param worker -- The worker asking for a task.
+    \retval task  -- The task to process.
 
-void Bf2h5Calculator::checkIfBlockComplete (void) {
-  while (1) {
-    if (!checking_completeness) { // added for thread safety (it could be that a thread becomes ready when just checking completeness for another thread, then we have to wait for the first check to complete before doing the next check
-      checking_completeness = true;
-      for (uint8_t i=0; i < nrOfSubbands; ++i) {
-	if (subbandReady[i] == false) {
-	  checking_completeness = false;
-	  return; // we are not ready with the current block
+    \return status -- Returns \e false if the calculator was stopped and no
+    tasks are left.
+  */
+  bool Bf2h5Calculator::getTask (thread_data *worker,
+				 Task &task)
+  {
+    unsigned int nofWorkers = itsWorkers.size();
+    
+    while (1) {
+      bool found  = false;
+      bool stolen = false;
+      
+      // own queue first, oldest task first
+      pthread_mutex_lock (&worker->mutex);
+      if (!worker->queue.empty()) {
+	task = worker->queue.front();
+	worker->queue.pop_front();
+	found = true;
+      }
+      pthread_mutex_unlock (&worker->mutex);
+      
+      // steal from the back of the queues of the other workers
+      for (unsigned int k = 1; (k < nofWorkers) && (!found); ++k) {
+	thread_data *victim = itsWorkers[(worker->id + k) % nofWorkers];
+	pthread_mutex_lock (&victim->mutex);
+	if (!victim->queue.empty()) {
+	  task = victim->queue.back();
+	  victim->queue.pop_back();
+	  found  = true;
+	  stolen = true;
 	}
+	pthread_mutex_unlock (&victim->mutex);
       }
       
-      // apparently all subbands for this block are done
-      for (uint8_t i=0; i < nrOfSubbands; ++i) { // set subbandReady array to all false for next data block
-	subbandReady[i] = false;
+      if (found) {
+	pthread_mutex_lock (&itsPoolMutex);
+	--itsNofPending;
+	pthread_mutex_unlock (&itsPoolMutex);
+	
+	pthread_mutex_lock (&worker->mutex);
+	worker->busy    = true;
+	worker->current = task;
+	if (stolen) {
+	  ++worker->nofSteals;
+	}
+	worker->queueLatency.add(wallTime() - task.submitTime);
+	pthread_mutex_unlock (&worker->mutex);
+	return true;
+      }
+      
+      // nothing to do: wait for new tasks
+      pthread_mutex_lock (&itsPoolMutex);
+      while ((itsNofPending == 0) && (!itsStopProcessing)) {
+	pthread_cond_wait(&itsPoolCondition, &itsPoolMutex);
+      }
+      bool finished = itsStopProcessing && (itsNofPending == 0);
+      pthread_mutex_unlock (&itsPoolMutex);
+      
+      if (finished) {
+	return false;
       }
-      //lastReadyBlock = currentBlockNr++;
-      itsParent->blockComplete(++currentBlockNr); // signal parent
-      checking_completeness = false;
-      return;
     }
-    usleep(100);
-  }
-}
-
-//_______________________________________________________________________________
-//                                                                     showStatus
-
-void Bf2h5Calculator::showStatus(void)
-{
-  if (!itsStopProcessing) {
-    cout << "Calculator busy with block: " << currentBlockNr << endl;
   }
-  else {
-    cout << "Calculator has stopped, status of its threads and data follow below" << endl;
-  }
-  for (unsigned short threadIdx = 0; threadIdx < NUM_CALCULATION_THREADS; ++threadIdx) {
-    cout << "thread[" << threadIdx << "]";
-    if (thread_data_array[threadIdx].busy == true) {
-      cout << " is busy with: block=" << thread_data_array[threadIdx].blockNr << ", subband=" << thread_data_array[threadIdx].subbandNr << ", input data 1st sample xx=" << thread_data_array[threadIdx].input_data->xx << ", yy=" << thread_data_array[threadIdx].input_data->yy << endl;
+  
+  //_______________________________________________________________________________
+  //                                                                    subbandDone
+  
+  /*!
+    \param task -- The task which has been processed; once all subbands of its
+    block are done, the parent is notified that the input buffer can be reused,
+    and a reader waiting for the set of output buffers is woken up.
+  */
+  void Bf2h5Calculator::subbandDone (Task const &task)
+  {
+    bool complete (false);
+    
+    pthread_mutex_lock (&itsBlockMutex);
+    std::map<long int, unsigned int>::iterator it = itsRemaining.find(task.blockNr);
+    if (it != itsRemaining.end() && --(it->second) == 0) {
+      itsRemaining.erase(it);
+      itsBlockLatency.add(wallTime() - itsBlockStart[task.blockNr]);
+      itsBlockStart.erase(task.blockNr);
+      ++itsNofBlocksCompleted;
+      complete = true;
+      pthread_cond_broadcast(&itsBlockCondition);
     }
-    else {
-      cout << "is idle." << endl;
+    pthread_mutex_unlock (&itsBlockMutex);
+    
+    if (complete) {
+      itsParent->blockComplete(task.blockNr); // signal parent
     }
   }
-  cout << "writemap contains: " << endl;
-  pthread_mutex_lock (&calculationMapMutex);
-  for (calculationMap::const_iterator it = itsData.begin(); it != itsData.end(); ++it) {
-    cout << "block " << it->first;
-    if (it->second.empty()) {
-      cout << " has no subbands left" << endl;
+  
+  //_______________________________________________________________________________
+  //                                                                     showStatus
+  
+  void Bf2h5Calculator::showStatus(void)
+  {
+    double elapsed (wallTime() - itsStartTime);
+    unsigned long nofSamples (0);
+    
+    cout << "[Bf2h5Calculator] Status of the calculator." << endl;
+    cout << "-- nof. threads ........... : " << itsWorkers.size() << endl;
+    cout << "-- nof. output buffers .... : " << itsNofOutputBuffers << endl;
+    
+    pthread_mutex_lock (&itsBlockMutex);
+    cout << "-- Processing stopped ..... : " << itsStopProcessing << endl;
+    cout << "-- Blocks completed ....... : " << itsNofBlocksCompleted << endl;
+    cout << "-- Blocks written ......... : " << itsNofBlocksWritten << endl;
+    cout << "-- Block latency [s] ...... : mean " << itsBlockLatency.mean()
+	 << " , max " << itsBlockLatency.maximum << endl;
+    for (std::map<long int, unsigned int>::const_iterator it = itsRemaining.begin();
+	 it != itsRemaining.end(); ++it) {
+      cout << "-- Block " << it->first << " in progress, "
+	   << it->second << " subbands left" << endl;
     }
-    else {
-      cout << ", subbands: ";
-      for (std::deque<std::pair<uint8_t, BFRawFormat::Sample *> >::const_iterator cit = it->second.begin(); cit != it->second.end(); ++cit) {
-	cout << static_cast<int>(cit->first) << ",";
+    pthread_mutex_unlock (&itsBlockMutex);
+    
+    for (unsigned int i = 0; i < itsWorkers.size(); ++i) {
+      thread_data *worker = itsWorkers[i];
+      pthread_mutex_lock (&worker->mutex);
+      cout << "-- thread[" << i << "] ";
+      if (worker->busy) {
+	cout << "busy with block " << worker->current.blockNr
+	     << ", subband " << static_cast<int>(worker->current.subbandNr);
+      }
+      else {
+	cout << "idle";
       }
+      cout << ", queued " << worker->queue.size()
+	   << ", tasks " << worker->computeLatency.count
+	   << ", steals " << worker->nofSteals << endl;
+      cout << "   queue latency [s] ..... : mean " << worker->queueLatency.mean()
+	   << " , max " << worker->queueLatency.maximum << endl;
+      cout << "   compute latency [s] ... : mean " << worker->computeLatency.mean()
+	   << " , max " << worker->computeLatency.maximum << endl;
+      if (worker->computeLatency.total > 0) {
+	cout << "   throughput [samples/s]  : "
+	     << worker->nofSamples / worker->computeLatency.total << endl;
+      }
+      nofSamples += worker->nofSamples;
+      pthread_mutex_unlock (&worker->mutex);
     }
-  }
-  pthread_mutex_unlock(&calculationMapMutex);
-  cout << "subband(s) that still need processing for the current block: " << endl;
-  for (uint8_t i=0; i < nrOfSubbands; ++i) {
-    if (subbandReady[i] == false) {
-      cout << static_cast<int>(i) << ",";
+    
+    if (elapsed > 0) {
+      cout << "-- Throughput [samples/s] . : " << nofSamples / elapsed << endl;
     }
   }
-}
   
 } // Namespace DAL -- end
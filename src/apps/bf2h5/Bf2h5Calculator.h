@@ -28,15 +28,12 @@
 #include <map>
 #include <deque>
 #include <string>
+#include <vector>
 
 #include <data_hl/BFRawFormat.h>
+#include <data_hl/BFRawKernels.h>
 
 class BF2H5;
-//                 block                               subband       pointer to data
-typedef std::map<long int, std::deque<std::pair<uint8_t, BFRawFormat::Sample *> > > calculationMap;
-
-#define NUM_CALCULATION_THREADS 4
-#define NUM_OUTPUT_BUFFERS 2
 
 namespace DAL { // Namespace DAL -- begin
   
@@ -47,6 +44,27 @@ namespace DAL { // Namespace DAL -- begin
     \ingroup dal_apps
     
     \author Alwin de Jong
+
+    <h3>Synopsis</h3>
+
+    The subbands of every data block handed over by calculateDataBlock() are
+    down-sampled by a pool of worker threads. Each worker owns a queue; the
+    subbands of a block are distributed over the queues, subband \e sb going to
+    worker <tt>sb % nofThreads</tt>. A worker takes its tasks from the front of
+    its own queue and, once that is empty, steals from the back of the queues
+    of the other workers, so that no worker idles while work is left and
+    several blocks may be in progress at the same time.
+
+    The results are written into one of nofOutputBuffers() sets of output
+    buffers; calculateDataBlock() blocks until the writer has finished the
+    block which previously used the set. Each worker initializes the output
+    buffers of the subbands in its own queue, so that with first-touch page
+    placement these buffers reside on the memory node of the worker; on Linux
+    the workers are bound to separate processors, provided there are enough.
+
+    showStatus() reports per worker the number of tasks and steals, the
+    throughput and the latencies of the queueing and computation stages, as
+    well as the latency of complete blocks.
   */
   class Bf2h5Calculator
   {
@@ -57,13 +75,27 @@ namespace DAL { // Namespace DAL -- begin
     //! Argumented constructor
     Bf2h5Calculator (BF2H5 *parent,
 		     uint8_t nofSubbands,
-		     uint32_t nr_samples_subband);
+		     uint32_t nr_samples_subband,
+		     unsigned int nofThreads=4,
+		     unsigned int nofOutputBuffers=2);
     
     // === Destruction ==========================================================
     
     //! Default destructor
     ~Bf2h5Calculator();
     
+    // === Parameter access =====================================================
+
+    //! Get the number of calculation threads
+    inline unsigned int nofThreads (void) const {
+      return itsWorkers.size();
+    }
+
+    //! Get the number of sets of output buffers, i.e. blocks in progress
+    inline unsigned int nofOutputBuffers (void) const {
+      return itsNofOutputBuffers;
+    }
+
     // === Methods ==============================================================
     
     //! Allocate memory
@@ -73,8 +105,8 @@ namespace DAL { // Namespace DAL -- begin
     void calculateDataBlock (long int blockNr,
 			     BFRawFormat::Sample *sampleData);
     
-    //! Signal that the subband has been written
-    void subbandWritten(/*unsigned int blockNr,*/ uint8_t subband);
+    //! Signal that all subbands of a block have been written
+    void blockWritten (long int blockNr);
     
     //! Enable the processing of datablock
     void startProcessing(void);
@@ -92,59 +124,125 @@ namespace DAL { // Namespace DAL -- begin
     void showStatus(void);
     
   private:
-    //		bool unscheduledDataLeft(void); // checks if there are still data blocks that need to be scheduled for processing
-    
-    //! Check if a complete block of subbands has been calculated
-    void checkIfBlockComplete (void);
-    
-    //! Each calculation thread uses one of these structs
-    struct thread_data
+
+    //! Down-sampling of a single subband of a block
+    struct Task
     {
-      //! Is this thread currently being used?
-      bool busy;
-      //! Number of the block being processed
+      //! Number of the block
       long int blockNr;
-      //! Number of the subband being processed by this thread
+      //! Number of the subband
       uint8_t subbandNr;
-      //! Pointer to the input data block
+      //! Pointer to the input data of the subband
       BFRawFormat::Sample *input_data;
-      float * subband_output_data; // pointer into output buffer where the calculated ata for this subband needs to be written
+      //! Pointer to the output buffer of the subband
+      float *subband_output_data;
+      //! Time at which the task was submitted [s]
+      double submitTime;
+    };
+
+    //! Number, total and maximum of the latencies of a processing stage
+    struct StageCounter
+    {
+      unsigned long count;
+      double total;
+      double maximum;
+      StageCounter () : count(0), total(0), maximum(0) {}
+      void add (double const &latency) {
+	++count;
+	total += latency;
+	if (latency > maximum) maximum = latency;
+      }
+      double mean () const {
+	return count>0 ? total/count : 0;
+      }
+    };
+
+    //! Each calculation thread uses one of these structs
+    struct thread_data
+    {
+      //! Number of the worker
+      unsigned int id;
+      //! The calculation thread
+      pthread_t thread;
+      //! Protects the queue and the counters
+      pthread_mutex_t mutex;
+      //! Tasks assigned to this worker
+      std::deque<Task> queue;
+      //! Is this thread currently processing a task?
+      bool busy;
+      //! The task being processed
+      Task current;
+      //! Number of tasks taken from the queues of other workers
+      unsigned long nofSteals;
+      //! Number of input samples processed
+      unsigned long nofSamples;
+      //! Time between submission and start of the tasks
+      StageCounter queueLatency;
+      //! Time spent on the computation of the tasks
+      StageCounter computeLatency;
       Bf2h5Calculator * This;
-    } thread_data_array[NUM_CALCULATION_THREADS];
+    };
     
     static void * startInternalThread(void * tData)
     {
-      reinterpret_cast<thread_data *>(tData)->This->doDownSampleSingleSubband(tData);
+      thread_data *worker = reinterpret_cast<thread_data *>(tData);
+      worker->This->doDownSampleSingleSubband(worker);
       return NULL;
     }
     
-    void * doDownSampleSingleSubband(void *); // the actual thread that does the downsample calculation for a single subband
+    //! The actual thread that does the downsample calculation for a single subband
+    void * doDownSampleSingleSubband(thread_data *worker);
+
+    //! Get the next task, from the own queue or from another worker
+    bool getTask (thread_data *worker,
+		  Task &task);
+
+    //! Book-keeping once a subband has been calculated
+    void subbandDone (Task const &task);
     
   private:
     
-    unsigned level;
     //! Parent application BF2H5    
     BF2H5 * itsParent;
     unsigned short itsDownSampleFactor;
+    //! Kernels computing the down-sampled Stokes parameters of a subband
+    BFRawKernels itsKernels;
     uint8_t nrOfSubbands;
     uint32_t nrSamplesPerSubband;
-    //! Points to array of flags marking subbands that have been written
-    bool * subbandReady;
-    bool checking_completeness;
-    // the parallel threads for calculation
-    pthread_t itsCalculationThread[NUM_CALCULATION_THREADS]; // the calculation threads
-    // the tread_data_array contain input, settings and output data for that tread
-    bool itsStopProcessing;
-    //! Number of the currently processed block
-    long int currentBlockNr;
-    //! The size in float units of a single subband output data block
+    //! The number of output samples of a single subband output data block
     uint32_t itsSingleSubbandNrOutputSamples;
-    float ** dataBlockOutput; // the pointers to the output buffers for output data. Pointer to pointer to single subband output buffer
-    
-    // itsDatamap is protected by the calculationMapMutex and the pthread condition
-    calculationMap itsData; // first = blockNr; second.first = subbandNr; second.second = pointer to start sample of one subband datablock
-    pthread_mutex_t calculationMapMutex;
-    pthread_cond_t  condition;
+    //! Number of sets of output buffers
+    unsigned int itsNofOutputBuffers;
+    //! [itsNofOutputBuffers*nrOfSubbands] Output buffers, one per block slot and subband
+    float ** dataBlockOutput;
+    //! The workers of the pool
+    std::vector<thread_data *> itsWorkers;
+    
+    // The pool mutex and condition let idle workers wait for new tasks
+    pthread_mutex_t itsPoolMutex;
+    pthread_cond_t  itsPoolCondition;
+    //! Number of tasks queued but not yet taken by a worker
+    unsigned long itsNofPending;
+    //! Number of workers which have initialized their output buffers
+    unsigned int itsNofReady;
+    //! Set by stop(); written holding both mutexes, read holding either
+    bool itsStopProcessing;
+
+    // The block mutex and condition protect the book-keeping of the blocks
+    pthread_mutex_t itsBlockMutex;
+    pthread_cond_t  itsBlockCondition;
+    //! Blocks in progress: number of subbands left to calculate
+    std::map<long int, unsigned int> itsRemaining;
+    //! Blocks in progress: time of submission
+    std::map<long int, double> itsBlockStart;
+    //! Number of blocks written by the writer, i.e. number of free slots
+    long int itsNofBlocksWritten;
+    //! Number of blocks completely calculated
+    long int itsNofBlocksCompleted;
+    //! Time between submission and completion of the blocks
+    StageCounter itsBlockLatency;
+    //! Time at which the processing was started [s]
+    double itsStartTime;
   };
   
 } // Namespace DAL -- end
@@ -18,8 +18,11 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <cerrno>
+
 #include "bf2h5.h"
 #include "HDF5Writer.h"
+#include <core/dalCommon.h>
 #include <data_hl/BFRawFormat.h>
 
 using namespace DAL;
@@ -41,10 +44,22 @@ HDF5Writer::HDF5Writer (BF2H5 *parent,
   : itsParent(parent),
     rawfile(0), 
     table(0),
+    dataset(0),
     stopWriting(false),
     itsOutputFile(output_file), 
-    waitForDataTimeOut(0),
+    itsDeadline(1.0),
+    itsNofQueued(0),
+    itsMaxQueued(0),
+    itsNofReceived(0),
+    itsQueueDepthTotal(0),
+    itsNofBlocksWritten(0),
+    itsBlockLatencyTotal(0),
+    itsBlockLatencyMax(0),
+    itsNofZeroFilled(0),
+    itsNofLate(0),
     foundDataForCurrentBlock(false),
+    itsBeamGroup(0),
+    itsBlockBuffer(0),
     outputBlockSize(output_block_size),
     creation_mode("TCP"),
     nrOfBlocks(0),
@@ -58,9 +73,15 @@ HDF5Writer::HDF5Writer (BF2H5 *parent,
   }
   
   pthread_mutex_init(&writeMapMutex, NULL);
+  pthread_cond_init(&itsDataCondition, NULL);
   
-  zeroBlock = new float [outputBlockSize];
-  memset(zeroBlock, 0, outputBlockSize * sizeof(float));
+  zeroBlock = new float [outputBlockSize * itsParent->getNrStokesProducts()];
+  memset(zeroBlock, 0, outputBlockSize * itsParent->getNrStokesProducts() * sizeof(float));
+  itsDatasetOutput = itsParent->doDatasetOutput();
+  if (itsDatasetOutput) {
+    itsBlockData.assign(nrOfSubbands, static_cast<float *>(0));
+    itsBlockBuffer = new float [outputBlockSize * nrOfSubbands];
+  }
   // create output file
   createHDF5File(ps);
 }
@@ -75,12 +96,27 @@ HDF5Writer::HDF5Writer (BF2H5 *parent,
 HDF5Writer::~HDF5Writer()
 {
   pthread_mutex_destroy(&writeMapMutex);
+  pthread_cond_destroy(&itsDataCondition);
   delete [] zeroBlock;
   delete [] subbandReady;
-  for (uint8_t i = 0; i < nrOfSubbands; ++i) {
-    delete table[i];
+  delete [] itsBlockBuffer;
+  if (table) {
+    for (uint8_t i = 0; i < nrOfSubbands; ++i) {
+      delete table[i];
+    }
+    delete table;
+  }
+  // record the number of samples actually written
+  hsize_t nofSamples = hsize_t(currentBlockNr) * outputBlockSize;
+  for (unsigned int n=0; n < itsBlockPlans.size(); ++n) {
+    delete itsBlockPlans[n];
   }
-  delete table;
+  for (unsigned int n=0; n < itsStokesDatasets.size(); ++n) {
+    DAL::HDF5Attribute::write (itsStokesDatasets[n]->objectID(), "NOF_SAMPLES", nofSamples);
+    delete itsStokesDatasets[n];
+  }
+  delete itsBeamGroup;
+  delete dataset;
 }
 
 // ==============================================================================
@@ -96,7 +132,7 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   std::stringstream sstr; // used for type conversion
   std::string strValue;
 
-  dataset = dalDataset( itsOutputFile.c_str(), "HDF5" );
+  dataset = new dalDataset( itsOutputFile.c_str(), "HDF5" );
 
   const BFRawFormat::BFRaw_Header & header = itsParent->getMainHeader();
 
@@ -122,7 +158,7 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   uint downsample_factor = itsParent->getDownSampleFactor();
   
   // write headers using above
-  dataset.setAttribute( "ANTENNA_SET", ps->antennaSet() );
+  dataset->setAttribute( "ANTENNA_SET", ps->antennaSet() );
   /*
   // station clock frequency
   if (header.nrSamplesPerSubband == 155648) strValue = "160MHz";
@@ -136,12 +172,12 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   sstr.clear();
   sstr << clock_speed;
   strValue = sstr.str();
-  dataset.setAttribute( "CLOCK_FREQUENCY", strValue);
-  dataset.setAttribute( "CLOCK_FREQUENCY_UNIT", string("Hz") );
-  dataset.setAttribute( "CREATION_MODE", creation_mode );
-  dataset.setAttribute( "DOWNSAMPLE_RATE", &downsample_factor );
-  dataset.setAttribute( "FILENAME", itsOutputFile );
-  dataset.setAttribute( "FILETYPE", string("bfstation") );
+  dataset->setAttribute( "CLOCK_FREQUENCY", strValue);
+  dataset->setAttribute( "CLOCK_FREQUENCY_UNIT", string("Hz") );
+  dataset->setAttribute( "CREATION_MODE", creation_mode );
+  dataset->setAttribute( "DOWNSAMPLE_RATE", &downsample_factor );
+  dataset->setAttribute( "FILENAME", itsOutputFile );
+  dataset->setAttribute( "FILETYPE", string("bfstation") );
   // get current time = file creation time
   time_t rawtime;
   struct tm * timeinfo;
@@ -149,11 +185,11 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   time ( &rawtime );
   timeinfo = localtime ( &rawtime );
   strftime (timestr,80,"%Y-%m-%dT%X",timeinfo );
-  dataset.setAttribute( "FILEDATE",  string(timestr) );
+  dataset->setAttribute( "FILEDATE",  string(timestr) );
   
-  dataset.setAttribute( "FILTER_SELECTION", ps->bandFilter() );
-  dataset.setAttribute( "GROUPTYPE", string("Root") );
-  dataset.setAttribute( "INPUT_FILESIZE", &file_byte_size );
+  dataset->setAttribute( "FILTER_SELECTION", ps->bandFilter() );
+  dataset->setAttribute( "GROUPTYPE", string("Root") );
+  dataset->setAttribute( "INPUT_FILESIZE", &file_byte_size );
   
   // number of stations
   unsigned int nrOfStations = ps->nrStations();
@@ -161,15 +197,15 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   sstr.clear();
   sstr << nrOfStations;
   strValue = sstr.str();
-  dataset.setAttribute( "NOF_STATIONS", strValue            );
-  dataset.setAttribute( "NOTES",        string("UNDEFINED") );
+  dataset->setAttribute( "NOF_STATIONS", strValue            );
+  dataset->setAttribute( "NOTES",        string("UNDEFINED") );
   
   // observationID
   sstr.str("");
   sstr.clear();
   sstr << ps->observationID();
   strValue = sstr.str();
-  dataset.setAttribute( "OBSERVATION_ID", strValue );
+  dataset->setAttribute( "OBSERVATION_ID", strValue );
   
   // observation start time
   time_t obsStartTime = ps->startTime() / 86400 + 40587; // convert from unix time to MJD
@@ -177,12 +213,12 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   sstr.clear();
   sstr << obsStartTime;
   strValue = sstr.str();
-  dataset.setAttribute( "OBSERVATION_START_MJD", strValue );
+  dataset->setAttribute( "OBSERVATION_START_MJD", strValue );
   time ( &obsStartTime );
   tm * ptm = gmtime ( &obsStartTime );
   strftime (timestr,80,"%Y-%m-%dT%X",ptm);
-  dataset.setAttribute( "OBSERVATION_START_UTC", string(timestr) );
-  dataset.setAttribute( "OBSERVATION_START_TAI", string("") );
+  dataset->setAttribute( "OBSERVATION_START_UTC", string(timestr) );
+  dataset->setAttribute( "OBSERVATION_START_TAI", string("") );
   
   // observation start time
   time_t obsStopTime = ps->stopTime()  / 86400 + 40587; // convert from unix time to MJD
@@ -190,21 +226,21 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   sstr.clear();
   sstr << obsStopTime;
   strValue = sstr.str();
-  dataset.setAttribute( "OBSERVATION_END_MJD",strValue );
+  dataset->setAttribute( "OBSERVATION_END_MJD",strValue );
   time ( &obsStopTime );
   ptm = gmtime ( &obsStopTime );
   strftime (timestr,80,"%Y-%m-%dT%X", ptm);
-  dataset.setAttribute( "OBSERVATION_END_UTC", string(timestr) );
-  dataset.setAttribute( "OBSERVATION_END_TAI", string("") );
-  dataset.setAttribute( "OBSERVER", ps->observerName() );
-  dataset.setAttribute( "PIPELINE_NAME", string("") );
-  dataset.setAttribute( "PIPELINE_VERSION", string("") );
-  dataset.setAttribute( "PROJECT_ID", string("") );
-  dataset.setAttribute( "PROJECT_TITLE", ps->projectName() );
-  dataset.setAttribute( "PROJECT_PI", string("") );
-  dataset.setAttribute( "PROJECT_CO_I", string("") );
-  dataset.setAttribute( "PROJECT_CONTACT", ps->contactName() );
-  dataset.setAttribute( "PROJECT_DESCRIPTION", string("") );
+  dataset->setAttribute( "OBSERVATION_END_UTC", string(timestr) );
+  dataset->setAttribute( "OBSERVATION_END_TAI", string("") );
+  dataset->setAttribute( "OBSERVER", ps->observerName() );
+  dataset->setAttribute( "PIPELINE_NAME", string("") );
+  dataset->setAttribute( "PIPELINE_VERSION", string("") );
+  dataset->setAttribute( "PROJECT_ID", string("") );
+  dataset->setAttribute( "PROJECT_TITLE", ps->projectName() );
+  dataset->setAttribute( "PROJECT_PI", string("") );
+  dataset->setAttribute( "PROJECT_CO_I", string("") );
+  dataset->setAttribute( "PROJECT_CONTACT", ps->contactName() );
+  dataset->setAttribute( "PROJECT_DESCRIPTION", string("") );
   // station list
   if (nrOfStations > 0) {
     std::string stations;
@@ -213,31 +249,36 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
       stations += ps->stationName(station_idx) + ",";
     }
     stations += ps->stationName(station_idx);
-    dataset.setAttribute( "STATIONS_LIST", stations );
+    dataset->setAttribute( "STATIONS_LIST", stations );
   }
   else {
-    dataset.setAttribute( "STATIONS_LIST",  string("no stations defined") );
+    dataset->setAttribute( "STATIONS_LIST",  string("no stations defined") );
   }
-  dataset.setAttribute( "SYSTEM_VERSION",  string("") );
-  dataset.setAttribute( "TARGET", string("") );
-  dataset.setAttribute( "TELESCOPE", string("LOFAR") );
+  dataset->setAttribute( "SYSTEM_VERSION",  string("") );
+  dataset->setAttribute( "TARGET", string("") );
+  dataset->setAttribute( "TELESCOPE", string("LOFAR") );
   /*
-    dataset.setAttribute( "NUMBER_OF_STATIONS", &n_stations );
-    dataset.setAttribute( "STATION_LIST", string(header.station) );
-    //		dataset.setAttribute_string( "SOURCE", srcvec ); // replaced by TARGET
-    dataset.setAttribute( "MAIN_BEAM_DIAM", &main_beam_diam );
-    dataset.setAttribute( "BANDWIDTH", &bandwidth );
-    dataset.setAttribute( "BREAKS_IN_DATA", &breaks_in_data );
-    dataset.setAttribute( "DISPERSION_MEASURE", &dispersion_measure );
-    // 	dataset.setAttribute( "SECONDS_OF_DATA", &nrOfBlocks );
-    dataset.setAttribute( "SAMPLE_RATE", &header.sampleRate );
-    dataset.setAttribute( "NOF_SAMPLES_PER_SUBBAND", &header.nrSamplesPerSubband );
-    dataset.setAttribute( "TOTAL_NUMBER_OF_SAMPLES", &total_number_of_samples );
-    dataset.setAttribute( "NUMBER_OF_BEAMS", &number_of_beams );
-    dataset.setAttribute( "SUB_BEAM_DIAMETER", &sub_beam_diameter );
-    dataset.setAttribute( "WEATHER_TEMPERATURE", &weather_temperature );
-    dataset.setAttribute( "WEATHER_HUMIDITY", &weather_humidity );
+    dataset->setAttribute( "NUMBER_OF_STATIONS", &n_stations );
+    dataset->setAttribute( "STATION_LIST", string(header.station) );
+    //		dataset->setAttribute_string( "SOURCE", srcvec ); // replaced by TARGET
+    dataset->setAttribute( "MAIN_BEAM_DIAM", &main_beam_diam );
+    dataset->setAttribute( "BANDWIDTH", &bandwidth );
+    dataset->setAttribute( "BREAKS_IN_DATA", &breaks_in_data );
+    dataset->setAttribute( "DISPERSION_MEASURE", &dispersion_measure );
+    // 	dataset->setAttribute( "SECONDS_OF_DATA", &nrOfBlocks );
+    dataset->setAttribute( "SAMPLE_RATE", &header.sampleRate );
+    dataset->setAttribute( "NOF_SAMPLES_PER_SUBBAND", &header.nrSamplesPerSubband );
+    dataset->setAttribute( "TOTAL_NUMBER_OF_SAMPLES", &total_number_of_samples );
+    dataset->setAttribute( "NUMBER_OF_BEAMS", &number_of_beams );
+    dataset->setAttribute( "SUB_BEAM_DIAMETER", &sub_beam_diameter );
+    dataset->setAttribute( "WEATHER_TEMPERATURE", &weather_temperature );
+    dataset->setAttribute( "WEATHER_HUMIDITY", &weather_humidity );
   */
+  if (itsDatasetOutput) {
+    createStokesDatasets();
+    return;
+  }
+  
   dalGroup * beamGroup;
   
   char * beamstr = new char[10];
@@ -246,7 +287,7 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   
   beam_number = 0;
   sprintf( beamstr, "beam%03d", beam_number );
-  beamGroup = dataset.createGroup( beamstr );
+  beamGroup = dataset->createGroup( beamstr );
   
   float ra_val  = header.beamDirections[beam_number+1][0];
   float dec_val = header.beamDirections[beam_number+1][1];
@@ -280,12 +321,21 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   for (unsigned int idx=0; idx<header.nrSubbands; idx++)
     {
       sprintf( sbName, "SB%03d", idx );
-      table[idx] = dataset.createTable( sbName, beamstr );
+      table[idx] = dataset->createTable( sbName, beamstr );
     }
   
   for (unsigned int idx=0; idx<header.nrSubbands; idx++)
     {
-      if ( itsParent->doDownSampling() || itsParent->doIntensity() )
+      if ( itsParent->getStokesProducts() != DAL::BFRawKernels::StokesI )
+	{
+	  // one column per Stokes parameter, in the order of the calculator output
+	  std::string stokes = DAL::BFRawKernels::productNames( itsParent->getStokesProducts() );
+	  for (unsigned int n=0; n<stokes.size(); ++n)
+	    {
+	      table[idx]->addColumn( "STOKES_" + stokes.substr(n,1), dal_FLOAT );
+	    }
+	}
+      else if ( itsParent->doDownSampling() || itsParent->doIntensity() )
 	{
 	  table[idx]->addColumn( "TOTAL_INTENSITY_SQUARED", dal_FLOAT );
 	}
@@ -304,6 +354,68 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   beamstr = 0;
 }
 
+//_______________________________________________________________________________
+//                                                           createStokesDatasets
+
+/*!
+  Creates the group of the first beam, holding one dataset per Stokes
+  parameter, <tt>STOKES_0</tt> to <tt>STOKES_3</tt> in the order I, Q, U, V.
+  Each dataset stores one column per subband; it starts with a single row and
+  is extended by every block written.
+*/
+void HDF5Writer::createStokesDatasets (void)
+{
+  const BFRawFormat::BFRaw_Header & header = itsParent->getMainHeader();
+  const DAL::Stokes::Component components[] = { DAL::Stokes::I,
+						DAL::Stokes::Q,
+						DAL::Stokes::U,
+						DAL::Stokes::V };
+  int beam_number = 0;
+
+  itsBeamGroup = new DAL::BF_BeamGroup (dataset->getId(), beam_number, true);
+  
+  hid_t location = itsBeamGroup->locationID();
+  unsigned int nofSubbands = nrOfSubbands;
+  float ra_val   = header.beamDirections[beam_number+1][0];
+  float dec_val  = header.beamDirections[beam_number+1][1];
+  std::vector<int> center_frequency (header.nrSubbands);
+  for (unsigned int idx=0; idx < header.nrSubbands; idx++) {
+    center_frequency[idx] = (int)header.subbandFrequencies[ idx ];
+  }
+  DAL::HDF5Attribute::write (location, "RA",               ra_val           );
+  DAL::HDF5Attribute::write (location, "DEC",              dec_val          );
+  DAL::HDF5Attribute::write (location, "NOF_SUBBANDS",     nofSubbands      );
+  DAL::HDF5Attribute::write (location, "CENTER_FREQUENCY", center_frequency );
+  
+  unsigned int products = itsParent->getStokesProducts();
+  for (unsigned int n=0; n < 4; ++n) {
+    if (products & (1 << n)) {
+      itsStokesDatasets.push_back (new DAL::BF_StokesDataset (location,
+							      itsStokesDatasets.size(),
+							      0,
+							      nrOfSubbands,
+							      1,
+							      components[n],
+							      H5T_NATIVE_FLOAT));
+    }
+  }
+  
+  /* Every block is written to the same shape of selection */
+  std::vector<hsize_t> block (2);
+  block[0] = outputBlockSize;
+  block[1] = nrOfSubbands;
+  for (unsigned int n=0; n < itsStokesDatasets.size(); ++n) {
+    itsBlockPlans.push_back (new DAL::HDF5AccessPlan (itsStokesDatasets[n]->objectID(),
+						      block));
+  }
+  
+#ifdef DAL_DEBUGGING_MESSAGES
+  std::cerr << "CREATED New beam group: " << DAL::BF_BeamGroup::getName(beam_number) << std::endl;
+  std::cerr << "   " << itsStokesDatasets.size() << " Stokes datasets of "
+	    << header.nrSubbands << " subbands" << std::endl;
+#endif
+}
+
 #endif
 
 //_______________________________________________________________________________
@@ -316,8 +428,8 @@ bool HDF5Writer::start(void)
   cout << "setting attribute EPOCH_UTC to " << itsParent->getEpochUTC() << endl;
   cout << "setting attribute EPOCH_DATE to " << itsParent->getEpochDate() << endl;	
 #endif
-  dataset.setAttribute( "EPOCH_UTC", itsParent->getEpochUTC() );
-  dataset.setAttribute( "EPOCH_DATE", itsParent->getEpochDate() );
+  dataset->setAttribute( "EPOCH_UTC", itsParent->getEpochUTC() );
+  dataset->setAttribute( "EPOCH_DATE", itsParent->getEpochDate() );
   
   if (pthread_create(&itsWriteThread, NULL, StartInternalThread, (void *) this) == 0) {
     return true;
@@ -343,7 +455,10 @@ bool HDF5Writer::stop (void)
   cout << "Stopping the writer" << endl;
 #endif 
 
+  pthread_mutex_lock (&writeMapMutex);
   stopWriting = true;
+  pthread_cond_signal (&itsDataCondition);
+  pthread_mutex_unlock (&writeMapMutex);
   status      = pthread_join (itsWriteThread, &thread_result);
 
   if (status != 0 || thread_result != NULL) {
@@ -353,6 +468,21 @@ bool HDF5Writer::stop (void)
   return bResult;
 }
 
+//_______________________________________________________________________________
+//                                                                    setDeadline
+
+/*!
+  \param seconds -- Time [s] after the arrival of the first subband of a block
+         within which its other subbands must arrive; subbands arriving later
+         are written as zeros.
+*/
+void HDF5Writer::setDeadline (double const &seconds)
+{
+  pthread_mutex_lock (&writeMapMutex);
+  itsDeadline = seconds > 0 ? seconds : 0;
+  pthread_mutex_unlock (&writeMapMutex);
+}
+
 //_______________________________________________________________________________
 //                                                                   writeSubband
 
@@ -363,7 +493,25 @@ void HDF5Writer::writeSubband (long int blockNr,
 {
   std::pair<unsigned int, float *> dataPair(subband, calculator_data);
   pthread_mutex_lock (&writeMapMutex);
-  itsData[blockNr].push_back(dataPair);
+  if (blockNr < currentBlockNr) {
+    // the block has already been finished, with zeros for this subband
+    ++itsNofLate;
+  }
+  else {
+    itsData[blockNr].push_back(dataPair);
+    if (itsBlockArrival.find(blockNr) == itsBlockArrival.end()) {
+      itsBlockArrival[blockNr] = wallTime();
+    }
+    ++itsNofQueued;
+    ++itsNofReceived;
+    itsQueueDepthTotal += itsNofQueued;
+    if (itsNofQueued > itsMaxQueued) {
+      itsMaxQueued = itsNofQueued;
+    }
+    if (blockNr == currentBlockNr) {
+      pthread_cond_signal (&itsDataCondition);
+    }
+  }
   pthread_mutex_unlock(&writeMapMutex);
 }
 
@@ -389,30 +537,12 @@ bool HDF5Writer::dataLeft (void)
   return false;
 }
 
-//_______________________________________________________________________________
-//                                                         getDataForCurrentBlock
-
-bool HDF5Writer::getDataForCurrentBlock (void)
-{
-  pthread_mutex_lock(&writeMapMutex);
-  writeMap::iterator it = itsData.find(currentBlockNr);
-  if (it != itsData.end()) {
-    if (!(it->second.empty())) {
-      dataPair = it->second.front();
-      
-      foundDataForCurrentBlock = true;
-      it->second.pop_front();
-      pthread_mutex_unlock(&writeMapMutex);
-      return true;
-    }
-  }
-  pthread_mutex_unlock(&writeMapMutex);
-  return false; // no data found for current block
-}
-
 //_______________________________________________________________________________
 //                                                           checkIfBlockComplete
 
+/*!
+  Must be called with writeMapMutex locked.
+*/
 void HDF5Writer::checkIfBlockComplete (void)
 {
   for (uint8_t i=0; i < nrOfSubbands; ++i) {
@@ -427,55 +557,173 @@ void HDF5Writer::checkIfBlockComplete (void)
 //_______________________________________________________________________________
 //                                                                 startNextBlock
 
+/*!
+  Must be called with writeMapMutex locked; if 2-D datasets are written, the
+  lock is released while writing the block.
+*/
 void HDF5Writer::startNextBlock (void)
 {
+  if (itsDatasetOutput) {
+    writeBlock();
+  }
   cout << "block " << currentBlockNr << " is done." << endl;
   for (uint8_t i=0; i < nrOfSubbands; ++i) {
     subbandReady[i] = false;
   }
-  pthread_mutex_lock(&writeMapMutex);
-  itsData.erase(itsData.find(currentBlockNr++));
-  pthread_mutex_unlock(&writeMapMutex);
-  waitForDataTimeOut = 0;
+  writeMap::iterator it = itsData.find(currentBlockNr);
+  if (it != itsData.end()) {
+    itsNofQueued -= it->second.size();
+    itsData.erase(it);
+  }
+  std::map<long int, double>::iterator arrival = itsBlockArrival.find(currentBlockNr);
+  if (arrival != itsBlockArrival.end()) {
+    double latency = wallTime() - arrival->second;
+    itsBlockLatencyTotal += latency;
+    if (latency > itsBlockLatencyMax) {
+      itsBlockLatencyMax = latency;
+    }
+    itsBlockArrival.erase(arrival);
+  }
+  ++itsNofBlocksWritten;
   foundDataForCurrentBlock = false;
+  itsParent->blockWritten(currentBlockNr++); // the calculator may reuse the output buffers
   return;
 }
 
+//_______________________________________________________________________________
+//                                                            fillMissingSubbands
+
+/*!
+  Must be called with writeMapMutex locked; the lock is released while writing.
+*/
+void HDF5Writer::fillMissingSubbands (void)
+{
+  std::vector<uint8_t> missing;
+  
+  for (uint8_t sb=0; sb < nrOfSubbands; ++sb) {
+    if (subbandReady[sb] == false) {
+      missing.push_back(sb);
+    }
+  }
+  itsNofZeroFilled += missing.size();
+  
+  pthread_mutex_unlock(&writeMapMutex);
+  cout << "HDF5Writer: block " << currentBlockNr << ", skipping subbands: ";
+  for (unsigned int n=0; n < missing.size(); ++n) {
+    if (!itsDatasetOutput) {
+      // for the 2-D datasets the zeros are written along with the block
+      table[missing[n]]->appendRows( zeroBlock, outputBlockSize );
+    }
+    cout << static_cast<int>(missing[n]) << ", ";
+  }
+  cout << endl;
+  pthread_mutex_lock(&writeMapMutex);
+}
+
+//_______________________________________________________________________________
+//                                                                     writeBlock
+
+/*!
+  Must be called with writeMapMutex locked; the lock is released while writing.
+
+  The subbands of the current block are transposed into rows of
+  <tt>nrOfSubbands</tt> values, tile by tile so that the rows being filled stay
+  in cache; missing subbands are written as zeros. Each Stokes dataset then
+  receives the block in a single hyperslab write; the offset of the block is
+  kept in 64 bits, as it exceeds the range of an <tt>int</tt> for long
+  observations.
+*/
+void HDF5Writer::writeBlock (void)
+{
+  const size_t tile        = 64;
+  unsigned int nofProducts = itsStokesDatasets.size();
+  hsize_t start            = hsize_t(currentBlockNr) * outputBlockSize;
+  
+  pthread_mutex_unlock(&writeMapMutex);
+  for (unsigned int p=0; p < nofProducts; ++p) {
+    for (size_t t0=0; t0 < outputBlockSize; t0 += tile) {
+      size_t t1 = t0+tile < outputBlockSize ? t0+tile : outputBlockSize;
+      for (uint8_t sb=0; sb < nrOfSubbands; ++sb) {
+	const float *src = itsBlockData[sb] ? itsBlockData[sb] : zeroBlock;
+	for (size_t t=t0; t < t1; ++t) {
+	  itsBlockBuffer[t*nrOfSubbands+sb] = src[t*nofProducts+p];
+	}
+      }
+    }
+    if (!itsBlockPlans[p]->setOffset (start, true)
+	|| !itsBlockPlans[p]->write (itsBlockBuffer, H5T_NATIVE_FLOAT)) {
+      std::cerr << "[HDF5Writer::writeBlock] Failed to write block "
+		<< currentBlockNr << " to " << itsStokesDatasets[p]->name()
+		<< std::endl;
+    }
+  }
+  itsBlockData.assign(nrOfSubbands, static_cast<float *>(0));
+  pthread_mutex_lock(&writeMapMutex);
+}
+
 //_______________________________________________________________________________
 //                                                                      writeData
 
 /*!
-  This function runs in a separate thread
+  This function runs in a separate thread. It sleeps until subbands of the
+  current block arrive, writes all of them which are ready in one pass, and
+  writes zeros for the missing subbands once the deadline of the block has
+  passed.
 */
 void HDF5Writer::writeData (void)
 {
+  std::vector<std::pair<uint8_t, float *> > ready;
+  
+  pthread_mutex_lock(&writeMapMutex);
+  
   while (!stopWriting) {
-    if (getDataForCurrentBlock()) {
-      table[dataPair.first]->appendRows( dataPair.second, outputBlockSize );
-      subbandReady[dataPair.first] = true;
-      /*#ifdef DAL_DEBUGGING_MESSAGES
-	cout << "HDF5Writer:Wrote subband " << static_cast<int>(dataPair.first) << " for data block " << currentBlockNr << endl;
-	#endif*/
+    writeMap::iterator it = itsData.find(currentBlockNr);
+    
+    if (it != itsData.end() && !(it->second.empty())) {
+      /* Take all subbands of the current block that are ready */
+      ready.assign(it->second.begin(), it->second.end());
+      it->second.clear();
+      foundDataForCurrentBlock = true;
+      
+      pthread_mutex_unlock(&writeMapMutex);
+      for (unsigned int n=0; n < ready.size(); ++n) {
+	if (itsDatasetOutput) {
+	  // kept until the block is written; the calculator waits for blockWritten()
+	  itsBlockData[ready[n].first] = ready[n].second;
+	}
+	else {
+	  table[ready[n].first]->appendRows( ready[n].second, outputBlockSize );
+	}
+      }
+      pthread_mutex_lock(&writeMapMutex);
+      
+      itsNofQueued -= ready.size();
+      for (unsigned int n=0; n < ready.size(); ++n) {
+	subbandReady[ready[n].first] = true;
+      }
       checkIfBlockComplete();
-      waitForDataTimeOut = 0;
-      usleep(50);
     }
-    else { // no data to write, check if subbands received within time limit and go to sleep for a little while
-      if (foundDataForCurrentBlock) { // we don't want to skip a block which the calculator hasn't yet started
-	if (++waitForDataTimeOut > 25) {
-	  cout << "HDF5Writer: block " << currentBlockNr << ", skipping subbands: ";
-	  for (uint8_t sb=0; sb < nrOfSubbands; ++sb) {
-	    if (subbandReady[sb] == false) {
-	      table[sb]->appendRows( zeroBlock, outputBlockSize );
-	      cout << static_cast<int>(sb) << ", ";
-	    }
-	  }
+    else if (foundDataForCurrentBlock) {
+      /* Wait for the remaining subbands, at most until the deadline */
+      double deadline = itsBlockArrival[currentBlockNr] + itsDeadline;
+      struct timespec abstime;
+      abstime.tv_sec  = time_t(deadline);
+      abstime.tv_nsec = long((deadline - abstime.tv_sec) * 1e9);
+      if (pthread_cond_timedwait(&itsDataCondition, &writeMapMutex, &abstime) == ETIMEDOUT) {
+	it = itsData.find(currentBlockNr);
+	if (it == itsData.end() || it->second.empty()) {
+	  fillMissingSubbands();
 	  startNextBlock();
 	}
       }
-      usleep(10000); // wait when the data of the new block hasn't arrived yet
+    }
+    else {
+      /* Wait for the first subband of the block */
+      pthread_cond_wait(&itsDataCondition, &writeMapMutex);
     }
   }
+  
+  pthread_mutex_unlock(&writeMapMutex);
 }
 
 //_______________________________________________________________________________
@@ -505,6 +753,24 @@ void HDF5Writer::openRawFile (const char* filename)
 
 void HDF5Writer::showStatus (void)
 {
+  pthread_mutex_lock (&writeMapMutex);
+  cout << "[HDF5Writer] Status of the writer." << endl;
+  cout << "-- Deadline per block [s] . : " << itsDeadline << endl;
+  cout << "-- Blocks written ......... : " << itsNofBlocksWritten << endl;
+  if (itsNofBlocksWritten > 0) {
+    cout << "-- Block latency [s] ...... : mean " << itsBlockLatencyTotal / itsNofBlocksWritten
+	 << " , max " << itsBlockLatencyMax << endl;
+  }
+  cout << "-- Queued subbands ........ : " << itsNofQueued
+       << " , max " << itsMaxQueued;
+  if (itsNofReceived > 0) {
+    cout << " , mean " << itsQueueDepthTotal / itsNofReceived;
+  }
+  cout << endl;
+  cout << "-- Zero-filled subbands ... : " << itsNofZeroFilled << endl;
+  cout << "-- Dropped late subbands .. : " << itsNofLate << endl;
+  pthread_mutex_unlock(&writeMapMutex);
+  
   cout << "Writer busy with block: " << currentBlockNr << endl;
   if (foundDataForCurrentBlock) {
     cout << "writer did find data for this block" << endl;
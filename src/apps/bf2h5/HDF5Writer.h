@@ -34,6 +34,8 @@
 #include <dal_config.h>
 #include <core/dalCommon.h>
 #include <core/dalDataset.h>
+#include <core/HDF5AccessPlan.h>
+#include <data_hl/BF_BeamGroup.h>
 
 // LOFAR header files
 #ifdef DAL_WITH_LOFAR
@@ -61,6 +63,28 @@ class BF2H5;
     <li>DAL::Bf2h5Calculator
     <li>LOFAR::RTCP::Parset
   </ul>
+
+  <h3>Synopsis</h3>
+
+  The blocks are written in order by a separate thread, which sleeps on a
+  condition variable signalled by writeSubband(). Once woken up, all subbands
+  of the current block which are ready are written in one pass. Subbands of a
+  block which have not arrived within deadline() seconds after its first
+  subband are written as zeros, after which the writer moves on to the next
+  block; subbands arriving for a block which has been finished are dropped.
+
+  showStatus() reports the depth of the queue of subbands waiting to be
+  written, the latency between the arrival of the first subband of a block and
+  the completion of the block, and the number of zero-filled and dropped
+  subbands.
+
+  By default every subband is written to a table of its own. If
+  BF2H5::doDatasetOutput() is set instead, a single 2-D dataset of shape
+  <tt>[time,subband]</tt> is created within a DAL::BF_BeamGroup for each Stokes
+  parameter. The subbands of a block are then collected until the block is
+  complete, or until its deadline has passed. Each dataset then receives the
+  whole block in a single hyperslab write, with the rows of the block stored
+  contiguously.
   
 */
 class HDF5Writer {
@@ -88,6 +112,12 @@ public:
   void createHDF5File (const LOFAR::RTCP::Parset *ps);
 #endif
 
+  //! Get the time [s] within which all subbands of a block must arrive
+  inline double deadline (void) const {
+    return itsDeadline;
+  }
+  //! Set the time [s] within which all subbands of a block must arrive
+  void setDeadline (double const &seconds);
   //! Start the separate writing thread
   bool start(void);
   //! Add a datablock for writing
@@ -101,11 +131,16 @@ public:
   
  private:
 
-  //! Get the data for the currently processed block
-  bool getDataForCurrentBlock(void);
   //! Check if the currently processed block is complete
   void checkIfBlockComplete(void);
+  //! Finish the current block and move on to the next one
   void startNextBlock(void);
+  //! Write zeros for the subbands of the current block that did not arrive
+  void fillMissingSubbands(void);
+  //! Create the beam group and one 2-D dataset per Stokes parameter
+  void createStokesDatasets(void);
+  //! Write the current block to the 2-D datasets
+  void writeBlock(void);
   //! Thread to perform the writing of the data
   void writeData(void);
   //! Start new internal thread
@@ -120,15 +155,47 @@ public:
   BF2H5 * itsParent;
   std::fstream * rawfile;
   DAL::dalTable ** table;
-  DAL::dalDataset dataset;
+  DAL::dalDataset * dataset;
   bool stopWriting;
   std::string itsOutputFile;
-  uint8_t waitForDataTimeOut;
-  std::pair<uint8_t, float *> dataPair;
   writeMap itsData; // contains the block number, subbands and pointers to datablocks that still need to be written
   pthread_mutex_t writeMapMutex;
+  //! Signalled when data arrive or when the writer is stopped
+  pthread_cond_t itsDataCondition;
+  //! Time [s] within which all subbands of a block must arrive
+  double itsDeadline;
+  //! Time of arrival of the first subband of the blocks not yet written
+  std::map<long int, double> itsBlockArrival;
+  //! Number of subbands waiting to be written
+  unsigned long itsNofQueued;
+  //! Maximum number of subbands waiting to be written
+  unsigned long itsMaxQueued;
+  //! Number of subbands received
+  unsigned long itsNofReceived;
+  //! Sum of the queue depths seen by the received subbands
+  double itsQueueDepthTotal;
+  //! Number of blocks written
+  long int itsNofBlocksWritten;
+  //! Sum and maximum of the latencies of the blocks written [s]
+  double itsBlockLatencyTotal, itsBlockLatencyMax;
+  //! Number of subbands written as zeros
+  unsigned long itsNofZeroFilled;
+  //! Number of subbands dropped because their block had been finished
+  unsigned long itsNofLate;
   bool foundDataForCurrentBlock;
   float * zeroBlock;
+  //! Write a single 2-D dataset per Stokes parameter instead of a table per subband?
+  bool itsDatasetOutput;
+  //! Beam group holding the 2-D datasets
+  DAL::BF_BeamGroup * itsBeamGroup;
+  //! The 2-D datasets, one per Stokes parameter
+  std::vector<DAL::BF_StokesDataset *> itsStokesDatasets;
+  //! Selections of a block in the 2-D datasets, one per Stokes parameter
+  std::vector<DAL::HDF5AccessPlan *> itsBlockPlans;
+  //! [nrOfSubbands] Data of the subbands of the current block; NULL if missing
+  std::vector<float *> itsBlockData;
+  //! [outputBlockSize*nrOfSubbands] Block of a single Stokes parameter, time-major
+  float * itsBlockBuffer;
   //! Size of a data block (excluded its header)
   size_t outputBlockSize;
   std::string creation_mode;
@@ -18,9 +18,13 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <cerrno>
 #include <iostream> // for cout,cerr etc.
-#include <fstream> // for file mode
+#include <new>
+#include <fcntl.h> // for file mode
 #include <signal.h> // for time-out on socket
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "bf2h5.h"
 #include "StationBeamReader.h"
@@ -45,14 +49,25 @@ namespace DAL { // Namespace DAL -- begin
   
   StationBeamReader::StationBeamReader (BF2H5 *parent,
 					bool socket_mode)
-    : socklen(sizeof(incoming_addr)),
-      rawfile(0),
+    : finished_reading(false),
+      socklen(sizeof(incoming_addr)),
+      rawfile(-1),
+      itsFileOffset(0),
+      itsReadAhead(2),
+      itsThreadStarted(false),
+      itsStopReading(false),
+      itsNofBlocksRead(0),
+      itsNofStalls(0),
+      itsNofFull(0),
       itsParent(parent),
       socketmode(socket_mode), 
       memAllocOK(true),
+      dataBlockSize(0),
       blockHeaderSize(sizeof(BFRawFormat::BlockHeader))
   {
     bigendian = BigEndian();
+    pthread_mutex_init(&itsReadMutex, NULL);
+    pthread_cond_init(&itsReadCondition, NULL);
   }
   
   // ============================================================================
@@ -63,16 +78,32 @@ namespace DAL { // Namespace DAL -- begin
   
   StationBeamReader::~StationBeamReader()
   {
+    // stop the read thread; shutting down the socket ends a pending receive
+    if (itsThreadStarted) {
+      pthread_mutex_lock(&itsReadMutex);
+      itsStopReading = true;
+      pthread_cond_broadcast(&itsReadCondition);
+      pthread_mutex_unlock(&itsReadMutex);
+      if (socketmode) {
+	shutdown(server_socket, SHUT_RDWR);
+      }
+      pthread_join(itsReadThread, NULL);
+    }
     // close sockets and input file if open
     if (server_socket)
       close(server_socket);
-    if (rawfile) {
-      if (rawfile->is_open()) {
-	rawfile->close();
-      }
-      delete rawfile;
-      rawfile = NULL;
+    if (rawfile >= 0) {
+      close(rawfile);
+      rawfile = -1;
     }
+    for (unsigned int n=0; n < itsFreeBuffers.size(); ++n) {
+      delete [] itsFreeBuffers[n];
+    }
+    for (unsigned int n=0; n < itsFilledBlocks.size(); ++n) {
+      delete [] itsFilledBlocks[n].data;
+    }
+    pthread_mutex_destroy(&itsReadMutex);
+    pthread_cond_destroy(&itsReadCondition);
   }
   
   // ============================================================================
@@ -103,16 +134,25 @@ namespace DAL { // Namespace DAL -- begin
 
   bool StationBeamReader::openRawFile (std::string &filename)
   {
-    rawfile = new std::fstream( filename.data(), ios::binary|ios::in );
+    struct stat file_status;
+
+    rawfile       = open( filename.c_str(), O_RDONLY );
+    itsFileOffset = 0;
+
+    if (rawfile < 0 || fstat(rawfile, &file_status) != 0) {
+      std::cerr << "[StationBeamReader::openRawFile] Unable to open file "
+		<< filename << std::endl;
+      return false;
+    }
 
-    /* Move to end of file to determine its file size. */
-    rawfile->seekg(0, ios::end);
     /* See how many bytes in file */
-    file_byte_size = static_cast<size_t>(rawfile->tellg())-2;
-    /* Move to start of file */
-    rawfile->seekg(0, ios::beg);
+    file_byte_size = static_cast<size_t>(file_status.st_size)-2;
+    /* The file is read front to back */
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(rawfile, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 
-    return rawfile->is_open();
+    return true;
   }
   
   //_____________________________________________________________________________
@@ -130,10 +170,43 @@ namespace DAL { // Namespace DAL -- begin
       close(server_socket);
     }
     else {
-      if (rawfile->is_open())
-	rawfile->close();
+      if (rawfile >= 0) {
+	close(rawfile);
+	rawfile = -1;
+      }
     }
+    pthread_mutex_lock(&itsReadMutex);
     finished_reading = true;
+    pthread_cond_broadcast(&itsReadCondition);
+    pthread_mutex_unlock(&itsReadMutex);
+  }
+
+  //_____________________________________________________________________________
+  //                                                              finishedReading
+
+  /*!
+    \return finished -- Returns \e true once the end of the input has been
+            reached and all blocks read have been handed out.
+  */
+  bool StationBeamReader::finishedReading (void)
+  {
+    pthread_mutex_lock(&itsReadMutex);
+    bool finished = finished_reading && itsFilledBlocks.empty();
+    pthread_mutex_unlock(&itsReadMutex);
+
+    return finished;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 setReadAhead
+
+  /*!
+    \param nofBlocks -- Number of data blocks read ahead, i.e. the number of
+           buffers allocated by the reader; at least one.
+  */
+  void StationBeamReader::setReadAhead (unsigned int const &nofBlocks)
+  {
+    itsReadAhead = nofBlocks > 0 ? nofBlocks : 1;
   }
   
   //_____________________________________________________________________________
@@ -213,18 +286,18 @@ namespace DAL { // Namespace DAL -- begin
       }
     }
     else { // file mode
-      if ( !rawfile->read ( reinterpret_cast<char *>(&header), sizeof(header) ))
+      if ( receiveBytes ( &header, sizeof(header) ) <= 0 )
 	{
 #ifdef DAL_DEBUGGING_MESSAGES
 	  cerr << "ERROR reading main header from file" << endl;
-	  cerr << "read pointer position: " << rawfile->tellg() << endl;
+	  cerr << "read pointer position: " << itsFileOffset << endl;
 #endif
 	  return false;
 	}
       
 #ifdef DAL_DEBUGGING_MESSAGES
       cout << "size of main header: " << sizeof(header) << endl;
-      cout << "read pointer position: " << rawfile->tellg() << endl;
+      cout << "read pointer position: " << itsFileOffset << endl;
 #endif
     }
     
@@ -243,108 +316,246 @@ namespace DAL { // Namespace DAL -- begin
   //_____________________________________________________________________________
   //                                                           readFirstDataBlock
 
+  /*!
+    \param first_block_header -- Header of the first data block.
+    \param sample_data        -- Buffer to exchange for the samples of the first
+           data block, see readDataBlock().
+    \param data_block_size    -- Size [bytes] of the samples of a data block.
+
+    \return status -- Returns \e false if the read thread could not be started
+            or the input ended before the first block.
+  */
   bool
   StationBeamReader::readFirstDataBlock (BFRawFormat::BlockHeader &first_block_header,
-					 BFRawFormat::Sample *sample_data,
+					 BFRawFormat::Sample *&sample_data,
 					 size_t data_block_size)
   {
-    dataBlockSize      = data_block_size;
-    int64_t read_bytes = receiveBytes(reinterpret_cast<char *>(&first_block_header),
-				      sizeof(BFRawFormat::BlockHeader));
-
-    if (read_bytes > 0) {
-      if (!bigendian) { convertEndian(&first_block_header); }
-      if ((read_bytes = receiveBytes(reinterpret_cast<char *>(sample_data), dataBlockSize)) != -1) {
-	return true;
-      }
-      else if (read_bytes == 0) {
-	finishReading();
-	return false;
-      }
-      else {
-#ifdef DAL_DEBUGGING_MESSAGES
-	cerr << "ERROR, receiving the first data block samples" << endl;
-#endif
-	return false;
+    dataBlockSize = data_block_size;
+
+    /* Allocate the buffers which are read ahead */
+    try {
+      for (unsigned int n=0; n < itsReadAhead; ++n) {
+	itsFreeBuffers.push_back(new BFRawFormat::Sample[dataBlockSize / sizeof(BFRawFormat::Sample)]);
       }
     }
-    else if (read_bytes == 0) {
-      finishReading();
+    catch (std::bad_alloc &) {
+      cerr << "[StationBeamReader::readFirstDataBlock] Can't allocate memory for "
+	   << itsReadAhead << " read-ahead buffers" << endl;
       return false;
     }
-    else {
+
+    /* Start reading ahead */
+    if (pthread_create(&itsReadThread, NULL, startReadThread, (void *) this) != 0) {
+      cerr << "[StationBeamReader::readFirstDataBlock] Could not start read thread!"
+	   << endl;
+      return false;
+    }
+    itsThreadStarted = true;
+
+    if (readDataBlock(sample_data, &first_block_header)) {
+      return true;
+    }
 #ifdef DAL_DEBUGGING_MESSAGES
-      cerr << "ERROR, receiving the first data block header" << endl;
+    cerr << "ERROR, receiving the first data block" << endl;
 #endif
-      //throw "Error, receiving the first data block header";
-    }
     return false;
-    //}
   }
-  
+
   //_____________________________________________________________________________
   //                                                                readDataBlock
 
-  bool StationBeamReader::readDataBlock (BFRawFormat::Sample *sample_data)
+  /*!
+    \param sample_data  -- Buffer, holding space for a complete data block,
+           which is taken over by the reader; on return it points to the
+           buffer with the samples of the next data block.
+    \param block_header -- If given, set to the header of the data block.
+
+    \return status -- Returns \e false once the end of the input has been
+            reached and all blocks read have been handed out; in that case
+            \c sample_data is left unchanged.
+  */
+  bool StationBeamReader::readDataBlock (BFRawFormat::Sample *&sample_data,
+					 BFRawFormat::BlockHeader *block_header)
   {
-    BFRawFormat::BlockHeader *dump = new BFRawFormat::BlockHeader();
-    int64_t read_bytes = receiveBytes(reinterpret_cast<char *>(dump), blockHeaderSize);
-    delete dump;
-    if (read_bytes > 0) { // throw away block header
-      //	if (!bigendian) { convertEndian(&blockheader); }
-      if ((read_bytes = receiveBytes(reinterpret_cast<char *>(sample_data), dataBlockSize)) > 0) {
-	cout << "sampledata[0].xx=" << sample_data->xx << ", yy=" << sample_data->yy << endl;
-	return true;
-      }
-      else if (read_bytes == 0) {
-	finishReading();
-	return false;
-      }
-      else {
-	cerr << "ERROR, receiving data block samples" << endl;
-	return false;
+    pthread_mutex_lock(&itsReadMutex);
+
+    if (itsFilledBlocks.empty() && !finished_reading) {
+      ++itsNofStalls;
+      while (itsFilledBlocks.empty() && !finished_reading) {
+	pthread_cond_wait(&itsReadCondition, &itsReadMutex);
       }
     }
-    else if (read_bytes == 0) {
-      finishReading();
+    if (itsFilledBlocks.empty()) {
+      pthread_mutex_unlock(&itsReadMutex);
       return false;
     }
-    else {
-#ifdef DAL_DEBUGGING_MESSAGES
-      cerr << "ERROR, receiving data block header" << endl;
+
+    Block const &block = itsFilledBlocks.front();
+    if (block_header) {
+      *block_header = block.header;
+    }
+    itsFreeBuffers.push_back(sample_data);
+    sample_data = block.data;
+    itsFilledBlocks.pop_front();
+
+    pthread_cond_broadcast(&itsReadCondition);
+    pthread_mutex_unlock(&itsReadMutex);
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                              readAheadBlocks
+
+  /*!
+    This function runs in a separate thread. It reads the data blocks into the
+    free buffers, converting them to the byte order of the host, until the end
+    of the input is reached or the reader is destroyed.
+  */
+  void StationBeamReader::readAheadBlocks (void)
+  {
+    Block block;
+    int64_t read_bytes = 0;
+
+    while (true) {
+      pthread_mutex_lock(&itsReadMutex);
+      if (itsFreeBuffers.empty() && !itsStopReading) {
+	++itsNofFull;
+	while (itsFreeBuffers.empty() && !itsStopReading) {
+	  pthread_cond_wait(&itsReadCondition, &itsReadMutex);
+	}
+      }
+      if (itsStopReading) {
+	pthread_mutex_unlock(&itsReadMutex);
+	return;
+      }
+      block.data = itsFreeBuffers.back();
+      itsFreeBuffers.pop_back();
+      pthread_mutex_unlock(&itsReadMutex);
+
+      read_bytes = receiveBytes(&block.header, blockHeaderSize);
+      if (read_bytes > 0) {
+	read_bytes = receiveBytes(block.data, dataBlockSize);
+      }
+      if (read_bytes > 0) {
+#ifdef POSIX_FADV_WILLNEED
+	if (!socketmode) {
+	  /* Have the kernel prefetch the next block while this one is converted */
+	  posix_fadvise(rawfile, itsFileOffset, blockHeaderSize+dataBlockSize, POSIX_FADV_WILLNEED);
+	}
 #endif
-      //throw "Error, receiving the first data block header";
-      return false;
+	if (!bigendian) {
+	  convertEndian(&block.header);
+	  swapSampleEndians(block.data, dataBlockSize / sizeof(BFRawFormat::Sample));
+	}
+      }
+
+      pthread_mutex_lock(&itsReadMutex);
+      if (read_bytes > 0) {
+	itsFilledBlocks.push_back(block);
+	++itsNofBlocksRead;
+	pthread_cond_broadcast(&itsReadCondition);
+	pthread_mutex_unlock(&itsReadMutex);
+      }
+      else {
+	itsFreeBuffers.push_back(block.data);
+	bool stopped = itsStopReading;
+	pthread_mutex_unlock(&itsReadMutex);
+	if (read_bytes < 0 && !stopped) {
+	  cerr << "[StationBeamReader::readAheadBlocks] Error receiving data block "
+	       << itsNofBlocksRead << endl;
+	}
+	finishReading();
+	return;
+      }
     }
   }
-  
+
   //_____________________________________________________________________________
   //                                                                 receiveBytes
 
+  /*!
+    \param storage         -- Buffer to read into.
+    \param nrOfBytesToRead -- Number of bytes to read.
+
+    \return nofBytes -- Number of bytes read; 0 if the end of the input was
+            reached before, and -1 in case of an error.
+  */
   int64_t StationBeamReader::receiveBytes (void *storage,
 					   int64_t nrOfBytesToRead)
   {
     int64_t bytes_read  = 0;
+    int64_t total_read  = 0;
     int8_t *bytepointer = reinterpret_cast<int8_t *>(storage);
 
     while (true) {
-      bytes_read = recvfrom(server_socket, bytepointer, nrOfBytesToRead, 0, (sockaddr *) &incoming_addr, &socklen);
+      if (socketmode) {
+	bytes_read = recvfrom(server_socket, bytepointer, nrOfBytesToRead, 0, (sockaddr *) &incoming_addr, &socklen);
+      }
+      else {
+	bytes_read = pread(rawfile, bytepointer, nrOfBytesToRead, itsFileOffset);
+      }
       if (bytes_read == -1) { // error reading
-	shutdown(server_socket, SHUT_RDWR);
-	close(server_socket);
+	if (errno == EINTR) {
+	  continue;
+	}
+	if (socketmode) {
+	  shutdown(server_socket, SHUT_RDWR);
+	  close(server_socket);
+	}
 	return -1;
       }
       else if (bytes_read == 0) { // end of stream?
 	return 0;
       }
+      if (!socketmode) {
+	itsFileOffset += bytes_read;
+      }
       nrOfBytesToRead -= bytes_read;
       bytepointer += bytes_read;
+      total_read += bytes_read;
       if (nrOfBytesToRead == 0) { // did we read enough?
-	return bytes_read;
+	return total_read;
       }
     }
   }
-  
+
+  //_____________________________________________________________________________
+  //                                                            swapSampleEndians
+
+  /*!
+    \param sample_data -- Samples to convert, in place.
+    \param nofSamples  -- Number of samples.
+
+    The components of the samples are swapped as a flat array of 16-bit
+    values, in a loop which the compiler vectorises.
+  */
+  void StationBeamReader::swapSampleEndians (BFRawFormat::Sample *sample_data,
+					     size_t nofSamples)
+  {
+    uint16_t *values = reinterpret_cast<uint16_t *>(sample_data);
+    size_t nofValues = nofSamples * sizeof(BFRawFormat::Sample) / sizeof(uint16_t);
+
+    for (size_t n=0; n < nofValues; ++n) {
+      values[n] = static_cast<uint16_t>((values[n] >> 8) | (values[n] << 8));
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   showStatus
+
+  void StationBeamReader::showStatus (void)
+  {
+    pthread_mutex_lock(&itsReadMutex);
+    cout << "[StationBeamReader] Status of the reader." << endl;
+    cout << "-- Blocks read ahead ...... : " << itsReadAhead      << endl;
+    cout << "-- Blocks read ............ : " << itsNofBlocksRead  << endl;
+    cout << "-- Blocks waiting ......... : " << itsFilledBlocks.size() << endl;
+    cout << "-- Waits for data ......... : " << itsNofStalls      << endl;
+    cout << "-- Waits for free buffers . : " << itsNofFull        << endl;
+    pthread_mutex_unlock(&itsReadMutex);
+  }
+
   //_____________________________________________________________________________
   //                                                            swapHeaderEndians
 
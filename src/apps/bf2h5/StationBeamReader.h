@@ -24,16 +24,19 @@
 #ifndef _StationBeamReader_
 #define _StationBeamReader_
 
+#include <deque>
 #include <string>
 #include <sstream>
+#include <vector>
 #include <netdb.h>
+#include <pthread.h>
 #include <sys/socket.h>
+#include <sys/types.h>
 
 #include <coordinates/Angle.h>
 #include <data_hl/BFRawFormat.h>
 
 // Forward declarations
-class fstream;
 class BF2H5;
 
 namespace DAL { // Namespace DAL -- begin
@@ -45,6 +48,19 @@ namespace DAL { // Namespace DAL -- begin
     \ingroup dal_apps
     
     \author Alwin de Jong
+
+    <h3>Synopsis</h3>
+
+    After the main header has been read, the data blocks are read ahead by a
+    separate thread into a pool of readAhead() buffers. Files are read with
+    \c pread(), with the kernel advised to prefetch the following block;
+    sockets are drained by the same thread, so that the sender is not held up
+    while the calculator is busy. The samples are converted in place to the
+    byte order of the host.
+
+    readDataBlock() hands out the oldest block which has been read, and takes
+    over the buffer passed in for a later block; the blocks are therefore never
+    copied, and all buffers exchanged must hold a complete data block.
   */
   class StationBeamReader {
     
@@ -78,18 +94,28 @@ namespace DAL { // Namespace DAL -- begin
     //! Read the main file or socket header
     bool readMainHeader (BFRawFormat::BFRaw_Header &header);
     
-    //! Read the first block of data
+    //! Get the number of blocks read ahead
+    inline unsigned int readAhead (void) const {
+      return itsReadAhead;
+    }
+    
+    //! Set the number of blocks read ahead; takes effect with the first block
+    void setReadAhead (unsigned int const &nofBlocks);
+    
+    //! Start reading ahead and get the first block of data
     bool readFirstDataBlock (BFRawFormat::BlockHeader &first_block_header,
-			     BFRawFormat::Sample *sample_data,
+			     BFRawFormat::Sample *&sample_data,
 			     size_t data_block_size);
     
-    //! Read a block of data
-    bool readDataBlock(BFRawFormat::Sample *sample_data);
+    //! Exchange a buffer for the next block of data
+    bool readDataBlock(BFRawFormat::Sample *&sample_data,
+		       BFRawFormat::BlockHeader *block_header=0);
     
     //! Check if we have finished reading data
-    inline bool finishedReading(void) const {
-      return finished_reading;
-    };
+    bool finishedReading(void);
+    
+    //! Show the status of the reader
+    void showStatus(void);
     
     //! Print debug info of the main header
     void printHeaderParameters(BFRawFormat::BFRaw_Header &header);
@@ -98,9 +124,20 @@ namespace DAL { // Namespace DAL -- begin
     
     // === Private methods ========================================================
     
-    //! Low level read from socket
+    //! Low level read from socket or file
     int64_t receiveBytes (void *storage, int64_t nrOfBytesToRead);
     bool openRawFile( std::string &filename );
+    //! Thread reading the data blocks ahead
+    static void * startReadThread (void * This)
+    {
+      ((StationBeamReader *)This)->readAheadBlocks();
+      return NULL;
+    }
+    //! Read the data blocks into the free buffers until the end of the input
+    void readAheadBlocks (void);
+    //! Convert the samples of a block in place from big endian
+    static void swapSampleEndians (BFRawFormat::Sample *sample_data,
+				   size_t nofSamples);
     bool connectSocket(unsigned int port_number);
     //! Swap the byte endians if not in bigendian
     void swapHeaderEndians(BFRawFormat::BFRaw_Header &header);
@@ -110,6 +147,13 @@ namespace DAL { // Namespace DAL -- begin
     
     // === Private variables ======================================================
     
+    //! A data block which has been read
+    struct Block
+    {
+      BFRawFormat::BlockHeader header;
+      BFRawFormat::Sample *data;
+    };
+    
     bool finished_reading;
     bool bigendian;
     
@@ -119,9 +163,31 @@ namespace DAL { // Namespace DAL -- begin
     socklen_t socklen;
     
     //file things
-    std::fstream * rawfile;	
+    int rawfile;
+    off_t itsFileOffset;
     size_t file_byte_size;
     
+    // read-ahead things:
+    //! Number of blocks read ahead
+    unsigned int itsReadAhead;
+    //! Buffers which may be filled
+    std::vector<BFRawFormat::Sample *> itsFreeBuffers;
+    //! Blocks which have been read, oldest first
+    std::deque<Block> itsFilledBlocks;
+    //! Protects the buffers, the blocks and the counters
+    pthread_mutex_t itsReadMutex;
+    //! Signalled when a buffer is freed or a block has been read
+    pthread_cond_t itsReadCondition;
+    pthread_t itsReadThread;
+    bool itsThreadStarted;
+    bool itsStopReading;
+    //! Number of blocks read
+    unsigned long itsNofBlocksRead;
+    //! Number of times readDataBlock() had to wait for a block
+    unsigned long itsNofStalls;
+    //! Number of times the read thread had to wait for a free buffer
+    unsigned long itsNofFull;
+    
     BF2H5 * itsParent;
     bool socketmode;
     bool memAllocOK;
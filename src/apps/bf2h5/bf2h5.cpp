@@ -38,11 +38,15 @@ using std::bad_alloc;
   \param parset_filename -- Name of the parameter set file.
   \param downsample_factor -- Downsample factor.
   \param do_intensity -- Compute intensities?
+  \param stokes_products -- Stokes parameters to compute, combination of
+         DAL::BFRawKernels::Product; any selection other than Stokes I implies
+         the computation of intensities.
 */
 BF2H5::BF2H5 (const std::string &outfile,
 	      const std::string &parset_filename,
 	      uint downsample_factor,
-	      bool do_intensity)
+	      bool do_intensity,
+	      unsigned int stokes_products)
   : socketmode(false),
     outputFile(outfile),
     itsCalculator(0),
@@ -50,11 +54,27 @@ BF2H5::BF2H5 (const std::string &outfile,
     itsReader(0),
     oneBlockdataSize(0),
     itsReadBuffer(0),
-    itsCurrentNrOfReadBuffers(INITIAL_NR_OF_READ_BUFFERS)
+    itsCurrentNrOfReadBuffers(0)
 {
+  pthread_mutex_init(&itsBufferMutex, NULL);
+  
+  itsNrCalculationThreads = 4;
+  itsNrBuffers            = 2;
+  itsNrReadAhead          = 2;
+  itsWriteDeadline        = 1.0;
+  itsDatasetOutput        = false;
+
   itsParseFile        = parset_filename;
   itsDownsampleFactor = downsample_factor;
   itsDoIntensity      = do_intensity;
+  itsStokesProducts   = stokes_products & DAL::BFRawKernels::StokesIQUV;
+  
+  if (itsStokesProducts == 0) {
+    itsStokesProducts = DAL::BFRawKernels::StokesI;
+  }
+  else if (itsStokesProducts != DAL::BFRawKernels::StokesI) {
+    itsDoIntensity = true;
+  }
   
   if (downsample_factor > 1) {
     itsDoDownSample = true;
@@ -88,6 +108,8 @@ BF2H5::~BF2H5()
 #ifdef DAL_WITH_LOFAR
   delete itsParset;
 #endif
+
+  pthread_mutex_destroy(&itsBufferMutex);
 }
 
 // ==============================================================================
@@ -96,6 +118,73 @@ BF2H5::~BF2H5()
 //
 // ==============================================================================
 
+//_______________________________________________________________________________
+//                                                        setNrCalculationThreads
+
+/*!
+  \param nofThreads -- Number of threads down-sampling the subbands; takes
+         effect when the processing is started.
+*/
+void BF2H5::setNrCalculationThreads (uint nofThreads)
+{
+  itsNrCalculationThreads = nofThreads > 0 ? nofThreads : 1;
+}
+
+//_______________________________________________________________________________
+//                                                                   setNrBuffers
+
+/*!
+  \param nofBuffers -- Number of blocks which may be in progress at the same
+         time, i.e. the number of sets of output buffers of the calculator;
+         one more read buffer is allocated up front.
+*/
+void BF2H5::setNrBuffers (uint nofBuffers)
+{
+  itsNrBuffers = nofBuffers > 0 ? nofBuffers : 1;
+}
+
+//_______________________________________________________________________________
+//                                                                 setNrReadAhead
+
+/*!
+  \param nofBlocks -- Number of data blocks read by a separate thread ahead of
+         the calculation; takes effect when the processing is started.
+*/
+void BF2H5::setNrReadAhead (uint nofBlocks)
+{
+  itsNrReadAhead = nofBlocks > 0 ? nofBlocks : 1;
+}
+
+//_______________________________________________________________________________
+//                                                               setWriteDeadline
+
+/*!
+  \param seconds -- Time [s] after the arrival of the first subband of a block
+         within which the writer waits for its other subbands; subbands which
+         have not arrived by then are written as zeros.
+*/
+void BF2H5::setWriteDeadline (double seconds)
+{
+  itsWriteDeadline = seconds > 0 ? seconds : 0;
+}
+
+//_______________________________________________________________________________
+//                                                               setDatasetOutput
+
+/*!
+  \param datasetOutput -- Write the data of all subbands into a single
+         <tt>[time,subband]</tt> dataset per Stokes parameter, instead of one
+         table per subband; this implies the computation of intensities. Takes
+         effect when the processing is started.
+*/
+void BF2H5::setDatasetOutput (bool const &datasetOutput)
+{
+  itsDatasetOutput = datasetOutput;
+  if (itsDatasetOutput) {
+    itsDoIntensity = true;
+  }
+}
+
 //_______________________________________________________________________________
 //                                                                  setSocketMode
 
@@ -147,6 +236,7 @@ bool BF2H5::allocateSampleBuffers(void)
   cout << "BF2H5::allocateSampleBuffers: allocating " << itsCurrentNrOfReadBuffers * oneBlockdataSize * sizeof(BFRawFormat::Sample) << " bytes for sample input data" << endl;
 #endif
   try {
+    itsCurrentNrOfReadBuffers = itsNrBuffers + 1;
     for (unsigned short i = 0; i < itsCurrentNrOfReadBuffers; ++i) {
       BFRawFormat::Sample *pbuf = new BFRawFormat::Sample[ oneBlockdataSize ];
 //		memset(pbuf, 0, oneBlockdataSize * sizeof(BFRawFormat::Sample));
@@ -167,12 +257,15 @@ bool BF2H5::allocateSampleBuffers(void)
 
 void BF2H5::blockComplete (long int blockNr)
 {
+  pthread_mutex_lock(&itsBufferMutex);
   for (bufferTracker::iterator it = itsBufferTracker.begin(); it != itsBufferTracker.end(); ++it) {
     if (it->second == blockNr) {
       it->second = -1;
+      pthread_mutex_unlock(&itsBufferMutex);
       return;
     }
   }
+  pthread_mutex_unlock(&itsBufferMutex);
   std::cerr << "[BF2H5::blockComplete] ERROR, trying to free a read buffer for block "
 	    << blockNr
 	    << " that doesn't have a read buffer!"
@@ -184,10 +277,12 @@ void BF2H5::blockComplete (long int blockNr)
 
 bool BF2H5::switchReadBuffer (long int block_nr)
 {
+  pthread_mutex_lock(&itsBufferMutex);
   for (bufferTracker::iterator it = itsBufferTracker.begin(); it != itsBufferTracker.end(); ++it) {
     if (it->second == -1) { // not in use
       it->second    = block_nr;
       itsReadBuffer = it->first;
+      pthread_mutex_unlock(&itsBufferMutex);
       return true;
     }
   }
@@ -201,11 +296,13 @@ bool BF2H5::switchReadBuffer (long int block_nr)
     itsSampleBuffers.push_back(pbuf);
   }
   catch (bad_alloc) {
+    pthread_mutex_unlock(&itsBufferMutex);
     cerr << "BF2H5::switchReadBuffer, ERROR cannot allocate memory for new input read buffer." << endl;
     return false;
   }
   itsBufferTracker.insert(std::pair<uint8_t, long int>(itsCurrentNrOfReadBuffers, block_nr));
   itsReadBuffer = itsCurrentNrOfReadBuffers++; // switch to new buffer
+  pthread_mutex_unlock(&itsBufferMutex);
 //	itsCalculator->showStatus();
 //	itsWriter->showStatus();
   return true;
@@ -253,7 +350,9 @@ void BF2H5::start (bool const &verbose)
 	// Start the calculator
         itsCalculator = new DAL::Bf2h5Calculator (this,
 						  BFMainHeader.nrSubbands,
-						  getNrSamplesPerSubband());
+						  getNrSamplesPerSubband(),
+						  itsNrCalculationThreads,
+						  itsNrBuffers);
 	// Start the writer
 #ifdef DAL_WITH_LOFAR
         itsWriter = new HDF5Writer (this,
@@ -261,10 +360,13 @@ void BF2H5::start (bool const &verbose)
 				    itsParset,
 				    downSampledDataSize,
 				    BFMainHeader.nrSubbands);
+	itsWriter->setDeadline(itsWriteDeadline);
 #else
 	itsWriter = NULL;
 #endif
 
+        itsReader->setReadAhead(itsNrReadAhead);
+        // the reader exchanges the read buffers for buffers holding the data blocks
         if (itsReader->readFirstDataBlock(firstBlockHeader, itsSampleBuffers[itsReadBuffer], oneBlockdataSize * sizeof(BFRawFormat::Sample))) {
           getTimeFromBlockHeader();
 	  
@@ -273,8 +375,7 @@ void BF2H5::start (bool const &verbose)
             itsCalculator->startProcessing();
             itsCalculator->calculateDataBlock(blockNr++, itsSampleBuffers[itsReadBuffer]); // calculator will call calculationFinished when done
             switchReadBuffer(blockNr);
-            while (!(itsReader->finishedReading())) {
-              itsReader->readDataBlock(itsSampleBuffers[itsReadBuffer]); // blocking read
+            while (itsReader->readDataBlock(itsSampleBuffers[itsReadBuffer])) { // waits only if no block has been read ahead
               itsCalculator->calculateDataBlock(blockNr++, itsSampleBuffers[itsReadBuffer]); // non-blocking calculator will call calculationFinished
               switchReadBuffer(blockNr);
             }
@@ -295,6 +396,12 @@ void BF2H5::start (bool const &verbose)
               sleep(1); // calculator or hdf5 writer still busy
             }
 
+            if (verbose) {
+              itsReader->showStatus();
+              itsCalculator->showStatus();
+              itsWriter->showStatus();
+            }
+
             if (!itsCalculator->stop()) {
               cerr << "[BF2H5::start] Calculator didn't stop all its threads correctly!"
 		   << endl;
@@ -37,11 +37,10 @@
 #include "Bf2h5Calculator.h"
 #include "StationBeamReader.h"
 #include <data_hl/BFRawFormat.h>
+#include <data_hl/BFRawKernels.h>
 
 #define DAL_DEBUGGING_MESSAGES
 
-#define INITIAL_NR_OF_READ_BUFFERS 2
-
 typedef std::vector<BFRawFormat::Sample *> sampleBuffers;
 /*!
   - key = nr of sample buffer
@@ -79,7 +78,8 @@ class BF2H5 {
   BF2H5 (const std::string &outfile,
 	 const std::string &parset_filename,
 	 uint downsample_factor,
-	 bool do_intensity);
+	 bool do_intensity,
+	 unsigned int stokes_products=DAL::BFRawKernels::StokesI);
 
   // === Destruction ============================================================
 
@@ -100,6 +100,44 @@ class BF2H5 {
   inline uint getDownSampleFactor (void) const {
     return itsDownsampleFactor;
   }
+  //! Get the Stokes parameters to compute, combination of DAL::BFRawKernels::Product
+  inline unsigned int getStokesProducts (void) const {
+    return itsStokesProducts;
+  }
+  //! Get the number of Stokes parameters per output sample
+  inline unsigned int getNrStokesProducts (void) const {
+    return DAL::BFRawKernels::productNames(itsStokesProducts).size();
+  }
+  //! Get the number of calculation threads
+  inline uint getNrCalculationThreads (void) const {
+    return itsNrCalculationThreads;
+  }
+  //! Set the number of calculation threads
+  void setNrCalculationThreads (uint nofThreads);
+  //! Get the number of blocks which may be in progress at the same time
+  inline uint getNrBuffers (void) const {
+    return itsNrBuffers;
+  }
+  //! Set the number of blocks which may be in progress at the same time
+  void setNrBuffers (uint nofBuffers);
+  //! Get the number of blocks read ahead of the calculation
+  inline uint getNrReadAhead (void) const {
+    return itsNrReadAhead;
+  }
+  //! Set the number of blocks read ahead of the calculation
+  void setNrReadAhead (uint nofBlocks);
+  //! Get the time [s] within which all subbands of a block must be written
+  inline double getWriteDeadline (void) const {
+    return itsWriteDeadline;
+  }
+  //! Set the time [s] within which all subbands of a block must be written
+  void setWriteDeadline (double seconds);
+  //! Write a single 2-D dataset per Stokes parameter instead of a table per subband?
+  inline bool doDatasetOutput (void) const {
+    return itsDatasetOutput;
+  }
+  //! Enable/disable the output of a single 2-D dataset per Stokes parameter
+  void setDatasetOutput (bool const &datasetOutput);
   //! Set input mode to read from socket
   void setSocketMode(uint port);
   //! Set input mode to read from file
@@ -140,6 +178,11 @@ class BF2H5 {
   //! Called by the calculator when a block of subbands was completed
   void blockComplete(long int blockNr);
 
+  //! Called by the writer when a block of subbands was written
+  inline void blockWritten (long int blockNr) {
+    itsCalculator->blockWritten(blockNr);
+  }
+
   //! Get epoch as UTC
   inline const std::string &getEpochUTC(void) const {
     return EpochUTC;
@@ -164,6 +207,18 @@ class BF2H5 {
   bool itsDoDownSample;
   //! Downsampling factor
   uint itsDownsampleFactor;
+  //! Stokes parameters to compute, combination of DAL::BFRawKernels::Product
+  unsigned int itsStokesProducts;
+  //! Number of calculation threads
+  uint itsNrCalculationThreads;
+  //! Number of blocks which may be in progress at the same time
+  uint itsNrBuffers;
+  //! Number of blocks read ahead of the calculation
+  uint itsNrReadAhead;
+  //! Time [s] within which all subbands of a block must be written
+  double itsWriteDeadline;
+  //! Write a single 2-D dataset per Stokes parameter?
+  bool itsDatasetOutput;
   
   // some main header parameters we need to know here
   std::string itsParseFile;
@@ -183,6 +238,7 @@ class BF2H5 {
   //sample buffers things
   uint8_t itsReadBuffer, itsCurrentNrOfReadBuffers; // the current read buffer
   bufferTracker itsBufferTracker; // keeps track of which buffer is used for which data block
+  pthread_mutex_t itsBufferMutex; // protects itsBufferTracker, which is updated by the calculator threads
   sampleBuffers itsSampleBuffers; // pointers to input data samplebuffers
   
   std::string EpochUTC;
@@ -56,6 +56,12 @@ void print_examples (std::ostream &os)
   os << "2) Read data from TCP stream to a HDF5 file:" << endl;
   os << "  bf2h5 --port <port number> --outfile <HDF5 output>" << endl;
   os << endl;
+  os << "3) Write all four Stokes parameters, down-sampled by a factor 16:" << endl;
+  os << "  bf2h5 --infile <raw data> --outfile <HDF5 output> --stokes IQUV --downsample 16" << endl;
+  os << endl;
+  os << "4) Write a single [time,subband] dataset per Stokes parameter:" << endl;
+  os << "  bf2h5 --infile <raw data> --outfile <HDF5 output> --stokes IQUV --dataset" << endl;
+  os << endl;
 }
 
 //_______________________________________________________________________________
@@ -74,6 +80,12 @@ int main (int argc, char *argv[])
   bool doIntensity      = false;
   bool doDownsample     = false;
   uint dsFactor         = 1;
+  unsigned int stokes   = DAL::BFRawKernels::StokesI;
+  uint nofThreads       = 4;
+  uint nofBuffers       = 2;
+  double deadline       = 1.0;
+  uint nofReadAhead     = 2;
+  bool datasetOutput    = false;
   //	bool doChannelization = false;
   
   // Processing of command line options ____________________
@@ -90,6 +102,12 @@ int main (int argc, char *argv[])
     ("port,P", bpo::value<uint>(), "Port number to accept beam formed raw data from")
     //("downsample", "Downsampling of the original data")
     ("intensity", "Compute total intensity")
+    ("stokes", bpo::value<std::string>(), "Stokes parameters to compute, e.g. I or IQUV (implies --intensity)")
+    ("threads,T", bpo::value<uint>(), "Number of calculation threads (default 4)")
+    ("buffers,B", bpo::value<uint>(), "Number of data blocks in progress at the same time (default 2)")
+    ("readahead", bpo::value<uint>(), "Number of data blocks read ahead of the calculation (default 2)")
+    ("deadline", bpo::value<double>(), "Time [s] after the first subband of a block within which all its subbands must arrive, otherwise they are written as zeros (default 1)")
+    ("dataset", "Write a single [time,subband] dataset per Stokes parameter instead of a table per subband (implies --intensity)")
     ("noninteractive", "non-interactive mode, automatically overwrites output file if it exists")
     ;
   
@@ -135,6 +153,16 @@ int main (int argc, char *argv[])
     doIntensity = true;
   }
   
+  if (vm.count("stokes")) {
+    stokes = DAL::BFRawKernels::products (vm["stokes"].as<std::string>());
+    if (stokes == 0) {
+      std::cerr << "[bf2h5] Invalid selection of Stokes parameters: "
+		<< vm["stokes"].as<std::string>() << endl;
+      return 1;
+    }
+    doIntensity = true;
+  }
+  
   if (vm.count("downsample")) {
     dsFactor = vm["downsample"].as<uint>();
     // check parameter value
@@ -146,6 +174,39 @@ int main (int argc, char *argv[])
       doDownsample = true;
     }
   }
+  if (vm.count("threads")) {
+    nofThreads = vm["threads"].as<uint>();
+    if (nofThreads == 0) {
+      nofThreads = 1;
+    }
+  }
+  
+  if (vm.count("buffers")) {
+    nofBuffers = vm["buffers"].as<uint>();
+    if (nofBuffers == 0) {
+      nofBuffers = 1;
+    }
+  }
+  
+  if (vm.count("readahead")) {
+    nofReadAhead = vm["readahead"].as<uint>();
+    if (nofReadAhead == 0) {
+      nofReadAhead = 1;
+    }
+  }
+  
+  if (vm.count("deadline")) {
+    deadline = vm["deadline"].as<double>();
+    if (deadline < 0) {
+      deadline = 0;
+    }
+  }
+  
+  if (vm.count("dataset")) {
+    datasetOutput = true;
+    doIntensity   = true;
+  }
+  
   if (vm.count("noninteractive")) {
     non_interactive = true; 
   }
@@ -194,8 +255,14 @@ int main (int argc, char *argv[])
       std::cout << "-- Output file ........... : " << outfile << endl;
     }
   std::cout << "-- Compute total intensity : " << doIntensity  << endl;
+  std::cout << "-- Stokes parameters ..... : " << DAL::BFRawKernels::productNames(stokes) << endl;
   std::cout << "-- Downsampling of data .. : " << doDownsample << endl;
   std::cout << "-- Downsampling factor ... : " << dsFactor       << endl;
+  std::cout << "-- Calculation threads ... : " << nofThreads     << endl;
+  std::cout << "-- Blocks in progress .... : " << nofBuffers     << endl;
+  std::cout << "-- Blocks read ahead ..... : " << nofReadAhead   << endl;
+  std::cout << "-- Deadline per block [s]  : " << deadline       << endl;
+  std::cout << "-- Single 2-D datasets ... : " << datasetOutput  << endl;
   
   // Processing of input data ______________________________
   
@@ -230,7 +297,12 @@ int main (int argc, char *argv[])
       }
     }
   }
-  BF2H5 bf2h5(outfile, parsetFilename, dsFactor, doIntensity);
+  BF2H5 bf2h5(outfile, parsetFilename, dsFactor, doIntensity, stokes);
+  bf2h5.setNrCalculationThreads(nofThreads);
+  bf2h5.setNrBuffers(nofBuffers);
+  bf2h5.setNrReadAhead(nofReadAhead);
+  bf2h5.setWriteDeadline(deadline);
+  bf2h5.setDatasetOutput(datasetOutput);
   
   if (socketmode) {
     bf2h5.setSocketMode(port);
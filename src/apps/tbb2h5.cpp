@@ -402,9 +402,6 @@ int main(int argc, char *argv[])
                 break;
             }
 
-          // cleanup open groups, etc.
-          tbb.cleanup();
-
         } // while (true)
 
     }
@@ -415,7 +412,8 @@ int main(int argc, char *argv[])
           counter++;
 
           /* Read header block of raw file */
-          tbb.readRawFileBlockHeader();
+          if ( !tbb.readRawFileBlockHeader() )
+            break;
           if ( doCheckCRC > 0)
             {
               if (!tbb.headerCRC() )
@@ -463,13 +461,13 @@ int main(int argc, char *argv[])
               tbb.processSpectralFileDataBlock();
             }
 
-          // cleanup open groups, etc.
-          tbb.cleanup();
-
         } // !eof
 
     } // socket or file
 
+  // write back the dipole lengths and close open groups, etc.
+  tbb.cleanup();
+
   cout << "Total no of processed blocks: " << counter << endl;
   cout << "of which were discarded: " << discardedBlocks << endl;
   cout << "Correctly written to file: " << counter - discardedBlocks << endl;
@@ -0,0 +1,414 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "HDF5AccessPlan.h"
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                               HDF5AccessPlan
+
+  HDF5AccessPlan::HDF5AccessPlan ()
+  {
+    init ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                               HDF5AccessPlan
+
+  /*!
+    \param dataset -- Identifier of the dataset.
+    \param block   -- Shape of the selection.
+  */
+  HDF5AccessPlan::HDF5AccessPlan (hid_t const &dataset,
+				  std::vector<hsize_t> const &block)
+  {
+    init ();
+    setup (dataset, block);
+  }
+
+  //_____________________________________________________________________________
+  //                                                               HDF5AccessPlan
+
+  /*!
+    \param dataset -- Identifier of the dataset.
+    \param stride  -- Number of elements separating two subsequent blocks.
+    \param count   -- Number of blocks selected along each axis.
+    \param block   -- Size of a block.
+  */
+  HDF5AccessPlan::HDF5AccessPlan (hid_t const &dataset,
+				  std::vector<hsize_t> const &stride,
+				  std::vector<hsize_t> const &count,
+				  std::vector<hsize_t> const &block)
+  {
+    init ();
+    setup (dataset, stride, count, block);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         init
+
+  void HDF5AccessPlan::init ()
+  {
+    itsDataset     = -1;
+    itsFileSpace   = -1;
+    itsMemorySpace = -1;
+    itsRank        = 0;
+    itsSelected    = false;
+
+    for (unsigned int n=0; n<HDF5ACCESSPLAN_MAX_RANK; ++n) {
+      itsShape[n]    = 0;
+      itsMaxShape[n] = 0;
+      itsStart[n]    = 0;
+      itsStride[n]   = 1;
+      itsCount[n]    = 1;
+      itsBlock[n]    = 1;
+      itsSpan[n]     = 1;
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  HDF5AccessPlan::~HDF5AccessPlan ()
+  {
+    destroy ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      destroy
+
+  void HDF5AccessPlan::destroy ()
+  {
+    if (itsFileSpace >= 0) {
+      H5Sclose (itsFileSpace);
+    }
+    if (itsMemorySpace >= 0) {
+      H5Sclose (itsMemorySpace);
+    }
+    init ();
+  }
+
+  // ============================================================================
+  //
+  //  Parameter access
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                        shape
+
+  std::vector<hsize_t> HDF5AccessPlan::shape () const
+  {
+    return std::vector<hsize_t> (itsShape, itsShape+itsRank);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        start
+
+  std::vector<hsize_t> HDF5AccessPlan::start () const
+  {
+    return std::vector<hsize_t> (itsStart, itsStart+itsRank);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                nofDatapoints
+
+  hsize_t HDF5AccessPlan::nofDatapoints () const
+  {
+    hsize_t nofPoints = itsRank > 0 ? 1 : 0;
+
+    for (unsigned int n=0; n<itsRank; ++n) {
+      nofPoints *= itsCount[n]*itsBlock[n];
+    }
+
+    return nofPoints;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5AccessPlan::summary (std::ostream &os)
+  {
+    os << "[HDF5AccessPlan] Summary of internal parameters." << std::endl;
+    os << "-- Dataset ID               = " << itsDataset              << std::endl;
+    os << "-- Rank                     = " << itsRank                 << std::endl;
+    os << "-- Shape of the dataset     = " << toString(itsShape,itsRank)  << std::endl;
+    os << "-- Start                    = " << toString(itsStart,itsRank)  << std::endl;
+    os << "-- Stride                   = " << toString(itsStride,itsRank) << std::endl;
+    os << "-- Count                    = " << toString(itsCount,itsRank)  << std::endl;
+    os << "-- Block                    = " << toString(itsBlock,itsRank)  << std::endl;
+    os << "-- nof. datapoints          = " << nofDatapoints()         << std::endl;
+    os << "-- Valid selection          = " << itsSelected             << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                        setup
+
+  /*!
+    \param dataset -- Identifier of the dataset.
+    \param block   -- Shape of the selection.
+
+    \return status -- Status of the operation; returns \e false in case an error
+            was encountered.
+  */
+  bool HDF5AccessPlan::setup (hid_t const &dataset,
+			      std::vector<hsize_t> const &block)
+  {
+    std::vector<hsize_t> unity (block.size(), 1);
+
+    return setup (dataset, unity, unity, block);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        setup
+
+  /*!
+    \param dataset -- Identifier of the dataset.
+    \param stride  -- Number of elements separating two subsequent blocks.
+    \param count   -- Number of blocks selected along each axis.
+    \param block   -- Size of a block.
+
+    \return status -- Status of the operation; returns \e false in case an error
+            was encountered, e.g. if the rank of the dataset exceeds
+	    \c HDF5ACCESSPLAN_MAX_RANK or the selection does not match it.
+  */
+  bool HDF5AccessPlan::setup (hid_t const &dataset,
+			      std::vector<hsize_t> const &stride,
+			      std::vector<hsize_t> const &count,
+			      std::vector<hsize_t> const &block)
+  {
+    destroy ();
+
+    if (!H5Iis_valid(dataset) || H5Iget_type(dataset) != H5I_DATASET) {
+      std::cerr << "[HDF5AccessPlan::setup] Invalid dataset identifier!"
+		<< std::endl;
+      return false;
+    }
+
+    hid_t fileSpace = H5Dget_space (dataset);
+    int rank        = H5Sget_simple_extent_ndims (fileSpace);
+
+    if (rank < 1 || rank > HDF5ACCESSPLAN_MAX_RANK) {
+      std::cerr << "[HDF5AccessPlan::setup] Unsupported rank " << rank
+		<< " of the dataset!" << std::endl;
+      H5Sclose (fileSpace);
+      return false;
+    }
+
+    if (block.size() != (unsigned int)rank
+	|| stride.size() != (unsigned int)rank
+	|| count.size() != (unsigned int)rank) {
+      std::cerr << "[HDF5AccessPlan::setup] Selection does not match the rank "
+		<< rank << " of the dataset!" << std::endl;
+      H5Sclose (fileSpace);
+      return false;
+    }
+
+    hsize_t dims[HDF5ACCESSPLAN_MAX_RANK];
+
+    for (int n=0; n<rank; ++n) {
+      if (block[n] < 1 || count[n] < 1 || stride[n] < 1
+	  || (count[n] > 1 && stride[n] < block[n])) {
+	std::cerr << "[HDF5AccessPlan::setup] Invalid selection along axis "
+		  << n << "!" << std::endl;
+	H5Sclose (fileSpace);
+	return false;
+      }
+      itsStride[n] = stride[n];
+      itsCount[n]  = count[n];
+      itsBlock[n]  = block[n];
+      itsSpan[n]   = (count[n]-1)*stride[n] + block[n];
+      dims[n]      = count[n]*block[n];
+    }
+
+    itsDataset     = dataset;
+    itsFileSpace   = fileSpace;
+    itsRank        = rank;
+    itsMemorySpace = H5Screate_simple (rank, dims, NULL);
+    H5Sget_simple_extent_dims (itsFileSpace, itsShape, itsMaxShape);
+
+    return isValid();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      refresh
+
+  /*!
+    \return status -- Status of the operation; returns \e false in case an error
+            was encountered.
+  */
+  bool HDF5AccessPlan::refresh ()
+  {
+    if (!isValid()) {
+      return false;
+    }
+
+    H5Sclose (itsFileSpace);
+    itsFileSpace = H5Dget_space (itsDataset);
+    itsSelected  = false;
+
+    return H5Sget_simple_extent_dims (itsFileSpace, itsShape, itsMaxShape) >= 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       select
+
+  /*!
+    \param start  -- Offset of the selection, rank() elements.
+    \param extend -- Extend the dataset if the selection reaches beyond its
+           current shape? Otherwise such a selection is rejected.
+
+    \return status -- Status of the operation; returns \e false if the selection
+            cannot be applied.
+  */
+  bool HDF5AccessPlan::select (hsize_t const start[],
+			       bool const &extend)
+  {
+    bool extendDataset = false;
+    hsize_t shape[HDF5ACCESSPLAN_MAX_RANK];
+
+    itsSelected = false;
+
+    if (!isValid()) {
+      std::cerr << "[HDF5AccessPlan::select] Plan has not been set up!"
+		<< std::endl;
+      return false;
+    }
+
+    for (unsigned int n=0; n<itsRank; ++n) {
+      itsStart[n] = start[n];
+      shape[n]    = itsShape[n];
+      if (start[n]+itsSpan[n] > itsShape[n]) {
+	if (!extend || (itsMaxShape[n] != H5S_UNLIMITED
+			&& start[n]+itsSpan[n] > itsMaxShape[n])) {
+	  std::cerr << "[HDF5AccessPlan::select] Selection exceeds the shape"
+		    << " of the dataset along axis " << n << "!" << std::endl;
+	  return false;
+	}
+	shape[n]      = start[n]+itsSpan[n];
+	extendDataset = true;
+      }
+    }
+
+    /* The dataset may have been extended elsewhere since the shape was cached:
+       start from its current extent and only grow the axes which need it */
+    if (extendDataset) {
+      hsize_t current[HDF5ACCESSPLAN_MAX_RANK];
+      hid_t dataspace = H5Dget_space (itsDataset);
+      bool ok         = H5Sget_simple_extent_dims (dataspace, current, NULL) >= 0;
+      H5Sclose (dataspace);
+
+      extendDataset = false;
+      for (unsigned int n=0; ok && n<itsRank; ++n) {
+	if (shape[n] > current[n]) {
+	  extendDataset = true;
+	} else {
+	  shape[n] = current[n];
+	}
+      }
+
+      if (!ok
+	  || (extendDataset && H5Dset_extent (itsDataset, shape) < 0)
+	  || H5Sset_extent_simple (itsFileSpace, itsRank, shape, itsMaxShape) < 0) {
+	std::cerr << "[HDF5AccessPlan::select] Error extending dataset!"
+		  << std::endl;
+	return false;
+      }
+      for (unsigned int n=0; n<itsRank; ++n) {
+	itsShape[n] = shape[n];
+      }
+    }
+
+    itsSelected = H5Sselect_hyperslab (itsFileSpace,
+				       H5S_SELECT_SET,
+				       itsStart,
+				       itsStride,
+				       itsCount,
+				       itsBlock) >= 0;
+
+    return itsSelected;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    setOffset
+
+  /*!
+    \param start  -- Offset of the selection.
+    \param extend -- Extend the dataset if the selection reaches beyond its
+           current shape?
+
+    \return status -- Status of the operation; returns \e false if the selection
+            cannot be applied.
+  */
+  bool HDF5AccessPlan::setOffset (std::vector<hsize_t> const &start,
+				  bool const &extend)
+  {
+    if (start.size() != itsRank) {
+      std::cerr << "[HDF5AccessPlan::setOffset] Offset does not match the rank"
+		<< " of the dataset!" << std::endl;
+      itsSelected = false;
+      return false;
+    }
+
+    return select (&start[0], extend);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    setOffset
+
+  /*!
+    \param start  -- Offset of the selection along the first axis; the offset
+           along all other axes is zero.
+    \param extend -- Extend the dataset if the selection reaches beyond its
+           current shape?
+
+    \return status -- Status of the operation; returns \e false if the selection
+            cannot be applied.
+  */
+  bool HDF5AccessPlan::setOffset (hsize_t const &start,
+				  bool const &extend)
+  {
+    hsize_t offset[HDF5ACCESSPLAN_MAX_RANK] = {0};
+
+    offset[0] = start;
+
+    return select (offset, extend);
+  }
+
+} // Namespace DAL -- end
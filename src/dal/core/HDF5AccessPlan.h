@@ -0,0 +1,276 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5ACCESSPLAN_H
+#define HDF5ACCESSPLAN_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "dalCommon.h"
+
+//! Highest rank of a dataset an access plan can be set up for
+#define HDF5ACCESSPLAN_MAX_RANK 4
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5AccessPlan
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief Repeated access to equally shaped selections of a dataset
+
+    \author agent
+
+    \date 2026/10/17
+
+    \test tHDF5AccessPlan.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>HDF5Dataset
+      <li>HDF5Hyperslab
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    HDF5Dataset::readData() and HDF5Dataset::writeData() set up a new hyperslab
+    selection and memory dataspace for every call, which is the dominant cost
+    when reading many small slices of a dataset, e.g. a few time samples of a
+    Stokes dataset at a time. An access plan does this work only once: the
+    shape of the selection (stride, count and block) is fixed when the plan is
+    set up, together with a matching memory dataspace and a private copy of the
+    file dataspace. Afterwards only the offset of the selection is moved, which
+    is checked against the cached shape of the dataset without any memory being
+    allocated; all parameters are kept in arrays of fixed size, hence the plan is
+    restricted to datasets of rank up to \c HDF5ACCESSPLAN_MAX_RANK.
+
+    A write beyond the current end of the dataset extends it, provided this was
+    requested for setOffset(); the extension starts from the extent the
+    dataset has at that moment and only grows the axes the selection reaches
+    beyond, so that extensions by other plans are kept. The shape cached by
+    an HDF5Dataset object referring to the same dataset is not updated by
+    this; if the dataset is extended elsewhere, call refresh() before
+    accessing the new data.
+
+    <h3>Example(s)</h3>
+
+    Read a Stokes dataset 16 time samples at a time:
+    \code
+    std::vector<hsize_t> block (2);
+    block[0] = 16;
+    block[1] = nofChannels;
+
+    DAL::HDF5AccessPlan plan (dataset.objectID(), block);
+
+    for (hsize_t n=0; n<nofSamples; n+=16) {
+      plan.setOffset (n);
+      plan.read (buffer, H5T_NATIVE_FLOAT);
+    }
+    \endcode
+  */
+  class HDF5AccessPlan {
+
+    //! Identifier of the dataset (not owned by the plan)
+    hid_t itsDataset;
+    //! Copy of the file dataspace carrying the selection
+    hid_t itsFileSpace;
+    //! Memory dataspace matching the selection
+    hid_t itsMemorySpace;
+    //! Rank of the dataset
+    unsigned int itsRank;
+    //! Current shape of the dataset
+    hsize_t itsShape[HDF5ACCESSPLAN_MAX_RANK];
+    //! Maximum shape of the dataset
+    hsize_t itsMaxShape[HDF5ACCESSPLAN_MAX_RANK];
+    //! Offset of the selection
+    hsize_t itsStart[HDF5ACCESSPLAN_MAX_RANK];
+    //! Stride of the selection
+    hsize_t itsStride[HDF5ACCESSPLAN_MAX_RANK];
+    //! Number of blocks selected along each axis
+    hsize_t itsCount[HDF5ACCESSPLAN_MAX_RANK];
+    //! Size of a block
+    hsize_t itsBlock[HDF5ACCESSPLAN_MAX_RANK];
+    //! Number of elements spanned by the selection along each axis
+    hsize_t itsSpan[HDF5ACCESSPLAN_MAX_RANK];
+    //! Is a valid selection in place?
+    bool itsSelected;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    HDF5AccessPlan ();
+
+    //! Argumented constructor
+    HDF5AccessPlan (hid_t const &dataset,
+		    std::vector<hsize_t> const &block);
+
+    //! Argumented constructor
+    HDF5AccessPlan (hid_t const &dataset,
+		    std::vector<hsize_t> const &stride,
+		    std::vector<hsize_t> const &count,
+		    std::vector<hsize_t> const &block);
+
+    // === Destruction ==========================================================
+
+    //! Destructor
+    ~HDF5AccessPlan ();
+
+    // === Parameter access =====================================================
+
+    //! Has the plan been set up successfully?
+    inline bool isValid () const {
+      return itsMemorySpace >= 0;
+    }
+
+    //! Rank of the dataset
+    inline unsigned int rank () const {
+      return itsRank;
+    }
+
+    //! Current shape of the dataset
+    std::vector<hsize_t> shape () const;
+
+    //! Current offset of the selection
+    std::vector<hsize_t> start () const;
+
+    //! Number of elements in the selection
+    hsize_t nofDatapoints () const;
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5AccessPlan.
+    */
+    inline std::string className () const {
+      return "HDF5AccessPlan";
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    // === Methods ==============================================================
+
+    //! Set up the plan for selections of a given shape
+    bool setup (hid_t const &dataset,
+		std::vector<hsize_t> const &block);
+
+    //! Set up the plan for selections of a given shape
+    bool setup (hid_t const &dataset,
+		std::vector<hsize_t> const &stride,
+		std::vector<hsize_t> const &count,
+		std::vector<hsize_t> const &block);
+
+    //! Update the cached shape after the dataset has been extended elsewhere
+    bool refresh ();
+
+    //! Move the selection to a new offset
+    bool setOffset (std::vector<hsize_t> const &start,
+		    bool const &extend=false);
+
+    //! Move the selection to a new offset along the first axis
+    bool setOffset (hsize_t const &start,
+		    bool const &extend=false);
+
+    /*!
+      \brief Read the data of the current selection
+
+      \retval data    -- Array of nofDatapoints() elements.
+      \param datatype -- Type of the elements in memory.
+
+      \return status -- Status of the operation; returns \e false if no valid
+              selection is in place or reading failed.
+    */
+    template <class T>
+      inline bool read (T data[],
+			hid_t const &datatype)
+      {
+	if (!itsSelected) {
+	  std::cerr << "[HDF5AccessPlan::read] No valid selection!" << std::endl;
+	  return false;
+	}
+	return H5Dread (itsDataset,
+			datatype,
+			itsMemorySpace,
+			itsFileSpace,
+			H5P_DEFAULT,
+			data) >= 0;
+      }
+
+    /*!
+      \brief Write data to the current selection
+
+      \param data     -- Array of nofDatapoints() elements.
+      \param datatype -- Type of the elements in memory.
+
+      \return status -- Status of the operation; returns \e false if no valid
+              selection is in place or writing failed.
+    */
+    template <class T>
+      inline bool write (T const data[],
+			 hid_t const &datatype)
+      {
+	if (!itsSelected) {
+	  std::cerr << "[HDF5AccessPlan::write] No valid selection!" << std::endl;
+	  return false;
+	}
+	return H5Dwrite (itsDataset,
+			 datatype,
+			 itsMemorySpace,
+			 itsFileSpace,
+			 H5P_DEFAULT,
+			 data) >= 0;
+      }
+
+  private:
+
+    //! Initialize the internal parameters
+    void init ();
+
+    //! Release the dataspaces
+    void destroy ();
+
+    //! Apply the selection at a new offset
+    bool select (hsize_t const start[],
+		 bool const &extend);
+
+    //! Unimplemented, the plan holds HDF5 object identifiers
+    HDF5AccessPlan (HDF5AccessPlan const &other);
+
+    //! Unimplemented, the plan holds HDF5 object identifiers
+    HDF5AccessPlan & operator= (HDF5AccessPlan const &other);
+
+  }; // Class HDF5AccessPlan -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5ACCESSPLAN_H */
@@ -594,9 +594,15 @@ namespace DAL { // Namespace DAL -- begin
     */
     
     if (status) {
+      /* Variable-length strings are passed on as array of C strings */
+      std::vector<const char*> buffer (size);
+      for (unsigned int n=0; n<size; ++n) {
+	buffer[n] = data[n].c_str();
+      }
+      HDF5Object::close (datatype);
       datatype = H5Aget_type(attribute);
       /* Write the data to the attribute ... */
-      h5err = H5Awrite (attribute, datatype, data);
+      h5err = H5Awrite (attribute, datatype, &buffer[0]);
       /* ... and check the return value of the operation */
       if (h5err<0) {
 	std::cerr << "[HDF5Attribute::write]"
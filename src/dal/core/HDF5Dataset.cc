@@ -161,7 +161,7 @@ namespace DAL {
 
     /* Check dimensions of the input array */
     if (chunksize.empty() || chunksize.size() != rank) {
-      itsChunking = itsShape;
+      itsChunking = itsStoragePolicy.chunking (itsShape, H5Tget_size(itsDatatype));
     } else {
       itsChunking = chunksize;
     }
@@ -195,6 +195,7 @@ namespace DAL {
     itsShape.clear();
     itsChunking.clear();
     itsHyperslab.clear();
+    itsHyperslab.reserve(HDF5DATASET_MAX_HYPERSLABS);
   }
 
   //_____________________________________________________________________________
@@ -240,6 +241,19 @@ namespace DAL {
 	  HDF5Dataspace::shape (itsLocation, itsShape);
 	  // Retrieve the size of chunks for the raw data
 	  status = getChunksize ();
+	  // Reopen with a larger chunk cache, if required
+	  if (itsLayout == H5D_CHUNKED) {
+	    hid_t accessList = itsStoragePolicy.accessProperties (itsShape,
+								  itsChunking,
+								  H5Tget_size(itsDatatype));
+	    if (accessList != H5P_DEFAULT) {
+	      H5Dclose (itsLocation);
+	      itsLocation = H5Dopen (location,
+				     name.c_str(),
+				     accessList);
+	      H5Pclose (accessList);
+	    }
+	  }
 	} else {
 	  std::cerr << "[HDF5Dataset::open] Error opening dataset "
 		    << name << std::endl;
@@ -282,6 +296,58 @@ namespace DAL {
     return status;
   }
   
+  //_____________________________________________________________________________
+  //                                                                         open
+
+  /*!
+    \param location  -- Identifier of the location to which the to be opened
+           structure is attached.
+    \param name      -- Name of the dataset to be opened.
+    \param policy    -- Storage policy, setting the size of the chunk cache.
+    \param createNew -- Create the dataset, if it does not exist yet?
+
+    \return status -- Status of the operation; returns \c false in case an error
+            was encountered.
+  */
+  bool HDF5Dataset::open (hid_t const &location,
+			  std::string const &name,
+			  HDF5StoragePolicy const &policy,
+			  bool const &createNew)
+  {
+    setStoragePolicy (policy);
+    return open (location, name, createNew);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                       create
+  
+  /*!
+    \param location -- Identifier for the location at which the dataset is about
+           to be created.
+    \param name     -- Name of the dataset.
+    \param shape    -- Shape of the dataset.
+    \param policy   -- Storage policy, setting chunking, filters and chunk cache.
+    \param datatype -- Datatype for the elements within the Dataset
+    \return status  -- Status of the operation; returns \c false in case an error
+            was encountered.
+  */
+  bool HDF5Dataset::create (hid_t const &location,
+			    std::string const &name,
+			    std::vector<hsize_t> const &shape,
+			    HDF5StoragePolicy const &policy,
+			    hid_t const &datatype)
+  {
+    std::vector<hsize_t> chunksize;
+
+    setStoragePolicy (policy);
+
+    return create (location,
+		   name,
+		   shape,
+		   chunksize,
+		   datatype);
+  }
+    
   //_____________________________________________________________________________
   //                                                                       create
   
@@ -320,7 +386,8 @@ namespace DAL {
            to be created.
     \param name      -- Name of the dataset.
     \param shape     -- Shape of the dataset.
-    \param chunksize -- Chunk size for extendible array.
+    \param chunksize -- Chunk size for extendible array; if empty, the chunk
+           size is chosen by the storage policy of the dataset.
     \param datatype  -- Datatype for the elements within the Dataset
     \return status   -- Status of the operation; returns \c false in case an
             error was encountered.
@@ -352,14 +419,10 @@ namespace DAL {
     int rank = shape.size();
     hsize_t dims [rank];
     hsize_t maxdims [rank];
-    hsize_t chunkdims [rank];
-    hid_t creationProperties;
-    herr_t h5error;
 
     for (int n(0); n<rank; ++n) {
       dims[n]      = itsShape[n];
       maxdims[n]   = H5S_UNLIMITED;
-      chunkdims[n] = itsChunking[n];
     }
 
     // Set up the dataspace
@@ -369,31 +432,19 @@ namespace DAL {
 		  << std::endl;
       return false;
     }
-    // Create the dataset creation property list
-    creationProperties  = H5Pcreate (H5P_DATASET_CREATE);
-    // Set the chunk size
-    h5error     = H5Pset_chunk (creationProperties, rank, chunkdims);
-    // Create the Dataset ...
-    itsLocation  = H5Dcreate (location,
-			      itsName.c_str(),
-			      itsDatatype,
-			      itsDataspace,
-			      H5P_DEFAULT,
-			      creationProperties,
-			      H5P_DEFAULT);
+    // Create the Dataset, with chunking and filters as set by the policy ...
+    itsLocation  = itsStoragePolicy.create (location,
+					    itsName,
+					    itsDatatype,
+					    itsDataspace,
+					    itsChunking);
     // ... and check it
     if (!H5Iis_valid(itsLocation)) {
       std::cerr << "[HDF5Dataset::create] Failed to create dataset!"
 		  << std::endl;
       return false;
     }
-    
-    // Release HDF5 object identifiers
-    if (H5Iis_valid(creationProperties)) {
-      H5Pclose (creationProperties);
-    } else {
-      status = false;
-    }
+    itsLayout = H5D_CHUNKED;
     
     return status;
   }
@@ -510,6 +561,13 @@ namespace DAL {
 
     \return status -- Status of the operation; returns \e false in case an error
             was encountered.
+
+    The book-keeping is bounded: a hyperslab with <tt>H5S_SELECT_SET</tt>
+    replaces the previous selection, while of the hyperslabs combined with it
+    only the last <tt>HDF5DATASET_MAX_HYPERSLABS-1</tt> are kept. Once the list
+    has been filled, no further memory is allocated for a plain selection.
+    The shape of the dataset is not queried again, but only updated if the
+    dataset is extended.
    */
   bool HDF5Dataset::setHyperslab (HDF5Hyperslab &slab,
 				  bool const &resizeDataset)
@@ -524,23 +582,22 @@ namespace DAL {
 	*/
 	status = slab.setHyperslab (itsLocation,
 				    itsDataspace,
+				    itsShape,
 				    resizeDataset);
 	/* Book-keeping: store the assigned hyperslab for later inspection. */
 	
 	switch (slab.selection()) {
 	case H5S_SELECT_SET:
-	  itsHyperslab.empty();
-	  itsHyperslab.push_back(slab);
+	  itsHyperslab.resize(1);
+	  itsHyperslab[0] = slab;
 	  break;
 	default:
+	  if (itsHyperslab.size() >= HDF5DATASET_MAX_HYPERSLABS) {
+	    itsHyperslab.erase(itsHyperslab.begin()+1);
+	  }
 	  itsHyperslab.push_back(slab);
 	  break;
 	};
-	
-	/* As the dataset might have been resized, the "shape" parameter needs to be
-	   updated to the current value.
-	*/
-	HDF5Dataspace::shape(itsLocation, itsShape);
       } else {
 	std::cerr << "[HDF5Dataset::setHyperslab]"
 		  << " Unable to select hyperslab - invalid HDF5 dataspace!"
@@ -555,6 +612,40 @@ namespace DAL {
     return status;
   }
   
+  //_____________________________________________________________________________
+  //                                                                  memoryShape
+  
+  /*!
+    \param slab  -- Hyperslab selected from the dataset.
+    \retval dims -- Shape of the memory buffer, <tt>count*block</tt> along each
+           axis; must provide space for rank() elements.
+
+    \return status -- Returns \e false if neither count nor block of the
+            hyperslab are defined.
+  */
+  bool HDF5Dataset::memoryShape (HDF5Hyperslab const &slab,
+				 hsize_t dims[])
+  {
+    unsigned int nelem            = itsShape.size();
+    std::vector<int> const &count = slab.count();
+    std::vector<int> const &block = slab.block();
+    bool haveCount                = (count.size() == nelem);
+    bool haveBlock                = (block.size() == nelem);
+
+    if (!haveCount && !haveBlock) {
+      std::cerr << "[HDF5Dataset::memoryShape]"
+		<< " both block and count parameters undefined!" 
+		<< std::endl;
+      return false;
+    }
+
+    for (unsigned int n(0); n<nelem; ++n) {
+      dims[n] = (haveCount ? count[n] : 1) * (haveBlock ? block[n] : 1);
+    }
+
+    return true;
+  }
+
   //_____________________________________________________________________________
   //                                                                 setHyperslab
   
@@ -730,6 +821,8 @@ namespace DAL {
     os << "-- Dataset shape          = " << itsShape            << std::endl;
     os << "-- Layout of the raw data = " << itsLayout           << std::endl;
     os << "-- Chunk size             = " << itsChunking         << std::endl;
+    os << "-- Access pattern (chunks)= " << itsStoragePolicy.accessPatternName() << std::endl;
+    os << "-- nof. filters           = " << itsStoragePolicy.nofFilters()        << std::endl;
     os << "-- nof. datapoints        = " << nofDatapoints()     << std::endl;
     os << "-- nof. active hyperslabs = " << itsHyperslab.size() << std::endl;
   }
@@ -27,9 +27,12 @@
 
 #include "dalCommon.h"
 #include "HDF5Attribute.h"
+#include "HDF5StoragePolicy.h"
 #include <data_common/HDF5Hyperslab.h>
 
 #define H5S_CHUNKSIZE_MAX  ((uint32_t)(-1))  /* (4GB - 1) */
+//! Number of hyperslabs kept for inspection, see HDF5Dataset::hyperslabs()
+#define HDF5DATASET_MAX_HYPERSLABS 8
 
 namespace DAL {
   
@@ -57,6 +60,7 @@ namespace DAL {
     <ul type="square">
       <li>DAL::HDF5Hyperslab
       <li>DAL::HDF5Object
+      <li>DAL::HDF5StoragePolicy
     </ul>
 
     <h3>Synopsis</h3>
@@ -131,6 +135,10 @@ namespace DAL {
       selection within that dataspace.
     </ol>
 
+    The chunk shape of a newly created dataset -- unless given explicitly --,
+    the filters applied to its chunks and the size of the chunk cache are set by
+    a DAL::HDF5StoragePolicy, see setStoragePolicy().
+
     Furthermore HDF5Dataset encapsulates a number of functions to inspect and
     return properties of the dataset:
     <ul>
@@ -263,8 +271,10 @@ namespace DAL {
     H5D_layout_t itsLayout;
     //! Chunk size for extendible array
     std::vector<hsize_t> itsChunking;
-    //! Hyperslabs for the dataspace attached to the dataset
+    //! Last hyperslabs applied to the dataspace attached to the dataset
     std::vector<DAL::HDF5Hyperslab> itsHyperslab;
+    //! Chunking, filters and chunk cache of the dataset
+    HDF5StoragePolicy itsStoragePolicy;
 
   public:
     
@@ -317,6 +327,16 @@ namespace DAL {
       return itsChunking;
     }
     
+    //! Get the policy for chunking, filters and chunk cache
+    inline HDF5StoragePolicy storagePolicy () const {
+      return itsStoragePolicy;
+    }
+
+    //! Set the policy for chunking, filters and chunk cache of datasets to be created or opened
+    inline void setStoragePolicy (HDF5StoragePolicy const &policy) {
+      itsStoragePolicy = policy;
+    }
+    
     //! Get the rank (i.e. the number of axes) of the dataset
     inline unsigned int rank () const {
       return itsShape.size();
@@ -355,7 +375,20 @@ namespace DAL {
 			 std::vector<hsize_t> const &shape,
 			 hid_t const &datatype=H5T_NATIVE_DOUBLE);
     
-    //! Get the Hyperslabs for the dataspace attached to the dataset
+    //! Create the dataset, with chunking and filters set by a storage policy
+    bool create (hid_t const &location,
+		 std::string const &name,
+		 std::vector<hsize_t> const &shape,
+		 HDF5StoragePolicy const &policy,
+		 hid_t const &datatype=H5T_NATIVE_DOUBLE);
+    
+    //! Open the dataset, with the chunk cache set by a storage policy
+    bool open (hid_t const &location,
+	       std::string const &name,
+	       HDF5StoragePolicy const &policy,
+	       bool const &createNew=false);
+    
+    //! Get the last (at most HDF5DATASET_MAX_HYPERSLABS) Hyperslabs applied to the dataset
     inline std::vector<DAL::HDF5Hyperslab> hyperslabs () const {
       return itsHyperslab;
     }
@@ -579,7 +612,12 @@ namespace DAL {
     //! Select a hyperslab for the dataspace attached to the dataset
     bool setHyperslab (HDF5Hyperslab &slab,
 		       bool const &resizeDataset);
+    //! Get the shape of the memory buffer matching a hyperslab
+    bool memoryShape (HDF5Hyperslab const &slab,
+		      hsize_t dims[]);
     
+  public:
+
     /*!
       \brief Read the data
       \param data     -- Array with the data to be written.
@@ -588,51 +626,38 @@ namespace DAL {
       \return status  -- Status of the operation; returns \e false in case an
               error was encountered.
     */
-
-  public:
-
     template <class T>
       bool readData (T data[],
 		     HDF5Hyperslab &slab,
 		     hid_t const &datatype)
       {
-	bool status (true);
-	
 	/* Set the Hyperslab for the dataspace attached to a dataset */
-	status = setHyperslab (slab, false);
-	
-	if (status) {
-	  /* Local variables */
-	  herr_t h5error          = 0;
-	  unsigned int nelem      = rank();
-	  hsize_t * dimensions    = new hsize_t[nelem];
-	  std::vector<int> stride = slab.stride();
-	  std::vector<int> block  = slab.block();
-	  /* Setup the memory space */
-	  for (unsigned int n=0; n<nelem; ++n) {
-	    dimensions[n] = block[n];
-	  }
-	  hid_t memorySpace = H5Screate_simple (nelem,
-						dimensions,
-						NULL);
-	  /* Read the data from the dataset */
-	  h5error = H5Dread (itsLocation,
-			     datatype,
-			     memorySpace,
-			     itsDataspace,
-			     H5P_DEFAULT,
-			     data);
-	  /* Release allocated memory */
-	  delete [] dimensions;
-	  /* Release HDF5 object identifier */
-	  HDF5Object::close (memorySpace);
-	} else {
+	if (!setHyperslab (slab, false)) {
 	  std::cerr << "[HDF5Dataset::readData] Failed to properly set up Hyperslab!"
 		    << std::endl;
-	  status = false;
+	  return false;
+	}
+
+	/* Setup the memory space */
+	unsigned int nelem = rank();
+	hsize_t dims[nelem];
+	if (!memoryShape (slab, dims)) {
+	  return false;
 	}
-	
-	return status;
+	hid_t memorySpace = H5Screate_simple (nelem,
+					      dims,
+					      NULL);
+	/* Read the data from the dataset */
+	herr_t h5error = H5Dread (itsLocation,
+				  datatype,
+				  memorySpace,
+				  itsDataspace,
+				  H5P_DEFAULT,
+				  data);
+	/* Release HDF5 object identifier */
+	H5Sclose (memorySpace);
+
+	return (h5error >= 0);
       }
 
     /*!
@@ -648,80 +673,39 @@ namespace DAL {
 		      HDF5Hyperslab &slab,
 		      hid_t const &datatype)
       {
-	bool status = true;
-
 	// Set the Hyperslab selection _____________________
 
-	status = setHyperslab (slab, true);
-	
-	if (status) {
-
-	  // Local variables _______________________________
+	if (!setHyperslab (slab, true)) {
+	  std::cerr << "[HDF5Dataset::writeDate] Failed to properly set up Hyperslab!"
+		    << std::endl;
+	  return false;
+	}
 
-	  unsigned int nofDatapoints (1);
-	  unsigned int nelem (rank());
-	  hsize_t dims[nelem];
-	  herr_t h5error;
-	  std::vector<int> block   = slab.block();
-	  std::vector<int> count   = slab.count();
-	  std::vector<hsize_t> end = slab.end();
+	// Set up memory space _____________________________
 
-	  // Set up memory space ___________________________
-	  
-	  if (count.empty()) {
-	    if (block.empty()) {
-	      // count=empty, block=empty
-	      std::cerr << "[HDF5Dataset::writeDate]"
-			<< " both block and count parameters undefined!" 
-			<< std::endl;
-	      return false;
-	    } else {
-	      // count=empty, block=[..]
-	      for (unsigned int n(0); n<nelem; ++n) {
-		dims[n] = block[n];
-		nofDatapoints *= dims[n];
-	      }
-	    }
-	  } else {
-	    if (block.empty()) {
-	      // count=[..], block=empty
-	      for (unsigned int n(0); n<nelem; ++n) {
-		dims[n] = count[n];
-		nofDatapoints *= dims[n];
-	      }
-	    } else {
-	      // count=[..], block=[..]
-	      for (unsigned int n(0); n<nelem; ++n) {
-		dims[n] = block[n]*count[n];
-		nofDatapoints *= dims[n];
-	      }
-	    }
-	  }
-
-	  hid_t memspace = H5Screate_simple (nelem,
-					     dims,
-					     dims);
+	unsigned int nelem = rank();
+	hsize_t dims[nelem];
+	if (!memoryShape (slab, dims)) {
+	  return false;
+	}
+	hid_t memspace = H5Screate_simple (nelem,
+					   dims,
+					   dims);
 	  
-	  // Write data to dataset _________________________
+	// Write data to dataset ___________________________
 	  
-	  h5error = H5Dwrite (itsLocation,
-			      datatype,
-			      memspace,
-			      itsDataspace,
-			      H5P_DEFAULT,
-			      data);
+	herr_t h5error = H5Dwrite (itsLocation,
+				   datatype,
+				   memspace,
+				   itsDataspace,
+				   H5P_DEFAULT,
+				   data);
+
+	// Release memory space ____________________________
 	  
+	H5Sclose (memspace);
 
-	  // Release memory space __________________________
-	  
-	  HDF5Object::close (H5Sclose (memspace));
-	} else {
-	  std::cerr << "[HDF5Dataset::writeDate] Failed to properly set up Hyperslab!"
-		    << std::endl;
-	  status = false;
-	}
-	
-	return status;
+	return (h5error >= 0);
       }
 
   }; // end class HDF5Dataset
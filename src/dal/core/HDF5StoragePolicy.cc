@@ -0,0 +1,429 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "HDF5StoragePolicy.h"
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                            HDF5StoragePolicy
+
+  /*!
+    \param chunkBytes -- Target size of a chunk [bytes].
+    \param pattern    -- Hint on how the data are accessed.
+  */
+  HDF5StoragePolicy::HDF5StoragePolicy (size_t const &chunkBytes,
+					AccessPattern const &pattern)
+  {
+    setChunkBytes (chunkBytes);
+    itsAccessPattern   = pattern;
+    itsShuffle         = false;
+    itsDeflateLevel    = -1;
+    itsChunkCacheBytes = 0;
+  }
+
+  // ============================================================================
+  //
+  //  Parameter access
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                            accessPatternName
+
+  std::string HDF5StoragePolicy::accessPatternName () const
+  {
+    switch (itsAccessPattern) {
+    case TimeMajor:
+      return "TimeMajor";
+    case ChannelMajor:
+      return "ChannelMajor";
+    default:
+      return "Balanced";
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    addFilter
+
+  /*!
+    \param id         -- Identifier of the filter, as registered with the HDF5
+           library.
+    \param parameters -- Auxiliary parameters passed on to the filter.
+    \param flags      -- <tt>H5Z_FLAG_OPTIONAL</tt> if the dataset may be
+           created without the filter, should it not be available;
+           <tt>H5Z_FLAG_MANDATORY</tt> otherwise.
+  */
+  void HDF5StoragePolicy::addFilter (H5Z_filter_t const &id,
+				     std::vector<unsigned int> const &parameters,
+				     unsigned int const &flags)
+  {
+    Filter filter;
+
+    filter.id         = id;
+    filter.flags      = flags;
+    filter.parameters = parameters;
+
+    itsFilters.push_back (filter);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   nofFilters
+
+  unsigned int HDF5StoragePolicy::nofFilters () const
+  {
+    unsigned int nofFilters = itsFilters.size();
+
+    if (itsShuffle) {
+      ++nofFilters;
+    }
+    if (itsDeflateLevel >= 0) {
+      ++nofFilters;
+    }
+
+    return nofFilters;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5StoragePolicy::summary (std::ostream &os)
+  {
+    os << "[HDF5StoragePolicy] Summary of internal parameters." << std::endl;
+    os << "-- Chunk size [bytes]       = " << itsChunkBytes       << std::endl;
+    os << "-- Access pattern           = " << accessPatternName() << std::endl;
+    os << "-- Shuffle filter           = " << itsShuffle          << std::endl;
+    os << "-- Deflate level            = " << itsDeflateLevel     << std::endl;
+    os << "-- Further filters          = " << itsFilters.size()   << std::endl;
+    os << "-- Chunk cache [bytes]      = " << itsChunkCacheBytes  << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                     chunking
+
+  /*!
+    \param shape        -- (Initial) shape of the dataset.
+    \param datatypeSize -- Size of a single element of the dataset [bytes].
+
+    \return chunking -- Shape of a chunk; every axis has at least one element
+            and a chunk never exceeds the 4 GB allowed by the HDF5 library.
+  */
+  std::vector<hsize_t> HDF5StoragePolicy::chunking (std::vector<hsize_t> const &shape,
+						    size_t const &datatypeSize) const
+  {
+    unsigned int rank = shape.size();
+    std::vector<hsize_t> chunk (rank, 1);
+
+    if (rank == 0) {
+      return chunk;
+    }
+
+    hsize_t nofElements = itsChunkBytes/(datatypeSize > 0 ? datatypeSize : 1);
+    hsize_t maxElements = ((uint64_t)0xffffffff)/(datatypeSize > 0 ? datatypeSize : 1);
+    hsize_t nofTrailing = 1;
+    unsigned int n;
+
+    if (nofElements < 1) {
+      nofElements = 1;
+    } else if (nofElements > maxElements) {
+      nofElements = maxElements;
+    }
+
+    /* Extent of the chunk along the trailing axes */
+    for (n=1; n<rank; ++n) {
+      hsize_t extent = shape[n] > 0 ? shape[n] : 1;
+      switch (itsAccessPattern) {
+      case ChannelMajor:
+	chunk[n] = extent < 16 ? extent : 16;
+	break;
+      default:
+	chunk[n] = extent;
+	break;
+      }
+      nofTrailing *= chunk[n];
+    }
+
+    /* Halve the longest trailing axis until a single row fits ... */
+    while (nofTrailing > nofElements) {
+      unsigned int longest = 1;
+      for (n=2; n<rank; ++n) {
+	if (chunk[n] > chunk[longest]) {
+	  longest = n;
+	}
+      }
+      nofTrailing /= chunk[longest];
+      chunk[longest] = (chunk[longest]+1)/2;
+      nofTrailing *= chunk[longest];
+    }
+
+    /* ... and fill up the chunk along the first axis */
+    chunk[0] = nofElements/nofTrailing;
+
+    if (itsAccessPattern == Balanced && rank > 1) {
+      /* Keep the chunk from becoming much longer than wide */
+      hsize_t extent = shape[0] > 0 ? shape[0] : 1;
+      while (chunk[0] < extent/2 && nofTrailing > 1) {
+	unsigned int longest = 1;
+	for (n=2; n<rank; ++n) {
+	  if (chunk[n] > chunk[longest]) {
+	    longest = n;
+	  }
+	}
+	if (chunk[longest] < 2 || chunk[longest] < chunk[0]) {
+	  break;
+	}
+	nofTrailing /= chunk[longest];
+	chunk[longest] = (chunk[longest]+1)/2;
+	nofTrailing *= chunk[longest];
+	chunk[0] = nofElements/nofTrailing;
+      }
+    }
+
+    /* A chunk only partially written to is allocated nevertheless, so do not
+       exceed a length along the first axis which is already known */
+    if (rank > 1 && shape[0] > 1 && chunk[0] > shape[0]) {
+      chunk[0] = shape[0];
+    }
+
+    if (chunk[0] < 1) {
+      chunk[0] = 1;
+    }
+
+    return chunk;
+  }
+
+  //_____________________________________________________________________________
+  //                                                        setCreationProperties
+
+  /*!
+    \param creationProperties -- Dataset creation property list.
+    \param chunking           -- Shape of a chunk.
+
+    \return status -- Status of the operation; returns \e false if the chunking
+            could not be set or a mandatory filter is not available.
+  */
+  bool HDF5StoragePolicy::setCreationProperties (hid_t const &creationProperties,
+						 std::vector<hsize_t> const &chunking) const
+  {
+    bool status = true;
+    int rank    = chunking.size();
+    hsize_t chunkdims[rank];
+
+    for (int n=0; n<rank; ++n) {
+      chunkdims[n] = chunking[n];
+    }
+
+    if (H5Pset_chunk (creationProperties, rank, chunkdims) < 0) {
+      std::cerr << "[HDF5StoragePolicy::setCreationProperties]"
+		<< " Failed to set the chunk size!" << std::endl;
+      return false;
+    }
+
+    /* The shuffle filter only helps a subsequent compression */
+    if (itsShuffle) {
+      if (H5Pset_shuffle (creationProperties) < 0) {
+	std::cerr << "[HDF5StoragePolicy::setCreationProperties]"
+		  << " Failed to set the shuffle filter!" << std::endl;
+	status = false;
+      }
+    }
+
+    if (itsDeflateLevel >= 0) {
+      if (H5Zfilter_avail (H5Z_FILTER_DEFLATE) <= 0) {
+	std::cerr << "[HDF5StoragePolicy::setCreationProperties]"
+		  << " Deflate filter not available, data are not compressed!"
+		  << std::endl;
+      } else if (H5Pset_deflate (creationProperties, itsDeflateLevel) < 0) {
+	std::cerr << "[HDF5StoragePolicy::setCreationProperties]"
+		  << " Failed to set the deflate filter!" << std::endl;
+	status = false;
+      }
+    }
+
+    for (unsigned int n=0; n<itsFilters.size(); ++n) {
+      Filter const &filter = itsFilters[n];
+      if (H5Zfilter_avail (filter.id) <= 0) {
+	std::cerr << "[HDF5StoragePolicy::setCreationProperties]"
+		  << " Filter " << filter.id << " not available!" << std::endl;
+	if (!(filter.flags & H5Z_FLAG_OPTIONAL)) {
+	  status = false;
+	}
+	continue;
+      }
+      if (H5Pset_filter (creationProperties,
+			 filter.id,
+			 filter.flags,
+			 filter.parameters.size(),
+			 filter.parameters.empty() ? NULL : &filter.parameters[0]) < 0) {
+	std::cerr << "[HDF5StoragePolicy::setCreationProperties]"
+		  << " Failed to set filter " << filter.id << "!" << std::endl;
+	status = false;
+      }
+    }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                             accessProperties
+
+  /*!
+    \param shape        -- Shape of the dataset.
+    \param chunking     -- Shape of a chunk.
+    \param datatypeSize -- Size of a single element of the dataset [bytes].
+
+    \return accessProperties -- Dataset access property list, which has to be
+            released by the caller; <tt>H5P_DEFAULT</tt> if the default chunk
+            cache of the HDF5 library is sufficient.
+  */
+  hid_t HDF5StoragePolicy::accessProperties (std::vector<hsize_t> const &shape,
+					     std::vector<hsize_t> const &chunking,
+					     size_t const &datatypeSize) const
+  {
+    size_t cacheBytes = itsChunkCacheBytes;
+    uint64_t chunkBytes = datatypeSize;
+
+    if (chunking.empty() || chunking.size() != shape.size()) {
+      return H5P_DEFAULT;
+    }
+
+    /* Size of a single chunk and of a row of chunks along the trailing axes */
+    uint64_t nofChunks = 1;
+    for (unsigned int n=0; n<chunking.size(); ++n) {
+      chunkBytes *= chunking[n];
+      if (n > 0 && chunking[n] > 0) {
+	nofChunks *= (shape[n]+chunking[n]-1)/chunking[n];
+      }
+    }
+
+    if (cacheBytes == 0) {
+      uint64_t rowBytes = nofChunks*chunkBytes;
+      if (rowBytes <= DEFAULT_CHUNK_CACHE_BYTES) {
+	return H5P_DEFAULT;
+      }
+      cacheBytes = rowBytes < MAX_CHUNK_CACHE_BYTES ? rowBytes : MAX_CHUNK_CACHE_BYTES;
+    }
+
+    /* The number of hash slots should be a prime, about 100 times the number
+       of chunks held by the cache */
+    size_t nofSlots = 100*(cacheBytes/(chunkBytes > 0 ? chunkBytes : 1) + 1);
+    if (nofSlots < 521) {
+      nofSlots = 521;
+    }
+    bool isPrime = false;
+    while (!isPrime) {
+      isPrime = true;
+      for (size_t d=2; d*d<=nofSlots; ++d) {
+	if (nofSlots%d == 0) {
+	  isPrime = false;
+	  ++nofSlots;
+	  break;
+	}
+      }
+    }
+
+    hid_t propertyList = H5Pcreate (H5P_DATASET_ACCESS);
+    if (H5Pset_chunk_cache (propertyList,
+			    nofSlots,
+			    cacheBytes,
+			    H5D_CHUNK_CACHE_W0_DEFAULT) < 0) {
+      H5Pclose (propertyList);
+      return H5P_DEFAULT;
+    }
+
+    return propertyList;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       create
+
+  /*!
+    \param location  -- Identifier for the location at which the dataset is
+           about to be created.
+    \param name      -- Name of the dataset.
+    \param datatype  -- Datatype of the elements within the dataset.
+    \param dataspace -- Dataspace of the dataset, which should be extendible.
+    \param chunking  -- Shape of a chunk; if empty, it is derived from the
+           shape of the dataspace by chunking().
+
+    \return datasetID -- Identifier of the new dataset, negative if it could not
+            be created.
+  */
+  hid_t HDF5StoragePolicy::create (hid_t const &location,
+				   std::string const &name,
+				   hid_t const &datatype,
+				   hid_t const &dataspace,
+				   std::vector<hsize_t> const &chunking) const
+  {
+    int rank = H5Sget_simple_extent_ndims (dataspace);
+
+    if (rank < 1) {
+      std::cerr << "[HDF5StoragePolicy::create] Invalid dataspace for "
+		<< name << std::endl;
+      return -1;
+    }
+
+    hsize_t dims[rank];
+    H5Sget_simple_extent_dims (dataspace, dims, NULL);
+
+    std::vector<hsize_t> shape (dims, dims+rank);
+    size_t datatypeSize        = H5Tget_size (datatype);
+    std::vector<hsize_t> chunk = chunking.size() == shape.size()
+      ? chunking : this->chunking (shape, datatypeSize);
+
+    hid_t creationList = H5Pcreate (H5P_DATASET_CREATE);
+    if (!setCreationProperties (creationList, chunk)) {
+      H5Pclose (creationList);
+      return -1;
+    }
+    hid_t accessList = accessProperties (shape, chunk, datatypeSize);
+
+    hid_t datasetID = H5Dcreate (location,
+				 name.c_str(),
+				 datatype,
+				 dataspace,
+				 H5P_DEFAULT,
+				 creationList,
+				 accessList);
+
+    H5Pclose (creationList);
+    if (accessList != H5P_DEFAULT) {
+      H5Pclose (accessList);
+    }
+
+    return datasetID;
+  }
+
+} // Namespace DAL -- end
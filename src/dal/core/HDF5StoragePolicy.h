@@ -0,0 +1,261 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5STORAGEPOLICY_H
+#define HDF5STORAGEPOLICY_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "dalCommon.h"
+
+//! Default size of a chunk [bytes]
+#define DEFAULT_CHUNK_BYTES 1048576
+//! Size of the chunk cache the HDF5 library assigns to a dataset [bytes]
+#define DEFAULT_CHUNK_CACHE_BYTES 1048576
+//! Upper limit for the chunk cache chosen automatically [bytes]
+#define MAX_CHUNK_CACHE_BYTES 268435456
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5StoragePolicy
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief How the raw data of a chunked dataset are laid out and filtered
+
+    \author agent
+
+    \date 2026/10/17
+
+    \test tHDF5StoragePolicy.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>HDF5 dataset creation and access property lists
+      (<tt>H5Pset_chunk</tt>, <tt>H5Pset_shuffle</tt>, <tt>H5Pset_deflate</tt>,
+      <tt>H5Pset_filter</tt>, <tt>H5Pset_chunk_cache</tt>)
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    All datasets written by the library are extendible along their first axis,
+    which is the time axis for both the TBB dipole datasets and the Stokes
+    datasets of beam-formed data. A policy derives the chunk shape of such a
+    dataset from a target size per chunk and a hint on how the data are
+    accessed:
+    <ul>
+      <li>\e Balanced -- the chunk spans the full extent of the dataset; if that
+      exceeds the target size, the longest axis is halved repeatedly; if it
+      falls short, the chunk is extended along the first axis.
+      <li>\e TimeMajor -- the chunk spans full rows (all channels), as many of
+      them as fit into the target size; suited for data written and read one
+      time step after the other.
+      <li>\e ChannelMajor -- the chunk spans a long stretch of time for a
+      narrow band of at most 16 channels; suited for reading the time series of
+      individual channels.
+    </ul>
+    For a 1-dim dataset the chunk is not limited by the current shape, as the
+    dataset is expected to grow; for a dataset of higher rank the first axis of
+    the chunk does not exceed the number of rows, if already known (i.e. more
+    than one), as a partially filled chunk takes its full size in the file.
+
+    Optionally the chunks are passed through the byte-shuffle and the deflate
+    filter, or any other filter registered with the HDF5 library (e.g. LZF or
+    bitshuffle, identified by their filter ID). Filters declared optional are
+    skipped with a warning if not available.
+
+    The HDF5 library caches 1 MB of chunks per open dataset; a chunk which does
+    not fit is read (and decompressed) again for every partial access. Unless
+    set explicitly, the chunk cache is therefore enlarged to hold all the
+    chunks along one row of the dataset, up to 256 MB.
+
+    <h3>Example(s)</h3>
+
+    Beam-formed data, compressed:
+    \code
+    DAL::HDF5StoragePolicy policy (DEFAULT_CHUNK_BYTES,
+                                   DAL::HDF5StoragePolicy::TimeMajor);
+    policy.setShuffle (true);
+    policy.setDeflate (1);
+
+    DAL::HDF5Dataset dataset;
+    dataset.create (location, "STOKES_0", shape, policy, H5T_NATIVE_FLOAT);
+    \endcode
+  */
+  class HDF5StoragePolicy {
+
+  public:
+
+    //! Hint on how the data of a dataset are accessed
+    enum AccessPattern {
+      //! Chunks of the overall shape of the dataset
+      Balanced,
+      //! Chunks spanning complete rows, i.e. all channels of a time step
+      TimeMajor,
+      //! Chunks spanning a long time range of a few channels
+      ChannelMajor
+    };
+
+  private:
+
+    //! Filter applied to the chunks, in addition to shuffle and deflate
+    struct Filter {
+      //! Identifier of the filter
+      H5Z_filter_t id;
+      //! Flags, e.g. H5Z_FLAG_OPTIONAL
+      unsigned int flags;
+      //! Auxiliary parameters of the filter
+      std::vector<unsigned int> parameters;
+    };
+
+    //! Target size of a chunk [bytes]
+    size_t itsChunkBytes;
+    //! Hint on how the data are accessed
+    AccessPattern itsAccessPattern;
+    //! Apply the byte-shuffle filter?
+    bool itsShuffle;
+    //! Compression level of the deflate filter, negative if not applied
+    int itsDeflateLevel;
+    //! Further filters
+    std::vector<Filter> itsFilters;
+    //! Size of the chunk cache [bytes], 0 for an automatic choice
+    size_t itsChunkCacheBytes;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Argumented constructor
+    explicit HDF5StoragePolicy (size_t const &chunkBytes=DEFAULT_CHUNK_BYTES,
+				AccessPattern const &pattern=Balanced);
+
+    // === Parameter access =====================================================
+
+    //! Get the target size of a chunk [bytes]
+    inline size_t chunkBytes () const {
+      return itsChunkBytes;
+    }
+
+    //! Set the target size of a chunk [bytes]
+    inline void setChunkBytes (size_t const &chunkBytes) {
+      itsChunkBytes = chunkBytes > 0 ? chunkBytes : 1;
+    }
+
+    //! Get the hint on how the data are accessed
+    inline AccessPattern accessPattern () const {
+      return itsAccessPattern;
+    }
+
+    //! Set the hint on how the data are accessed
+    inline void setAccessPattern (AccessPattern const &pattern) {
+      itsAccessPattern = pattern;
+    }
+
+    //! Get the name of the access pattern
+    std::string accessPatternName () const;
+
+    //! Is the byte-shuffle filter applied?
+    inline bool shuffle () const {
+      return itsShuffle;
+    }
+
+    //! Apply the byte-shuffle filter?
+    inline void setShuffle (bool const &shuffle) {
+      itsShuffle = shuffle;
+    }
+
+    //! Get the compression level of the deflate filter, negative if not applied
+    inline int deflateLevel () const {
+      return itsDeflateLevel;
+    }
+
+    //! Set the compression level (0-9) of the deflate filter, negative disables it
+    inline void setDeflate (int const &level) {
+      itsDeflateLevel = level > 9 ? 9 : level;
+    }
+
+    //! Add a filter registered with the HDF5 library
+    void addFilter (H5Z_filter_t const &id,
+		    std::vector<unsigned int> const &parameters=std::vector<unsigned int>(),
+		    unsigned int const &flags=H5Z_FLAG_OPTIONAL);
+
+    //! Get the number of filters applied to the chunks
+    unsigned int nofFilters () const;
+
+    //! Get the size of the chunk cache [bytes], 0 for an automatic choice
+    inline size_t chunkCacheBytes () const {
+      return itsChunkCacheBytes;
+    }
+
+    //! Set the size of the chunk cache [bytes], 0 for an automatic choice
+    inline void setChunkCacheBytes (size_t const &cacheBytes) {
+      itsChunkCacheBytes = cacheBytes;
+    }
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5StoragePolicy.
+    */
+    inline std::string className () const {
+      return "HDF5StoragePolicy";
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    // === Methods ==============================================================
+
+    //! Get the chunk shape for a dataset
+    std::vector<hsize_t> chunking (std::vector<hsize_t> const &shape,
+				   size_t const &datatypeSize) const;
+
+    //! Set up the chunking and filters within a dataset creation property list
+    bool setCreationProperties (hid_t const &creationProperties,
+				std::vector<hsize_t> const &chunking) const;
+
+    //! Get a dataset access property list with a suitable chunk cache
+    hid_t accessProperties (std::vector<hsize_t> const &shape,
+			    std::vector<hsize_t> const &chunking,
+			    size_t const &datatypeSize) const;
+
+    //! Create a chunked dataset
+    hid_t create (hid_t const &location,
+		  std::string const &name,
+		  hid_t const &datatype,
+		  hid_t const &dataspace,
+		  std::vector<hsize_t> const &chunking=std::vector<hsize_t>()) const;
+
+  }; // Class HDF5StoragePolicy -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5STORAGEPOLICY_H */
@@ -39,6 +39,30 @@ namespace DAL {
     datatype    = "UNKNOWN";
     status      = 0;
     name        = "UNKNOWN";
+    /* Append cursor */
+    itsCursorFilespace   = 0;
+    itsCursorMemspace    = 0;
+    itsCursorComplexType = 0;
+    itsCursorBlocksize   = 0;
+    itsCursorExtent      = 0;
+    itsCursorSize        = 0;
+    itsNofH5Calls        = 0;
+    itsNofSamples        = 0;
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  /*!
+    An append cursor still open is closed, which trims the array to the
+    appended data; the dataset itself is left to close().
+  */
+  dalArray::~dalArray()
+  {
+    closeCursor();
   }
   
   //_____________________________________________________________________________
@@ -70,6 +94,8 @@ namespace DAL {
   */
   bool dalArray::close()
   {
+    closeCursor();
+
     if ( H5Dclose(itsDatasetID) < 0 ) {
       std::cerr << "ERROR: dalArray::close() failed.\n";
       return DAL::FAIL;
@@ -98,6 +124,8 @@ namespace DAL {
     os << "-- Array name         = " << name        << std::endl;
     os << "-- Rank of the array  = " << getRank()   << std::endl;
     os << "-- Shape of the array = " << dims()      << std::endl;
+    os << "-- Appended samples   = " << itsNofSamples << std::endl;
+    os << "-- HDF5 calls/sample  = " << h5CallsPerSample() << std::endl;
   }
 
   //_____________________________________________________________________________
@@ -434,8 +462,282 @@ namespace DAL {
         return DAL::FAIL;
       }
 
+    /* Keep the append cursor in sync with the new shape */
+    if ( itsCursorFilespace > 0 && rank == 1 )
+      {
+        if ( H5Sset_extent_simple( itsCursorFilespace, 1, lcldims, NULL ) < 0 )
+          {
+            std::cerr << "ERROR: Could not update filespace of append cursor.\n";
+            return DAL::FAIL;
+          }
+        ++itsNofH5Calls;
+        itsCursorExtent = lcldims[0];
+        if ( itsCursorSize < itsCursorExtent )
+          itsCursorSize = itsCursorExtent;
+      }
+
+    return DAL::SUCCESS;
+
+  }
+
+  // ============================================================================
+  //
+  //  Append cursor
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                   initCursor
+
+  /*!
+    Retrieve the file dataspace of the array, which then is kept open until
+    closeCursor() is called.
+
+    \return bool -- DAL::FAIL or DAL::SUCCESS
+  */
+  bool dalArray::initCursor ()
+  {
+    hsize_t extent = 0;
+
+    if ( itsCursorFilespace > 0 )
+      return DAL::SUCCESS;
+
+    if ( ( itsCursorFilespace = H5Dget_space( itsDatasetID ) ) < 0 )
+      {
+        std::cerr << "ERROR: Could not get filespace for array.\n";
+        itsCursorFilespace = 0;
+        return DAL::FAIL;
+      }
+    ++itsNofH5Calls;
+
+    if ( H5Sget_simple_extent_ndims( itsCursorFilespace ) != 1 )
+      {
+        std::cerr << "ERROR: Append cursor requires a one-dimensional array.\n";
+        H5Sclose( itsCursorFilespace );
+        itsCursorFilespace = 0;
+        return DAL::FAIL;
+      }
+    H5Sget_simple_extent_dims( itsCursorFilespace, &extent, NULL );
+    itsNofH5Calls += 2;
+
+    itsCursorExtent = extent;
+    if ( itsCursorSize < extent )
+      itsCursorSize = extent;
+
+    return DAL::SUCCESS;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  closeCursor
+
+  /*!
+    If the array was extended beyond the range covered by the appended data,
+    its shape is trimmed accordingly.
+
+    \return bool -- DAL::FAIL or DAL::SUCCESS
+  */
+  bool dalArray::closeCursor ()
+  {
+    bool status = DAL::SUCCESS;
+
+    if ( itsCursorFilespace > 0 )
+      {
+        if ( itsCursorExtent > itsCursorSize )
+          {
+            hsize_t size[1] = { itsCursorSize };
+            if ( H5Dset_extent( itsDatasetID, size ) < 0 )
+              {
+                std::cerr << "ERROR: Could not trim array to appended data.\n";
+                status = DAL::FAIL;
+              }
+            else
+              {
+                itsCursorExtent = itsCursorSize;
+              }
+            ++itsNofH5Calls;
+          }
+        H5Sclose( itsCursorFilespace );
+        itsCursorFilespace = 0;
+      }
+
+    if ( itsCursorMemspace > 0 )
+      {
+        H5Sclose( itsCursorMemspace );
+        itsCursorMemspace  = 0;
+        itsCursorBlocksize = 0;
+      }
+
+    if ( itsCursorComplexType > 0 )
+      {
+        H5Tclose( itsCursorComplexType );
+        itsCursorComplexType = 0;
+      }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   appendData
+
+  /*!
+    \param offset    -- Position to begin writing array.
+    \param data      -- Data array to write.
+    \param arraysize -- Size of the array to write.
+    \param memtype   -- HDF5 datatype of the elements in \e data.
+
+    \return bool -- DAL::FAIL or DAL::SUCCESS
+  */
+  bool dalArray::appendData (int const &offset,
+                             void * data,
+                             int const &arraysize,
+                             hid_t const &memtype)
+  {
+    if ( offset < 0 || arraysize <= 0 )
+      {
+        std::cerr << "ERROR: Invalid block [" << offset << "," << arraysize
+                  << "] for append cursor.\n";
+        return DAL::FAIL;
+      }
+
+    if ( !initCursor() )
+      return DAL::FAIL;
+
+    hsize_t off[1]   = { hsize_t(offset) };
+    hsize_t count[1] = { hsize_t(arraysize) };
+    hsize_t end      = off[0] + count[0];
+
+    /* Grow the array in geometric steps */
+    if ( end > itsCursorExtent )
+      {
+        hsize_t extent[1] = { 2*itsCursorExtent };
+        if ( extent[0] < end )
+          extent[0] = end;
+        if ( H5Dset_extent( itsDatasetID, extent ) < 0 )
+          {
+            std::cerr << "ERROR: Could not extend array dimensions.\n";
+            return DAL::FAIL;
+          }
+        if ( H5Sset_extent_simple( itsCursorFilespace, 1, extent, NULL ) < 0 )
+          {
+            std::cerr << "ERROR: Could not update filespace of append cursor.\n";
+            return DAL::FAIL;
+          }
+        itsNofH5Calls  += 2;
+        itsCursorExtent = extent[0];
+      }
+
+    /* (Re-)create the memory space only if the block size changes */
+    if ( itsCursorBlocksize != count[0] )
+      {
+        if ( itsCursorMemspace > 0 )
+          {
+            H5Sclose( itsCursorMemspace );
+            ++itsNofH5Calls;
+          }
+        if ( ( itsCursorMemspace = H5Screate_simple( 1, count, NULL ) ) < 0 )
+          {
+            std::cerr << "ERROR: Could not create dataspace for array.\n";
+            itsCursorMemspace  = 0;
+            itsCursorBlocksize = 0;
+            return DAL::FAIL;
+          }
+        ++itsNofH5Calls;
+        itsCursorBlocksize = count[0];
+      }
+
+    if ( H5Sselect_hyperslab( itsCursorFilespace, H5S_SELECT_SET, off, NULL,
+                              count, NULL ) < 0 )
+      {
+        std::cerr << "ERROR: Could not select hyperslab for array.\n";
+        return DAL::FAIL;
+      }
+
+    if ( H5Dwrite( itsDatasetID, memtype, itsCursorMemspace, itsCursorFilespace,
+                   H5P_DEFAULT, data ) < 0 )
+      {
+        std::cerr << "ERROR: Could not write block to array.\n";
+        return DAL::FAIL;
+      }
+    itsNofH5Calls += 2;
+
+    itsNofSamples += count[0];
+    if ( itsCursorSize < end )
+      itsCursorSize = end;
+
     return DAL::SUCCESS;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       append
+
+  /*!
+    \brief Write data to an array, extending it's dimensions if required.
+
+    \param offset Position to begin writing array.
+    \param data Data array to write.
+    \param arraysize Size of the array to write.
+    \return bool -- DAL::FAIL or DAL::SUCCESS
+  */
+  bool dalArray::append (int offset,
+                         short data[],
+                         int arraysize)
+  {
+    return appendData (offset, data, arraysize, H5T_NATIVE_SHORT);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       append
+
+  /*!
+    \brief Write data to an array, extending it's dimensions if required.
+
+    \param offset Position to begin writing array.
+    \param data Data array to write.
+    \param arraysize Size of the array to write.
+    \return bool -- DAL::FAIL or DAL::SUCCESS
+  */
+  bool dalArray::append (int offset,
+                         int data[],
+                         int arraysize)
+  {
+    return appendData (offset, data, arraysize, H5T_NATIVE_INT);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       append
+
+  /*!
+    \brief Write data to an array, extending it's dimensions if required.
+
+    The compound memory datatype matches the one created by
+    DAL::dalComplexArray_int16 and is kept along with the cursor.
+
+    \param offset Position to begin writing array.
+    \param data Data array to write.
+    \param arraysize Size of the array to write.
+    \return bool -- DAL::FAIL or DAL::SUCCESS
+  */
+  bool dalArray::append (int offset,
+                         std::complex<Int16> data[],
+                         int arraysize)
+  {
+    if ( itsCursorComplexType <= 0 )
+      {
+        if ( ( itsCursorComplexType = H5Tcreate( H5T_COMPOUND,
+                                                 sizeof(DAL::Complex_Int16) ) ) < 0 )
+          {
+            std::cerr << "ERROR: Could not create complex datatype.\n";
+            itsCursorComplexType = 0;
+            return DAL::FAIL;
+          }
+        H5Tinsert( itsCursorComplexType, "real", HOFFSET(DAL::Complex_Int16,real),
+                   H5T_NATIVE_SHORT );
+        H5Tinsert( itsCursorComplexType, "imag", HOFFSET(DAL::Complex_Int16,imag),
+                   H5T_NATIVE_SHORT );
+        itsNofH5Calls += 3;
+      }
 
+    return appendData (offset, data, arraysize, itsCursorComplexType);
   }
 
   //_____________________________________________________________________________
@@ -37,6 +37,24 @@ namespace DAL {
     \author Joseph Masters, Lars B&auml;hren
     
     The dalArray object holds an n-dimensional array of a single datatype.
+
+    <h3>Append cursor</h3>
+
+    Writing many small blocks into a one-dimensional array -- e.g. a TBB
+    dipole dataset which receives one frame of 1024 samples at a time -- is
+    better done through the append() methods than through extend() followed
+    by write():
+    - the file and memory dataspaces are created once and kept alive between
+      subsequent calls;
+    - the array is extended in geometric steps (doubling its size) rather than
+      by a single block; as chunks of an extendible dataset only get allocated
+      once written to, this does not cost any space in the file;
+    - upon close() -- or destruction of the object, if it has not been closed
+      before -- the cached dataspaces are released and the array is trimmed
+      back to the range actually covered by the appended data.
+
+    The number of HDF5 library calls issued per written sample can be
+    inspected through h5CallsPerSample().
   */
   class dalArray {
     
@@ -46,7 +64,35 @@ namespace DAL {
     std::string datatype;
     //! HDF5 return status
     herr_t status;
+    //! Append cursor: Cached file dataspace
+    hid_t itsCursorFilespace;
+    //! Append cursor: Cached memory dataspace
+    hid_t itsCursorMemspace;
+    //! Append cursor: Cached memory datatype for complex<Int16> data
+    hid_t itsCursorComplexType;
+    //! Append cursor: Number of elements described by the memory dataspace
+    hsize_t itsCursorBlocksize;
+    //! Append cursor: Current extent of the array
+    hsize_t itsCursorExtent;
+    //! Append cursor: Number of elements covered by the data written so far
+    hsize_t itsCursorSize;
+    //! Append cursor: Number of HDF5 library calls
+    unsigned long itsNofH5Calls;
+    //! Append cursor: Number of samples written
+    unsigned long itsNofSamples;
     
+    //! Set up the append cursor
+    bool initCursor ();
+    //! Append a block of data of a given memory datatype
+    bool appendData (int const &offset,
+		     void * data,
+		     int const &arraysize,
+		     hid_t const &memtype);
+    //! Unimplemented, the append cursor holds HDF5 object identifiers
+    dalArray (dalArray const &other);
+    //! Unimplemented, the append cursor holds HDF5 object identifiers
+    dalArray & operator= (dalArray const &other);
+
   protected:
     
     //! HDF5 object ID for array
@@ -63,6 +109,11 @@ namespace DAL {
     //! Default constructor
     dalArray();
 
+    // === Destruction ==========================================================
+
+    //! Destructor, releasing the append cursor
+    virtual ~dalArray();
+
     // === Parameter access =====================================================
 
     //! Retrieve the dimensions of an array
@@ -179,6 +230,33 @@ namespace DAL {
     bool write( int offset, std::complex<float> data[], int arraysize );
     //! Write \e data of type \e complex<Int16>.
     bool write( int offset, std::complex<Int16> data[], int arraysize );
+
+    // === Append cursor ========================================================
+
+    //! Write \e data of type \e short, growing the array as required.
+    bool append (int offset, short data[], int arraysize);
+    //! Write \e data of type \e int, growing the array as required.
+    bool append (int offset, int data[], int arraysize);
+    //! Write \e data of type \e complex<Int16>, growing the array as required.
+    bool append (int offset, std::complex<Int16> data[], int arraysize);
+    //! Trim the array to the appended data and release the cached dataspaces
+    bool closeCursor ();
+    //! Get the number of elements covered by the data written through append()
+    inline hsize_t appendedSize () const {
+      return itsCursorSize;
+    }
+    //! Get the number of HDF5 library calls issued by append()
+    inline unsigned long nofH5Calls () const {
+      return itsNofH5Calls;
+    }
+    //! Get the number of samples written by append()
+    inline unsigned long nofAppendedSamples () const {
+      return itsNofSamples;
+    }
+    //! Get the number of HDF5 library calls per sample written by append()
+    inline double h5CallsPerSample () const {
+      return itsNofSamples ? double(itsNofH5Calls)/itsNofSamples : 0.0;
+    }
     
     // === Python wrapper functions =============================================
 
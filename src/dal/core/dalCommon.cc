@@ -21,6 +21,8 @@
 
 #include "dalCommon.h"
 
+#include <sys/time.h>
+
 #ifdef DAL_WITH_CASA
 using casa::MPosition;
 #endif
@@ -62,6 +64,56 @@ namespace DAL {
     }
   }
   
+  //_____________________________________________________________________________
+  //                                                                   CRCTables
+
+  /*!
+    \brief Lookup tables for the word-oriented CRC routines
+
+    For a generator polynomial \f$ P \f$ of degree \f$ W \f$ the table entry
+    <tt>table[k][b]</tt> holds \f$ b(x) \cdot x^{8k+16} \bmod P \f$, i.e. the
+    contribution of byte \f$ b \f$ once it has been shifted \f$ 8k+16 \f$
+    bits further through the division register. With \f$ N \f$ such tables
+    four 16-bit words can be folded into the running remainder per iteration
+    ("slice-by-8"); \f$ N=8 \f$ for the 16-bit and \f$ N=10 \f$ for the
+    32-bit CRC.
+  */
+  template <class T, int W, int N>
+  class CRCTables {
+  public:
+    T table[N][256];
+    
+    CRCTables (T const &poly)
+    {
+      const T topbit = T(1) << (W-1);
+      
+      for (unsigned int b=0; b<256; ++b) {
+	/* b(x)*x^16 mod P; reduction only is required if W < 24 */
+	T crc;
+	if (W < 24) {
+	  crc = T(b) << (W-8);
+	  for (int bit=0; bit<24-W; ++bit) {
+	    crc = (crc & topbit) ? T((crc << 1) ^ poly) : T(crc << 1);
+	  }
+	} else {
+	  crc = T(b) << 16;
+	}
+	table[0][b] = crc;
+      }
+      
+      /* Every further table moves the byte another 8 bits along */
+      for (int k=1; k<N; ++k) {
+	for (unsigned int b=0; b<256; ++b) {
+	  T crc = table[k-1][b];
+	  for (int bit=0; bit<8; ++bit) {
+	    crc = (crc & topbit) ? T((crc << 1) ^ poly) : T(crc << 1);
+	  }
+	  table[k][b] = crc;
+	}
+      }
+    }
+  };
+
   //_____________________________________________________________________________
   //                                                                        crc16
   
@@ -69,6 +121,12 @@ namespace DAL {
     Generic CRC16 method working on 16-bit unsigned data adapted from Python
     script by Gijs Schoonderbeek.
 
+    The message is interpreted as a polynomial made up from the 16-bit words in
+    \e buffer (most significant bit first) and the remainder of its division
+    by \f$ P(x) = x^{16} + x^{15} + x^{2} + 1 \f$ is returned; a block which
+    has its CRC appended therefore yields zero. The division is carried out
+    with lookup tables, folding four words per iteration.
+
     \param buffer -- Pointer to the data
     \param length -- Length of the data in 16-bit words.
     
@@ -77,25 +135,77 @@ namespace DAL {
   uint16_t crc16 (uint16_t * buffer,
 		  uint32_t length)
   {
-    uint16_t CRC            = 0;
-    const uint32_t CRC_poly = 0x18005;
-    const uint16_t bits     = 16;
-    uint32_t data           = 0;
-    const uint32_t CRC_div  = (CRC_poly & 0x7fffffff) << 15;
+    static const CRCTables<uint16_t,16,8> crcTables (0x8005);
+    const uint16_t (*t)[256] = crcTables.table;
     
-    data = (buffer[0] & 0x7fffffff) << 16;
-    for (uint32_t i=1; i<length; i++) {
-      data += buffer[i];
-      for (uint16_t j=0; j<bits; j++) {
-	if ((data & 0x80000000) != 0) {
-	  data ^= CRC_div;
-	}
-	data &= 0x7fffffff;
-	data <<= 1;
-      }
+    if (length == 0) {
+      return 0;
+    }
+
+    uint16_t crc = buffer[0];
+    uint32_t i   = 1;
+    
+    for (; i+4<=length; i+=4) {
+      crc = t[7][crc >> 8]         ^ t[6][crc & 0xff]
+	^ t[5][buffer[i] >> 8]     ^ t[4][buffer[i] & 0xff]
+	^ t[3][buffer[i+1] >> 8]   ^ t[2][buffer[i+1] & 0xff]
+	^ t[1][buffer[i+2] >> 8]   ^ t[0][buffer[i+2] & 0xff]
+	^ buffer[i+3];
+    }
+    
+    for (; i<length; ++i) {
+      crc = t[1][crc >> 8] ^ t[0][crc & 0xff] ^ buffer[i];
     }
-    CRC = data >> 16;
-    return CRC;
+    
+    return crc;
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                        crc32
+  
+  /*!
+    Counterpart of DAL::crc16 using the CRC-32 generator polynomial
+    <tt>0x04C11DB7</tt>; it is used to verify the payload of a TBB frame. As
+    the remainder spans two words, the CRC to be appended to a block has to
+    be stored most significant half first.
+
+    \param buffer -- Pointer to the data
+    \param length -- Length of the data in 16-bit words.
+    
+    \return crc -- Value of the CRC
+  */
+  uint32_t crc32 (uint16_t * buffer,
+		  uint32_t length)
+  {
+    static const CRCTables<uint32_t,32,10> crcTables (0x04C11DB7);
+    const uint32_t (*t)[256] = crcTables.table;
+    
+    if (length == 0) {
+      return 0;
+    }
+    
+    uint32_t crc = buffer[0];
+    uint32_t i   = 1;
+    
+    /* The first word only fills the lower half of the register */
+    if (length > 1) {
+      crc = (crc << 16) | buffer[1];
+      i   = 2;
+    }
+    
+    for (; i+4<=length; i+=4) {
+      crc = t[9][crc >> 24]          ^ t[8][(crc >> 16) & 0xff]
+	^ t[7][(crc >> 8) & 0xff]    ^ t[6][crc & 0xff]
+	^ t[5][buffer[i] >> 8]       ^ t[4][buffer[i] & 0xff]
+	^ t[3][buffer[i+1] >> 8]     ^ t[2][buffer[i+1] & 0xff]
+	^ (uint32_t(buffer[i+2]) << 16) ^ buffer[i+3];
+    }
+    
+    for (; i<length; ++i) {
+      crc = (crc << 16) ^ t[3][crc >> 24] ^ t[2][(crc >> 16) & 0xff] ^ buffer[i];
+    }
+    
+    return crc;
   }
   
   // ============================================================================
@@ -119,6 +229,20 @@ namespace DAL {
     }
   }
   
+  //_____________________________________________________________________________
+  //                                                                     wallTime
+  
+  /*!
+    \return seconds -- Seconds since the epoch, with microsecond resolution;
+            meant to time operations, by taking the difference of two calls.
+  */
+  double wallTime ( void )
+  {
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    return tv.tv_sec + 1e-6*tv.tv_usec;
+  }
+  
   //_____________________________________________________________________________
   //                                                                   h5get_name
 
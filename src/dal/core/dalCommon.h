@@ -67,6 +67,7 @@ using std::endl;
   \test tdalCommon.cc
   \test tdalCommon_operators.cc
   \test tdalCommon_tbb.cc
+  \test tdalCommon_crc.cc
 
   <h3>Prerequisite</h3>
 
@@ -98,9 +99,11 @@ using std::endl;
   used routines:
   - Conversion routines
     - DAL::julday
+    - DAL::crc16, DAL::crc32
   - Service functions
     - DAL::it_exists
     - DAL::BigEndian
+    - DAL::wallTime
   - Routines for the access of HDF5 attributes
     - DAL::h5attribute_summary
 
@@ -122,6 +125,10 @@ namespace DAL {
   uint16_t crc16 (uint16_t * buffer,
 		  uint32_t length);
   
+  //! Calculate a 32-bit CRC
+  uint32_t crc32 (uint16_t * buffer,
+		  uint32_t length);
+  
   // ============================================================================
   //
   //  System inspection
@@ -131,6 +138,9 @@ namespace DAL {
   //! Test if the system is big endian
   bool BigEndian ( void );
   
+  //! Get the wall-clock time [s]
+  double wallTime ( void );
+  
   // ============================================================================
   //
   //  Array operations
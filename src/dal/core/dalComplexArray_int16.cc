@@ -154,4 +154,59 @@ namespace DAL {   // BEGIN -- namespace DAL
     
   }
 
+  /*!
+    \param obj_id    -- Dataset file handle
+    \param arrayname -- The name of the array you want to create.
+    \param dims      -- Vector of the array dimensions
+    \param data      -- complex<Int16> vector of data to write
+    \param policy    -- Sets the chunk size and the filters of the array.
+  */
+  dalComplexArray_int16::dalComplexArray_int16 (hid_t obj_id,
+						std::string arrayname,
+						std::vector<int> dims,
+						std::complex<Int16> data[],
+						HDF5StoragePolicy const &policy)
+  {
+    unsigned int rank = dims.size();
+    hsize_t mydims[rank];
+    hsize_t maxdims[rank];
+
+    name = arrayname;
+
+    for (unsigned int ii=0; ii<rank; ii++) {
+      mydims[ii]  = dims[ii];
+      maxdims[ii] = H5S_UNLIMITED;
+    }
+
+    // create a new hdf5 datatype for complex values
+    hid_t datatype = H5Tcreate( H5T_COMPOUND, sizeof( DAL::Complex_Int16 ));
+    if ( datatype < 0
+	 || H5Tinsert( datatype, "real", HOFFSET(DAL::Complex_Int16,real), H5T_NATIVE_SHORT) < 0
+	 || H5Tinsert( datatype, "imag", HOFFSET(DAL::Complex_Int16,imag), H5T_NATIVE_SHORT) < 0 )
+      {
+        std::cerr << "ERROR: Could not create compound datatype.\n";
+      }
+
+    hid_t dataspace = H5Screate_simple(rank,mydims,maxdims);
+    if ( dataspace < 0 )
+      {
+        std::cerr << "ERROR: Could not create dataspace for '"
+                  << arrayname << "'.\n";
+      }
+
+    itsDatasetID = policy.create (obj_id, arrayname, datatype, dataspace);
+    if ( itsDatasetID < 0 )
+      {
+        std::cerr << "ERROR: Could not create array '" << arrayname << "'.\n";
+      }
+    else if ( H5Dwrite( itsDatasetID, datatype, dataspace, dataspace, H5P_DEFAULT,
+			data) < 0 )
+      {
+        std::cerr << "ERROR: Could not write array '" << arrayname << "'\n";
+      }
+
+    H5Sclose( dataspace );
+    H5Tclose( datatype );
+  }
+
 } //   END -- namespace DAL
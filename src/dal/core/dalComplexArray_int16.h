@@ -22,6 +22,7 @@
 #define DALCOMPLEXARRAY_INT16_H
 
 #include <core/dalArray.h>
+#include <core/HDF5StoragePolicy.h>
 
 namespace DAL {
   
@@ -48,6 +49,13 @@ namespace DAL {
 			   std::vector<int> dims,
 			   std::complex<Int16> data[],
 			   std::vector<int>chnkdims);
+
+    //! Argumented constructor, chunking and filters set by a policy
+    dalComplexArray_int16( hid_t objfile,
+			   std::string arrayname,
+			   std::vector<int> dims,
+			   std::complex<Int16> data[],
+			   HDF5StoragePolicy const &policy);
   };
 
 } //   END -- namespace DAL
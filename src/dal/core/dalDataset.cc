@@ -114,9 +114,9 @@ namespace DAL {
 	    }
 	    
 	  }
-	
-	itsFilePointer = &h5fh_p;
       }
+      
+      itsFilePointer = &h5fh_p;
     }
     else if ( filetype == FITSTYPE )
       {
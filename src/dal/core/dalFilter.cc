@@ -20,6 +20,10 @@
 
 #include <core/dalFilter.h>
 
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
 namespace DAL {
 
   // ============================================================================
@@ -127,6 +131,8 @@ namespace DAL {
     itsFilterString = "";
     itsFiletype     = dalFileType();
     filterIsSet_p         = false;
+    itsColumns.clear();
+    itsConditions.clear();
   }
 
   //_____________________________________________________________________________
@@ -149,6 +155,14 @@ namespace DAL {
       itsFilterString = "Select " + cols + " from $1";
       filterIsSet_p   = true;
       break;
+    case dalFileType::HDF5:
+      if (!parseColumns (cols, itsColumns)) {
+	return false;
+      }
+      itsConditions.clear();
+      itsFilterString = "Select " + cols;
+      filterIsSet_p   = true;
+      break;
     default:
       {
 	status = false;
@@ -196,23 +210,39 @@ namespace DAL {
                    want to pass the filter (i.e. "TIME,DATA,ANTENNA").
     \param conditions A list of the conditions you want to apply.
                       (i.e. "ANTENNA1=1 AND ANTENNA2=10")
+    \return status -- Status of the operation; returns \e false in case an error
+            was encountered, e.g. because the conditions cannot be parsed or
+	    the operation is not supported for the file type.
    */
-  void dalFilter::set (std::string const &cols,
+  bool dalFilter::set (std::string const &cols,
 		       std::string const &conditions)
   {
+    bool status = true;
+
     switch (itsFiletype.type()) {
     case dalFileType::MSCASA:
+      itsFilterString = "Select " + cols + " from $1 where " + conditions;
+      filterIsSet_p   = true;
+      break;
+    case dalFileType::HDF5:
+      if (!parseColumns (cols, itsColumns)
+	  || !parseConditions (conditions, itsConditions)) {
+	return false;
+      }
+      itsFilterString = "Select " + cols + " where " + conditions;
+      filterIsSet_p   = true;
       break;
-        itsFilterString = "Select " + cols + " from $1 where " + conditions;
-        filterIsSet_p         = true;
     default:
       {
-      std::cerr << "Operation not yet supported for type: " 
-		<< itsFiletype.name()
-		<< ". Sorry.\n";
+	status = false;
+	std::cerr << "Operation not yet supported for type: " 
+		  << itsFiletype.name()
+		  << ". Sorry.\n";
       }
       break;
     };
+
+    return status;
   }
 
   //_____________________________________________________________________________
@@ -245,6 +275,234 @@ namespace DAL {
     os << "-- Filter string = " << itsFilterString         << std::endl;
     os << "-- File type     = " << itsFiletype.name()      << std::endl;
     os << "-- Filter is set = " << filterIsSet_p          << std::endl;
+    os << "-- Columns       = " << itsColumns.size()       << std::endl;
+    os << "-- Conditions    = " << itsConditions.size()    << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Static methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                 parseColumns
+  
+  /*!
+    \param selection -- A comma-separated list of column names; an empty
+           selection or <tt>"*"</tt> selects all columns.
+    \retval columns  -- Names of the selected columns, with leading and
+           trailing blanks removed; empty if all columns are selected.
+    \return status   -- Returns \e false if the list contains an empty name.
+  */
+  bool dalFilter::parseColumns (std::string const &selection,
+				std::vector<std::string> &columns)
+  {
+    std::string const blanks (" \t");
+    std::string::size_type pos   = 0;
+    std::string::size_type first = selection.find_first_not_of (blanks);
+
+    columns.clear();
+
+    if (first == std::string::npos
+	|| selection.substr (first, selection.find_last_not_of (blanks)-first+1) == "*") {
+      return true;
+    }
+
+    while (pos <= selection.size()) {
+      std::string::size_type end = selection.find (',', pos);
+      if (end == std::string::npos) {
+	end = selection.size();
+      }
+      std::string name = selection.substr (pos, end-pos);
+      first = name.find_first_not_of (blanks);
+      if (first == std::string::npos) {
+	std::cerr << "[dalFilter::parseColumns] Empty column name in selection \""
+		  << selection << "\"" << std::endl;
+	columns.clear();
+	return false;
+      }
+      columns.push_back (name.substr (first, name.find_last_not_of (blanks)-first+1));
+      pos = end+1;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                              parseConditions
+  
+  /*!
+    \param conditions -- Terms of the form <tt>column operator value</tt>,
+           joined by <tt>AND</tt> or <tt>&&</tt>, e.g.
+           <tt>"ANTENNA1=1 AND TIME>=4.5e9"</tt>.
+    \retval result    -- The parsed conditions.
+    \return status    -- Returns \e false if the conditions cannot be parsed.
+  */
+  bool dalFilter::parseConditions (std::string const &conditions,
+				   std::vector<Condition> &result)
+  {
+    /* Operators, the ones of two characters to be tried first */
+    char const *symbols[]   = { "==", "!=", "<>", "<=", ">=", "=", "<", ">" };
+    Operator const ops[]    = { Equal, NotEqual, NotEqual, LessEqual,
+				GreaterEqual, Equal, Less, Greater };
+    std::string const blanks (" \t");
+    std::string upper (conditions);
+    std::string::size_type pos = 0;
+
+    result.clear();
+
+    for (std::string::size_type n=0; n<upper.size(); ++n) {
+      upper[n] = toupper (upper[n]);
+    }
+
+    while (pos < conditions.size()) {
+      /* Isolate the next term */
+      std::string::size_type end  = upper.find (" AND ", pos);
+      std::string::size_type next = end+5;
+      if (upper.find ("&&", pos) < end) {
+	end  = upper.find ("&&", pos);
+	next = end+2;
+      }
+      if (end == std::string::npos) {
+	end  = conditions.size();
+	next = end;
+      }
+      std::string term = conditions.substr (pos, end-pos);
+      pos = next;
+
+      /* Split the term at the operator */
+      Condition condition;
+      std::string::size_type opPos = std::string::npos;
+      unsigned int opLength        = 0;
+      for (unsigned int n=0; n<8; ++n) {
+	std::string::size_type found = term.find (symbols[n]);
+	if (found != std::string::npos
+	    && (found < opPos || (found == opPos && strlen(symbols[n]) > opLength))) {
+	  opPos        = found;
+	  opLength     = strlen (symbols[n]);
+	  condition.op = ops[n];
+	}
+      }
+      if (opPos == std::string::npos) {
+	std::cerr << "[dalFilter::parseConditions] No comparison operator in \""
+		  << term << "\"" << std::endl;
+	result.clear();
+	return false;
+      }
+
+      std::string column = term.substr (0, opPos);
+      std::string value  = term.substr (opPos+opLength);
+      std::string::size_type first = column.find_first_not_of (blanks);
+      char *valueEnd = NULL;
+
+      if (first == std::string::npos) {
+	std::cerr << "[dalFilter::parseConditions] Missing column name in \""
+		  << term << "\"" << std::endl;
+	result.clear();
+	return false;
+      }
+      condition.column = column.substr (first, column.find_last_not_of (blanks)-first+1);
+      condition.value  = strtod (value.c_str(), &valueEnd);
+      if (valueEnd == value.c_str()
+	  || value.find_first_not_of (blanks, valueEnd-value.c_str()) != std::string::npos) {
+	std::cerr << "[dalFilter::parseConditions] Value of \"" << term
+		  << "\" is not a number" << std::endl;
+	result.clear();
+	return false;
+      }
+
+      result.push_back (condition);
+    }
+
+    if (result.empty()) {
+      std::cerr << "[dalFilter::parseConditions] Empty list of conditions!"
+		<< std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     evaluate
+  
+  /*!
+    \param condition -- The condition to apply.
+    \param values    -- Values of the column, one every \e stride elements.
+    \param stride    -- Distance between the values of two rows [elements].
+    \param nofValues -- Number of rows.
+    \retval mask     -- Mask of the rows passing the filter; rows failing the
+           condition are set to 0, all others are left untouched.
+  */
+  void dalFilter::evaluate (Condition const &condition,
+			    double const *values,
+			    size_t const &stride,
+			    size_t const &nofValues,
+			    unsigned char *mask)
+  {
+    double const ref = condition.value;
+    size_t const n   = nofValues;
+    size_t const s   = stride;
+
+    /* One loop per operator, such that each of them can be vectorised */
+    switch (condition.op) {
+    case Equal:
+      for (size_t i=0; i<n; ++i) mask[i] &= (values[i*s] == ref);
+      break;
+    case NotEqual:
+      for (size_t i=0; i<n; ++i) mask[i] &= (values[i*s] != ref);
+      break;
+    case Less:
+      for (size_t i=0; i<n; ++i) mask[i] &= (values[i*s] <  ref);
+      break;
+    case LessEqual:
+      for (size_t i=0; i<n; ++i) mask[i] &= (values[i*s] <= ref);
+      break;
+    case Greater:
+      for (size_t i=0; i<n; ++i) mask[i] &= (values[i*s] >  ref);
+      break;
+    case GreaterEqual:
+      for (size_t i=0; i<n; ++i) mask[i] &= (values[i*s] >= ref);
+      break;
+    };
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     overlaps
+  
+  /*!
+    \param condition -- The condition to check.
+    \param min       -- Smallest value within the range.
+    \param max       -- Largest value within the range.
+
+    \return overlaps -- Returns \e false only if the condition is false for all
+            values within [min,max]. An empty range (\e min larger than
+            \e max, e.g. for a block holding NaN values only) passes
+            nothing but <tt>!=</tt>.
+  */
+  bool dalFilter::overlaps (Condition const &condition,
+			    double const &min,
+			    double const &max)
+  {
+    double const ref = condition.value;
+
+    switch (condition.op) {
+    case Equal:
+      return min <= ref && ref <= max;
+    case NotEqual:
+      return !(min == ref && max == ref);
+    case Less:
+      return min < ref;
+    case LessEqual:
+      return min <= ref;
+    case Greater:
+      return max > ref;
+    case GreaterEqual:
+      return max >= ref;
+    };
+
+    return true;
   }
   
 } // DAL namespace
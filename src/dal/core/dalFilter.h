@@ -34,16 +34,73 @@ namespace DAL {
     \brief Class representing a filter that can be applied to a table.
 
     \author Joseph Masters, Lars B&auml;hren
+
+    \test tdalFilter.cc
+
+    <h3>Synopsis</h3>
+
+    A filter consists of a selection of columns -- a comma-separated list of
+    column names, e.g. <tt>"TIME,DATA,ANTENNA1"</tt> -- and optionally a
+    number of conditions on the rows, e.g.
+    <tt>"ANTENNA1=1 AND ANTENNA2=10"</tt>. For a CASA MeasurementSet both are
+    translated into a TaQL query, which is evaluated by casacore.
+
+    For an HDF5 table the filter is evaluated by dalTable::selectRows() itself.
+    The conditions therefore are parsed into a list of terms
+    <tt>column operator value</tt>, joined by <tt>AND</tt> (or
+    <tt>&&</tt>), with the operators <tt>=</tt> (or <tt>==</tt>),
+    <tt>!=</tt> (or <tt><></tt>), <tt><</tt>, <tt><=</tt>, <tt>></tt> and
+    <tt>>=</tt>; the value has to be a number, as the columns are compared
+    as double precision values. evaluate() applies a single condition to a
+    block of column values, updating a mask of the rows passing the filter;
+    its loops are kept free of branches, such that the compiler is able to
+    vectorise them. overlaps() tells whether a condition can hold for any
+    value within a range, which allows skipping blocks of rows of which only
+    the minimum and maximum value are known (see dalTable::createZoneMap()).
   */
   
   class dalFilter {
 
+  public:
+
+    //! Comparison operators of a condition
+    enum Operator {
+      //! Column value equal to the reference value
+      Equal,
+      //! Column value not equal to the reference value
+      NotEqual,
+      //! Column value smaller than the reference value
+      Less,
+      //! Column value smaller than or equal to the reference value
+      LessEqual,
+      //! Column value larger than the reference value
+      Greater,
+      //! Column value larger than or equal to the reference value
+      GreaterEqual
+    };
+
+    //! Condition on the value of a column
+    struct Condition {
+      //! Name of the column
+      std::string column;
+      //! Comparison operator
+      Operator op;
+      //! Reference value
+      double value;
+    };
+
+  private:
+
     //! Table filter std::string
     std::string itsFilterString;
     //! File type: MSCASA, HDF5, FITS, etc.
     dalFileType itsFiletype;
     //! Book-keeping whether a filter is set or not.
     bool filterIsSet_p;
+    //! Names of the selected columns (empty if all columns are selected)
+    std::vector<std::string> itsColumns;
+    //! Conditions on the rows
+    std::vector<Condition> itsConditions;
     
   public:
 
@@ -75,7 +132,7 @@ namespace DAL {
     bool set (std::vector<std::string> const &selection);
 
     //! Restrict the opening of a table to particular columns and conditions.
-    void set (std::string const &columns,
+    bool set (std::string const &columns,
 	      std::string const &conditions);
 
     //! Get the type of the file
@@ -99,12 +156,49 @@ namespace DAL {
       return itsFilterString;
     }
 
+    //! Get the names of the selected columns (empty if all are selected)
+    inline std::vector<std::string> columns () const {
+      return itsColumns;
+    }
+
+    //! Get the conditions on the rows
+    inline std::vector<Condition> conditions () const {
+      return itsConditions;
+    }
+
+    //! Get the number of conditions on the rows
+    inline unsigned int nofConditions () const {
+      return itsConditions.size();
+    }
+
     //! Provide a summary of the internal status
     inline void summary () {
       summary (std::cout);
     }
     //! Provide a summary of the internal status
     void summary (std::ostream &os);    
+
+    // === Static methods =======================================================
+
+    //! Split a comma-separated list of column names
+    static bool parseColumns (std::string const &selection,
+			      std::vector<std::string> &columns);
+
+    //! Parse conditions of the form "ANTENNA1=1 AND TIME>100"
+    static bool parseConditions (std::string const &conditions,
+				 std::vector<Condition> &result);
+
+    //! Apply a condition to a block of column values
+    static void evaluate (Condition const &condition,
+			  double const *values,
+			  size_t const &stride,
+			  size_t const &nofValues,
+			  unsigned char *mask);
+
+    //! Can a condition hold for any of the values within a range?
+    static bool overlaps (Condition const &condition,
+			  double const &min,
+			  double const &max);
     
   private:
 
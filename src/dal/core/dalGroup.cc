@@ -312,6 +312,24 @@ namespace DAL {
     return la;
   }
 
+  /*!
+    \param arrayname A string containing he name of the array.
+    \param dims A vector specifying the array dimensions.
+    \param data A structure containing the data to be written.  The size
+                of the data must match the provided dimensions.
+    \param policy The policy setting chunk size and filters of the array.
+
+    \return dalArray * A pointer to an array object.
+  */
+  dalArray *
+  dalGroup::createShortArray( std::string arrayname,
+                              std::vector<int> dims,
+                              short data[],
+                              HDF5StoragePolicy const &policy )
+  {
+    return new dalShortArray( itsGroupID, arrayname, dims, data, policy );
+  }
+
 
 
 // ------------------------------------------------------------ createIntArray
@@ -427,6 +445,24 @@ namespace DAL {
     return la;
   }
 
+  /*!
+    \param arrayname A string containing he name of the array.
+    \param dims A vector specifying the array dimensions.
+    \param data A structure containing the data to be written.  The size
+                of the data must match the provided dimensions.
+    \param policy The policy setting chunk size and filters of the array.
+
+    \return dalArray * A pointer to an array object.
+  */
+  dalArray *
+  dalGroup::createComplexShortArray( std::string arrayname,
+                                     std::vector<int> dims,
+                                     std::complex<Int16> data[],
+                                     HDF5StoragePolicy const &policy )
+  {
+    return new dalComplexArray_int16( itsGroupID, arrayname, dims, data, policy );
+  }
+
   // ---------------------------------------------------------- createGroup
   
   /*!
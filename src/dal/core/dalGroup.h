@@ -104,6 +104,11 @@ namespace DAL {
 					std::vector<int> dims,
 					short data[],
 					std::vector<int>cdims);
+    //! Create an array of shorts within the group, chunked and filtered by a policy
+    dalArray * createShortArray(        std::string arrayname,
+					std::vector<int> dims,
+					short data[],
+					HDF5StoragePolicy const &policy);
     //! Create an array of ints within the group.
     dalArray * createIntArray(          std::string arrayname,
 					std::vector<int> dims,
@@ -124,6 +129,11 @@ namespace DAL {
 					std::vector<int> dims,
 					std::complex<Int16> data[],
 					std::vector<int>cdims );
+    
+    dalArray * createComplexShortArray( std::string arrayname,
+					std::vector<int> dims,
+					std::complex<Int16> data[],
+					HDF5StoragePolicy const &policy );
     //! Retrief the array or table member names from the group.
     std::vector<std::string> getMemberNames();
     
@@ -131,6 +131,52 @@ namespace DAL {
     
   }
 
+  /*!
+    \param obj_id    -- An identifier for the dataset object.
+    \param arrayname -- The name of the array you want to create.
+    \param dims      -- The dimensions of the array you want to create.
+    \param data      -- The data to write into the new array; the size of the
+           structure should match the dimensions of the array.
+    \param policy    -- Sets the chunk size and the filters of the array.
+   */
+  dalShortArray::dalShortArray( hid_t obj_id,
+				std::string arrayname,
+                                std::vector<int> dims,
+				short data[],
+                                HDF5StoragePolicy const &policy )
+  {
+    name = arrayname;
+
+    unsigned int rank = dims.size();
+    hsize_t mydims[rank];
+    hsize_t maxdims[rank];
+
+    for (unsigned int ii=0; ii<rank; ii++)
+      {
+        mydims[ii]  = dims[ii];
+        maxdims[ii] = H5S_UNLIMITED;
+      }
+
+    hid_t dataspace = H5Screate_simple(rank,mydims,maxdims);
+    if ( dataspace < 0 ) {
+      std::cerr << "ERROR: Could not set array dataspace.\n";
+      return;
+    }
+
+    itsDatasetID = policy.create (obj_id, arrayname, H5T_NATIVE_SHORT, dataspace);
+    if ( itsDatasetID < 0 ) {
+      std::cerr << "ERROR: Could not create array.\n";
+    }
+    else if ( H5Dwrite( itsDatasetID, H5T_NATIVE_SHORT, dataspace, dataspace,
+			H5P_DEFAULT, data) < 0 ) {
+      std::cerr << "ERROR: Could not write array.\n";
+    }
+
+    if ( H5Sclose( dataspace ) < 0 ) {
+      std::cerr << "ERROR: Could not close array dataspace.\n";
+    }
+  }
+
   // ============================================================================
   //
   //  Methods
@@ -22,6 +22,7 @@
 #define DALSHORTARRAY_H
 
 #include <core/dalArray.h>
+#include <core/HDF5StoragePolicy.h>
 
 namespace DAL {
 
@@ -46,6 +47,13 @@ namespace DAL {
 		   short data[],
 		   std::vector<int>chnkdims);
 
+    //! Constructor for extendible \e short array, chunked and filtered by a policy
+    dalShortArray (hid_t obj_id,
+		   std::string arrayname,
+		   std::vector<int> dims,
+		   short data[],
+		   HDF5StoragePolicy const &policy);
+
     //! Read data  from the array
     short * readShortArray (hid_t obj_id,
 			    std::string arrayname );
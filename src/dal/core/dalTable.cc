@@ -20,6 +20,10 @@
 
 #include <core/dalTable.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace DAL {
   
   // ============================================================================
@@ -33,7 +37,7 @@ namespace DAL {
   
   dalTable::dalTable()
   {
-    filter = new dalFilter;
+    init ("");
   }
   
   //_____________________________________________________________________________
@@ -44,12 +48,38 @@ namespace DAL {
            "MSCASA", etc.)
   */
   dalTable::dalTable( std::string filetype )
+  {
+    init (filetype);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                         init
+  
+  /*!
+    \param filetype -- The type of table you want to create (i.e. "HDF5",
+           "MSCASA", etc.)
+  */
+  void dalTable::init (std::string const &filetype)
   {
     filter = new dalFilter;
 
     type = filetype;
     columns.clear();  // clear the columns vector
-    firstrecord = true;
+    firstrecord = false;
+
+    file            = NULL;
+    fileID_p        = -1;
+    tableID_p       = -1;
+    nfields         = 0;
+    nofRecords_p    = 0;
+    layoutDataset_p = -1;
+    layoutType_p    = -1;
+    recordSize_p    = 0;
+    zoneDataset_p   = -1;
+    zoneSize_p      = 0;
+    zoneRows_p      = 0;
+    zoneModified_p  = 0;
+    nofRowsScanned_p = 0;
     
     if ( type == MSCASATYPE ) {
 #ifdef DAL_WITH_CASA
@@ -71,6 +101,7 @@ namespace DAL {
   
   dalTable::~dalTable()
   {
+    h5layout_reset ();
     delete filter;
     if ( type == MSCASATYPE ) {
 #ifdef DAL_WITH_CASA
@@ -121,6 +152,15 @@ namespace DAL {
       os << "-- HDF5 table ID = " << tableID_p << std::endl;
       os << "-- nof. fields   = " << nfields  << std::endl;
       os << "-- nof. records  = " << nofRecords_p << std::endl;
+      os << "-- Record size   = " << recordSize_p << std::endl;
+      if (zoneDataset_p >= 0) {
+	os << "-- Zone map      = [";
+	for (unsigned int n=0; n<zoneColumns_p.size(); ++n) {
+	  os << " " << zoneColumns_p[n];
+	}
+	os << " ], " << zoneSize_p << " rows/zone, " << zoneRows_p
+	   << " rows covered" << std::endl;
+      }
     }
     else {
       os << "-- File type is HDF5, but object not connected to file!"
@@ -313,12 +353,12 @@ namespace DAL {
 
   \param columns A comma-separated list of columns you wish read from the
                  table.
+  \return status -- Returns \e false if the filter could not be set.
   */
-  void dalTable::setFilter( std::string columns )
+  bool dalTable::setFilter( std::string columns )
   {
-    filter = new dalFilter;
     filter->setFiletype( type );
-    filter->set(columns);
+    return filter->set(columns);
   }
 
   //_____________________________________________________________________________
@@ -334,12 +374,264 @@ namespace DAL {
            table.
     \param conditions The condition you wish to apply to the columns in the
            filter.  For example: "TIME>100".
+    \return status -- Returns \e false if the filter could not be set.
   */
-  void dalTable::setFilter (std::string columns,
+  bool dalTable::setFilter (std::string columns,
 			    std::string conditions )
   {
     filter->setFiletype( type );
-    filter->set(columns,conditions);
+    return filter->set(columns,conditions);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   selectRows
+  
+  /*!
+    \retval rows   -- Indices of the rows matching the conditions of the filter;
+           all rows in the range if no conditions are set.
+    \param start   -- Index of the first row to consider.
+    \param nofRows -- Number of rows to consider; a negative value selects all
+           rows up to the end of the table.
+
+    \return nofSelected -- The number of selected rows; -1 in case an error was
+            encountered.
+  */
+  long dalTable::selectRows (std::vector<hsize_t> &rows,
+			     long const &start,
+			     long const &nofRows)
+  {
+    return h5select (rows, NULL, filter->conditions(), start, nofRows);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   selectRows
+  
+  /*!
+    \retval rows    -- Indices of the rows matching the conditions of the
+           filter; all rows in the range if no conditions are set.
+    \retval records -- The columns selected by the filter -- all columns if
+           none are selected -- of the matching rows; the fields of a record
+           are packed in the order of the selection, see selectionRecordSize().
+    \param start    -- Index of the first row to consider.
+    \param nofRows  -- Number of rows to consider; a negative value selects all
+           rows up to the end of the table.
+
+    \return nofSelected -- The number of selected rows; -1 in case an error was
+            encountered.
+  */
+  long dalTable::selectRows (std::vector<hsize_t> &rows,
+			     std::vector<char> &records,
+			     long const &start,
+			     long const &nofRows)
+  {
+    return h5select (rows, &records, filter->conditions(), start, nofRows);
+  }
+
+  //_____________________________________________________________________________
+  //                                                              rangeConditions
+  
+  /*!
+    \param column -- Name of a numerical column.
+    \param lower  -- Lower limit of the range, included.
+    \param upper  -- Upper limit of the range, excluded.
+
+    \return conditions -- The conditions of the filter, followed by
+            \e lower <= \e column and \e column < \e upper.
+  */
+  std::vector<dalFilter::Condition> dalTable::rangeConditions (std::string const &column,
+							       double const &lower,
+							       double const &upper)
+  {
+    std::vector<dalFilter::Condition> conditions = filter->conditions();
+    dalFilter::Condition condition;
+
+    condition.column = column;
+    condition.op     = dalFilter::GreaterEqual;
+    condition.value  = lower;
+    conditions.push_back (condition);
+    condition.op     = dalFilter::Less;
+    condition.value  = upper;
+    conditions.push_back (condition);
+
+    return conditions;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  selectRange
+  
+  /*!
+    \retval rows   -- Indices of the rows with \e lower <= \e column <
+           \e upper, which also match the conditions of the filter.
+    \param column  -- Name of a numerical column, e.g. <tt>"TIME"</tt>.
+    \param lower   -- Lower limit of the range, included.
+    \param upper   -- Upper limit of the range, excluded.
+
+    \return nofSelected -- The number of selected rows; -1 in case an error was
+            encountered.
+  */
+  long dalTable::selectRange (std::vector<hsize_t> &rows,
+			      std::string const &column,
+			      double const &lower,
+			      double const &upper)
+  {
+    return h5select (rows, NULL, rangeConditions (column, lower, upper), 0, -1);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  selectRange
+  
+  /*!
+    With a zone map on \e column only the zones overlapping the range are
+    read, see createZoneMap().
+
+    \retval rows    -- Indices of the rows with \e lower <= \e column <
+           \e upper, which also match the conditions of the filter.
+    \retval records -- The columns selected by the filter of the matching rows,
+           packed as for selectRows().
+    \param column   -- Name of a numerical column, e.g. <tt>"TIME"</tt>.
+    \param lower    -- Lower limit of the range, included.
+    \param upper    -- Upper limit of the range, excluded.
+
+    \return nofSelected -- The number of selected rows; -1 in case an error was
+            encountered.
+  */
+  long dalTable::selectRange (std::vector<hsize_t> &rows,
+			      std::vector<char> &records,
+			      std::string const &column,
+			      double const &lower,
+			      double const &upper)
+  {
+    return h5select (rows, &records, rangeConditions (column, lower, upper), 0, -1);
+  }
+
+  //_____________________________________________________________________________
+  //                                                          selectionRecordSize
+  
+  /*!
+    \return size -- Size of a record returned by selectRows() [bytes]; 0 in case
+            an error was encountered.
+  */
+  size_t dalTable::selectionRecordSize ()
+  {
+    if ( type != H5TYPE || !h5layout() ) {
+      return 0;
+    }
+    if (filter->columns().empty()) {
+      return recordSize_p;
+    }
+
+    size_t size = 0;
+    std::vector<int> fields;
+    if (h5fields (filter->columns(), fields, false)) {
+      for (unsigned int n=0; n<fields.size(); ++n) {
+	size += fieldSizes_p[fields[n]];
+      }
+    }
+    return size;
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                createZoneMap
+  
+  /*!
+    The zone map keeps the minimum and maximum value of the given columns for
+    every chunk of rows of the table; it is stored in the companion dataset
+    <tt>\<table\>_ZONEMAP</tt>, and replaces an existing zone map.
+
+    \param columns -- Comma-separated list of numerical columns, e.g.
+           <tt>"TIME"</tt>; all numerical columns if empty.
+
+    \return status -- Returns \e false if the zone map could not be created.
+  */
+  bool dalTable::createZoneMap (std::string const &columns)
+  {
+    if ( type != H5TYPE ) {
+      std::cerr << "Operation not yet supported for type " << type << ".  Sorry.\n";
+      return false;
+    }
+
+    std::vector<std::string> names;
+    std::vector<int> fields;
+    if (!h5layout() || !dalFilter::parseColumns (columns, names)) {
+      return false;
+    }
+    if (names.empty()) {
+      for (unsigned int n=0; n<nfields; ++n) {
+	H5T_class_t typeClass = H5Tget_member_class (layoutType_p, n);
+	if (typeClass == H5T_INTEGER || typeClass == H5T_FLOAT) {
+	  char *member = H5Tget_member_name (layoutType_p, n);
+	  names.push_back (member);
+	  H5free_memory (member);
+	}
+      }
+    }
+    if (names.empty()) {
+      std::cerr << "[dalTable::createZoneMap] No numerical columns in table "
+		<< name << std::endl;
+      return false;
+    }
+    if (!h5fields (names, fields, true)) {
+      return false;
+    }
+
+    /* Replace an existing zone map */
+    std::string zoneName = name + "_ZONEMAP";
+    if (zoneDataset_p >= 0) {
+      H5Dclose (zoneDataset_p);
+      zoneDataset_p = -1;
+    }
+    if (H5Lexists (fileID_p, zoneName.c_str(), H5P_DEFAULT) > 0) {
+      H5Ldelete (fileID_p, zoneName.c_str(), H5P_DEFAULT);
+    }
+
+    hsize_t width      = 2*names.size();
+    hsize_t dims[2]    = { 0, width };
+    hsize_t maxdims[2] = { H5S_UNLIMITED, width };
+    hsize_t chunk[2]   = { std::max (hsize_t(1), 4096/width), width };
+    hid_t dataspace    = H5Screate_simple (2, dims, maxdims);
+    hid_t plist        = H5Pcreate (H5P_DATASET_CREATE);
+    H5Pset_chunk (plist, 2, chunk);
+
+    zoneDataset_p = H5Dcreate (fileID_p, zoneName.c_str(), H5T_NATIVE_DOUBLE,
+			       dataspace, H5P_DEFAULT, plist, H5P_DEFAULT);
+    H5Pclose (plist);
+    H5Sclose (dataspace);
+
+    if (zoneDataset_p < 0) {
+      std::cerr << "[dalTable::createZoneMap] Failed to create dataset "
+		<< zoneName << std::endl;
+      return false;
+    }
+
+    zoneColumns_p  = names;
+    zoneFields_p   = fields;
+    zoneSize_p     = h5chunkSize();
+    zoneRows_p     = 0;
+    zoneModified_p = 0;
+    zoneBounds_p.clear();
+
+    bool ok = h5set_attribute (zoneDataset_p, "COLUMNS", names)
+      && h5set_attribute (zoneDataset_p, "ZONE_SIZE", (unsigned long long)(zoneSize_p))
+      && h5set_attribute (zoneDataset_p, "NOF_ROWS", (unsigned long long)(zoneRows_p));
+
+    if (ok && nofRecords_p > 0) {
+      ok = h5zoneScan (0, (nofRecords_p-1)/zoneSize_p);
+      zoneRows_p = nofRecords_p;
+    }
+
+    return ok && h5zoneFlush();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   hasZoneMap
+  
+  /*!
+    \return hasZoneMap -- Returns \e true if the table is an HDF5 table with a
+            zone map, see createZoneMap().
+  */
+  bool dalTable::hasZoneMap ()
+  {
+    return type == H5TYPE && h5layout() && zoneDataset_p >= 0;
   }
   
   // ---------------------------------------------------------- getColumnData
@@ -687,6 +979,7 @@ namespace DAL {
                             std::string groupname )
   {
     if ( type == H5TYPE ) {
+      h5layout_reset ();
       name = groupname + '/' + tablename;
       hid_t * lclfile = (hid_t*)voidfile; // H5File object
       file = lclfile;
@@ -773,6 +1066,9 @@ namespace DAL {
         // columns are added
         //
 
+        h5layout_reset ();
+        // the first rows appended through this handle replace the dummy record
+        firstrecord = true;
         name = groupname + '/' + tablename;// set the private class variable: name
         // cast the voidfile to an hdf5 file
         hid_t * lclfile = (hid_t*)voidfile; // H5File object
@@ -815,6 +1111,779 @@ namespace DAL {
 
   }
 
+  //_____________________________________________________________________________
+  //                                                                     h5layout
+
+  /*!
+    Open the table dataset and retrieve the native compound type of its
+    records, together with the sizes and offsets of the individual fields; if
+    this already has been done before, the cached layout is kept.
+
+    \return status -- Status of the operation; returns \e false in case an error
+            was encountered.
+  */
+  bool dalTable::h5layout ()
+  {
+    if (layoutType_p >= 0) {
+      return true;
+    }
+
+    layoutDataset_p = H5Dopen (fileID_p, name.c_str(), H5P_DEFAULT);
+    if (layoutDataset_p < 0) {
+      std::cerr << "[dalTable::h5layout] Failed to open table " << name
+		<< std::endl;
+      return false;
+    }
+
+    hid_t fileType = H5Dget_type (layoutDataset_p);
+    layoutType_p   = H5Tget_native_type (fileType, H5T_DIR_DEFAULT);
+    H5Tclose (fileType);
+
+    if (layoutType_p < 0) {
+      std::cerr << "[dalTable::h5layout] Failed to resolve record type of table "
+		<< name << std::endl;
+      h5layout_reset ();
+      return false;
+    }
+
+    recordSize_p = H5Tget_size (layoutType_p);
+    nfields      = H5Tget_nmembers (layoutType_p);
+    fieldSizes_p.resize (nfields);
+    fieldOffsets_p.resize (nfields);
+
+    for (unsigned int n=0; n<nfields; ++n) {
+      hid_t memberType  = H5Tget_member_type (layoutType_p, n);
+      fieldSizes_p[n]   = H5Tget_size (memberType);
+      fieldOffsets_p[n] = H5Tget_member_offset (layoutType_p, n);
+      H5Tclose (memberType);
+    }
+
+    hid_t dataspace = H5Dget_space (layoutDataset_p);
+    H5Sget_simple_extent_dims (dataspace, &nofRecords_p, NULL);
+    H5Sclose (dataspace);
+
+    h5zoneLoad ();
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                               h5layout_reset
+
+  void dalTable::h5layout_reset ()
+  {
+    if (zoneDataset_p >= 0) {
+      h5zoneFlush ();
+      H5Dclose (zoneDataset_p);
+    }
+    if (layoutType_p >= 0) {
+      H5Tclose (layoutType_p);
+    }
+    if (layoutDataset_p >= 0) {
+      H5Dclose (layoutDataset_p);
+    }
+
+    layoutDataset_p = -1;
+    layoutType_p    = -1;
+    recordSize_p    = 0;
+    fieldSizes_p.clear();
+    fieldOffsets_p.clear();
+
+    zoneDataset_p   = -1;
+    zoneSize_p      = 0;
+    zoneRows_p      = 0;
+    zoneModified_p  = 0;
+    zoneColumns_p.clear();
+    zoneFields_p.clear();
+    zoneBounds_p.clear();
+  }
+
+  //_____________________________________________________________________________
+  //                                                               h5writeRecords
+
+  /*!
+    \param data       -- Records to be written, laid out as the native compound
+           type of the table.
+    \param start      -- Index of the first record to be written.
+    \param nofRecords -- Number of records to be written; the table is extended
+           if the records reach beyond its current end.
+
+    \return status -- Status of the operation; returns \e false in case an error
+            was encountered.
+  */
+  bool dalTable::h5writeRecords (void const *data,
+				 hsize_t const &start,
+				 hsize_t const &nofRecords)
+  {
+    if (!h5layout()) {
+      return false;
+    }
+
+    herr_t h5err    = 0;
+    hsize_t count   = nofRecords;
+    hsize_t offset  = start;
+    hsize_t extent  = 0;
+    hid_t fileSpace = H5Dget_space (layoutDataset_p);
+
+    H5Sget_simple_extent_dims (fileSpace, &extent, NULL);
+
+    if (start+nofRecords > extent) {
+      extent = start+nofRecords;
+      if (H5Dset_extent (layoutDataset_p, &extent) < 0
+	  || H5Sset_extent_simple (fileSpace, 1, &extent, NULL) < 0) {
+	std::cerr << "[dalTable::h5writeRecords] Failed to extend table "
+		  << name << std::endl;
+	H5Sclose (fileSpace);
+	return false;
+      }
+    }
+
+    hid_t memorySpace = H5Screate_simple (1, &count, NULL);
+
+    h5err = H5Sselect_hyperslab (fileSpace, H5S_SELECT_SET, &offset, NULL, &count, NULL);
+    if (h5err >= 0) {
+      h5err = H5Dwrite (layoutDataset_p, layoutType_p, memorySpace, fileSpace,
+			H5P_DEFAULT, data);
+    }
+    if (h5err < 0) {
+      std::cerr << "[dalTable::h5writeRecords] Failed to write records to table "
+		<< name << std::endl;
+    }
+
+    nofRecords_p = extent;
+
+    H5Sclose (memorySpace);
+    H5Sclose (fileSpace);
+
+    return h5err >= 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                h5readRecords
+
+  /*!
+    \param memType    -- Layout of the records in memory; a compound type
+           holding a subset of the fields of the table converts only these.
+    \param start      -- Index of the first record to be read.
+    \param nofRecords -- Number of records to be read.
+    \retval data      -- Buffer receiving the records.
+
+    \return status -- Status of the operation; returns \e false in case an error
+            was encountered.
+  */
+  bool dalTable::h5readRecords (hid_t const &memType,
+				hsize_t const &start,
+				hsize_t const &nofRecords,
+				void *data)
+  {
+    herr_t h5err      = 0;
+    hsize_t offset    = start;
+    hsize_t count     = nofRecords;
+    hid_t fileSpace   = H5Dget_space (layoutDataset_p);
+    hid_t memorySpace = H5Screate_simple (1, &count, NULL);
+
+    h5err = H5Sselect_hyperslab (fileSpace, H5S_SELECT_SET, &offset, NULL,
+				 &count, NULL);
+    if (h5err >= 0) {
+      h5err = H5Dread (layoutDataset_p, memType, memorySpace, fileSpace,
+		       H5P_DEFAULT, data);
+    }
+
+    H5Sclose (memorySpace);
+    H5Sclose (fileSpace);
+
+    return h5err >= 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     h5fields
+
+  /*!
+    \param names     -- Names of the fields.
+    \retval indices  -- Indices of the fields within a record.
+    \param numerical -- Require the fields to be numerical scalars?
+
+    \return status -- Returns \e false if a field does not exist or is not a
+            numerical scalar although required.
+  */
+  bool dalTable::h5fields (std::vector<std::string> const &names,
+			   std::vector<int> &indices,
+			   bool const &numerical)
+  {
+    indices.resize (names.size());
+
+    for (unsigned int n=0; n<names.size(); ++n) {
+      indices[n] = H5Tget_member_index (layoutType_p, names[n].c_str());
+      if (indices[n] < 0) {
+	std::cerr << "[dalTable::h5fields] No column " << names[n]
+		  << " in table " << name << std::endl;
+	return false;
+      }
+      if (numerical) {
+	H5T_class_t typeClass = H5Tget_member_class (layoutType_p, indices[n]);
+	if (typeClass != H5T_INTEGER && typeClass != H5T_FLOAT) {
+	  std::cerr << "[dalTable::h5fields] Column " << names[n]
+		    << " of table " << name << " is not a numerical scalar"
+		    << std::endl;
+	  return false;
+	}
+      }
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  gatherField
+
+  /*!
+    \param records    -- Records holding the field.
+    \param recordSize -- Size of a record [bytes].
+    \param nofRecords -- Number of records.
+    \retval values    -- Values of the field, converted to double precision.
+  */
+  template <class T>
+  static void gatherField (char const *records,
+			   size_t const &recordSize,
+			   size_t const &nofRecords,
+			   double *values)
+  {
+    for (size_t n=0; n<nofRecords; ++n) {
+      values[n] = *reinterpret_cast<T const *>(records+n*recordSize);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                h5gatherField
+
+  /*!
+    \param index      -- Index of the field within a record; the field has to
+           be a numerical scalar.
+    \param records    -- Records in the native layout of the table.
+    \param nofRecords -- Number of records.
+    \retval values    -- Values of the field, converted to double precision.
+  */
+  void dalTable::h5gatherField (int const &index,
+				char const *records,
+				size_t const &nofRecords,
+				double *values)
+  {
+    hid_t memberType    = H5Tget_member_type (layoutType_p, index);
+    size_t size         = fieldSizes_p[index];
+    bool isFloat        = H5Tget_class (memberType) == H5T_FLOAT;
+    bool isSigned       = isFloat || H5Tget_sign (memberType) == H5T_SGN_2;
+    char const *field   = records+fieldOffsets_p[index];
+    H5Tclose (memberType);
+
+    if (isFloat) {
+      if (size == sizeof(float)) {
+	gatherField<float> (field, recordSize_p, nofRecords, values);
+      } else {
+	gatherField<double> (field, recordSize_p, nofRecords, values);
+      }
+    } else if (size == 1) {
+      if (isSigned) gatherField<int8_t>  (field, recordSize_p, nofRecords, values);
+      else          gatherField<uint8_t> (field, recordSize_p, nofRecords, values);
+    } else if (size == 2) {
+      if (isSigned) gatherField<int16_t>  (field, recordSize_p, nofRecords, values);
+      else          gatherField<uint16_t> (field, recordSize_p, nofRecords, values);
+    } else if (size == 4) {
+      if (isSigned) gatherField<int32_t>  (field, recordSize_p, nofRecords, values);
+      else          gatherField<uint32_t> (field, recordSize_p, nofRecords, values);
+    } else {
+      if (isSigned) gatherField<int64_t>  (field, recordSize_p, nofRecords, values);
+      else          gatherField<uint64_t> (field, recordSize_p, nofRecords, values);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  h5chunkSize
+
+  /*!
+    \return chunk -- Number of rows per chunk of the table dataset; CHUNK_SIZE
+            if the dataset is not chunked.
+  */
+  hsize_t dalTable::h5chunkSize ()
+  {
+    hsize_t chunk = CHUNK_SIZE;
+    hid_t plist   = H5Dget_create_plist (layoutDataset_p);
+
+    if (H5Pget_layout (plist) != H5D_CHUNKED || H5Pget_chunk (plist, 1, &chunk) < 1) {
+      chunk = CHUNK_SIZE;
+    }
+    H5Pclose (plist);
+
+    return chunk;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     h5select
+
+  /*!
+    The rows are processed in batches of whole chunks of the table. Every
+    batch is read with a single <tt>H5Dread</tt> in the native layout of the
+    records -- which HDF5 serves without any conversion, whereas a compound
+    type holding just a subset of the fields would have to pass its generic
+    conversion engine at a fraction of the speed. The columns the conditions
+    refer to then are gathered into contiguous blocks of double precision
+    values, the conditions are applied to them by dalFilter::evaluate(), and
+    -- if requested -- the selected columns of the matching rows are copied.
+    If the table has a zone map, zones of rows whose bounds rule out one of
+    the conditions are not read at all.
+
+    \retval rows       -- Indices of the matching rows.
+    \retval records    -- Selected columns of the matching rows; not copied if
+           \e NULL.
+    \param conditions  -- Conditions the rows have to fulfil.
+    \param start       -- Index of the first row to consider.
+    \param nofRows  -- Number of rows to consider; all up to the end of the
+           table if negative.
+
+    \return nofSelected -- The number of selected rows; -1 in case an error was
+            encountered.
+  */
+  long dalTable::h5select (std::vector<hsize_t> &rows,
+			   std::vector<char> *records,
+			   std::vector<dalFilter::Condition> const &conditions,
+			   long const &start,
+			   long const &nofRows)
+  {
+    rows.clear();
+    nofRowsScanned_p = 0;
+    if (records != NULL) {
+      records->clear();
+    }
+
+    if ( type != H5TYPE ) {
+      std::cerr << "Operation not yet supported for type " << type << ".  Sorry.\n";
+      return -1;
+    }
+    if (!h5layout() || start < 0) {
+      return -1;
+    }
+
+    /* Columns the conditions refer to, each of them gathered only once */
+    std::vector<std::string> names;
+    std::vector<size_t> position (conditions.size());
+    for (unsigned int n=0; n<conditions.size(); ++n) {
+      position[n] = std::find (names.begin(), names.end(), conditions[n].column)
+	- names.begin();
+      if (position[n] == names.size()) {
+	names.push_back (conditions[n].column);
+      }
+    }
+
+    std::vector<int> predicateFields;
+    std::vector<int> selectedFields;
+    if (!h5fields (names, predicateFields, true)
+	|| !h5fields (filter->columns(), selectedFields, false)) {
+      return -1;
+    }
+    if (selectedFields.empty()) {
+      for (unsigned int n=0; n<nfields; ++n) {
+	selectedFields.push_back (n);
+      }
+    }
+    size_t selectionSize = 0;
+    for (unsigned int n=0; n<selectedFields.size(); ++n) {
+      selectionSize += fieldSizes_p[selectedFields[n]];
+    }
+
+    /* Batches of whole chunks, of at least 64k rows */
+    hsize_t chunk = h5chunkSize();
+    hsize_t batch = chunk*((65536+chunk-1)/chunk);
+
+    hsize_t end = nofRecords_p;
+    if (nofRows >= 0 && hsize_t(start+nofRows) < end) {
+      end = start+nofRows;
+    }
+
+    /* Ranges of rows to read, leaving out the zones ruled out by the map */
+    std::vector<std::pair<hsize_t,hsize_t> > ranges;
+    std::vector<int> zoneColumn (conditions.size(), -1);
+    bool prune = false;
+    for (unsigned int n=0; n<conditions.size(); ++n) {
+      zoneColumn[n] = std::find (zoneColumns_p.begin(), zoneColumns_p.end(),
+				 conditions[n].column) - zoneColumns_p.begin();
+      if (zoneColumn[n] == int(zoneColumns_p.size())) {
+	zoneColumn[n] = -1;
+      }
+      prune = prune || (zoneDataset_p >= 0 && zoneColumn[n] >= 0);
+    }
+
+    if (prune && hsize_t(start) < end) {
+      size_t width    = 2*zoneColumns_p.size();
+      hsize_t nofZones = zoneBounds_p.size()/width;
+      for (hsize_t zone=start/zoneSize_p; zone*zoneSize_p<end; ++zone) {
+	hsize_t first = std::max (hsize_t(start), zone*zoneSize_p);
+	hsize_t last  = std::min (end, (zone+1)*zoneSize_p);
+	bool overlaps = true;
+	/* Only zones fully covered by the map can be ruled out */
+	if (zone < nofZones
+	    && std::min (nofRecords_p, (zone+1)*zoneSize_p) <= zoneRows_p) {
+	  double const *bounds = &zoneBounds_p[zone*width];
+	  for (unsigned int n=0; overlaps && n<conditions.size(); ++n) {
+	    if (zoneColumn[n] >= 0) {
+	      overlaps = dalFilter::overlaps (conditions[n],
+					      bounds[2*zoneColumn[n]],
+					      bounds[2*zoneColumn[n]+1]);
+	    }
+	  }
+	}
+	if (!overlaps) {
+	  continue;
+	}
+	if (!ranges.empty() && ranges.back().second == first) {
+	  ranges.back().second = last;
+	} else {
+	  ranges.push_back (std::make_pair (first, last));
+	}
+      }
+    } else if (hsize_t(start) < end) {
+      ranges.push_back (std::make_pair (hsize_t(start), end));
+    }
+
+    /* Split the ranges into batches: first row and number of rows */
+    std::vector<std::pair<hsize_t,hsize_t> > batches;
+    for (unsigned int r=0; r<ranges.size(); ++r) {
+      for (hsize_t first=ranges[r].first; first<ranges[r].second; first+=batch) {
+	batches.push_back (std::make_pair (first,
+					   std::min (batch, ranges[r].second-first)));
+      }
+    }
+
+    bool ok = true;
+    bool needRecords = !names.empty() || records != NULL;
+    std::vector<char> buffer;
+    std::vector<double> values;
+    std::vector<unsigned char> mask;
+
+    for (unsigned int b=0; ok && b<batches.size(); ++b) {
+      hsize_t first  = batches[b].first;
+      hsize_t count  = batches[b].second;
+      size_t matched = rows.size();
+
+      if (needRecords) {
+	buffer.resize (count*recordSize_p);
+	ok = h5readRecords (layoutType_p, first, count, &buffer[0]);
+	nofRowsScanned_p += count;
+      }
+
+      mask.assign (count, 1);
+      if (ok && !names.empty()) {
+	values.resize (count*names.size());
+	for (unsigned int n=0; n<names.size(); ++n) {
+	  h5gatherField (predicateFields[n], &buffer[0], count, &values[n*count]);
+	}
+	for (unsigned int n=0; n<conditions.size(); ++n) {
+	  dalFilter::evaluate (conditions[n], &values[position[n]*count], 1,
+			       count, &mask[0]);
+	}
+      }
+      for (hsize_t n=0; ok && n<count; ++n) {
+	if (mask[n]) {
+	  rows.push_back (first+n);
+	}
+      }
+
+      /* Copy the selected fields of the matching rows */
+      if (ok && records != NULL && rows.size() > matched) {
+	size_t pos = records->size();
+	records->resize (pos+(rows.size()-matched)*selectionSize);
+	for (size_t n=matched; n<rows.size(); ++n) {
+	  char const *record = &buffer[(rows[n]-first)*recordSize_p];
+	  for (unsigned int k=0; k<selectedFields.size(); ++k) {
+	    size_t size = fieldSizes_p[selectedFields[k]];
+	    memcpy (&(*records)[pos], record+fieldOffsets_p[selectedFields[k]], size);
+	    pos += size;
+	  }
+	}
+      }
+    }
+
+    if (!ok) {
+      std::cerr << "[dalTable::h5select] Failed to read records of table "
+		<< name << std::endl;
+      rows.clear();
+      if (records != NULL) {
+	records->clear();
+      }
+      return -1;
+    }
+
+    return rows.size();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 h5getStrings
+
+  /*!
+    \param location -- HDF5 object the attribute is attached to.
+    \param name     -- Name of the attribute.
+    \retval value   -- Values of the attribute, written as variable-length
+           strings by h5set_attribute().
+
+    \return status -- Returns \e false if the attribute could not be read.
+  */
+  static bool h5getStrings (hid_t const &location,
+			    std::string const &name,
+			    std::vector<std::string> &value)
+  {
+    hid_t attribute = H5Aopen (location, name.c_str(), H5P_DEFAULT);
+    if (attribute < 0) {
+      return false;
+    }
+
+    hid_t dataspace = H5Aget_space (attribute);
+    hid_t datatype  = H5Tcopy (H5T_C_S1);
+    H5Tset_size (datatype, H5T_VARIABLE);
+    std::vector<char *> buffer (H5Sget_simple_extent_npoints (dataspace));
+
+    bool ok = !buffer.empty()
+      && H5Aread (attribute, datatype, &buffer[0]) >= 0;
+    if (ok) {
+      value.assign (buffer.begin(), buffer.end());
+      H5Dvlen_reclaim (datatype, dataspace, H5P_DEFAULT, &buffer[0]);
+    }
+
+    H5Tclose (datatype);
+    H5Sclose (dataspace);
+    H5Aclose (attribute);
+
+    return ok;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   h5zoneLoad
+
+  /*!
+    Open the companion dataset <tt>\<table\>_ZONEMAP</tt> and read the bounds
+    of all zones. A zone map which cannot be loaded, e.g. as it refers to
+    columns which no longer exist in the table, is ignored but left in the
+    file; createZoneMap() replaces it.
+
+    \return status -- Returns \e false if a zone map exists but could not be
+            loaded.
+  */
+  bool dalTable::h5zoneLoad ()
+  {
+    std::string zoneName = name + "_ZONEMAP";
+    if (H5Lexists (fileID_p, zoneName.c_str(), H5P_DEFAULT) <= 0) {
+      return true;
+    }
+
+    zoneDataset_p = H5Dopen (fileID_p, zoneName.c_str(), H5P_DEFAULT);
+    if (zoneDataset_p < 0) {
+      std::cerr << "[dalTable::h5zoneLoad] Failed to open zone map of table "
+		<< name << std::endl;
+      return false;
+    }
+
+    unsigned long long zoneSize = 0;
+    unsigned long long zoneRows = 0;
+    hsize_t dims[2]             = { 0, 0 };
+    hid_t dataspace             = H5Dget_space (zoneDataset_p);
+    H5Sget_simple_extent_dims (dataspace, dims, NULL);
+    H5Sclose (dataspace);
+
+    bool ok = h5getStrings (zoneDataset_p, "COLUMNS", zoneColumns_p)
+      && h5get_attribute (zoneDataset_p, "ZONE_SIZE", zoneSize)
+      && h5get_attribute (zoneDataset_p, "NOF_ROWS", zoneRows)
+      && zoneSize > 0
+      && dims[1] == 2*zoneColumns_p.size()
+      && h5fields (zoneColumns_p, zoneFields_p, true);
+
+    if (ok && dims[0] > 0) {
+      zoneBounds_p.resize (dims[0]*dims[1]);
+      ok = H5Dread (zoneDataset_p, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL,
+		    H5P_DEFAULT, &zoneBounds_p[0]) >= 0;
+    }
+
+    if (!ok) {
+      std::cerr << "[dalTable::h5zoneLoad] Ignoring invalid zone map of table "
+		<< name << std::endl;
+      H5Dclose (zoneDataset_p);
+      zoneDataset_p = -1;
+      zoneColumns_p.clear();
+      zoneFields_p.clear();
+      zoneBounds_p.clear();
+      return false;
+    }
+
+    zoneSize_p     = zoneSize;
+    zoneRows_p     = zoneRows;
+    zoneModified_p = dims[0];
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  h5zoneFlush
+
+  /*!
+    \return status -- Returns \e false if the zone map could not be written.
+  */
+  bool dalTable::h5zoneFlush ()
+  {
+    if (zoneDataset_p < 0) {
+      return true;
+    }
+
+    hsize_t width    = 2*zoneColumns_p.size();
+    hsize_t nofZones = zoneBounds_p.size()/width;
+    if (zoneModified_p >= nofZones) {
+      return true;
+    }
+
+    hsize_t dims[2]   = { nofZones, width };
+    hsize_t offset[2] = { zoneModified_p, 0 };
+    hsize_t count[2]  = { nofZones-zoneModified_p, width };
+    bool ok           = H5Dset_extent (zoneDataset_p, dims) >= 0;
+    hid_t fileSpace   = H5Dget_space (zoneDataset_p);
+    hid_t memorySpace = H5Screate_simple (2, count, NULL);
+
+    ok = ok
+      && H5Sselect_hyperslab (fileSpace, H5S_SELECT_SET, offset, NULL, count, NULL) >= 0
+      && H5Dwrite (zoneDataset_p, H5T_NATIVE_DOUBLE, memorySpace, fileSpace,
+		   H5P_DEFAULT, &zoneBounds_p[zoneModified_p*width]) >= 0
+      && h5set_attribute (zoneDataset_p, "NOF_ROWS", (unsigned long long)(zoneRows_p));
+
+    H5Sclose (memorySpace);
+    H5Sclose (fileSpace);
+
+    if (!ok) {
+      std::cerr << "[dalTable::h5zoneFlush] Failed to write zone map of table "
+		<< name << std::endl;
+      return false;
+    }
+
+    zoneModified_p = nofZones;
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  h5zoneMerge
+
+  /*!
+    \param records    -- Records in the native layout of the table.
+    \param start      -- Index of the row the first record belongs to.
+    \param nofRecords -- Number of records.
+  */
+  void dalTable::h5zoneMerge (char const *records,
+			      hsize_t const &start,
+			      hsize_t const &nofRecords)
+  {
+    size_t width     = 2*zoneColumns_p.size();
+    hsize_t end      = start+nofRecords;
+    hsize_t nofZones = (end+zoneSize_p-1)/zoneSize_p;
+
+    /* New zones start out empty */
+    while (zoneBounds_p.size() < nofZones*width) {
+      zoneBounds_p.push_back (HUGE_VAL);
+      zoneBounds_p.push_back (-HUGE_VAL);
+    }
+
+    std::vector<double> values (nofRecords);
+
+    for (unsigned int k=0; k<zoneFields_p.size(); ++k) {
+      h5gatherField (zoneFields_p[k], records, nofRecords, &values[0]);
+      for (hsize_t first=start; first<end; ) {
+	hsize_t zone = first/zoneSize_p;
+	hsize_t last = std::min (end, (zone+1)*zoneSize_p);
+	double min   = zoneBounds_p[zone*width+2*k];
+	double max   = zoneBounds_p[zone*width+2*k+1];
+	/* NaN values fail both comparisons and thus are left out */
+	for (double const *v=&values[first-start]; v<&values[last-start]; ++v) {
+	  min = *v < min ? *v : min;
+	  max = *v > max ? *v : max;
+	}
+	zoneBounds_p[zone*width+2*k]   = min;
+	zoneBounds_p[zone*width+2*k+1] = max;
+	first = last;
+      }
+    }
+
+    zoneModified_p = std::min (zoneModified_p, start/zoneSize_p);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   h5zoneScan
+
+  /*!
+    \param firstZone -- Index of the first zone to recompute.
+    \param lastZone  -- Index of the last zone to recompute.
+
+    \return status -- Returns \e false if the records could not be read.
+  */
+  bool dalTable::h5zoneScan (hsize_t const &firstZone,
+			     hsize_t const &lastZone)
+  {
+    size_t width = 2*zoneColumns_p.size();
+    hsize_t end  = std::min (nofRecords_p, (lastZone+1)*zoneSize_p);
+    hsize_t batch = zoneSize_p*((65536+zoneSize_p-1)/zoneSize_p);
+    std::vector<char> buffer;
+
+    /* Reset the bounds of the zones */
+    for (hsize_t n=firstZone*width; n<(lastZone+1)*width && n<zoneBounds_p.size(); n+=2) {
+      zoneBounds_p[n]   = HUGE_VAL;
+      zoneBounds_p[n+1] = -HUGE_VAL;
+    }
+
+    for (hsize_t first=firstZone*zoneSize_p; first<end; first+=batch) {
+      hsize_t count = std::min (batch, end-first);
+      buffer.resize (count*recordSize_p);
+      if (!h5readRecords (layoutType_p, first, count, &buffer[0])) {
+	std::cerr << "[dalTable::h5zoneScan] Failed to read records of table "
+		  << name << std::endl;
+	return false;
+      }
+      h5zoneMerge (&buffer[0], first, count);
+    }
+
+    zoneModified_p = std::min (zoneModified_p, firstZone);
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 h5zoneUpdate
+
+  /*!
+    Records appended right behind the rows covered by the zone map are merged
+    into the bounds of their zones; if rows have been overwritten or skipped
+    instead, the affected zones are rescanned.
+
+    \param data       -- Records which have been written, laid out as the
+           native compound type of the table.
+    \param start      -- Index of the first record written.
+    \param nofRecords -- Number of records written.
+
+    \return status -- Returns \e false if the zone map could not be updated.
+  */
+  bool dalTable::h5zoneUpdate (void const *data,
+			       hsize_t const &start,
+			       hsize_t const &nofRecords)
+  {
+    if (zoneDataset_p < 0 || nofRecords < 1) {
+      return true;
+    }
+
+    hsize_t end = start+nofRecords;
+
+    if (start == zoneRows_p) {
+      h5zoneMerge (reinterpret_cast<char const *>(data), start, nofRecords);
+      zoneRows_p = end;
+      return true;
+    }
+
+    hsize_t first = std::min (start, zoneRows_p);
+    if (!h5zoneScan (first/zoneSize_p, (end-1)/zoneSize_p)) {
+      return false;
+    }
+    zoneRows_p = std::max (zoneRows_p, end);
+
+    return true;
+  }
+
   //_____________________________________________________________________________
   //                                                            h5addColumn_setup
 
@@ -910,23 +1979,19 @@ namespace DAL {
   //                                                           h5addColumn_insert
 
   /*!
-    \param indims       -- Numer of dimensions
     \param colname      -- Name of the table column
     \param field_type   -- 
     \param removedummay -- 
   */
-  void dalTable::h5addColumn_insert (uint const & indims,
-                                     std::string const & colname,
+  void dalTable::h5addColumn_insert (std::string const & colname,
                                      hid_t const & field_type,
                                      bool const & removedummy )
   {
-    // set additional required fields for new column call
-    int * data = NULL;
-    data       = new int[indims];
-
-    for (unsigned int idx=0; idx<indims; idx++) {
-      data[idx] = 0;
-    }
+    /* The new column is filled with zeros for each of the records the table
+       already holds; H5TBinsert_field reads one field value per record from
+       the data buffer, so it has to cover all of them. */
+    hsize_t nofValues = (nofRecords_p > 0) ? nofRecords_p : 1;
+    std::vector<char> data (nofValues*H5Tget_size(field_type), 0);
 
     // create the new column
     status = H5TBinsert_field (fileID_p,
@@ -934,11 +1999,8 @@ namespace DAL {
 			       colname.c_str(),
                                field_type,
 			       nfields,
-			       data,
-			       data);
-
-    delete [] data;
-    data = NULL;
+			       &data[0],
+			       &data[0]);
 
     if ( removedummy ) {
       removeColumn("000dummy000");
@@ -961,6 +2023,7 @@ namespace DAL {
     if ( type == H5TYPE ) {
       bool removedummy = false;
       
+      h5layout_reset ();
       h5addColumn_setup( colname, removedummy );
       
       // set the column type
@@ -1061,7 +2124,7 @@ namespace DAL {
 	field_type = h5type;
       }
       
-      h5addColumn_insert( indims, colname, field_type, removedummy );
+      h5addColumn_insert( colname, field_type, removedummy );
     }
     else {
       std::cerr << "Operation not yet supported for type " << type << ".  Sorry.\n";
@@ -1090,6 +2153,7 @@ namespace DAL {
       {
         bool removedummy = false;
 
+        h5layout_reset ();
         h5addColumn_setup( compname, removedummy );
 
         // ----------   begin complex column-specific code. -------------
@@ -1143,7 +2207,7 @@ namespace DAL {
 	
 	// ----------   end complex column-specific code. -------------
 
-        h5addColumn_insert( subfields, compname, fieldtype, removedummy );
+        h5addColumn_insert( compname, fieldtype, removedummy );
 
         return;
 
@@ -1175,6 +2239,7 @@ namespace DAL {
   {
     if ( type == H5TYPE )
       {
+        h5layout_reset ();
         status = H5TBget_table_info (fileID_p,
 				     name.c_str(),
 				     &nfields,
@@ -1246,24 +2311,15 @@ namespace DAL {
   {
     if ( type == H5TYPE )
       {
-	
-        size_t * field_sizes = NULL;
-        size_t * field_offsets = NULL;
-        size_t * size_out = NULL;
-	
-        // retrieve the input fields needed for the append_records call
-        H5TBget_table_info ( fileID_p, name.c_str(), &nfields, &nofRecords_p );
-	
-        field_sizes   = new size_t[ nfields ];
-        field_offsets = new size_t[ nfields ];
-        size_out      = new size_t[ 1 ];
-
-        status = H5TBget_field_info( fileID_p, name.c_str(), NULL, field_sizes,
-                                     field_offsets, size_out );
-        /*
-         * Cleanup to make more efficient.  Check the last three fields for
-         * H5TBget_field_info();
-         */
+        if (!h5layout()) {
+          return;
+        }
+        if (index < 0 || index >= int(fieldSizes_p.size())) {
+          std::cerr << "[dalTable::writeDataByColNum] Column index " << index
+                    << " out of range." << endl;
+          return;
+        }
+
         int num_fields 		= 1;	  // number of fields to overwrite
         const int inum		= index;  // column number to overwrite
         const int * index_num	= &inum;  // pointer to column number to overwrite
@@ -1271,18 +2327,18 @@ namespace DAL {
         hsize_t numrecords	= nrecs;	  // number of records to write
 
         size_t col_offset[1] = { 0 };
-        size_t col_size[1] = { field_sizes[index] };
+        size_t col_size[1] = { fieldSizes_p[index] };
         status = H5TBwrite_fields_index(fileID_p, name.c_str(), num_fields,
                                         index_num, start, numrecords, *col_size,
                                         col_offset, col_size, data);
 
-        delete [] field_sizes;
-        field_sizes = NULL;
-        delete [] field_offsets;
-        field_offsets = NULL;
-        delete [] size_out;
-        size_out = NULL;
-
+        /* Rescan the zones holding the overwritten values */
+        if (status >= 0 && numrecords > 0 && start < zoneRows_p
+            && std::find (zoneFields_p.begin(), zoneFields_p.end(), index)
+               != zoneFields_p.end()) {
+          h5zoneScan (start/zoneSize_p,
+                      (std::min (start+numrecords, zoneRows_p)-1)/zoneSize_p);
+        }
       }
     else {
       std::cerr << "Operation not yet supported for type " << type << ".  Sorry.\n";
@@ -1303,46 +2359,7 @@ namespace DAL {
   */
   void dalTable::appendRow( void * data )
   {
-    if ( type == H5TYPE )
-      {
-        hsize_t recs2write     = 1; // number of records to append
-        size_t * field_sizes   = NULL;
-        size_t * field_offsets = NULL;
-        size_t * size_out      = NULL;
-
-        // retrieve the input fields needed for the append_records call
-        H5TBget_table_info ( fileID_p, name.c_str(), &nfields, &nofRecords_p );
-
-        field_sizes = (size_t*)malloc( nfields * sizeof(size_t) );
-        field_offsets = (size_t*)malloc( nfields * sizeof(size_t) );
-        size_out = (size_t*)malloc( sizeof(size_t) );
-
-        status = H5TBget_field_info( fileID_p, name.c_str(), NULL, field_sizes,
-                                     field_offsets, size_out );
-
-        if ( firstrecord )
-          {
-            hsize_t start = 0;
-            hsize_t numrows = 1;
-            status = H5TBwrite_records( fileID_p, name.c_str(), start,
-                                        numrows, *size_out, field_offsets, field_sizes,
-                                        data);
-            firstrecord = false;
-          }
-        else
-          {
-            status = H5TBappend_records ( fileID_p, name.c_str(), recs2write,
-                                          *size_out, field_offsets,
-                                          field_sizes, data );
-          }
-        free( field_sizes );
-        free( field_offsets );
-        free( size_out );
-      }
-    else
-      {
-        std::cerr << "Operation not yet supported for type " << type << ".  Sorry.\n";
-      }
+    appendRows (data, 1);
   }
 
   //_____________________________________________________________________________
@@ -1351,7 +2368,15 @@ namespace DAL {
   /*!
     \brief Append multiple rows.
 
-    Append multiple rows to the end of the table.
+    Append multiple rows to the end of the table. The first rows written
+    through the handle which created the table replace the single empty record
+    it has been created with, unless other handles have appended rows before;
+    a handle obtained by opening a table always appends after its last row. A
+    zone map of the table is updated along with the rows.
+
+    The number of records is re-read from the table before every append, such
+    that several handles may append to the same table in turn without
+    overwriting each other's rows.
 
     \param data The data you want to write at the end of the table.  The
                 structure of the data parameter should match that of the
@@ -1362,43 +2387,24 @@ namespace DAL {
   {
     if ( type == H5TYPE )
       {
-        size_t * field_sizes = NULL;
-        size_t * field_offsets = NULL;
-        size_t * size_out = NULL;
+        if (row_count < 1 || !h5layout()) {
+          return;
+        }
 
-        // retrieve the input fields needed for the append_records call
-        H5TBget_table_info( fileID_p, name.c_str(), &nfields, &nofRecords_p );
+        /* Another handle may have appended rows in the meantime */
+        hid_t dataspace = H5Dget_space (layoutDataset_p);
+        H5Sget_simple_extent_dims (dataspace, &nofRecords_p, NULL);
+        H5Sclose (dataspace);
 
-        field_sizes  = (size_t *)malloc((size_t)nfields * sizeof(size_t));
-        field_offsets = (size_t *)malloc((size_t)nfields * sizeof(size_t));
-        size_out = (size_t*)malloc( sizeof(size_t) );
+        /* Only the empty record of a table created by this handle is replaced */
+        hsize_t start = (firstrecord && nofRecords_p <= 1) ? 0 : nofRecords_p;
 
-        status = H5TBget_field_info( fileID_p, name.c_str(), NULL, field_sizes,
-                                     field_offsets, size_out );
+        status = h5writeRecords (data, start, row_count) ? 0 : -1;
+        firstrecord = false;
 
-        if ( firstrecord )
-          {
-            hsize_t start = 0;
-            if (row_count>1)
-              {
-                status = H5TBappend_records ( fileID_p, name.c_str(),
-                                              (hsize_t)row_count-1, *size_out,
-                                              field_offsets, field_sizes, data);
-              }
-            status = H5TBwrite_records( fileID_p, name.c_str(), start,
-                                        (hsize_t)row_count, *size_out,
-                                        field_offsets, field_sizes, data );
-            firstrecord = false;
-          }
-        else
-          {
-            status = H5TBappend_records ( fileID_p, name.c_str(),
-                                          (hsize_t)row_count, *size_out,
-                                          field_offsets, field_sizes, data);
-          }
-        free( field_sizes );
-        free( field_offsets );
-        free( size_out );
+        if (status >= 0) {
+          h5zoneUpdate (data, start, row_count);
+        }
       }
     else
       {
@@ -1697,42 +2703,23 @@ namespace DAL {
   {
     if ( type == H5TYPE )
       {
-        size_t * field_sizes = NULL;
-        size_t * field_offsets = NULL;
-        size_t * size_out = NULL;
-
-        // retrieve the input fields needed for the append_records call
-        H5TBget_table_info ( fileID_p, name.c_str(), &nfields, &nofRecords_p );
-
-        field_sizes = (size_t*)malloc( nfields * sizeof(size_t) );
-        field_offsets = (size_t*)malloc( nfields * sizeof(size_t) );
-        size_out = (size_t*)malloc( sizeof(size_t) );
-        field_names = (char**)malloc( nfields * sizeof(char*) );
-        for (unsigned int ii=0; ii<nfields; ii++)
-          {
-            field_names[ii] = (char*)malloc(MAX_COL_NAME_SIZE*sizeof(char));
-          }
-
-        status = H5TBget_field_info( fileID_p, name.c_str(), field_names,
-                                     field_sizes, field_offsets, size_out );
+        if (!h5layout()) {
+          return;
+        }
 
         hsize_t start = nstart;
         hsize_t nrecs = numberRecs;
 
-        if (buffersize > 0)
-          size_out[0] = buffersize;
-        status = H5TBread_records( fileID_p, name.c_str(), start, nrecs,
-                                   size_out[0], field_offsets, field_sizes,
-                                   data_out );
+        if (buffersize > 0 && size_t(buffersize) != recordSize_p) {
+          /* Records are laid out differently in memory */
+          status = H5TBread_records( fileID_p, name.c_str(), start, nrecs,
+                                     buffersize, &fieldOffsets_p[0],
+                                     &fieldSizes_p[0], data_out );
+        }
+        else {
+          status = h5readRecords (layoutType_p, start, nrecs, data_out) ? 0 : -1;
+        }
 
-        free(field_sizes);
-        free(field_offsets);
-        free(size_out);
-        for (unsigned int ii=0; ii<nfields; ii++)
-          {
-            free(field_names[ii]);
-          }
-        free(field_names);
         if (status < 0)
           {
             std::cerr << "ERROR: Problem reading records. Row buffer may be too big."
@@ -47,6 +47,46 @@ namespace DAL {
 
     A dalTable can reside within a dataset, or within a group that is within
     a dataset.
+
+    For an HDF5 table the layout of a record -- the native compound type, the
+    record size and the sizes and offsets of the fields -- is resolved once
+    and kept until the columns of the table are changed through addColumn()
+    or removeColumn(). appendRow(), appendRows() and readRows() then move the
+    records with a single <tt>H5Dwrite</tt>/<tt>H5Dread</tt> on the cached
+    type, instead of querying the table layout for every call.
+
+    A filter set through setFilter() is evaluated for an HDF5 table by
+    selectRows(): the table is scanned in batches of whole chunks, gathering
+    the columns the conditions refer to into contiguous blocks of double
+    precision values and applying the conditions to them with the vectorised
+    kernels of dalFilter::evaluate(). The indices of the matching
+    rows are returned, optionally together with the selected columns of those
+    rows, packed in the order of the selection (see selectionRecordSize()).
+
+    \code
+    table->setFilter ("TIME,DATA", "ANTENNA1=1 AND ANTENNA2=10");
+    std::vector<hsize_t> rows;
+    std::vector<char> records;
+    table->selectRows (rows, records);
+    \endcode
+
+    Time-ordered tables can be given a zone map by createZoneMap(): for
+    every chunk of rows -- a zone -- the minimum and maximum value of each
+    numerical column is kept in a companion dataset <tt>\<table\>_ZONEMAP</tt>,
+    a [zones,2*columns] array of doubles with the attributes
+    <tt>COLUMNS</tt>, <tt>ZONE_SIZE</tt> and <tt>NOF_ROWS</tt> (the number of
+    rows the map covers). The map is loaded along with the layout of the
+    table, kept up to date by appendRows() and writeDataByColNum() -- rows
+    appended to the end are merged into the bounds of their zones, all other
+    changes are rescanned -- and written back when the table is closed.
+    selectRows() and selectRange() skip every zone whose bounds rule out one
+    of the conditions, such that a time window on a table of several GB only
+    reads the chunks overlapping it.
+
+    \code
+    table->createZoneMap ("TIME");
+    table->selectRange (rows, records, "TIME", t0, t1);
+    \endcode
   */
   
   class dalTable {
@@ -68,10 +108,38 @@ namespace DAL {
     //! Table access filter
     dalFilter * filter;
     
+    //! Does the table still hold the empty record it has been created with?
     bool firstrecord;
     std::string name;  // table name
     std::string type;  // "HDF5", "MSCASA" or "FITS"; for example
     std::vector<dalColumn> columns; // list of table columns
+
+    //! HDF5 table dataset, opened for the cached layout
+    hid_t layoutDataset_p;
+    //! Native compound type of a table record
+    hid_t layoutType_p;
+    //! Size of a table record [bytes]
+    size_t recordSize_p;
+    //! Sizes of the fields within a record [bytes]
+    std::vector<size_t> fieldSizes_p;
+    //! Offsets of the fields within a record [bytes]
+    std::vector<size_t> fieldOffsets_p;
+    //! HDF5 dataset holding the zone map of the table
+    hid_t zoneDataset_p;
+    //! Number of rows per zone of the zone map
+    hsize_t zoneSize_p;
+    //! Number of leading rows of the table covered by the zone map
+    hsize_t zoneRows_p;
+    //! First zone modified since the zone map was last written
+    hsize_t zoneModified_p;
+    //! Names of the columns of the zone map
+    std::vector<std::string> zoneColumns_p;
+    //! Indices of the columns of the zone map within a record
+    std::vector<int> zoneFields_p;
+    //! Minimum and maximum of each column of the zone map, zone by zone
+    std::vector<double> zoneBounds_p;
+    //! Number of rows read by the last selection
+    hsize_t nofRowsScanned_p;
     
 #ifdef DAL_WITH_CASA
     casa::Table * casaTable_p;
@@ -80,11 +148,61 @@ namespace DAL {
     casa::ROTableColumn * casa_column;
 #endif
     
+    //! Initialize the internal parameters
+    void init (std::string const &filetype);
+    //! Resolve the layout of the records of an HDF5 table, if not yet done
+    bool h5layout ();
+    //! Discard the cached layout, e.g. after the columns have been changed
+    void h5layout_reset ();
+    //! Write records to an HDF5 table, extending it if required
+    bool h5writeRecords (void const *data,
+			 hsize_t const &start,
+			 hsize_t const &nofRecords);
+    //! Read records from an HDF5 table into a buffer of the given layout
+    bool h5readRecords (hid_t const &memType,
+			hsize_t const &start,
+			hsize_t const &nofRecords,
+			void *data);
+    //! Get the indices of fields within a record of an HDF5 table
+    bool h5fields (std::vector<std::string> const &names,
+		   std::vector<int> &indices,
+		   bool const &numerical);
+    //! Gather a numerical field of a block of records as double values
+    void h5gatherField (int const &index,
+			char const *records,
+			size_t const &nofRecords,
+			double *values);
+    //! Get the number of rows per chunk of an HDF5 table
+    hsize_t h5chunkSize ();
+    //! Scan an HDF5 table for the rows matching a list of conditions
+    long h5select (std::vector<hsize_t> &rows,
+		   std::vector<char> *records,
+		   std::vector<dalFilter::Condition> const &conditions,
+		   long const &start,
+		   long const &nofRows);
+    //! Get the conditions of the filter extended by a range of a column
+    std::vector<dalFilter::Condition> rangeConditions (std::string const &column,
+						       double const &lower,
+						       double const &upper);
+    //! Load the zone map of an HDF5 table, if there is one
+    bool h5zoneLoad ();
+    //! Write the modified zones back to the zone map dataset
+    bool h5zoneFlush ();
+    //! Merge records into the bounds of the zones they belong to
+    void h5zoneMerge (char const *records,
+		      hsize_t const &start,
+		      hsize_t const &nofRecords);
+    //! Recompute a range of zones from the records in the table
+    bool h5zoneScan (hsize_t const &firstZone,
+		     hsize_t const &lastZone);
+    //! Update the zone map for records written to the table
+    bool h5zoneUpdate (void const *data,
+		       hsize_t const &start,
+		       hsize_t const &nofRecords);
     //! Setup for adding another column to an HDF5 table
     bool h5addColumn_setup (std::string const &column_name,
 			    bool &removedummy);
-    void h5addColumn_insert (uint const & indims,
-			     std::string const & colname,
+    void h5addColumn_insert (std::string const & colname,
 			     hid_t const & field_type,
 			     bool const & removedummy );
     
@@ -186,8 +304,44 @@ namespace DAL {
     //! Remove a column from the table
     void removeColumn( const std::string &colname );
     void writeDataByColNum( void * structure, int index, int rownum, long nrecords=1 );
-    void setFilter( std::string columns );
-    void setFilter( std::string columns, std::string conditions );
+    //! Set a filter on the table
+    bool setFilter( std::string columns );
+    //! Set a filter on the table
+    bool setFilter( std::string columns, std::string conditions );
+    //! Get the filter set on the table
+    inline dalFilter * getFilter () {
+      return filter;
+    }
+    //! Find the rows matching the conditions of the filter
+    long selectRows (std::vector<hsize_t> &rows,
+		     long const &start=0,
+		     long const &nofRows=-1);
+    //! Find the rows matching the filter and read their selected columns
+    long selectRows (std::vector<hsize_t> &rows,
+		     std::vector<char> &records,
+		     long const &start=0,
+		     long const &nofRows=-1);
+    //! Find the rows with a column value within [lower,upper) and the filter
+    long selectRange (std::vector<hsize_t> &rows,
+		      std::string const &column,
+		      double const &lower,
+		      double const &upper);
+    //! Find the rows with a column value within [lower,upper) and read them
+    long selectRange (std::vector<hsize_t> &rows,
+		      std::vector<char> &records,
+		      std::string const &column,
+		      double const &lower,
+		      double const &upper);
+    //! Get the size of a record of the columns selected by the filter [bytes]
+    size_t selectionRecordSize ();
+    //! Get the number of rows read from the table by the last selection
+    inline hsize_t nofRowsScanned () const {
+      return nofRowsScanned_p;
+    }
+    //! Create a min/max zone map of numerical columns of the table
+    bool createZoneMap (std::string const &columns="");
+    //! Does the table have a zone map?
+    bool hasZoneMap ();
     void appendRow( void * data );
     void appendRows( void * data, long number_of_rows );
     //! List the column of the table
@@ -0,0 +1,337 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/*!
+  \file tHDF5AccessPlan.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of tests for the DAL::HDF5AccessPlan class
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  Besides testing the selections set up through an access plan, the number of
+  read calls per second is compared between HDF5Dataset::readData() and an
+  access plan, for slabs of 1 up to 1M samples.
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tHDF5AccessPlan [seconds per measurement]
+  \endverbatim
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <core/dalCommon.h>
+#include <core/HDF5AccessPlan.h>
+#include <core/HDF5Dataset.h>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5AccessPlan;
+using DAL::HDF5Dataset;
+using DAL::wallTime;
+
+//! Number of samples in the dataset used for the benchmark
+const hsize_t nofSamples = 1048576;
+
+//_______________________________________________________________________________
+//                                                                   test_selection
+
+/*!
+  \brief Test setting up a plan and moving the selection
+
+  \param fileID -- Identifier of the file to work with.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_selection (hid_t const &fileID)
+{
+  cout << "\n[tHDF5AccessPlan::test_selection]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<hsize_t> shape (2);
+  std::vector<hsize_t> block (2);
+
+  shape[0] = 100;
+  shape[1] = 8;
+
+  HDF5Dataset dataset (fileID, "Selection", shape, H5T_NATIVE_INT);
+
+  cout << "[1] Testing default constructor ..." << endl;
+  try {
+    HDF5AccessPlan plan;
+    plan.summary();
+    if (plan.isValid() || plan.setOffset (hsize_t(0))) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[2] Write rows, extending the dataset ..." << endl;
+  try {
+    block[0] = 10;
+    block[1] = 8;
+    HDF5AccessPlan plan (dataset.objectID(), block);
+    int data[80];
+    for (hsize_t row=0; row<200; row+=10) {
+      for (int n=0; n<80; ++n) {
+	data[n] = row*8 + n;
+      }
+      if (!plan.setOffset (row, true) || !plan.write (data, H5T_NATIVE_INT)) {
+	++nofFailedTests;
+      }
+    }
+    plan.summary();
+    if (plan.shape()[0] != 200) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[3] Read back with stride and count ..." << endl;
+  try {
+    std::vector<hsize_t> stride (2);
+    std::vector<hsize_t> count (2);
+    std::vector<hsize_t> start (2);
+    /* Every other element of 4 rows */
+    stride[0] = 1;
+    stride[1] = 2;
+    count[0]  = 1;
+    count[1]  = 4;
+    block[0]  = 4;
+    block[1]  = 1;
+    start[0]  = 150;
+    start[1]  = 1;
+    HDF5AccessPlan plan (dataset.objectID(), stride, count, block);
+    int data[16];
+    if (!plan.setOffset (start) || !plan.read (data, H5T_NATIVE_INT)) {
+      ++nofFailedTests;
+    }
+    cout << "-- data = " << DAL::toString(data,16) << endl;
+    for (int r=0; r<4; ++r) {
+      for (int c=0; c<4; ++c) {
+	if (data[r*4+c] != (150+r)*8 + 1 + 2*c) {
+	  ++nofFailedTests;
+	  r = 4;
+	  break;
+	}
+      }
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[4] Reject invalid selections ..." << endl;
+  try {
+    block[0] = 10;
+    block[1] = 8;
+    HDF5AccessPlan plan (dataset.objectID(), block);
+    /* Beyond the end, without extending */
+    if (plan.setOffset (hsize_t(195))) {
+      ++nofFailedTests;
+    }
+    /* Mismatching rank */
+    if (plan.setOffset (std::vector<hsize_t>(3,0))) {
+      ++nofFailedTests;
+    }
+    /* Rank beyond HDF5ACCESSPLAN_MAX_RANK */
+    hsize_t dims[5] = {2, 2, 2, 2, 2};
+    hid_t dataspace = H5Screate_simple (5, dims, NULL);
+    hid_t datasetID = H5Dcreate (fileID, "Rank5", H5T_NATIVE_INT, dataspace,
+				 H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (plan.setup (datasetID, std::vector<hsize_t>(5,1)) || plan.isValid()) {
+      ++nofFailedTests;
+    }
+    H5Dclose (datasetID);
+    H5Sclose (dataspace);
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[5] Extend different axes through two plans ..." << endl;
+  try {
+    shape[0] = 10;
+    shape[1] = 8;
+    HDF5Dataset extension (fileID, "Extension", shape, H5T_NATIVE_INT);
+    std::vector<hsize_t> start (2, 0);
+    int data[80] = { 0 };
+    /* Both plans cache the initial shape [10,8] */
+    block[0] = 10;
+    block[1] = 8;
+    HDF5AccessPlan rows (extension.objectID(), block);
+    block[1] = 4;
+    HDF5AccessPlan columns (extension.objectID(), block);
+    /* Grow the first axis, then the second one through the other plan */
+    start[0] = 20;
+    if (!rows.setOffset (start, true) || !rows.write (data, H5T_NATIVE_INT)) {
+      ++nofFailedTests;
+    }
+    start[0] = 0;
+    start[1] = 8;
+    if (!columns.setOffset (start, true) || !columns.write (data, H5T_NATIVE_INT)) {
+      ++nofFailedTests;
+    }
+    hsize_t dims[2] = { 0, 0 };
+    hid_t dataspace = H5Dget_space (extension.objectID());
+    H5Sget_simple_extent_dims (dataspace, dims, NULL);
+    H5Sclose (dataspace);
+    cout << "-- shape = [" << dims[0] << "," << dims[1] << "]" << endl;
+    if (dims[0] != 30 || dims[1] != 12) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                benchmark_reads
+
+/*!
+  \brief Compare the rate of read calls for HDF5Dataset and an access plan
+
+  \param fileID  -- Identifier of the file to work with.
+  \param seconds -- Duration of a single measurement.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int benchmark_reads (hid_t const &fileID,
+		     double const &seconds)
+{
+  cout << "\n[tHDF5AccessPlan::benchmark_reads]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<hsize_t> shape (1, nofSamples);
+  std::vector<float> buffer (nofSamples);
+
+  for (hsize_t n=0; n<nofSamples; ++n) {
+    buffer[n] = n;
+  }
+
+  HDF5Dataset dataset (fileID, "Benchmark", shape, H5T_NATIVE_FLOAT);
+  {
+    HDF5AccessPlan plan (dataset.objectID(), shape);
+    plan.setOffset (hsize_t(0));
+    plan.write (&buffer[0], H5T_NATIVE_FLOAT);
+  }
+
+  hsize_t sizes[] = {1, 16, 1024, 65536, 1048576};
+
+  for (unsigned int s=0; s<5; ++s) {
+    hsize_t size            = sizes[s];
+    hsize_t nofSlabs        = nofSamples/size;
+    std::vector<int> start (1, 0);
+    std::vector<int> block (1, size);
+    unsigned long nofCalls  = 0;
+    double start_t          = wallTime();
+    double end_t            = start_t;
+
+    /* HDF5Dataset::readData */
+    while (end_t-start_t < seconds) {
+      start[0] = (nofCalls%nofSlabs)*size;
+      if (!dataset.readData (&buffer[0], start, block)) {
+	++nofFailedTests;
+	break;
+      }
+      ++nofCalls;
+      end_t = wallTime();
+    }
+    double rateDataset = nofCalls/(end_t-start_t);
+    if (buffer[0] != start[0]) {
+      ++nofFailedTests;
+    }
+
+    /* HDF5AccessPlan */
+    HDF5AccessPlan plan (dataset.objectID(), std::vector<hsize_t>(1,size));
+    hsize_t offset = 0;
+    nofCalls = 0;
+    start_t  = wallTime();
+    end_t    = start_t;
+    while (end_t-start_t < seconds) {
+      offset = (nofCalls%nofSlabs)*size;
+      if (!plan.setOffset (offset) || !plan.read (&buffer[0], H5T_NATIVE_FLOAT)) {
+	++nofFailedTests;
+	break;
+      }
+      ++nofCalls;
+      end_t = wallTime();
+    }
+    double ratePlan = nofCalls/(end_t-start_t);
+    if (buffer[0] != offset) {
+      ++nofFailedTests;
+    }
+
+    cout << "-- " << size << " samples\t: readData " << rateDataset
+	 << " calls/s , access plan " << ratePlan
+	 << " calls/s , speed-up " << ratePlan/rateDataset << endl;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main (int argc, char *argv[])
+{
+  int nofFailedTests (0);
+  double seconds (0.2);
+
+  if (argc > 1) {
+    seconds = atof(argv[1]);
+  }
+
+  hid_t fileID = H5Fcreate ("tHDF5AccessPlan.h5",
+			    H5F_ACC_TRUNC,
+			    H5P_DEFAULT,
+			    H5P_DEFAULT);
+
+  if (!H5Iis_valid(fileID)) {
+    cerr << "-- ERROR: Failed to create file tHDF5AccessPlan.h5" << endl;
+    return -1;
+  }
+
+  nofFailedTests += test_selection (fileID);
+  nofFailedTests += benchmark_reads (fileID, seconds);
+
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
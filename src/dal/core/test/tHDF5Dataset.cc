@@ -47,10 +47,22 @@
       `-- test3          ...  Dataset
   \endverbatim
 
+  <h3>Usage</h3>
+
+  \verbatim
+  tHDF5Dataset [filename [nofBlocks]]
+  \endverbatim
+
+  By default test_soak() appends 10000 blocks, which checks the results but is
+  too short to show a growth of the memory used; for a proper soak test pass a
+  larger number, e.g. <tt>tHDF5Dataset tHDF5Dataset.h5 1000000</tt>.
 */
 
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <unistd.h>
 
 #include <core/dalCommon.h>
 #include <core/HDF5Attribute.h>
@@ -713,6 +725,102 @@ int test_array1d (hid_t const &fileID)
   return nofFailedTests;
 }
 
+//_______________________________________________________________________________
+//                                                                residentMemory
+
+/*!
+  \brief Get the resident set size of the running process
+
+  \return rss -- Resident set size [kB]; 0 if not available.
+*/
+long residentMemory ()
+{
+  long pages (0);
+  long rss (0);
+
+  FILE *statm = fopen ("/proc/self/statm", "r");
+  if (statm) {
+    if (fscanf (statm, "%ld %ld", &pages, &rss) != 2) {
+      rss = 0;
+    }
+    fclose (statm);
+  }
+
+  return rss*(sysconf(_SC_PAGESIZE)/1024);
+}
+
+//_______________________________________________________________________________
+//                                                                      test_soak
+
+/*!
+  \brief Append a long stream of small blocks to an extendible dataset
+
+  Every block is written through a new hyperslab selection, extending the
+  dataset; neither the book-keeping of the hyperslabs nor the memory used by
+  the process may grow along with the number of blocks written.
+
+  \param fileID          -- HDF5 object identifier for the file, to which the 
+         dataset are attached.
+  \param nofBlocks       -- Number of blocks to write.
+  \return nofFailedTests -- The number of failed tests encountered within this
+          functions.
+*/
+int test_soak (hid_t const &fileID,
+	       unsigned int const &nofBlocks)
+{
+  cout << "\n[tHDF5Datatset::test_soak]\n" << endl;
+
+  int nofFailedTests = 0;
+  int blocksize      = 16;
+  std::vector<hsize_t> shape (1,blocksize);
+  std::vector<int> start (1,0);
+  std::vector<int> block (1,blocksize);
+  short data[blocksize];
+  long rssStart (0);
+
+  for (int n=0; n<blocksize; ++n) {
+    data[n] = n;
+  }
+
+  cout << "[1] Write " << nofBlocks << " blocks of " << blocksize
+       << " samples ..." << endl;
+  try {
+    DAL::HDF5Dataset dataset (fileID, "Soak", shape, H5T_NATIVE_SHORT);
+
+    for (unsigned int n=0; n<nofBlocks; ++n) {
+      start[0] = n*blocksize;
+      if (!dataset.writeData (data, start, block)) {
+	++nofFailedTests;
+	break;
+      }
+      /* Leave some time for the caches of the HDF5 library to settle */
+      if (n == nofBlocks/4) {
+	rssStart = residentMemory();
+      }
+    }
+
+    long rssEnd = residentMemory();
+
+    cout << "-- Shape of the dataset = " << dataset.shape()             << endl;
+    cout << "-- nof. hyperslabs      = " << dataset.hyperslabs().size() << endl;
+    cout << "-- Resident memory [kB] = " << rssStart << " -> " << rssEnd << endl;
+
+    if (dataset.shape()[0] != hsize_t(nofBlocks*blocksize)
+	|| dataset.hyperslabs().size() != 1) {
+      ++nofFailedTests;
+    }
+    /* Allow for the growing index of chunks, but not a record per block */
+    if (rssEnd-rssStart > 16384) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
 //_______________________________________________________________________________
 //                                                                   test_array2d
 
@@ -1225,9 +1333,10 @@ int test_extension (std::string const &filename)
 int main (int argc,
           char *argv[])
 {
-  int nofFailedTests   = 0;
-  bool haveDataset     = false;
-  std::string filename = "tHDF5Dataset.h5";
+  int nofFailedTests     = 0;
+  bool haveDataset       = false;
+  std::string filename   = "tHDF5Dataset.h5";
+  unsigned int nofBlocks = 10000;
 
   //________________________________________________________
   // Process parameters from the command line
@@ -1238,6 +1347,9 @@ int main (int argc,
     filename    = argv[1];
     haveDataset = true;
   }
+  if (argc > 2) {
+    nofBlocks = atoi(argv[2]);
+  }
   
   std::cout << "[tHDF5Dataset] Output HDF5 file = " << filename << std::endl;
 
@@ -1267,6 +1379,9 @@ int main (int argc,
     // Test access R/W access to 2-dim data arrays
     nofFailedTests += test_array2d (fileID);
 
+    // Test appending a long stream of blocks
+    nofFailedTests += test_soak (fileID, nofBlocks);
+
     // // Test the effect of the various Hyperslab parameters
     // nofFailedTests += test_hyperslab (fileID);
 
@@ -0,0 +1,645 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/*!
+  \file tHDF5StoragePolicy.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of tests for the DAL::HDF5StoragePolicy class
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  Besides checking the chunk shapes derived for the various access patterns,
+  the test program compares the storage policies on the two kinds of data the
+  library mostly writes:
+  - a TBB dipole dataset -- 1-dim, 16 bit integers, appended frame by frame;
+  - a Stokes dataset of beam-formed data -- 2-dim [samples,channels], 32 bit
+    floating point, appended one time step after the other and read both as
+    rows (time steps) and as columns (time series of a channel).
+  For each combination the throughput and the size of the resulting file are
+  reported; the fixed chunking previously used by the library is included as
+  reference.
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tHDF5StoragePolicy [nofFrames [nofSamples [nofChannels]]]
+  \endverbatim
+
+  By default the benchmarks only write a few MB -- 100 TBB frames and a Stokes
+  dataset of shape [200,3904] -- as checks that all storage policies work; for
+  meaningful timings pass larger sizes, e.g.
+  <tt>tHDF5StoragePolicy 10000 20000 3904</tt>.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include <core/dalCommon.h>
+#include <core/HDF5StoragePolicy.h>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5StoragePolicy;
+using DAL::wallTime;
+
+//! Name of the file used by the benchmarks
+const std::string filename = "tHDF5StoragePolicy.h5";
+//! Number of samples in a TBB frame
+const hsize_t samplesPerFrame = 1024;
+
+// ==============================================================================
+//
+//  Helper functions
+//
+// ==============================================================================
+
+//_______________________________________________________________________________
+//                                                                       fileSize
+
+//! Get the size of the file \e name [MB]
+double fileSize (std::string const &name)
+{
+  struct stat info;
+  if (stat (name.c_str(), &info) != 0) {
+    return 0;
+  }
+  return info.st_size/1048576.0;
+}
+
+//_______________________________________________________________________________
+//                                                                  createDataset
+
+/*!
+  \brief Create an extendible dataset, either with a policy or a fixed chunking
+
+  \param fileID   -- Identifier of the file.
+  \param shape    -- Initial shape of the dataset.
+  \param datatype -- Datatype of the elements.
+  \param policy   -- Storage policy, used if \e chunking is empty.
+  \param chunking -- Fixed chunk shape.
+
+  \return datasetID -- Identifier of the new dataset.
+*/
+hid_t createDataset (hid_t const &fileID,
+		     std::vector<hsize_t> const &shape,
+		     hid_t const &datatype,
+		     HDF5StoragePolicy const &policy,
+		     std::vector<hsize_t> const &chunking)
+{
+  int rank = shape.size();
+  hsize_t dims[rank];
+  hsize_t maxdims[rank];
+
+  for (int n=0; n<rank; ++n) {
+    dims[n]    = shape[n];
+    maxdims[n] = H5S_UNLIMITED;
+  }
+
+  hid_t dataspace = H5Screate_simple (rank, dims, maxdims);
+  hid_t datasetID = policy.create (fileID,
+				   "data",
+				   datatype,
+				   dataspace,
+				   chunking);
+  H5Sclose (dataspace);
+
+  return datasetID;
+}
+
+// ==============================================================================
+//
+//  Test functions
+//
+// ==============================================================================
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test the constructors and the parameter access
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tHDF5StoragePolicy::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing default constructor ..." << endl;
+  try {
+    HDF5StoragePolicy policy;
+    policy.summary();
+    if (policy.chunkBytes() != DEFAULT_CHUNK_BYTES
+	|| policy.accessPattern() != HDF5StoragePolicy::Balanced
+	|| policy.nofFilters() != 0) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[2] Testing argumented constructor and filters ..." << endl;
+  try {
+    HDF5StoragePolicy policy (65536, HDF5StoragePolicy::TimeMajor);
+    policy.setShuffle (true);
+    policy.setDeflate (12);
+    policy.addFilter (32000);
+    policy.summary();
+    if (policy.chunkBytes() != 65536
+	|| policy.accessPatternName() != "TimeMajor"
+	|| policy.deflateLevel() != 9
+	|| policy.nofFilters() != 3) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                  test_chunking
+
+/*!
+  \brief Test the chunk shapes derived for the various access patterns
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_chunking ()
+{
+  cout << "\n[tHDF5StoragePolicy::test_chunking]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<hsize_t> shape;
+  std::vector<hsize_t> chunk;
+
+  cout << "[1] 1-dim dataset of 16 bit integers ..." << endl;
+  try {
+    HDF5StoragePolicy policy;
+    shape.assign (1, 1024);
+    chunk = policy.chunking (shape, sizeof(short));
+    cout << "-- shape = " << shape << "  ->  chunk = " << chunk << endl;
+    /* The chunk is not limited by the initial shape of the dataset */
+    if (chunk.size() != 1 || chunk[0] != DEFAULT_CHUNK_BYTES/sizeof(short)) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[2] 2-dim dataset of floats for the access patterns ..." << endl;
+  try {
+    HDF5StoragePolicy policy;
+    shape.resize (2);
+    shape[0] = 100000;
+    shape[1] = 3904;
+
+    policy.setAccessPattern (HDF5StoragePolicy::TimeMajor);
+    chunk = policy.chunking (shape, sizeof(float));
+    cout << "-- TimeMajor    : chunk = " << chunk << endl;
+    if (chunk[1] != 3904 || chunk[0] != 67) {
+      ++nofFailedTests;
+    }
+
+    policy.setAccessPattern (HDF5StoragePolicy::ChannelMajor);
+    chunk = policy.chunking (shape, sizeof(float));
+    cout << "-- ChannelMajor : chunk = " << chunk << endl;
+    if (chunk[1] != 16 || chunk[0] != 16384) {
+      ++nofFailedTests;
+    }
+
+    /* Do not exceed the known number of rows */
+    shape[0] = 2000;
+    chunk = policy.chunking (shape, sizeof(float));
+    cout << "-- ChannelMajor : chunk = " << chunk << " for 2000 rows" << endl;
+    if (chunk[1] != 16 || chunk[0] != 2000) {
+      ++nofFailedTests;
+    }
+    shape[0] = 100000;
+
+    policy.setAccessPattern (HDF5StoragePolicy::Balanced);
+    chunk = policy.chunking (shape, sizeof(float));
+    cout << "-- Balanced     : chunk = " << chunk << endl;
+    if (chunk[0]*chunk[1] > DEFAULT_CHUNK_BYTES/sizeof(float)
+	|| chunk[1] >= 3904 || chunk[0] < chunk[1]) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[3] Rows exceeding the size of a chunk ..." << endl;
+  try {
+    HDF5StoragePolicy policy (1024, HDF5StoragePolicy::TimeMajor);
+    shape.resize (3);
+    shape[0] = 10;
+    shape[1] = 100;
+    shape[2] = 50;
+    chunk = policy.chunking (shape, sizeof(double));
+    cout << "-- shape = " << shape << "  ->  chunk = " << chunk << endl;
+    if (chunk[0]*chunk[1]*chunk[2]*sizeof(double) > 1024 || chunk[0] < 1) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[4] Chunk cache for wide datasets ..." << endl;
+  try {
+    HDF5StoragePolicy policy (DEFAULT_CHUNK_BYTES, HDF5StoragePolicy::ChannelMajor);
+    shape.resize (2);
+    shape[0] = 100000;
+    shape[1] = 3904;
+    chunk = policy.chunking (shape, sizeof(float));
+    /* 244 chunks of 1 MB along a row: the default cache is too small */
+    hid_t access = policy.accessProperties (shape, chunk, sizeof(float));
+    size_t nslots, nbytes;
+    double w0;
+    if (access == H5P_DEFAULT
+	|| H5Pget_chunk_cache (access, &nslots, &nbytes, &w0) < 0) {
+      ++nofFailedTests;
+    } else {
+      cout << "-- nslots = " << nslots << " , nbytes = " << nbytes << endl;
+      if (nbytes < 244*DEFAULT_CHUNK_BYTES) {
+	++nofFailedTests;
+      }
+      H5Pclose (access);
+    }
+    /* A 1-dim dataset is served by the default cache */
+    shape.assign (1, 1024);
+    chunk = policy.chunking (shape, sizeof(short));
+    if (policy.accessProperties (shape, chunk, sizeof(short)) != H5P_DEFAULT) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                    test_create
+
+/*!
+  \brief Test creating datasets with filters
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_create ()
+{
+  cout << "\n[tHDF5StoragePolicy::test_create]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<hsize_t> shape (2);
+  std::vector<hsize_t> chunk;
+
+  shape[0] = 64;
+  shape[1] = 32;
+
+  cout << "[1] Shuffle and deflate filter ..." << endl;
+  try {
+    hid_t fileID = H5Fcreate (filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    HDF5StoragePolicy policy (4096, HDF5StoragePolicy::TimeMajor);
+    policy.setShuffle (true);
+    policy.setDeflate (1);
+
+    hid_t datasetID = createDataset (fileID, shape, H5T_NATIVE_FLOAT, policy, chunk);
+    if (datasetID < 0) {
+      ++nofFailedTests;
+    } else {
+      hid_t plist  = H5Dget_create_plist (datasetID);
+      hsize_t dims[2];
+      int nofFilters = H5Pget_nfilters (plist);
+      H5Pget_chunk (plist, 2, dims);
+      cout << "-- chunk = [" << dims[0] << "," << dims[1] << "]"
+	   << " , nof. filters = " << nofFilters << endl;
+      if (dims[0] != 32 || dims[1] != 32
+	  || nofFilters != (H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0 ? 2 : 1)) {
+	++nofFailedTests;
+      }
+      H5Pclose (plist);
+      H5Dclose (datasetID);
+    }
+    H5Fclose (fileID);
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[2] Unavailable optional and mandatory filter ..." << endl;
+  try {
+    hid_t fileID = H5Fcreate (filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    HDF5StoragePolicy policy;
+    /* Filter ID from the range reserved for testing, never registered */
+    policy.addFilter (511);
+
+    hid_t datasetID = createDataset (fileID, shape, H5T_NATIVE_FLOAT, policy, chunk);
+    if (datasetID < 0) {
+      ++nofFailedTests;
+    } else {
+      H5Dclose (datasetID);
+    }
+
+    policy.addFilter (511, std::vector<unsigned int>(), H5Z_FLAG_MANDATORY);
+    H5Ldelete (fileID, "data", H5P_DEFAULT);
+    datasetID = createDataset (fileID, shape, H5T_NATIVE_FLOAT, policy, chunk);
+    if (datasetID >= 0) {
+      ++nofFailedTests;
+      H5Dclose (datasetID);
+    }
+    H5Fclose (fileID);
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                 benchmark_tbb
+
+/*!
+  \brief Append TBB frames to a 1-dim dataset of 16 bit integers
+
+  \param nofFrames -- Number of frames to write.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int benchmark_tbb (unsigned int const &nofFrames)
+{
+  cout << "\n[tHDF5StoragePolicy::benchmark_tbb]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string names[] = {"CHUNK_SIZE (legacy)", "Balanced", "Balanced+deflate"};
+  std::vector<short> frame (samplesPerFrame);
+  double megabytes = nofFrames*samplesPerFrame*sizeof(short)/1048576.0;
+
+  for (hsize_t n=0; n<samplesPerFrame; ++n) {
+    frame[n] = short(100*sin(0.01*n)) + short(rand()%8);
+  }
+
+  for (int p=0; p<3; ++p) {
+    HDF5StoragePolicy policy;
+    std::vector<hsize_t> chunk;
+    if (p == 0) {
+      chunk.assign (1, CHUNK_SIZE);
+    } else if (p == 2) {
+      policy.setShuffle (true);
+      policy.setDeflate (1);
+    }
+
+    hid_t fileID = H5Fcreate (filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    hid_t datasetID = createDataset (fileID,
+				     std::vector<hsize_t>(1,samplesPerFrame),
+				     H5T_NATIVE_SHORT,
+				     policy,
+				     chunk);
+    if (datasetID < 0) {
+      ++nofFailedTests;
+      H5Fclose (fileID);
+      continue;
+    }
+
+    double start = wallTime();
+    hsize_t count  = samplesPerFrame;
+    hid_t memspace = H5Screate_simple (1, &count, NULL);
+    for (unsigned int f=0; f<nofFrames; ++f) {
+      hsize_t size   = (f+1)*samplesPerFrame;
+      hsize_t offset = f*samplesPerFrame;
+      H5Dset_extent (datasetID, &size);
+      hid_t filespace = H5Dget_space (datasetID);
+      H5Sselect_hyperslab (filespace, H5S_SELECT_SET, &offset, NULL, &count, NULL);
+      H5Dwrite (datasetID, H5T_NATIVE_SHORT, memspace, filespace, H5P_DEFAULT, &frame[0]);
+      H5Sclose (filespace);
+    }
+    H5Sclose (memspace);
+    H5Dclose (datasetID);
+    H5Fclose (fileID);
+    double seconds = wallTime()-start;
+
+    cout << "-- " << names[p] << "\t: write " << megabytes/seconds
+	 << " MB/s , file " << fileSize(filename) << " MB" << endl;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                              benchmark_stokes
+
+/*!
+  \brief Write a Stokes dataset row by row, read it by rows and by channels
+
+  \param nofSamples  -- Number of time steps.
+  \param nofChannels -- Number of channels.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int benchmark_stokes (unsigned int const &nofSamples,
+		      unsigned int const &nofChannels)
+{
+  cout << "\n[tHDF5StoragePolicy::benchmark_stokes]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string names[] = {"Whole shape (legacy)",
+			 "Balanced",
+			 "TimeMajor",
+			 "ChannelMajor",
+			 "TimeMajor+deflate"};
+  HDF5StoragePolicy::AccessPattern patterns[] = {HDF5StoragePolicy::Balanced,
+						 HDF5StoragePolicy::Balanced,
+						 HDF5StoragePolicy::TimeMajor,
+						 HDF5StoragePolicy::ChannelMajor,
+						 HDF5StoragePolicy::TimeMajor};
+  std::vector<float> row (nofChannels);
+  std::vector<float> column (nofSamples);
+  unsigned int nofColumns = nofChannels < 16 ? nofChannels : 16;
+  double megabytes        = double(nofSamples)*nofChannels*sizeof(float)/1048576.0;
+
+  cout << "-- shape = [" << nofSamples << "," << nofChannels << "]"
+       << " , " << megabytes << " MB" << endl;
+
+  for (unsigned int n=0; n<nofChannels; ++n) {
+    row[n] = 1000.0 + n%100 + 0.1*(rand()%10);
+  }
+
+  for (int p=0; p<5; ++p) {
+    HDF5StoragePolicy policy (DEFAULT_CHUNK_BYTES, patterns[p]);
+    std::vector<hsize_t> shape (2);
+    std::vector<hsize_t> chunk;
+
+    shape[0] = 1;
+    shape[1] = nofChannels;
+
+    if (p == 0) {
+      chunk = shape;
+    } else if (p == 4) {
+      policy.setShuffle (true);
+      policy.setDeflate (1);
+    }
+    if (chunk.empty()) {
+      /* Shape known to the writer when opening an observation */
+      shape[0] = nofSamples;
+      chunk    = policy.chunking (shape, sizeof(float));
+      shape[0] = 1;
+    }
+
+    hid_t fileID    = H5Fcreate (filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    hid_t datasetID = createDataset (fileID, shape, H5T_NATIVE_FLOAT, policy, chunk);
+    if (datasetID < 0) {
+      ++nofFailedTests;
+      H5Fclose (fileID);
+      continue;
+    }
+
+    /* Write one time step after the other */
+    double start    = wallTime();
+    hsize_t offset[2] = {0, 0};
+    hsize_t count[2]  = {1, nofChannels};
+    hsize_t size[2]   = {0, nofChannels};
+    hid_t memspace    = H5Screate_simple (2, count, NULL);
+    for (unsigned int t=0; t<nofSamples; ++t) {
+      offset[0] = t;
+      size[0]   = t+1;
+      H5Dset_extent (datasetID, size);
+      hid_t filespace = H5Dget_space (datasetID);
+      H5Sselect_hyperslab (filespace, H5S_SELECT_SET, offset, NULL, count, NULL);
+      H5Dwrite (datasetID, H5T_NATIVE_FLOAT, memspace, filespace, H5P_DEFAULT, &row[0]);
+      H5Sclose (filespace);
+    }
+    H5Sclose (memspace);
+    H5Dclose (datasetID);
+    H5Fclose (fileID);
+    double writeRate = megabytes/(wallTime()-start);
+
+    /* Reopen with the chunk cache suggested by the policy */
+    shape[0] = nofSamples;
+    hid_t access = policy.accessProperties (shape, chunk, sizeof(float));
+    fileID    = H5Fopen (filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    datasetID = H5Dopen (fileID, "data", access);
+    if (access != H5P_DEFAULT) {
+      H5Pclose (access);
+    }
+
+    /* Read one time step after the other */
+    start     = wallTime();
+    offset[1] = 0;
+    memspace  = H5Screate_simple (2, count, NULL);
+    hid_t filespace = H5Dget_space (datasetID);
+    for (unsigned int t=0; t<nofSamples; ++t) {
+      offset[0] = t;
+      H5Sselect_hyperslab (filespace, H5S_SELECT_SET, offset, NULL, count, NULL);
+      H5Dread (datasetID, H5T_NATIVE_FLOAT, memspace, filespace, H5P_DEFAULT, &row[0]);
+    }
+    H5Sclose (memspace);
+    double rowRate = megabytes/(wallTime()-start);
+
+    /* Read the time series of the first channels */
+    start    = wallTime();
+    count[0] = nofSamples;
+    count[1] = 1;
+    offset[0] = 0;
+    memspace = H5Screate_simple (2, count, NULL);
+    for (unsigned int c=0; c<nofColumns; ++c) {
+      offset[1] = c;
+      H5Sselect_hyperslab (filespace, H5S_SELECT_SET, offset, NULL, count, NULL);
+      H5Dread (datasetID, H5T_NATIVE_FLOAT, memspace, filespace, H5P_DEFAULT, &column[0]);
+    }
+    H5Sclose (memspace);
+    double columnRate = nofColumns*nofSamples*sizeof(float)/1048576.0/(wallTime()-start);
+
+    H5Sclose (filespace);
+    H5Dclose (datasetID);
+    H5Fclose (fileID);
+
+    if (column[nofSamples-1] != row[nofColumns-1]) {
+      ++nofFailedTests;
+    }
+
+    cout << "-- " << names[p] << "\t: chunk = " << chunk
+	 << "\n\twrite " << writeRate
+	 << " MB/s , read rows " << rowRate
+	 << " MB/s , read channels " << columnRate
+	 << " MB/s , file " << fileSize(filename) << " MB" << endl;
+  }
+
+  return nofFailedTests;
+}
+
+// ==============================================================================
+//
+//  Main routine
+//
+// ==============================================================================
+
+/*!
+  \brief Main routine of the test program
+
+  \return nofFailedTests -- The number of failed tests encountered within and
+          identified by this test program.
+*/
+int main (int argc,
+          char *argv[])
+{
+  int nofFailedTests       = 0;
+  unsigned int nofFrames   = 100;
+  unsigned int nofSamples  = 200;
+  unsigned int nofChannels = 3904;
+
+  if (argc > 1) {
+    nofFrames = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    nofSamples = atoi(argv[2]);
+  }
+  if (argc > 3) {
+    nofChannels = atoi(argv[3]);
+  }
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_chunking ();
+  nofFailedTests += test_create ();
+  nofFailedTests += benchmark_tbb (nofFrames);
+  nofFailedTests += benchmark_stokes (nofSamples, nofChannels);
+
+  return nofFailedTests;
+}
@@ -32,6 +32,9 @@
 */
 
 #include <core/dalArray.h>
+#include <core/dalShortArray.h>
+
+#include <ctime>
 
 //_______________________________________________________________________________
 //                                                              test_constructors
@@ -113,6 +116,145 @@ int test_constructors (std::string const &filename)
   return nofFailedTests;
 }
 
+//_______________________________________________________________________________
+//                                                                    test_append
+
+/*!
+  \brief Test writing a sequence of blocks through the append cursor
+
+  Frames of the size of a TBB transient data block are written first via
+  extend() and write(), and then via append(); both the contents and the
+  shape of the resulting arrays are compared.
+
+  \param nofFrames -- Number of frames to write to each array.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_append (int const &nofFrames=2000)
+{
+  std::cout << "\n[tdalArray::test_append]\n" << std::endl;
+
+  int nofFailedTests (0);
+  int blocksize (1024);
+  std::vector<int> shape (1,0);
+  std::vector<int> chunking (1,blocksize);
+  std::vector<short> data (blocksize);
+  clock_t start;
+  double seconds;
+
+  hid_t fileID = H5Fcreate ("tdalArray.h5",
+			    H5F_ACC_TRUNC,
+			    H5P_DEFAULT,
+			    H5P_DEFAULT);
+
+  std::cout << "[1] Write frames through extend() and write() ..." << std::endl;
+  try {
+    DAL::dalShortArray arr (fileID, "write", shape, &data[0], chunking);
+
+    start = clock();
+    for (int n=0; n<nofFrames; ++n) {
+      for (int k=0; k<blocksize; ++k) {
+	data[k] = short(n+k);
+      }
+      shape[0] = (n+1)*blocksize;
+      arr.extend(shape);
+      arr.write(n*blocksize, &data[0], blocksize);
+    }
+    seconds = double(clock()-start)/CLOCKS_PER_SEC;
+
+    std::cout << "-- Shape of the array = " << arr.dims()          << std::endl;
+    std::cout << "-- Frames/s           = " << nofFrames/seconds  << std::endl;
+    arr.close();
+  } catch (std::string message) {
+    std::cerr << message << std::endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[2] Write frames through append() ..." << std::endl;
+  try {
+    shape[0] = 0;
+    DAL::dalShortArray arr (fileID, "append", shape, &data[0], chunking);
+
+    start = clock();
+    for (int n=0; n<nofFrames; ++n) {
+      for (int k=0; k<blocksize; ++k) {
+	data[k] = short(n+k);
+      }
+      arr.append(n*blocksize, &data[0], blocksize);
+    }
+    seconds = double(clock()-start)/CLOCKS_PER_SEC;
+
+    std::cout << "-- Appended size      = " << arr.appendedSize()     << std::endl;
+    std::cout << "-- Frames/s           = " << nofFrames/seconds      << std::endl;
+    std::cout << "-- HDF5 calls/sample  = " << arr.h5CallsPerSample() << std::endl;
+    arr.close();
+  } catch (std::string message) {
+    std::cerr << message << std::endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[3] Compare shape and contents of the arrays ..." << std::endl;
+  try {
+    hid_t writeID  = H5Dopen (fileID, "write", H5P_DEFAULT);
+    hid_t appendID = H5Dopen (fileID, "append", H5P_DEFAULT);
+    hid_t spaceID  = H5Dget_space (appendID);
+    hsize_t nelem  = 0;
+    H5Sget_simple_extent_dims (spaceID, &nelem, NULL);
+    H5Sclose (spaceID);
+
+    std::cout << "-- Shape after close  = " << nelem << std::endl;
+    if (nelem != hsize_t(nofFrames*blocksize)) {
+      ++nofFailedTests;
+    }
+
+    std::vector<short> bufWrite (nofFrames*blocksize);
+    std::vector<short> bufAppend (nofFrames*blocksize);
+    H5Dread (writeID, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &bufWrite[0]);
+    H5Dread (appendID, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &bufAppend[0]);
+    if (bufWrite != bufAppend) {
+      std::cerr << "-- Contents of the arrays differ!" << std::endl;
+      ++nofFailedTests;
+    }
+
+    H5Dclose (writeID);
+    H5Dclose (appendID);
+  } catch (std::string message) {
+    std::cerr << message << std::endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[4] Append blocks out of order ..." << std::endl;
+  try {
+    shape[0] = 0;
+    DAL::dalShortArray arr (fileID, "unordered", shape, &data[0], chunking);
+
+    arr.append(3*blocksize, &data[0], blocksize);
+    arr.append(0, &data[0], blocksize);
+    arr.append(5*blocksize, &data[0], blocksize/2);
+    arr.close();
+
+    hid_t datasetID = H5Dopen (fileID, "unordered", H5P_DEFAULT);
+    hid_t spaceID   = H5Dget_space (datasetID);
+    hsize_t nelem   = 0;
+    H5Sget_simple_extent_dims (spaceID, &nelem, NULL);
+    H5Sclose (spaceID);
+    H5Dclose (datasetID);
+
+    std::cout << "-- Shape after close  = " << nelem << std::endl;
+    if (nelem != hsize_t(5*blocksize+blocksize/2)) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << std::endl;
+    nofFailedTests++;
+  }
+
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
+
 //_______________________________________________________________________________
 //                                                                           main
 
@@ -136,6 +278,7 @@ int main (int argc, char *argv[])
   // Run the tests
 
   nofFailedTests += test_constructors ();
+  nofFailedTests += test_append ();
 
   if (haveDataset) {
     nofFailedTests += test_constructors (filename);
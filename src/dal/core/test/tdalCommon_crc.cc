@@ -0,0 +1,340 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/dalCommon.h>
+
+#include <cstdlib>
+#include <ctime>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \file tdalCommon_crc.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief Test routines for the CRC computation contained in dalCommon
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  The table-driven implementations DAL::crc16 and DAL::crc32 are compared
+  against a straight bit-by-bit long division, before their throughput is
+  measured on blocks the size of a TBB frame.
+
+  <h3>Examples</h3>
+
+  Calling the test program without any further command-line parameters will
+  run the tests with a small default number of frames (5000), which merely
+  checks the benchmark; for timings provide a larger number as first argument:
+  \verbatim
+  tdalCommon_crc 100000
+  \endverbatim
+*/
+
+//! Number of 16-bit words in a TBB frame header
+const uint32_t nofHeaderWords = 44;
+//! Number of samples (16-bit words) in a TBB transient frame
+const uint32_t nofSamples     = 1024;
+//! Number of bytes in a TBB frame
+const uint32_t frameSize      = 2140;
+
+//_______________________________________________________________________________
+//                                                                  reference_crc
+
+/*!
+  \brief Bit-serial reference implementation of the word-oriented CRC
+
+  Straight polynomial long division, as originally used by DAL::crc16.
+
+  \param buffer -- Pointer to the data
+  \param length -- Length of the data in 16-bit words.
+  \param poly   -- Generator polynomial, without the leading term.
+  \param width  -- Degree of the generator polynomial (16 or 32).
+
+  \return crc -- Remainder of the division
+*/
+uint32_t reference_crc (uint16_t const *buffer,
+			uint32_t const &length,
+			uint32_t const &poly,
+			int const &width)
+{
+  uint64_t crc    = 0;
+  uint64_t topbit = uint64_t(1) << width;
+  uint64_t mask   = topbit - 1;
+
+  for (uint32_t i=0; i<length; ++i) {
+    for (int bit=15; bit>=0; --bit) {
+      crc = (crc << 1) | ((buffer[i] >> bit) & 1);
+      if (crc & topbit) {
+	crc ^= topbit | poly;
+      }
+    }
+  }
+
+  return uint32_t(crc & mask);
+}
+
+//_______________________________________________________________________________
+//                                                                   fill_random
+
+//! Fill a buffer with pseudo-random 16-bit words
+void fill_random (std::vector<uint16_t> &buffer)
+{
+  for (size_t n=0; n<buffer.size(); ++n) {
+    buffer[n] = uint16_t(rand() & 0xffff);
+  }
+}
+
+//_______________________________________________________________________________
+//                                                                     test_crc16
+
+/*!
+  \brief Test the computation of a 16-bit CRC
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_crc16 ()
+{
+  cout << "\n[tdalCommon_crc::test_crc16]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Compare against bit-serial computation ..." << endl;
+  try {
+    int nofMismatches (0);
+    std::vector<uint16_t> buffer;
+
+    for (uint32_t length=1; length<=nofSamples+2; length += (length<64 ? 1 : 37)) {
+      buffer.resize(length);
+      fill_random (buffer);
+      if (DAL::crc16(&buffer[0],length) != reference_crc(&buffer[0],length,0x8005,16)) {
+	++nofMismatches;
+      }
+    }
+    cout << "-- nof. mismatches = " << nofMismatches << endl;
+    if (nofMismatches) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[2] Verify TBB frame header with appended CRC ..." << endl;
+  try {
+    std::vector<uint16_t> header (nofHeaderWords);
+    fill_random (header);
+    /* CRC of the header, with the CRC field itself cleared */
+    header[nofHeaderWords-1] = 0;
+    header[nofHeaderWords-1] = DAL::crc16(&header[0],nofHeaderWords);
+    /* The complete header now must divide without remainder */
+    uint16_t crc = DAL::crc16(&header[0],nofHeaderWords);
+    cout << "-- crc16(header) = " << crc << endl;
+    if (crc != 0) {
+      ++nofFailedTests;
+    }
+    /* A single flipped bit must be detected */
+    header[3] ^= 0x0010;
+    crc = DAL::crc16(&header[0],nofHeaderWords);
+    cout << "-- crc16(corrupted header) = " << crc << endl;
+    if (crc == 0) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                     test_crc32
+
+/*!
+  \brief Test the computation of a 32-bit CRC
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_crc32 ()
+{
+  cout << "\n[tdalCommon_crc::test_crc32]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Compare against bit-serial computation ..." << endl;
+  try {
+    int nofMismatches (0);
+    std::vector<uint16_t> buffer;
+
+    for (uint32_t length=1; length<=nofSamples+2; length += (length<64 ? 1 : 37)) {
+      buffer.resize(length);
+      fill_random (buffer);
+      if (DAL::crc32(&buffer[0],length) != reference_crc(&buffer[0],length,0x04C11DB7,32)) {
+	++nofMismatches;
+      }
+    }
+    cout << "-- nof. mismatches = " << nofMismatches << endl;
+    if (nofMismatches) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[2] Verify TBB frame payload with appended CRC ..." << endl;
+  try {
+    std::vector<uint16_t> payload (nofSamples+2);
+    fill_random (payload);
+    /* CRC of the samples, most significant half first */
+    payload[nofSamples]   = 0;
+    payload[nofSamples+1] = 0;
+    uint32_t crc = DAL::crc32(&payload[0],nofSamples+2);
+    payload[nofSamples]   = uint16_t(crc >> 16);
+    payload[nofSamples+1] = uint16_t(crc & 0xffff);
+    /* The complete payload now must divide without remainder */
+    crc = DAL::crc32(&payload[0],nofSamples+2);
+    cout << "-- crc32(payload) = " << crc << endl;
+    if (crc != 0) {
+      ++nofFailedTests;
+    }
+    /* A single flipped bit must be detected */
+    payload[100] ^= 0x0100;
+    crc = DAL::crc32(&payload[0],nofSamples+2);
+    cout << "-- crc32(corrupted payload) = " << crc << endl;
+    if (crc == 0) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                 test_benchmark
+
+/*!
+  \brief Measure the throughput of the CRC computation on TBB frames
+
+  The reference rate is a dump of 12 stations, each of them sending frames
+  through a 1 Gbit/s link.
+
+  \param nofFrames -- Number of TBB frames to process.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_benchmark (uint32_t const &nofFrames)
+{
+  cout << "\n[tdalCommon_crc::test_benchmark]\n" << endl;
+
+  int nofFailedTests (0);
+  uint32_t nofWords    = frameSize/sizeof(uint16_t);
+  double requiredRate  = 12 * 1e9 / (8.0*frameSize);
+  std::vector<uint16_t> frames (16*nofWords);
+  fill_random (frames);
+
+  cout << "-- nof. frames             = " << nofFrames    << endl;
+  cout << "-- Required rate [frame/s] = " << requiredRate << endl;
+
+  try {
+    uint32_t sum (0);
+    clock_t start;
+    double seconds;
+
+    /* Bit-serial reference on a reduced number of frames */
+    uint32_t nofReference = nofFrames/20 + 1;
+    start = clock();
+    for (uint32_t n=0; n<nofReference; ++n) {
+      uint16_t *frame = &frames[(n%16)*nofWords];
+      sum += reference_crc(frame,nofHeaderWords,0x8005,16);
+      sum += reference_crc(frame+nofHeaderWords,nofSamples+2,0x04C11DB7,32);
+    }
+    seconds = double(clock()-start)/CLOCKS_PER_SEC;
+    cout << "-- Bit-serial  [frame/s]   = " << nofReference/seconds << endl;
+
+    /* Header only, which is what has been checked by default so far */
+    start = clock();
+    for (uint32_t n=0; n<nofFrames; ++n) {
+      sum += DAL::crc16(&frames[(n%16)*nofWords],nofHeaderWords);
+    }
+    seconds = double(clock()-start)/CLOCKS_PER_SEC;
+    cout << "-- crc16 header [frame/s]  = " << nofFrames/seconds << endl;
+
+    /* Header and payload */
+    start = clock();
+    for (uint32_t n=0; n<nofFrames; ++n) {
+      uint16_t *frame = &frames[(n%16)*nofWords];
+      sum += DAL::crc16(frame,nofHeaderWords);
+      sum += DAL::crc32(frame+nofHeaderWords,nofSamples+2);
+    }
+    seconds = double(clock()-start)/CLOCKS_PER_SEC;
+    cout << "-- crc16+crc32 [frame/s]   = " << nofFrames/seconds << endl;
+    cout << "-- crc16+crc32 [MB/s]      = "
+	 << nofFrames*double(frameSize)/(1e6*seconds) << endl;
+    cout << "-- Fraction of one core    = " << requiredRate*seconds/nofFrames << endl;
+    cout << "-- (checksum " << sum << ")" << endl;
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+/*!
+  \brief Main routine of the test program
+
+  \return nofFailedTests -- The number of failed tests encountered within and
+          identified by this test program.
+*/
+int main (int argc, char *argv[])
+{
+  int nofFailedTests = 0;
+  uint32_t nofFrames = 5000;
+
+  if (argc>1) {
+    nofFrames = atoi(argv[1]);
+  }
+
+  nofFailedTests += test_crc16 ();
+  nofFailedTests += test_crc32 ();
+  nofFailedTests += test_benchmark (nofFrames);
+
+  return nofFailedTests;
+}
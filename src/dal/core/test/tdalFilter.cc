@@ -84,6 +84,143 @@ int test_constructors ()
   return nofFailedTests;
 }
 
+//_______________________________________________________________________________
+//                                                                     test_parse
+
+/*!
+  \brief Test parsing of column selections and conditions
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_parse ()
+{
+  std::cout << "\n[tdalFilter::test_parse]\n" << std::endl;
+
+  int nofFailedTests (0);
+
+  std::cout << "[1] Parse column selections ..." << std::endl;
+  {
+    std::vector<std::string> columns;
+    if (!DAL::dalFilter::parseColumns (" TIME, DATA ,ANTENNA1", columns)
+	|| columns.size() != 3 || columns[0] != "TIME" || columns[1] != "DATA"
+	|| columns[2] != "ANTENNA1") {
+      ++nofFailedTests;
+    }
+    if (!DAL::dalFilter::parseColumns ("*", columns) || !columns.empty()) {
+      ++nofFailedTests;
+    }
+    if (DAL::dalFilter::parseColumns ("TIME,,DATA", columns)) {
+      ++nofFailedTests;
+    }
+  }
+
+  std::cout << "[2] Parse conditions ..." << std::endl;
+  {
+    std::vector<DAL::dalFilter::Condition> conditions;
+    if (!DAL::dalFilter::parseConditions ("ANTENNA1=1 AND ANTENNA2 != 10 and TIME>=4.5e9 && x<-2",
+					  conditions)
+	|| conditions.size() != 4) {
+      ++nofFailedTests;
+    } else {
+      if (conditions[0].column != "ANTENNA1" || conditions[0].op != DAL::dalFilter::Equal
+	  || conditions[0].value != 1) {
+	++nofFailedTests;
+      }
+      if (conditions[1].column != "ANTENNA2" || conditions[1].op != DAL::dalFilter::NotEqual
+	  || conditions[1].value != 10) {
+	++nofFailedTests;
+      }
+      if (conditions[2].column != "TIME" || conditions[2].op != DAL::dalFilter::GreaterEqual
+	  || conditions[2].value != 4.5e9) {
+	++nofFailedTests;
+      }
+      if (conditions[3].column != "x" || conditions[3].op != DAL::dalFilter::Less
+	  || conditions[3].value != -2) {
+	++nofFailedTests;
+      }
+    }
+    if (DAL::dalFilter::parseConditions ("TIME>yesterday", conditions)
+	|| DAL::dalFilter::parseConditions ("TIME", conditions)
+	|| DAL::dalFilter::parseConditions ("=5", conditions)) {
+      ++nofFailedTests;
+    }
+  }
+
+  std::cout << "[3] Set filter for HDF5 table ..." << std::endl;
+  {
+    DAL::dalFilter filter (DAL::dalFileType::HDF5, "TIME,DATA", "ANTENNA1==3");
+    filter.summary();
+    if (!filter.isSet() || filter.columns().size() != 2 || filter.nofConditions() != 1) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                  test_evaluate
+
+/*!
+  \brief Test the kernels applying a condition to a block of values
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_evaluate ()
+{
+  std::cout << "\n[tdalFilter::test_evaluate]\n" << std::endl;
+
+  int nofFailedTests (0);
+  DAL::dalFilter::Operator ops[] = { DAL::dalFilter::Equal,
+				     DAL::dalFilter::NotEqual,
+				     DAL::dalFilter::Less,
+				     DAL::dalFilter::LessEqual,
+				     DAL::dalFilter::Greater,
+				     DAL::dalFilter::GreaterEqual };
+  /* Number of values in 0..9 passing each of the conditions against 4 */
+  unsigned int expected[] = { 1, 9, 4, 5, 5, 6 };
+  /* Values interleaved with a second column */
+  double values[20];
+  for (int n=0; n<10; ++n) {
+    values[2*n]   = n;
+    values[2*n+1] = -1;
+  }
+
+  for (int k=0; k<6; ++k) {
+    DAL::dalFilter::Condition condition;
+    condition.column = "x";
+    condition.op     = ops[k];
+    condition.value  = 4;
+    std::vector<unsigned char> mask (10, 1);
+    DAL::dalFilter::evaluate (condition, values, 2, 10, &mask[0]);
+    unsigned int nofPassed = 0;
+    for (int n=0; n<10; ++n) {
+      nofPassed += mask[n];
+    }
+    std::cout << "-- Operator " << k << " : " << nofPassed << " rows" << std::endl;
+    if (nofPassed != expected[k]) {
+      ++nofFailedTests;
+    }
+    /* A range overlaps the condition if any of its values passes it */
+    int ranges[3][2] = { {0,3}, {4,4}, {5,9} };
+    for (int r=0; r<3; ++r) {
+      bool passed = false;
+      for (int n=ranges[r][0]; n<=ranges[r][1]; ++n) {
+	passed = passed || mask[n];
+      }
+      if (DAL::dalFilter::overlaps (condition, ranges[r][0], ranges[r][1]) != passed) {
+	std::cout << "--> Range [" << ranges[r][0] << "," << ranges[r][1]
+		  << "] wrongly classified" << std::endl;
+	++nofFailedTests;
+      }
+    }
+  }
+
+  return nofFailedTests;
+}
+
 //_______________________________________________________________________________
 //                                                                           main
 
@@ -107,6 +244,8 @@ int main (int argc, char *argv[])
   // Run the tests
 
   nofFailedTests += test_constructors ();
+  nofFailedTests += test_parse ();
+  nofFailedTests += test_evaluate ();
 
   return nofFailedTests;
 }
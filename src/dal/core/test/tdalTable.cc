@@ -28,11 +28,67 @@
   \author Lars B&auml;hren
 
   \date 2008/09/22
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tdalTable [input file] [nofRows]
+  tdalTable [nofRows]
+  \endverbatim
+
+  Writing and reading a table, together with the benchmarks for appending rows
+  and for selecting rows by a filter or through a zone map, does not require
+  an input file; all other tests are skipped without one. By default the
+  benchmarks only run briefly, the selections on tables of 20000 rows, as
+  checks of the results; for timings pass the number of rows, e.g.
+  <tt>tdalTable 1000000</tt>.
 */
 
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
 #include <core/dalCommon.h>
 #include <core/dalDataset.h>
 
+//! Layout of the records of the table used for testing
+typedef struct {
+  int index;
+  float value;
+  double time;
+} Record;
+
+//_______________________________________________________________________________
+//                                                                  appendLegacy
+
+/*!
+  \brief Append records, retrieving the table layout for every call
+
+  This is how dalTable::appendRows() used to append records to an HDF5 table;
+  it is kept for comparison with the cached layout.
+*/
+void appendLegacy (hid_t const &fileID,
+		   std::string const &name,
+		   void *data,
+		   hsize_t const &nofRecords)
+{
+  hsize_t nfields;
+  hsize_t nrecords;
+  size_t size_out;
+
+  H5TBget_table_info (fileID, name.c_str(), &nfields, &nrecords);
+
+  size_t *field_sizes   = (size_t*)malloc (nfields*sizeof(size_t));
+  size_t *field_offsets = (size_t*)malloc (nfields*sizeof(size_t));
+
+  H5TBget_field_info (fileID, name.c_str(), NULL, field_sizes, field_offsets, &size_out);
+  H5TBappend_records (fileID, name.c_str(), nofRecords, size_out,
+		      field_offsets, field_sizes, data);
+
+  free (field_sizes);
+  free (field_offsets);
+}
+
 //_______________________________________________________________________________
 //                                                                      test_H5TB
 
@@ -47,6 +103,507 @@ int test_H5TB ()
   std::cout << "\n[tdalTable::test_H5TB]\n" << std::endl;
 
   int nofFailedTests (0);
+  long nofRows (10000);
+  std::vector<Record> rows (nofRows);
+
+  for (long n=0; n<nofRows; ++n) {
+    rows[n].index = n;
+    rows[n].value = 0.5*n;
+    rows[n].time  = 1e-3*n;
+  }
+
+  DAL::dalDataset dataset ("tdalTable.h5", "HDF5", true);
+  DAL::dalTable * table = NULL;
+
+  std::cout << "[1] Create table and add columns ..." << std::endl;
+  try {
+    table = dataset.createTable ("Records");
+    table->addColumn ("index", DAL::dal_INT);
+    table->addColumn ("value", DAL::dal_FLOAT);
+    table->addColumn ("time",  DAL::dal_DOUBLE);
+    table->summary();
+    if (table->getNumberOfRows() != 1) {
+      ++nofFailedTests;
+    }
+  }
+  catch (std::string message) {
+    std::cerr << message << std::endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[2] Append rows and read them back ..." << std::endl;
+  try {
+    /* The first row replaces the empty record of the table created above */
+    table->appendRow (&rows[0]);
+    table->appendRows (&rows[1], nofRows-1);
+    if (table->getNumberOfRows() != nofRows) {
+      std::cerr << "-- Wrong number of rows " << table->getNumberOfRows() << std::endl;
+      ++nofFailedTests;
+    }
+    /* Reading through the cached layout */
+    std::vector<Record> buffer (nofRows);
+    table->readRows (&buffer[0], 0, nofRows);
+    for (long n=0; n<nofRows; ++n) {
+      if (buffer[n].index != rows[n].index
+	  || buffer[n].value != rows[n].value
+	  || buffer[n].time != rows[n].time) {
+	std::cerr << "-- Mismatch in row " << n << std::endl;
+	++nofFailedTests;
+	break;
+      }
+    }
+    /* Overwrite a single column */
+    int index[3] = {-1, -2, -3};
+    table->writeDataByColNum (index, 0, 100, 3);
+    table->readRows (&buffer[0], 100, 3);
+    if (buffer[2].index != -3 || buffer[2].value != rows[102].value) {
+      ++nofFailedTests;
+    }
+    /* Reading beyond the end of the table is rejected */
+    table->readRows (&buffer[0], nofRows-1, 2);
+    delete table;
+  }
+  catch (std::string message) {
+    std::cerr << message << std::endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[3] Adding a column invalidates the layout ..." << std::endl;
+  try {
+    /* Records with the additional column, padded in memory */
+    typedef struct {
+      Record record;
+      int flag;
+      int padding[3];
+    } FlaggedRecord;
+    table = dataset.openTable ("Records");
+    std::vector<Record> buffer (2);
+    table->readRows (&buffer[0], 0, 2);
+    table->addColumn ("flag", DAL::dal_INT);
+    table->summary();
+    FlaggedRecord flagged[2];
+    flagged[1].flag = -1;
+    table->readRows (flagged, 10, 2, sizeof(FlaggedRecord));
+    if (flagged[1].record.index != 11
+	|| flagged[1].record.time != rows[11].time
+	|| flagged[1].flag != 0) {
+      ++nofFailedTests;
+    }
+    delete table;
+  }
+  catch (std::string message) {
+    std::cerr << message << std::endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[4] Append through two handles in turn ..." << std::endl;
+  try {
+    table = dataset.createTable ("Shared");
+    table->addColumn ("index", DAL::dal_INT);
+    table->addColumn ("value", DAL::dal_FLOAT);
+    table->addColumn ("time",  DAL::dal_DOUBLE);
+    DAL::dalTable * first  = dataset.openTable ("Shared");
+    DAL::dalTable * second = dataset.openTable ("Shared");
+    table->appendRows (&rows[0], 10);
+    second->appendRows (&rows[10], 10);
+    first->appendRows (&rows[20], 10);
+    delete table;
+    std::vector<Record> buffer (30);
+    first->readRows (&buffer[0], 0, 30);
+    if (first->getNumberOfRows() != 30) {
+      std::cerr << "-- Wrong number of rows " << first->getNumberOfRows() << std::endl;
+      ++nofFailedTests;
+    }
+    for (long n=0; n<30; ++n) {
+      if (buffer[n].index != rows[n].index) {
+	std::cerr << "-- Mismatch in row " << n << std::endl;
+	++nofFailedTests;
+	break;
+      }
+    }
+    delete first;
+    delete second;
+  }
+  catch (std::string message) {
+    std::cerr << message << std::endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[5] Append to a reopened table holding a single row ..." << std::endl;
+  try {
+    table = dataset.createTable ("Single");
+    table->addColumn ("index", DAL::dal_INT);
+    table->addColumn ("value", DAL::dal_FLOAT);
+    table->addColumn ("time",  DAL::dal_DOUBLE);
+    table->appendRows (&rows[0], 1);
+    delete table;
+    table = dataset.openTable ("Single");
+    table->appendRows (&rows[1], 1);
+    std::vector<Record> buffer (2);
+    table->readRows (&buffer[0], 0, 2);
+    if (table->getNumberOfRows() != 2
+	|| buffer[0].index != rows[0].index
+	|| buffer[1].index != rows[1].index) {
+      std::cerr << "-- Row of the reopened table overwritten" << std::endl;
+      ++nofFailedTests;
+    }
+    delete table;
+  }
+  catch (std::string message) {
+    std::cerr << message << std::endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                               benchmark_append
+
+/*!
+  \brief Compare the rate of appended rows with and without cached layout
+
+  \param seconds -- Duration of a single measurement.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int benchmark_append (double const &seconds)
+{
+  std::cout << "\n[tdalTable::benchmark_append]\n" << std::endl;
+
+  int nofFailedTests (0);
+  long sizes[] = {1, 10000};
+  std::vector<Record> rows (10000);
+
+  DAL::dalDataset dataset ("tdalTable_benchmark.h5", "HDF5", true);
+  hid_t fileID = dataset.getId();
+
+  for (unsigned int s=0; s<2; ++s) {
+    long size = sizes[s];
+    double rate[2];
+
+    for (unsigned int method=0; method<2; ++method) {
+      std::string name = "Table" + DAL::toString(size) + "_" + DAL::toString(method);
+      DAL::dalTable * table = dataset.createTable (name);
+      table->addColumn ("index", DAL::dal_INT);
+      table->addColumn ("value", DAL::dal_FLOAT);
+      table->addColumn ("time",  DAL::dal_DOUBLE);
+
+      unsigned long nofRows = 0;
+      double start_t        = DAL::wallTime();
+      double end_t          = start_t;
+
+      while (end_t-start_t < seconds) {
+	if (method == 0) {
+	  appendLegacy (fileID, "/" + name, &rows[0], size);
+	} else {
+	  table->appendRows (&rows[0], size);
+	}
+	nofRows += size;
+	end_t = DAL::wallTime();
+      }
+
+      rate[method] = nofRows/(end_t-start_t);
+      delete table;
+    }
+
+    std::cout << "-- " << size << " rows/call\t: legacy " << rate[0]
+	      << " rows/s , cached layout " << rate[1]
+	      << " rows/s , speed-up " << rate[1]/rate[0] << std::endl;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                               benchmark_select
+
+/*!
+  \brief Compare selecting rows by a filter with reading and filtering all rows
+
+  A table of \e nofRows records is scanned for a time window, excluding one
+  value of the index column, once by reading all records through readRows()
+  and testing them one by one -- as done before tables could be filtered --
+  and once through dalTable::selectRows(), for the row indices only and
+  together with a projection onto two of the columns.
+
+  \param nofRows -- Number of rows in the table.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int benchmark_select (long const &nofRows)
+{
+  std::cout << "\n[tdalTable::benchmark_select]\n" << std::endl;
+
+  int nofFailedTests (0);
+  long blockSize (100000);
+  std::vector<Record> rows (blockSize);
+  double t0 (0.25e-3*nofRows);
+  double t1 (0.26e-3*nofRows);
+  int excluded (nofRows/4+1);
+  std::vector<hsize_t> expected;
+
+  DAL::dalDataset dataset ("tdalTable_select.h5", "HDF5", true);
+
+  std::cout << "[1] Create table of " << nofRows << " rows ..." << std::endl;
+  {
+    DAL::dalTable * table = dataset.createTable ("Records");
+    table->addColumn ("index", DAL::dal_INT);
+    table->addColumn ("value", DAL::dal_FLOAT);
+    table->addColumn ("time",  DAL::dal_DOUBLE);
+    double start_t = DAL::wallTime();
+    for (long first=0; first<nofRows; first+=blockSize) {
+      long count = std::min (blockSize, nofRows-first);
+      for (long n=0; n<count; ++n) {
+	rows[n].index = first+n;
+	rows[n].value = 0.5*(first+n);
+	rows[n].time  = 1e-3*(first+n);
+      }
+      table->appendRows (&rows[0], count);
+    }
+    std::cout << "-- Rows/s (append) ......... = "
+	      << nofRows/(DAL::wallTime()-start_t) << std::endl;
+    delete table;
+  }
+
+  std::cout << "[2] Read all rows and filter them ..." << std::endl;
+  {
+    DAL::dalTable * table = dataset.openTable ("Records");
+    double start_t = DAL::wallTime();
+    for (long first=0; first<nofRows; first+=blockSize) {
+      long count = std::min (blockSize, nofRows-first);
+      table->readRows (&rows[0], first, count);
+      for (long n=0; n<count; ++n) {
+	if (rows[n].time >= t0 && rows[n].time < t1 && rows[n].index != excluded) {
+	  expected.push_back (first+n);
+	}
+      }
+    }
+    std::cout << "-- Rows/s (scan) ........... = "
+	      << nofRows/(DAL::wallTime()-start_t) << std::endl;
+    std::cout << "-- nof. matching rows ...... = " << expected.size() << std::endl;
+    delete table;
+  }
+
+  std::ostringstream conditionStream;
+  conditionStream.precision (17);
+  conditionStream << "time >= " << t0 << " AND time<" << t1
+		  << " AND index != " << excluded;
+  std::string conditions = conditionStream.str();
+
+  std::cout << "[3] Select the row indices by the filter ..." << std::endl;
+  {
+    DAL::dalTable * table = dataset.openTable ("Records");
+    std::vector<hsize_t> selected;
+    table->setFilter ("*", conditions);
+    double start_t = DAL::wallTime();
+    table->selectRows (selected);
+    std::cout << "-- Rows/s (select) ......... = "
+	      << nofRows/(DAL::wallTime()-start_t) << std::endl;
+    if (selected != expected) {
+      std::cerr << "-- Selected rows differ from the scanned ones!" << std::endl;
+      ++nofFailedTests;
+    }
+    delete table;
+  }
+
+  std::cout << "[4] Select rows and read two of their columns ..." << std::endl;
+  {
+    DAL::dalTable * table = dataset.openTable ("Records");
+    std::vector<hsize_t> selected;
+    std::vector<char> records;
+    table->setFilter ("time,index", conditions);
+    double start_t = DAL::wallTime();
+    table->selectRows (selected, records);
+    std::cout << "-- Rows/s (select+read) .... = "
+	      << nofRows/(DAL::wallTime()-start_t) << std::endl;
+    size_t size = table->selectionRecordSize();
+    if (size != sizeof(double)+sizeof(int)
+	|| selected != expected
+	|| records.size() != size*expected.size()) {
+      ++nofFailedTests;
+    } else {
+      for (size_t n=0; n<selected.size(); ++n) {
+	double time;
+	int index;
+	memcpy (&time,  &records[n*size], sizeof(double));
+	memcpy (&index, &records[n*size+sizeof(double)], sizeof(int));
+	if (index != int(selected[n]) || time != 1e-3*selected[n]) {
+	  std::cerr << "-- Mismatch in selected row " << selected[n] << std::endl;
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+    delete table;
+  }
+
+  std::cout << "[5] Reject conditions on unknown columns ..." << std::endl;
+  {
+    DAL::dalTable * table = dataset.openTable ("Records");
+    std::vector<hsize_t> selected;
+    table->setFilter ("*", "weight > 1");
+    if (table->selectRows (selected) != -1) {
+      ++nofFailedTests;
+    }
+    /* Without conditions all rows in the range are selected */
+    table->setFilter ("index");
+    if (table->selectRows (selected, 10, 5) != 5 || selected[0] != 10) {
+      ++nofFailedTests;
+    }
+    delete table;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                              benchmark_zoneMap
+
+/*!
+  \brief Compare a time window looked up through a zone map with a full scan
+
+  A table of \e nofRows records, ordered by time, is given a zone map on its
+  time column before the rows are appended. A window of 1% of the rows then is
+  looked up by dalTable::selectRange(), which only reads the zones overlapping
+  the window, and compared with reading and testing all rows. Furthermore the
+  map has to follow overwritten values, be rebuilt over all numerical columns
+  and be discarded once its column has been removed.
+
+  \param nofRows -- Number of rows in the table.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int benchmark_zoneMap (long const &nofRows)
+{
+  std::cout << "\n[tdalTable::benchmark_zoneMap]\n" << std::endl;
+
+  int nofFailedTests (0);
+  long blockSize (100000);
+  std::vector<Record> rows (blockSize);
+  double t0 (0.50e-3*nofRows);
+  double t1 (0.51e-3*nofRows);
+  std::vector<hsize_t> expected;
+  std::vector<hsize_t> selected;
+  std::vector<char> records;
+
+  DAL::dalDataset dataset ("tdalTable_zoneMap.h5", "HDF5", true);
+
+  std::cout << "[1] Create table of " << nofRows << " rows with zone map ..."
+	    << std::endl;
+  {
+    DAL::dalTable * table = dataset.createTable ("Records");
+    table->addColumn ("index", DAL::dal_INT);
+    table->addColumn ("value", DAL::dal_FLOAT);
+    table->addColumn ("time",  DAL::dal_DOUBLE);
+    if (!table->createZoneMap ("time")) {
+      ++nofFailedTests;
+    }
+    double start_t = DAL::wallTime();
+    for (long first=0; first<nofRows; first+=blockSize) {
+      long count = std::min (blockSize, nofRows-first);
+      for (long n=0; n<count; ++n) {
+	rows[n].index = first+n;
+	rows[n].value = 0.5*(first+n);
+	rows[n].time  = 1e-3*(first+n);
+      }
+      /* Single rows as well as blocks are merged into the map */
+      table->appendRow (&rows[0]);
+      table->appendRows (&rows[1], count-1);
+    }
+    std::cout << "-- Rows/s (append) ......... = "
+	      << nofRows/(DAL::wallTime()-start_t) << std::endl;
+    delete table;
+  }
+
+  std::cout << "[2] Look up a time window ..." << std::endl;
+  {
+    DAL::dalTable * table = dataset.openTable ("Records");
+    if (!table->hasZoneMap()) {
+      std::cerr << "-- Zone map not found after reopening the table" << std::endl;
+      ++nofFailedTests;
+    }
+    double start_t = DAL::wallTime();
+    for (long first=0; first<nofRows; first+=blockSize) {
+      long count = std::min (blockSize, nofRows-first);
+      table->readRows (&rows[0], first, count);
+      for (long n=0; n<count; ++n) {
+	if (rows[n].time >= t0 && rows[n].time < t1) {
+	  expected.push_back (first+n);
+	}
+      }
+    }
+    double scan_t = DAL::wallTime()-start_t;
+    start_t = DAL::wallTime();
+    table->selectRange (selected, records, "time", t0, t1);
+    double range_t = DAL::wallTime()-start_t;
+    table->summary();
+    std::cout << "-- Rows/s (scan) ........... = " << nofRows/scan_t << std::endl;
+    std::cout << "-- Rows/s (zone map) ....... = " << nofRows/range_t << std::endl;
+    std::cout << "-- Speed-up ................ = " << scan_t/range_t << std::endl;
+    std::cout << "-- nof. rows read .......... = " << table->nofRowsScanned()
+	      << std::endl;
+    std::cout << "-- nof. matching rows ...... = " << selected.size() << std::endl;
+    if (selected != expected
+	|| records.size() != expected.size()*sizeof(Record)
+	|| table->nofRowsScanned() > hsize_t(nofRows/50+2*CHUNK_SIZE)) {
+      ++nofFailedTests;
+    }
+    delete table;
+  }
+
+  std::cout << "[3] Follow a value overwritten in another zone ..." << std::endl;
+  {
+    DAL::dalTable * table = dataset.openTable ("Records");
+    double time = t0;
+    table->writeDataByColNum (&time, 2, 0);
+    expected.insert (expected.begin(), 0);
+    table->selectRange (selected, "time", t0, t1);
+    if (selected != expected) {
+      std::cerr << "-- Overwritten row not found" << std::endl;
+      ++nofFailedTests;
+    }
+    delete table;
+  }
+
+  std::cout << "[4] Rebuild the zone map for all numerical columns ..." << std::endl;
+  {
+    DAL::dalTable * table = dataset.openTable ("Records");
+    if (!table->createZoneMap ()) {
+      ++nofFailedTests;
+    }
+    table->setFilter ("*", "index >= 1000 AND index < 1010");
+    if (table->selectRows (selected) != 10
+	|| selected[0] != 1000
+	|| table->nofRowsScanned() > hsize_t(CHUNK_SIZE)) {
+      ++nofFailedTests;
+    }
+    delete table;
+  }
+
+  std::cout << "[5] Ignore the zone map after removing its columns ..." << std::endl;
+  {
+    DAL::dalTable * table = dataset.openTable ("Records");
+    table->removeColumn ("time");
+    delete table;
+    table = dataset.openTable ("Records");
+    if (table->hasZoneMap()) {
+      ++nofFailedTests;
+    }
+    /* Opening the table leaves the zone map in the file ... */
+    if (H5Lexists (dataset.getId(), "Records_ZONEMAP", H5P_DEFAULT) <= 0) {
+      std::cerr << "-- Zone map removed from the file" << std::endl;
+      ++nofFailedTests;
+    }
+    /* ... until it is replaced */
+    if (!table->createZoneMap ("index") || !table->hasZoneMap()) {
+      ++nofFailedTests;
+    }
+    delete table;
+  }
 
   return nofFailedTests;
 }
@@ -196,20 +753,35 @@ int main (int argc,
   bool haveDataset (true);
   std::string filename ("tHDF5Dataset.h5");
   std::string tableName ("SB000");
+  long nofRows (20000);
+  double seconds (0.05);
 
   //________________________________________________________
   // Process parameters from the command line
   
   if (argc < 2) {
     haveDataset = false;
+  } else if (strspn (argv[1], "0123456789") == strlen (argv[1])) {
+    nofRows     = atol (argv[1]);
+    seconds     = 0.5;
+    haveDataset = false;
   } else {
     filename    = argv[1];
     haveDataset = true;
+    if (argc > 2) {
+      nofRows = atol (argv[2]);
+      seconds = 0.5;
+    }
   }
 
   //________________________________________________________
   // Run the tests
 
+  nofFailedTests += test_H5TB ();
+  nofFailedTests += benchmark_append (seconds);
+  nofFailedTests += benchmark_select (nofRows);
+  nofFailedTests += benchmark_zoneMap (nofRows);
+
   if (haveDataset) {
     nofFailedTests += test_constructors(filename, haveDataset);
     nofFailedTests += test_parameters(filename, haveDataset);
@@ -481,6 +481,38 @@ namespace DAL { // Namespace DAL -- begin
   //_____________________________________________________________________________
   //                                                                 setHyperslab
   
+  /*!
+    \param datasetID     -- HDF5 object identifier for the dataset which will be
+           extended, if required, to apply the hyperslab seection.
+    \param dataspaceID   -- HDF5 object identifier for the dataspace to which to
+           apply the hyperslab selection.
+    \param shape         -- Shape of the dataset as known to the caller; updated
+           if the dataset is extended.
+    \param resizeDataset -- Resize the dataset to the dimensions defined by the 
+           Hyperslab?
+
+    \return status -- Status of the operation; returns \e false in case an error 
+            was encountered.
+  */
+  bool HDF5Hyperslab::setHyperslab (hid_t &datasetID,
+				    hid_t &dataspaceID,
+				    std::vector<hsize_t> &shape,
+				    bool const &resizeDataset)
+  {
+    return setHyperslab (datasetID,
+			 dataspaceID,
+			 shape,
+			 itsSelection,
+			 itsStart,
+			 itsStride,
+			 itsCount,
+			 itsBlock,
+			 resizeDataset);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 setHyperslab
+  
   /*!
     \param location  -- HDF5 object identifier for the dataset or dataspace to
            to which the Hyperslab is going to be applied.
@@ -648,6 +680,60 @@ namespace DAL { // Namespace DAL -- begin
 				    std::vector<int> const &count,
 				    std::vector<int> const &block,
 				    bool const &resizeDataset)
+  {
+    std::vector<hsize_t> shape;
+
+    if (H5Iis_valid(datasetID) && H5Iget_type (datasetID) == H5I_DATASET) {
+      HDF5Dataspace::shape (datasetID,shape);
+    }
+
+    return setHyperslab (datasetID,
+			 dataspaceID,
+			 shape,
+			 selection,
+			 start,
+			 stride,
+			 count,
+			 block,
+			 resizeDataset);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 setHyperslab
+  
+  /*!
+    \param datasetID     -- HDF5 object identifier for the dataset which will be
+           extended, if required, to apply the hyperslab seection.
+    \param dataspaceID   -- HDF5 object identifier for the dataspace to which to
+           apply the hyperslab selection.
+    \param shape         -- Current shape of the dataset, as known to the caller;
+           updated if the dataset is extended. Passing the shape on saves
+	   querying it from the HDF5 library for every selection.
+    \param selection     -- Selection operator to determine how the new selection
+           is to be combined with the already existing selection for the
+	   dataspace.
+    \param start         -- Offset of the starting element of the specified
+           hyperslab.
+    \param stride        -- Number of elements to separate each element or block
+           to be selected
+    \param count         -- The number of elements or blocks to select along each
+           dimension.
+    \param block         -- The size of the block selected from the dataspace
+    \param resizeDataset -- Resize the dataset to the dimensions defined by the 
+           Hyperslab?
+
+    \return status -- Status of the operation; returns \e false in case an error 
+            was encountered.
+  */
+  bool HDF5Hyperslab::setHyperslab (hid_t &datasetID,
+				    hid_t &dataspaceID,
+				    std::vector<hsize_t> &shape,
+				    H5S_seloper_t const &selection,
+				    std::vector<int> const &start,
+				    std::vector<int> const &stride,
+				    std::vector<int> const &count,
+				    std::vector<int> const &block,
+				    bool const &resizeDataset)
   {
     bool status = true;
 
@@ -686,14 +772,12 @@ namespace DAL { // Namespace DAL -- begin
     // Check Hyperslab parameters __________________________
 
     unsigned int nelem;
-    std::vector<hsize_t> shape;
     bool haveStride (true);
     bool haveCount (true);
     bool haveBlock (true);
     herr_t h5error;
 
-    /* Get shape and rank of the dataspace */
-    HDF5Dataspace::shape (datasetID,shape);
+    /* Rank of the dataspace */
     nelem = shape.size();
     
     /* Start position m1*/
@@ -734,9 +818,10 @@ namespace DAL { // Namespace DAL -- begin
       }
       
       if (extendDataset && resizeDataset) {
-	/* Feedback */
+#ifdef DAL_DEBUGGING_MESSAGES
 	std::cout << "-- Extending dataset : " << shape << " -> " 
 		  << toString(tmpSize,nelem) << std::endl;
+#endif
 	/* Close the dataspace */
 	h5error = H5Sclose (dataspaceID);
 	/* Extend the dataset */
@@ -748,6 +833,9 @@ namespace DAL { // Namespace DAL -- begin
 	  std::cerr << "[HDF5Hyperslab::setHyperslab] Error extending dataset!"
 		    << std::endl;
 	  status = false;
+	} else {
+	  /* Keep the caller's copy of the shape up to date */
+	  shape.assign (tmpSize, tmpSize+nelem);
 	}
       }
     } catch (std::string message) {
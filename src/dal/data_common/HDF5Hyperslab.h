@@ -331,7 +331,7 @@ namespace DAL { // Namespace DAL -- begin
     }
 
     //! Get the offset of the starting element of the specified hyperslab
-    inline std::vector<int> start () const {
+    inline std::vector<int> const & start () const {
       return itsStart;
     }
 
@@ -339,7 +339,7 @@ namespace DAL { // Namespace DAL -- begin
     bool setStart (std::vector<int> const &start);
 
     //! Get the number of elements to separate each element or block to be selected
-    inline std::vector<int> stride () const {
+    inline std::vector<int> const & stride () const {
       return itsStride;
     }
 
@@ -347,7 +347,7 @@ namespace DAL { // Namespace DAL -- begin
     bool setStride (std::vector<int> const &stride);
     
     //! Get the number of elements or blocks to select along each dimension
-    inline std::vector<int> count () const {
+    inline std::vector<int> const & count () const {
       return itsCount;
     }
 
@@ -355,7 +355,7 @@ namespace DAL { // Namespace DAL -- begin
     bool setCount (std::vector<int> const &count);
     
     //! Get the size of the element block selected from the dataspace
-    inline std::vector<int> block () const {
+    inline std::vector<int> const & block () const {
       return itsBlock;
     }
 
@@ -423,6 +423,12 @@ namespace DAL { // Namespace DAL -- begin
 		       hid_t &dataspaceID,
 		       bool const &resizeDataset);
 
+    //! Set the Hyperslab for a dataset of known shape
+    bool setHyperslab (hid_t &datasetID,
+		       hid_t &dataspaceID,
+		       std::vector<hsize_t> &shape,
+		       bool const &resizeDataset);
+
     //! Set the Hyperslab for the dataspace attached to a dataset
     static bool setHyperslab (hid_t &location,
     			      H5S_seloper_t const &selection,
@@ -457,6 +463,17 @@ namespace DAL { // Namespace DAL -- begin
 			      std::vector<int> const &block,
 			      bool const &resizeDataset);
 
+    //! Set the Hyperslab for a dataset of known shape
+    static bool setHyperslab (hid_t &datasetID,
+			      hid_t &dataspaceID,
+			      std::vector<hsize_t> &shape,
+			      H5S_seloper_t const &selection,
+			      std::vector<int> const &start,
+			      std::vector<int> const &stride,
+			      std::vector<int> const &count,
+			      std::vector<int> const &block,
+			      bool const &resizeDataset);
+
     //! Check if Hyperslab selection is valid
     static bool checkSelectionValid (hid_t const &location,
 				     htri_t &errorCode);
@@ -0,0 +1,621 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "BFRawKernels.h"
+
+#include <cstring>
+
+/* The SIMD kernels are compiled for their instruction set through function
+   attributes, hence do not depend on the flags the library is built with. */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) \
+  && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define BFRAWKERNELS_X86
+#include <immintrin.h>
+#endif
+
+//! Number of input samples processed per call of the per-sample kernel
+#define BFRAWKERNELS_BLOCKSIZE 1024
+
+using std::endl;
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                 BFRawKernels
+
+  /*!
+    \param products       -- Products to compute, combination of
+           BFRawKernels::Product.
+    \param factor         -- Number of input samples summed into one output
+           sample.
+    \param instructionSet -- Instruction set to use; if it is not supported by
+           the processor, the most capable one that is will be used instead.
+  */
+  BFRawKernels::BFRawKernels (unsigned int const &products,
+			      unsigned int const &factor,
+			      InstructionSet const &instructionSet)
+  {
+    InstructionSet supported = supportedInstructionSet();
+
+    itsProducts       = products & StokesIQUV;
+    itsFactor         = factor>0 ? factor : 1;
+    itsInstructionSet = instructionSet;
+
+    if (itsProducts == 0) {
+      std::cerr << "[BFRawKernels] No valid product selected - computing Stokes I"
+		<< endl;
+      itsProducts = StokesI;
+    }
+
+    itsNofProducts = 0;
+    for (unsigned int flag=StokesI; flag<=StokesV; flag*=2) {
+      if (itsProducts & flag) {
+	++itsNofProducts;
+      }
+    }
+
+    if (itsInstructionSet == Best || itsInstructionSet > supported) {
+      if (itsInstructionSet != Best) {
+	std::cerr << "[BFRawKernels] Instruction set " << name(itsInstructionSet)
+		  << " not supported - using " << name(supported) << endl;
+      }
+      itsInstructionSet = supported;
+    }
+
+    switch (itsInstructionSet) {
+    case AVX2:
+      itsKernel = avx2Kernel;
+      break;
+    case SSE2:
+      itsKernel = sse2Kernel;
+      break;
+    default:
+      itsKernel = scalarKernel;
+      break;
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void BFRawKernels::summary (std::ostream &os)
+  {
+    os << "[BFRawKernels] Summary of internal parameters." << endl;
+    os << "-- Products               = " << productNames(itsProducts)    << endl;
+    os << "-- nof. products          = " << itsNofProducts               << endl;
+    os << "-- Down-sampling factor   = " << itsFactor                    << endl;
+    os << "-- Instruction set        = " << name(itsInstructionSet)      << endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                    sumGroups
+
+  /*!
+    Eight groups are summed at a time, so that the additions are not limited by
+    the latency of a single chain; within each group the samples are still added
+    one after another, in the order of the input.
+
+    \param product     -- [nofGroups*factor] Per-sample values of a product.
+    \param nofGroups   -- Number of output samples.
+    \param factor      -- Number of input samples per output sample.
+    \param nofProducts -- Number of values per output sample, i.e. the distance
+           between two consecutive output values of the product.
+    \retval output     -- [nofGroups,nofProducts] Output samples.
+  */
+  static void sumGroups (float const *product,
+			 unsigned int const &nofGroups,
+			 unsigned int const &factor,
+			 unsigned int const &nofProducts,
+			 float *output)
+  {
+    unsigned int group (0);
+
+    for (; group+8<=nofGroups; group+=8) {
+      float const *values = product+group*factor;
+      float sum[8]        = {0, 0, 0, 0, 0, 0, 0, 0};
+      for (unsigned int n=0; n<factor; ++n) {
+	for (unsigned int k=0; k<8; ++k) {
+	  sum[k] += values[k*factor+n];
+	}
+      }
+      for (unsigned int k=0; k<8; ++k) {
+	output[(group+k)*nofProducts] = sum[k];
+      }
+    }
+
+    for (; group<nofGroups; ++group) {
+      float const *values = product+group*factor;
+      float sum (0);
+      for (unsigned int n=0; n<factor; ++n) {
+	sum += values[n];
+      }
+      output[group*nofProducts] = sum;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      process
+
+  /*!
+    The input is processed in blocks of up to \c BFRAWKERNELS_BLOCKSIZE samples:
+    the per-sample products of a block are computed by the kernel of the
+    selected instruction set, after which they are summed over groups of
+    factor() samples in the order of the input, just as done by the original
+    loop. Blocks hold complete groups, unless factor() exceeds the block size.
+
+    \param input      -- [nofSamples] Input samples.
+    \param nofSamples -- Number of input samples; trailing samples not filling
+           a complete output sample are ignored.
+    \retval output    -- [nofSamples/factor,nofProducts] Output samples, each
+            holding the selected products in the order I, Q, U, V.
+  */
+  void BFRawKernels::process (BFRawFormat::Sample const *input,
+			      unsigned int const &nofSamples,
+			      float *output) const
+  {
+    float buffer[4][BFRAWKERNELS_BLOCKSIZE];
+    float *product[4];
+    float *selected[4];
+    float sum[4]           = {0, 0, 0, 0};
+    unsigned int nofUsed   = (nofSamples/itsFactor)*itsFactor;
+    unsigned int blocksize = BFRAWKERNELS_BLOCKSIZE;
+    unsigned int filled    = 0;
+
+    if (itsFactor <= BFRAWKERNELS_BLOCKSIZE) {
+      blocksize = (BFRAWKERNELS_BLOCKSIZE/itsFactor)*itsFactor;
+    }
+
+    for (unsigned int p=0, k=0; p<4; ++p) {
+      product[p] = (itsProducts & (1u<<p)) ? buffer[p] : NULL;
+      if (product[p] != NULL) {
+	selected[k++] = product[p];
+      }
+    }
+
+    for (unsigned int start=0, nofBlock=0; start<nofUsed; start+=nofBlock) {
+      nofBlock = nofUsed-start < blocksize ? nofUsed-start : blocksize;
+      if (itsFactor > BFRAWKERNELS_BLOCKSIZE && nofBlock > itsFactor-filled) {
+	nofBlock = itsFactor-filled;
+      }
+
+      itsKernel (input+start, nofBlock, product[0], product[1], product[2], product[3]);
+
+      if (itsFactor == 1 && itsNofProducts == 1) {
+	memcpy (output, selected[0], nofBlock*sizeof(float));
+	output += nofBlock;
+      }
+      else if (itsFactor <= BFRAWKERNELS_BLOCKSIZE) {
+	unsigned int nofGroups = nofBlock/itsFactor;
+	for (unsigned int p=0; p<itsNofProducts; ++p) {
+	  sumGroups (selected[p], nofGroups, itsFactor, itsNofProducts, output+p);
+	}
+	output += nofGroups*itsNofProducts;
+      }
+      else {
+	/* Groups spanning several blocks */
+	for (unsigned int p=0; p<itsNofProducts; ++p) {
+	  float value = sum[p];
+	  for (unsigned int n=0; n<nofBlock; ++n) {
+	    value += selected[p][n];
+	  }
+	  sum[p] = value;
+	}
+	filled += nofBlock;
+	if (filled == itsFactor) {
+	  for (unsigned int p=0; p<itsNofProducts; ++p) {
+	    *output++ = sum[p];
+	    sum[p]    = 0;
+	  }
+	  filled = 0;
+	}
+      }
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Static methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                      supportedInstructionSet
+
+  /*!
+    \return instructionSet -- Most capable instruction set for which kernels
+            are available and which is supported by the processor.
+  */
+  BFRawKernels::InstructionSet BFRawKernels::supportedInstructionSet ()
+  {
+#ifdef BFRAWKERNELS_X86
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2")) {
+      return AVX2;
+    }
+    if (__builtin_cpu_supports ("sse2")) {
+      return SSE2;
+    }
+#endif
+    return Scalar;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         name
+
+  /*!
+    \param instructionSet -- Instruction set.
+    \return name          -- Name of the instruction set.
+  */
+  std::string BFRawKernels::name (InstructionSet const &instructionSet)
+  {
+    switch (instructionSet) {
+    case Scalar:
+      return "Scalar";
+    case SSE2:
+      return "SSE2";
+    case AVX2:
+      return "AVX2";
+    default:
+      return "Best";
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     products
+
+  /*!
+    \param names -- Names of the Stokes parameters, e.g. "I" or "IQUV".
+
+    \return products -- Combination of BFRawKernels::Product; returns 0 if the
+            string is empty or contains anything but the letters I, Q, U, V.
+  */
+  unsigned int BFRawKernels::products (std::string const &names)
+  {
+    unsigned int products (0);
+
+    for (unsigned int n=0; n<names.size(); ++n) {
+      switch (names[n]) {
+      case 'I':
+      case 'i':
+	products |= StokesI;
+	break;
+      case 'Q':
+      case 'q':
+	products |= StokesQ;
+	break;
+      case 'U':
+      case 'u':
+	products |= StokesU;
+	break;
+      case 'V':
+      case 'v':
+	products |= StokesV;
+	break;
+      default:
+	return 0;
+      }
+    }
+
+    return products;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 productNames
+
+  /*!
+    \param products -- Combination of BFRawKernels::Product.
+    \return names   -- Names of the selected Stokes parameters, e.g. "IQUV".
+  */
+  std::string BFRawKernels::productNames (unsigned int const &products)
+  {
+    std::string names;
+
+    if (products & StokesI) names += "I";
+    if (products & StokesQ) names += "Q";
+    if (products & StokesU) names += "U";
+    if (products & StokesV) names += "V";
+
+    return names;
+  }
+
+  // ============================================================================
+  //
+  //  Kernels
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                 scalarKernel
+
+  /*!
+    \param input      -- [nofSamples] Input samples.
+    \param nofSamples -- Number of input samples.
+    \retval I         -- [nofSamples] Stokes I per sample; skipped if NULL.
+    \retval Q         -- [nofSamples] Stokes Q per sample; skipped if NULL.
+    \retval U         -- [nofSamples] Stokes U per sample; skipped if NULL.
+    \retval V         -- [nofSamples] Stokes V per sample; skipped if NULL.
+  */
+  void BFRawKernels::scalarKernel (BFRawFormat::Sample const *input,
+				   unsigned int const &nofSamples,
+				   float *I,
+				   float *Q,
+				   float *U,
+				   float *V)
+  {
+    for (unsigned int n=0; n<nofSamples; ++n) {
+      int32_t xr = real (input[n].xx);
+      int32_t xi = imag (input[n].xx);
+      int32_t yr = real (input[n].yy);
+      int32_t yi = imag (input[n].yy);
+      /* Up to 2^31, which fits into an unsigned 32-bit integer */
+      uint32_t xx = uint32_t(xr*xr) + uint32_t(xi*xi);
+      uint32_t yy = uint32_t(yr*yr) + uint32_t(yi*yi);
+
+      if (I) I[n] = float(xx) + float(yy);
+      if (Q) Q[n] = float(xx) - float(yy);
+      if (U) U[n] = 2.0f*(float(xr)*float(yr) + float(xi)*float(yi));
+      if (V) V[n] = 2.0f*(float(xi)*float(yr) - float(xr)*float(yi));
+    }
+  }
+
+#ifdef BFRAWKERNELS_X86
+
+  //! Convert unsigned 32-bit integers to float
+  __attribute__ ((target ("sse2")))
+  static inline __m128 sse2ToFloat (__m128i const &value)
+  {
+    __m128 result = _mm_cvtepi32_ps (value);
+    __m128 offset = _mm_and_ps (_mm_castsi128_ps (_mm_srai_epi32 (value, 31)),
+				_mm_set1_ps (4294967296.0f));
+    return _mm_add_ps (result, offset);
+  }
+
+  //! Sign-extend four 16-bit integers and convert them to float
+  __attribute__ ((target ("sse2")))
+  static inline __m128 sse2ToFloat (__m128i const &value,
+				    bool const &upper)
+  {
+    __m128i widened = upper ? _mm_unpackhi_epi16 (value, value)
+      : _mm_unpacklo_epi16 (value, value);
+    return _mm_cvtepi32_ps (_mm_srai_epi32 (widened, 16));
+  }
+
+  //! Convert unsigned 32-bit integers to float
+  __attribute__ ((target ("avx2")))
+  static inline __m256 avx2ToFloat (__m256i const &value)
+  {
+    __m256 result = _mm256_cvtepi32_ps (value);
+    __m256 offset = _mm256_and_ps (_mm256_castsi256_ps (_mm256_srai_epi32 (value, 31)),
+				   _mm256_set1_ps (4294967296.0f));
+    return _mm256_add_ps (result, offset);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   sse2Kernel
+
+  /*!
+    Four samples are processed per iteration: \f$|X|^2\f$ and \f$|Y|^2\f$ of two
+    samples are obtained from a single multiply-add of 16-bit integers, the
+    components of the voltages are transposed for \f$U\f$ and \f$V\f$.
+
+    \param input      -- [nofSamples] Input samples.
+    \param nofSamples -- Number of input samples.
+    \retval I         -- [nofSamples] Stokes I per sample; skipped if NULL.
+    \retval Q         -- [nofSamples] Stokes Q per sample; skipped if NULL.
+    \retval U         -- [nofSamples] Stokes U per sample; skipped if NULL.
+    \retval V         -- [nofSamples] Stokes V per sample; skipped if NULL.
+  */
+  __attribute__ ((target ("sse2")))
+  void BFRawKernels::sse2Kernel (BFRawFormat::Sample const *input,
+				 unsigned int const &nofSamples,
+				 float *I,
+				 float *Q,
+				 float *U,
+				 float *V)
+  {
+    unsigned int n (0);
+    __m128 two = _mm_set1_ps (2.0f);
+
+    for (; n+4<=nofSamples; n+=4) {
+      __m128i v0 = _mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n));
+      __m128i v1 = _mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n+2));
+
+      if (I || Q) {
+	/* [XX0,YY0,XX1,YY1] and [XX2,YY2,XX3,YY3] */
+	__m128 p0 = sse2ToFloat (_mm_madd_epi16 (v0, v0));
+	__m128 p1 = sse2ToFloat (_mm_madd_epi16 (v1, v1));
+	__m128 xx = _mm_shuffle_ps (p0, p1, _MM_SHUFFLE(2,0,2,0));
+	__m128 yy = _mm_shuffle_ps (p0, p1, _MM_SHUFFLE(3,1,3,1));
+	if (I) _mm_storeu_ps (I+n, _mm_add_ps (xx, yy));
+	if (Q) _mm_storeu_ps (Q+n, _mm_sub_ps (xx, yy));
+      }
+
+      if (U || V) {
+	/* One sample [xr,xi,yr,yi] per register, transposed into components */
+	__m128 xr = sse2ToFloat (v0, false);
+	__m128 xi = sse2ToFloat (v0, true);
+	__m128 yr = sse2ToFloat (v1, false);
+	__m128 yi = sse2ToFloat (v1, true);
+	_MM_TRANSPOSE4_PS (xr, xi, yr, yi);
+	if (U) {
+	  _mm_storeu_ps (U+n, _mm_mul_ps (two, _mm_add_ps (_mm_mul_ps (xr, yr),
+							   _mm_mul_ps (xi, yi))));
+	}
+	if (V) {
+	  _mm_storeu_ps (V+n, _mm_mul_ps (two, _mm_sub_ps (_mm_mul_ps (xi, yr),
+							   _mm_mul_ps (xr, yi))));
+	}
+      }
+    }
+
+    if (n < nofSamples) {
+      scalarKernel (input+n,
+		    nofSamples-n,
+		    I ? I+n : NULL,
+		    Q ? Q+n : NULL,
+		    U ? U+n : NULL,
+		    V ? V+n : NULL);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   avx2Kernel
+
+  /*!
+    Eight samples are processed per iteration, along the lines of sse2Kernel();
+    as the 256-bit shuffles operate within 128-bit lanes, the results are put
+    back into the order of the samples by a final permutation.
+
+    \param input      -- [nofSamples] Input samples.
+    \param nofSamples -- Number of input samples.
+    \retval I         -- [nofSamples] Stokes I per sample; skipped if NULL.
+    \retval Q         -- [nofSamples] Stokes Q per sample; skipped if NULL.
+    \retval U         -- [nofSamples] Stokes U per sample; skipped if NULL.
+    \retval V         -- [nofSamples] Stokes V per sample; skipped if NULL.
+  */
+  __attribute__ ((target ("avx2")))
+  void BFRawKernels::avx2Kernel (BFRawFormat::Sample const *input,
+				 unsigned int const &nofSamples,
+				 float *I,
+				 float *Q,
+				 float *U,
+				 float *V)
+  {
+    unsigned int n (0);
+    __m256 two          = _mm256_set1_ps (2.0f);
+    __m256i orderPowers = _mm256_setr_epi32 (0, 1, 4, 5, 2, 3, 6, 7);
+    __m256i orderCross  = _mm256_setr_epi32 (0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (; n+8<=nofSamples; n+=8) {
+      if (I || Q) {
+	__m256i v0 = _mm256_loadu_si256 (reinterpret_cast<__m256i const*>(input+n));
+	__m256i v1 = _mm256_loadu_si256 (reinterpret_cast<__m256i const*>(input+n+4));
+	/* [XX0,YY0,XX1,YY1|XX2,YY2,XX3,YY3] and likewise for samples 4-7 */
+	__m256 p0 = avx2ToFloat (_mm256_madd_epi16 (v0, v0));
+	__m256 p1 = avx2ToFloat (_mm256_madd_epi16 (v1, v1));
+	/* Samples in the order [0,1,4,5|2,3,6,7] */
+	__m256 xx = _mm256_shuffle_ps (p0, p1, _MM_SHUFFLE(2,0,2,0));
+	__m256 yy = _mm256_shuffle_ps (p0, p1, _MM_SHUFFLE(3,1,3,1));
+	if (I) {
+	  _mm256_storeu_ps (I+n, _mm256_permutevar8x32_ps (_mm256_add_ps (xx, yy),
+							   orderPowers));
+	}
+	if (Q) {
+	  _mm256_storeu_ps (Q+n, _mm256_permutevar8x32_ps (_mm256_sub_ps (xx, yy),
+							   orderPowers));
+	}
+      }
+
+      if (U || V) {
+	/* Two samples [xr,xi,yr,yi|xr,xi,yr,yi] per register */
+	__m256 r0 = _mm256_cvtepi32_ps (_mm256_cvtepi16_epi32 (_mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n))));
+	__m256 r1 = _mm256_cvtepi32_ps (_mm256_cvtepi16_epi32 (_mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n+2))));
+	__m256 r2 = _mm256_cvtepi32_ps (_mm256_cvtepi16_epi32 (_mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n+4))));
+	__m256 r3 = _mm256_cvtepi32_ps (_mm256_cvtepi16_epi32 (_mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n+6))));
+	__m256 t0 = _mm256_unpacklo_ps (r0, r1);
+	__m256 t1 = _mm256_unpackhi_ps (r0, r1);
+	__m256 t2 = _mm256_unpacklo_ps (r2, r3);
+	__m256 t3 = _mm256_unpackhi_ps (r2, r3);
+	/* Samples in the order [0,2,4,6|1,3,5,7] */
+	__m256 xr = _mm256_shuffle_ps (t0, t2, _MM_SHUFFLE(1,0,1,0));
+	__m256 xi = _mm256_shuffle_ps (t0, t2, _MM_SHUFFLE(3,2,3,2));
+	__m256 yr = _mm256_shuffle_ps (t1, t3, _MM_SHUFFLE(1,0,1,0));
+	__m256 yi = _mm256_shuffle_ps (t1, t3, _MM_SHUFFLE(3,2,3,2));
+	if (U) {
+	  __m256 u = _mm256_mul_ps (two, _mm256_add_ps (_mm256_mul_ps (xr, yr),
+							_mm256_mul_ps (xi, yi)));
+	  _mm256_storeu_ps (U+n, _mm256_permutevar8x32_ps (u, orderCross));
+	}
+	if (V) {
+	  __m256 v = _mm256_mul_ps (two, _mm256_sub_ps (_mm256_mul_ps (xi, yr),
+							_mm256_mul_ps (xr, yi)));
+	  _mm256_storeu_ps (V+n, _mm256_permutevar8x32_ps (v, orderCross));
+	}
+      }
+    }
+
+    if (n < nofSamples) {
+      sse2Kernel (input+n,
+		  nofSamples-n,
+		  I ? I+n : NULL,
+		  Q ? Q+n : NULL,
+		  U ? U+n : NULL,
+		  V ? V+n : NULL);
+    }
+  }
+
+#else
+
+  //_____________________________________________________________________________
+  //                                                                   sse2Kernel
+
+  /*!
+    Not available on this platform; never selected by the constructor.
+  */
+  void BFRawKernels::sse2Kernel (BFRawFormat::Sample const *input,
+				 unsigned int const &nofSamples,
+				 float *I,
+				 float *Q,
+				 float *U,
+				 float *V)
+  {
+    scalarKernel (input, nofSamples, I, Q, U, V);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   avx2Kernel
+
+  /*!
+    Not available on this platform; never selected by the constructor.
+  */
+  void BFRawKernels::avx2Kernel (BFRawFormat::Sample const *input,
+				 unsigned int const &nofSamples,
+				 float *I,
+				 float *Q,
+				 float *U,
+				 float *V)
+  {
+    scalarKernel (input, nofSamples, I, Q, U, V);
+  }
+
+#endif
+
+} // Namespace DAL -- end
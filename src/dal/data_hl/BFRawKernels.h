@@ -0,0 +1,241 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef BFRAWKERNELS_H
+#define BFRAWKERNELS_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+
+#include <data_hl/BFRawFormat.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class BFRawKernels
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Stokes parameters and down-sampling of raw beam-formed samples
+
+    \author agent
+
+    \date 2026/10/17
+
+    \test tBFRawKernels.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>BFRawFormat -- defines the dual-polarization sample
+      <tt>BFRawFormat::Sample</tt>, holding the complex 16-bit voltages of the
+      X and Y dipoles.
+      <li>Bf2h5Calculator -- computes the output of \t bf2h5 with these kernels.
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    For every input sample the Stokes parameters of the linearly polarized
+    dipoles are
+    \f[
+      I = |X|^2 + |Y|^2 , \quad Q = |X|^2 - |Y|^2 , \quad
+      U = 2\,\mathrm{Re}(X Y^*) , \quad V = 2\,\mathrm{Im}(X Y^*)
+    \f]
+    and the down-sampled output is the sum over <tt>factor</tt> consecutive
+    samples. The products to compute are selected as a combination of the
+    flags in BFRawKernels::Product; the output holds one record per output
+    sample, with the selected products in the order I, Q, U, V.
+
+    \f$|X|^2\f$ and \f$|Y|^2\f$ are computed exactly as 32-bit integers, so
+    that the total intensity agrees bit by bit with the scalar loop previously
+    used by \t bf2h5; \f$U\f$ and \f$V\f$ are computed in single precision.
+
+    The kernels are implemented for three instruction sets -- plain C++, SSE2
+    and AVX2 -- which deliver identical results; by default the most capable
+    one supported by the processor is selected at run time.
+
+    <h3>Example(s)</h3>
+
+    \code
+    DAL::BFRawKernels kernels (DAL::BFRawKernels::StokesI | DAL::BFRawKernels::StokesV,
+                               16);
+    std::vector<float> output (kernels.nofOutputValues(nofSamples));
+
+    kernels.process (samples, nofSamples, &output[0]);
+    \endcode
+  */
+  class BFRawKernels {
+
+  public:
+
+    //! Products which can be computed
+    enum Product {
+      //! Total intensity
+      StokesI = 1,
+      //! Difference of the intensities of the X and Y dipole
+      StokesQ = 2,
+      //! Real part of the cross-correlation of X and Y
+      StokesU = 4,
+      //! Imaginary part of the cross-correlation of X and Y
+      StokesV = 8,
+      //! All four Stokes parameters
+      StokesIQUV = 15
+    };
+
+    //! Instruction sets for which the kernels are implemented
+    enum InstructionSet {
+      //! Plain C++, available on all platforms
+      Scalar,
+      //! 128-bit SSE2 instructions
+      SSE2,
+      //! 256-bit AVX2 instructions
+      AVX2,
+      //! Most capable instruction set supported by the processor
+      Best
+    };
+
+  private:
+
+    //! Computes the per-sample products of a block of input samples
+    typedef void (*SampleKernel) (BFRawFormat::Sample const *input,
+				  unsigned int const &nofSamples,
+				  float *I,
+				  float *Q,
+				  float *U,
+				  float *V);
+
+    //! Selected products, combination of BFRawKernels::Product
+    unsigned int itsProducts;
+    //! Number of selected products
+    unsigned int itsNofProducts;
+    //! Number of input samples summed into one output sample
+    unsigned int itsFactor;
+    //! Instruction set in use
+    InstructionSet itsInstructionSet;
+    //! Kernel for the instruction set in use
+    SampleKernel itsKernel;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Argumented constructor
+    BFRawKernels (unsigned int const &products=StokesI,
+		  unsigned int const &factor=1,
+		  InstructionSet const &instructionSet=Best);
+
+    // === Parameter access =====================================================
+
+    //! Get the selected products, combination of BFRawKernels::Product
+    inline unsigned int products () const {
+      return itsProducts;
+    }
+
+    //! Get the number of selected products, i.e. the values per output sample
+    inline unsigned int nofProducts () const {
+      return itsNofProducts;
+    }
+
+    //! Get the number of input samples summed into one output sample
+    inline unsigned int factor () const {
+      return itsFactor;
+    }
+
+    //! Get the instruction set in use
+    inline InstructionSet instructionSet () const {
+      return itsInstructionSet;
+    }
+
+    //! Number of output values for a block of <tt>nofSamples</tt> input samples
+    inline unsigned int nofOutputValues (unsigned int const &nofSamples) const {
+      return (nofSamples/itsFactor)*itsNofProducts;
+    }
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, BFRawKernels.
+    */
+    inline std::string className () const {
+      return "BFRawKernels";
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    // === Methods ==============================================================
+
+    //! Compute the selected products for a block of input samples
+    void process (BFRawFormat::Sample const *input,
+		  unsigned int const &nofSamples,
+		  float *output) const;
+
+    // === Static methods =======================================================
+
+    //! Most capable instruction set supported by the processor
+    static InstructionSet supportedInstructionSet ();
+
+    //! Get the name of an instruction set
+    static std::string name (InstructionSet const &instructionSet);
+
+    //! Get the products listed in a string, e.g. "IQUV"
+    static unsigned int products (std::string const &names);
+
+    //! Get the names of the products, e.g. "IQUV"
+    static std::string productNames (unsigned int const &products);
+
+  private:
+
+    //! Per-sample products in plain C++
+    static void scalarKernel (BFRawFormat::Sample const *input,
+			      unsigned int const &nofSamples,
+			      float *I,
+			      float *Q,
+			      float *U,
+			      float *V);
+
+    //! Per-sample products using SSE2
+    static void sse2Kernel (BFRawFormat::Sample const *input,
+			    unsigned int const &nofSamples,
+			    float *I,
+			    float *Q,
+			    float *U,
+			    float *V);
+
+    //! Per-sample products using AVX2
+    static void avx2Kernel (BFRawFormat::Sample const *input,
+			    unsigned int const &nofSamples,
+			    float *I,
+			    float *Q,
+			    float *U,
+			    float *V);
+
+  }; // Class BFRawKernels -- end
+
+} // Namespace DAL -- end
+
+#endif /* BFRAWKERNELS_H */
@@ -200,7 +200,7 @@ namespace DAL { // Namespace DAL -- begin
 		      std::vector<int> const &block)
       {
 	bool status      = true;
-	std::string name = getName (index);
+	std::string name = BF_StokesDataset::getName (index);
 	std::map<std::string,BF_StokesDataset>::iterator it;
 
 	/*____________________________________________________________
@@ -0,0 +1,583 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "BF_Dedispersion.h"
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                              BF_Dedispersion
+
+  /*!
+    \param frequencies -- [channel] Frequencies of the channels [Hz], in the
+           order of the frequency axis of the data.
+    \param sampleTime  -- Time resolution of the data [s].
+    \param trials      -- Trial dispersion measures [pc/cm^3]; negative values
+           are treated as zero.
+    \param nofThreads  -- Number of threads over which the trials are
+           distributed.
+  */
+  BF_Dedispersion::BF_Dedispersion (std::vector<double> const &frequencies,
+				    double const &sampleTime,
+				    std::vector<double> const &trials,
+				    unsigned int const &nofThreads)
+    : itsFrequencies (frequencies),
+      itsSampleTime (sampleTime),
+      itsTrials (trials),
+      itsNofThreads (nofThreads>0 ? nofThreads : 1),
+      itsMaxDelay (0),
+      itsStride (0),
+      itsFill (0),
+      itsNofSamplesIn (0),
+      itsNofSamplesOut (0)
+  {
+    setDelays ();
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                           referenceFrequency
+
+  /*!
+    \return frequency -- The highest channel frequency [Hz], with respect to
+            which the delays are computed.
+  */
+  double BF_Dedispersion::referenceFrequency () const
+  {
+    if (itsFrequencies.empty()) {
+      return 0;
+    }
+    return *std::max_element (itsFrequencies.begin(), itsFrequencies.end());
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void BF_Dedispersion::summary (std::ostream &os)
+  {
+    os << "[BF_Dedispersion] Summary of internal parameters." << std::endl;
+    os << "-- nof. channels          = " << nofChannels()        << std::endl;
+    os << "-- Reference frequency    = " << referenceFrequency() << std::endl;
+    os << "-- Sample time            = " << itsSampleTime        << std::endl;
+    os << "-- nof. trials            = " << nofTrials()          << std::endl;
+    if (!itsTrials.empty()) {
+      os << "-- Trial DM range         = [" << itsTrials.front()
+	 << " .. " << itsTrials.back() << "]" << std::endl;
+    }
+    os << "-- Max. delay [samples]   = " << itsMaxDelay          << std::endl;
+    os << "-- nof. threads           = " << itsNofThreads        << std::endl;
+    os << "-- nof. samples in        = " << itsNofSamplesIn      << std::endl;
+    os << "-- nof. samples out       = " << itsNofSamplesOut     << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                      process
+
+  /*!
+    \param data       -- [time,channel] Block of input data, following the
+           samples of the previous call.
+    \param nofSamples -- Number of samples in the block.
+    \retval plane     -- [time,trial] The part of the DM-time plane which could
+           be completed with this block.
+
+    \return nofSamples -- Number of samples in \e plane; this is zero as long as
+            no more than maxDelay() samples have been received in total.
+  */
+  unsigned int BF_Dedispersion::process (float const *data,
+					 unsigned int const &nofSamples,
+					 std::vector<float> &plane)
+  {
+    unsigned int nofChannels = itsFrequencies.size();
+    unsigned int nofTrials   = itsTrials.size();
+
+    plane.clear();
+
+    if (nofChannels == 0 || nofTrials == 0 || itsSampleTime <= 0) {
+      std::cerr << "[BF_Dedispersion::process]"
+		<< " Channels, trials and sample time are not set up!"
+		<< std::endl;
+      return 0;
+    }
+
+    /* Make room for the block in the rolling buffer */
+
+    if (itsFill + nofSamples > itsStride) {
+      unsigned int stride = itsFill + nofSamples;
+      std::vector<float> buffer (size_t(nofChannels)*stride);
+      for (unsigned int c=0; c<nofChannels; ++c) {
+	std::copy (itsBuffer.begin() + size_t(c)*itsStride,
+		   itsBuffer.begin() + size_t(c)*itsStride + itsFill,
+		   buffer.begin() + size_t(c)*stride);
+      }
+      itsBuffer.swap (buffer);
+      itsStride = stride;
+    }
+
+    /* Append the block, transposed to [channel,time] in tiles of rows */
+
+    for (unsigned int t0=0; t0<nofSamples; t0+=64) {
+      unsigned int nt = std::min (64U, nofSamples-t0);
+      for (unsigned int c=0; c<nofChannels; ++c) {
+	float *row      = &itsBuffer[size_t(c)*itsStride + itsFill + t0];
+	float const *in = data + size_t(t0)*nofChannels + c;
+	for (unsigned int t=0; t<nt; ++t) {
+	  row[t] = in[size_t(t)*nofChannels];
+	}
+      }
+    }
+
+    itsFill         += nofSamples;
+    itsNofSamplesIn += nofSamples;
+
+    if (itsFill <= itsMaxDelay) {
+      return 0;
+    }
+
+    /* Compute the DM-time plane, distributing the tiles of trials */
+
+    unsigned int nofOut   = itsFill - itsMaxDelay;
+    unsigned int nofTiles = (nofTrials + BF_DEDISPERSION_TRIAL_TILE - 1) / BF_DEDISPERSION_TRIAL_TILE;
+    unsigned int nofThreads = std::min (itsNofThreads, nofTiles);
+
+    plane.resize (size_t(nofOut)*nofTrials);
+
+    std::vector<TrialRange> ranges (nofThreads);
+    std::vector<pthread_t> threads (nofThreads);
+    std::vector<bool> started (nofThreads, false);
+
+    for (unsigned int n=0; n<nofThreads; ++n) {
+      ranges[n].This       = this;
+      ranges[n].first      = std::min (nofTrials, (n*nofTiles/nofThreads) * BF_DEDISPERSION_TRIAL_TILE);
+      ranges[n].last       = std::min (nofTrials, ((n+1)*nofTiles/nofThreads) * BF_DEDISPERSION_TRIAL_TILE);
+      ranges[n].nofSamples = nofOut;
+      ranges[n].plane      = &plane[0];
+    }
+    for (unsigned int n=1; n<nofThreads; ++n) {
+      started[n] = pthread_create (&threads[n], NULL, startTrialRange, &ranges[n]) == 0;
+    }
+    /* The calling thread takes the first range, and any not started */
+    for (unsigned int n=0; n<nofThreads; ++n) {
+      if (!started[n]) {
+	dedisperse (ranges[n].first, ranges[n].last, nofOut, &plane[0]);
+      }
+    }
+    for (unsigned int n=1; n<nofThreads; ++n) {
+      if (started[n]) {
+	pthread_join (threads[n], NULL);
+      }
+    }
+
+    /* Keep the last maxDelay() samples for the next block */
+
+    for (unsigned int c=0; c<nofChannels; ++c) {
+      std::vector<float>::iterator row = itsBuffer.begin() + size_t(c)*itsStride;
+      std::copy (row + nofOut, row + itsFill, row);
+    }
+
+    itsFill           = itsMaxDelay;
+    itsNofSamplesOut += nofOut;
+
+    return nofOut;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      process
+
+  /*!
+    \param stokes    -- [time,frequency] Stokes dataset to dedisperse; its
+           frequency axis must match the channels of the engine.
+    \param location  -- Location at which the output dataset is created, e.g.
+           the beam group.
+    \param name      -- Name of the output dataset.
+    \param blocksize -- Number of samples read from \e stokes at a time.
+
+    \return status -- Status of the operation; returns \e false in case an
+            error was encountered.
+
+    The output dataset holds the DM-time plane of shape
+    <tt>[nofSamples-maxDelay(),nofTrials()]</tt>, with the attributes
+    \c DISPERSION_MEASURE, \c SAMPLING_TIME, \c REFERENCE_FREQUENCY and
+    \c NOF_SAMPLES. Any data buffered from a previous call are discarded.
+  */
+  bool BF_Dedispersion::process (BF_StokesDataset &stokes,
+				 hid_t const &location,
+				 std::string const &name,
+				 unsigned int const &blocksize)
+  {
+    bool status              = true;
+    unsigned int nofSamples  = stokes.nofSamples();
+    unsigned int nofChannels = itsFrequencies.size();
+    unsigned int nofTrials   = itsTrials.size();
+    unsigned int nofWritten  = 0;
+
+    if (stokes.nofFrequencies() != nofChannels || blocksize == 0) {
+      std::cerr << "[BF_Dedispersion::process]"
+		<< " Dataset with " << stokes.nofFrequencies()
+		<< " frequencies does not match " << nofChannels
+		<< " channels!" << std::endl;
+      return false;
+    }
+
+    reset ();
+
+    /* Create the output dataset, extended by every block */
+
+    std::vector<hsize_t> shape (2);
+    shape[0] = 0;
+    shape[1] = nofTrials;
+
+    HDF5StoragePolicy policy (DEFAULT_CHUNK_BYTES,
+			      HDF5StoragePolicy::TimeMajor);
+    HDF5Dataset dataset;
+
+    if (!dataset.create (location, name, shape, policy, H5T_NATIVE_FLOAT)) {
+      std::cerr << "[BF_Dedispersion::process]"
+		<< " Failed to create dataset " << name << std::endl;
+      return false;
+    }
+
+    /* Stream the blocks of the Stokes dataset through the engine */
+
+    std::vector<float> data (size_t(blocksize)*nofChannels);
+    std::vector<float> plane;
+    std::vector<int> start (2,0);
+    std::vector<int> block (2);
+
+    for (unsigned int t=0; t<nofSamples; t+=blocksize) {
+      unsigned int nofRead = std::min (blocksize, nofSamples-t);
+
+      start[0] = t;
+      block[0] = nofRead;
+      block[1] = nofChannels;
+      if (!stokes.readData (&data[0], start, block)) {
+	std::cerr << "[BF_Dedispersion::process]"
+		  << " Failed to read samples " << t << " .. " << t+nofRead
+		  << std::endl;
+	status = false;
+	break;
+      }
+
+      unsigned int nofOut = process (&data[0], nofRead, plane);
+      if (nofOut > 0) {
+	start[0] = nofWritten;
+	block[0] = nofOut;
+	block[1] = nofTrials;
+	if (!dataset.writeData (&plane[0], start, block)) {
+	  std::cerr << "[BF_Dedispersion::process]"
+		    << " Failed to write samples " << nofWritten << " .. "
+		    << nofWritten+nofOut << std::endl;
+	  status = false;
+	  break;
+	}
+	nofWritten += nofOut;
+      }
+    }
+
+    /* Describe the axes of the DM-time plane */
+
+    hid_t id = dataset.objectID();
+    HDF5Attribute::write (id, "DISPERSION_MEASURE",       itsTrials);
+    HDF5Attribute::write (id, "DISPERSION_MEASURE_UNIT",  std::string("pc/cm^3"));
+    HDF5Attribute::write (id, "SAMPLING_TIME",            itsSampleTime);
+    HDF5Attribute::write (id, "SAMPLING_TIME_UNIT",       std::string("s"));
+    HDF5Attribute::write (id, "REFERENCE_FREQUENCY",      referenceFrequency());
+    HDF5Attribute::write (id, "REFERENCE_FREQUENCY_UNIT", std::string("Hz"));
+    HDF5Attribute::write (id, "NOF_SAMPLES",              nofWritten);
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        reset
+
+  void BF_Dedispersion::reset ()
+  {
+    itsFill          = 0;
+    itsNofSamplesIn  = 0;
+    itsNofSamplesOut = 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    setDelays
+
+  void BF_Dedispersion::setDelays ()
+  {
+    unsigned int nofChannels = itsFrequencies.size();
+    unsigned int nofTrials   = itsTrials.size();
+    double reference         = referenceFrequency();
+
+    itsDelays.assign (size_t(nofChannels)*nofTrials, 0);
+    itsMaxDelay = 0;
+
+    if (itsSampleTime <= 0) {
+      std::cerr << "[BF_Dedispersion::setDelays]"
+		<< " Invalid sample time " << itsSampleTime << std::endl;
+      return;
+    }
+
+    for (unsigned int c=0; c<nofChannels; ++c) {
+      if (itsFrequencies[c] <= 0) {
+	std::cerr << "[BF_Dedispersion::setDelays]"
+		  << " Invalid frequency " << itsFrequencies[c]
+		  << " of channel " << c << std::endl;
+	continue;
+      }
+      for (unsigned int d=0; d<nofTrials; ++d) {
+	double delay = dispersionDelay (std::max (itsTrials[d], 0.0),
+					itsFrequencies[c],
+					reference) / itsSampleTime;
+	unsigned int samples = static_cast<unsigned int>(std::floor (delay + 0.5));
+	itsDelays[size_t(c)*nofTrials+d] = samples;
+	itsMaxDelay = std::max (itsMaxDelay, samples);
+      }
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   dedisperse
+
+  /*!
+    \param first      -- First trial to compute.
+    \param last       -- One past the last trial to compute.
+    \param nofSamples -- Number of output samples.
+    \retval plane     -- [time,trial] DM-time plane, of which the columns
+           <tt>[first,last)</tt> are set.
+  */
+  void BF_Dedispersion::dedisperse (unsigned int const &first,
+				    unsigned int const &last,
+				    unsigned int const &nofSamples,
+				    float *plane)
+  {
+    unsigned int nofChannels = itsFrequencies.size();
+    unsigned int nofTrials   = itsTrials.size();
+    float sum[BF_DEDISPERSION_TRIAL_TILE*BF_DEDISPERSION_TIME_TILE];
+
+    for (unsigned int t0=0; t0<nofSamples; t0+=BF_DEDISPERSION_TIME_TILE) {
+      unsigned int nt = std::min (nofSamples-t0, (unsigned int)BF_DEDISPERSION_TIME_TILE);
+
+      for (unsigned int d0=first; d0<last; d0+=BF_DEDISPERSION_TRIAL_TILE) {
+	unsigned int nd = std::min (last-d0, (unsigned int)BF_DEDISPERSION_TRIAL_TILE);
+
+	std::fill (sum, sum + nd*BF_DEDISPERSION_TIME_TILE, 0.0f);
+
+	for (unsigned int c=0; c<nofChannels; ++c) {
+	  float const *row            = &itsBuffer[size_t(c)*itsStride + t0];
+	  unsigned int const *delays  = &itsDelays[size_t(c)*nofTrials + d0];
+	  for (unsigned int d=0; d<nd; ++d) {
+	    float const *in = row + delays[d];
+	    float *out      = sum + d*BF_DEDISPERSION_TIME_TILE;
+	    for (unsigned int t=0; t<nt; ++t) {
+	      out[t] += in[t];
+	    }
+	  }
+	}
+
+	for (unsigned int t=0; t<nt; ++t) {
+	  float *out = plane + size_t(t0+t)*nofTrials + d0;
+	  for (unsigned int d=0; d<nd; ++d) {
+	    out[d] = sum[d*BF_DEDISPERSION_TIME_TILE+t];
+	  }
+	}
+      }
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Static methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                              dispersionDelay
+
+  /*!
+    \param dm        -- Dispersion measure [pc/cm^3].
+    \param frequency -- Frequency [Hz].
+    \param reference -- Reference frequency [Hz].
+
+    \return delay -- Arrival time at \e frequency relative to the arrival time
+            at \e reference [s].
+  */
+  double BF_Dedispersion::dispersionDelay (double const &dm,
+					   double const &frequency,
+					   double const &reference)
+  {
+    double f   = frequency * 1e-6;
+    double ref = reference * 1e-6;
+
+    return 4.148808e3 * dm * (1.0/(f*f) - 1.0/(ref*ref));
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       trials
+
+  /*!
+    \param min       -- Smallest dispersion measure [pc/cm^3].
+    \param max       -- Largest dispersion measure [pc/cm^3].
+    \param nofTrials -- Number of trials.
+
+    \return trials -- \e nofTrials equidistant values from \e min to \e max.
+  */
+  std::vector<double> BF_Dedispersion::trials (double const &min,
+					       double const &max,
+					       unsigned int const &nofTrials)
+  {
+    std::vector<double> dm (nofTrials, min);
+
+    for (unsigned int n=1; n<nofTrials; ++n) {
+      dm[n] = min + n*(max-min)/(nofTrials-1);
+    }
+
+    return dm;
+  }
+
+  //_____________________________________________________________________________
+  //                                                           channelFrequencies
+
+  /*!
+    \param beamGroup    -- Identifier of the beam group holding the dataset.
+    \param stokes       -- Stokes dataset within the beam group.
+    \retval frequencies -- [channel] Frequencies of the channels along the
+            frequency axis of the dataset [Hz].
+
+    \return status -- Status of the operation; returns \e false in case an
+            error was encountered.
+
+    The beam group records the center frequencies of the subbands in the
+    attribute \c CENTER_FREQUENCY. If the subbands are split into channels
+    (attribute \c NOF_CHANNELS of the dataset), the width of a subband is
+    taken as the spacing of the first two subbands, and the channels are
+    centered within their subband.
+  */
+  bool BF_Dedispersion::channelFrequencies (hid_t const &beamGroup,
+					    BF_StokesDataset &stokes,
+					    std::vector<double> &frequencies)
+  {
+    std::vector<double> centers;
+    std::vector<double> channels;
+    unsigned int nofFrequencies = stokes.nofFrequencies();
+
+    frequencies.clear();
+
+    if (!readAttribute (beamGroup, "CENTER_FREQUENCY", centers) || centers.empty()) {
+      std::cerr << "[BF_Dedispersion::channelFrequencies]"
+		<< " No subband frequencies attached to the beam group!"
+		<< std::endl;
+      return false;
+    }
+
+    if (!readAttribute (stokes.objectID(), "NOF_CHANNELS", channels)) {
+      channels.assign (centers.size(), nofFrequencies/centers.size());
+    }
+
+    if (channels.size() != centers.size()) {
+      std::cerr << "[BF_Dedispersion::channelFrequencies]"
+		<< " Mismatch between " << centers.size() << " subbands and "
+		<< channels.size() << " channel counts!" << std::endl;
+      return false;
+    }
+
+    double width = centers.size()>1 ? std::fabs (centers[1]-centers[0]) : 0;
+
+    for (unsigned int sb=0; sb<centers.size(); ++sb) {
+      unsigned int nofChannels = static_cast<unsigned int>(channels[sb]);
+      if (nofChannels > 1 && width == 0) {
+	std::cerr << "[BF_Dedispersion::channelFrequencies]"
+		  << " Unable to derive the channel width of a single subband!"
+		  << std::endl;
+	frequencies.clear();
+	return false;
+      }
+      for (unsigned int ch=0; ch<nofChannels; ++ch) {
+	frequencies.push_back (centers[sb] + (ch - 0.5*(nofChannels-1)) * width/nofChannels);
+      }
+    }
+
+    if (frequencies.size() != nofFrequencies) {
+      std::cerr << "[BF_Dedispersion::channelFrequencies]"
+		<< " Derived " << frequencies.size() << " channels for a dataset"
+		<< " with " << nofFrequencies << " frequencies!" << std::endl;
+      frequencies.clear();
+      return false;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                readAttribute
+
+  /*!
+    \param location -- Object to which the attribute is attached.
+    \param name     -- Name of the attribute.
+    \retval values  -- Values of the attribute, converted to double.
+
+    \return status -- Returns \e false if the attribute does not exist or
+            cannot be converted.
+  */
+  bool BF_Dedispersion::readAttribute (hid_t const &location,
+				       std::string const &name,
+				       std::vector<double> &values)
+  {
+    if (H5Aexists (location, name.c_str()) <= 0) {
+      return false;
+    }
+
+    hid_t attribute = H5Aopen (location, name.c_str(), H5P_DEFAULT);
+    hid_t dataspace = H5Aget_space (attribute);
+    hssize_t size   = H5Sget_simple_extent_npoints (dataspace);
+    herr_t h5error  = -1;
+
+    if (size > 0) {
+      values.resize (size);
+      h5error = H5Aread (attribute, H5T_NATIVE_DOUBLE, &values[0]);
+    }
+
+    H5Sclose (dataspace);
+    H5Aclose (attribute);
+
+    return h5error >= 0;
+  }
+
+} // Namespace DAL -- end
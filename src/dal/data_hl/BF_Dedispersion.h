@@ -0,0 +1,298 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef BF_DEDISPERSION_H
+#define BF_DEDISPERSION_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include <data_hl/BF_StokesDataset.h>
+
+//! Number of trials in a tile of the DM-time plane
+#define BF_DEDISPERSION_TRIAL_TILE 16
+//! Number of samples in a tile of the DM-time plane
+#define BF_DEDISPERSION_TIME_TILE 256
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class BF_Dedispersion
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Streaming incoherent dedispersion of a Stokes dataset
+
+    \author agent
+
+    \date 2026/10/17
+
+    \test tBF_Dedispersion.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>BF_StokesDataset -- [time,frequency] Stokes dataset of beam-formed
+      data.
+      <li>BF_BeamGroup -- carries the center frequencies of the subbands.
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    A signal of dispersion measure \f$ DM \f$ arrives at frequency \f$ \nu \f$
+    later than at the reference frequency \f$ \nu_{\rm ref} \f$ by
+    \f[
+      \Delta t = k_{DM} \, DM \, \left( \nu^{-2} - \nu_{\rm ref}^{-2} \right)
+    \f]
+    with \f$ k_{DM} = 4.148808 \cdot 10^{3}\,{\rm s\,MHz^2\,pc^{-1}\,cm^{3}}
+    \f$. For each trial DM the channels are shifted by their delay, rounded to
+    full samples, and summed; the reference frequency is the highest channel
+    frequency, so that all delays are positive. Output sample \f$ t \f$ of a
+    trial therefore is
+    \f[
+      P(t,DM) = \sum_{c} S(t + \Delta t_c(DM), c)
+    \f]
+    i.e. it is labelled by the arrival time at the top of the band.
+
+    The data are consumed block by block, see process(). The engine keeps a
+    rolling buffer of the last maxDelay() samples of every channel, so that its
+    memory footprint does not depend on the length of the observation; the
+    first block may be produced once more than maxDelay() samples have been
+    received, and in total <tt>N - maxDelay()</tt> output samples result from
+    \e N input samples.
+
+    The kernel is a brute-force sum, blocked for the caches: the DM-time plane
+    is computed in tiles of #BF_DEDISPERSION_TRIAL_TILE trials by
+    #BF_DEDISPERSION_TIME_TILE samples, whose partial sums stay in the L1 cache
+    while the channels are added one after the other; the samples of a channel
+    are used by all trials of the tile, whose delays differ only a little. The
+    trials are distributed over nofThreads() threads.
+
+    <h3>Example(s)</h3>
+
+    Dedisperse the first Stokes dataset of a beam into the dataset \c DM_TIME
+    of the beam group:
+    \code
+    DAL::BF_BeamGroup beam (location, 0);
+    DAL::BF_StokesDataset stokes (beam.locationID(), "STOKES_0");
+
+    std::vector<double> frequencies;
+    DAL::BF_Dedispersion::channelFrequencies (beam.locationID(),
+                                              stokes,
+                                              frequencies);
+
+    std::vector<double> trials (DAL::BF_Dedispersion::trials (0, 100, 256));
+    DAL::BF_Dedispersion dedispersion (frequencies, sampleTime, trials, 4);
+
+    dedispersion.process (stokes, beam.locationID(), "DM_TIME");
+    \endcode
+  */
+  class BF_Dedispersion {
+
+    //! Arguments of a thread computing a range of trials
+    struct TrialRange {
+      BF_Dedispersion *This;
+      //! First trial to compute
+      unsigned int first;
+      //! One past the last trial to compute
+      unsigned int last;
+      //! Number of output samples
+      unsigned int nofSamples;
+      //! [time,trial] Output DM-time plane
+      float *plane;
+    };
+
+    //! [channel] Frequencies of the channels [Hz]
+    std::vector<double> itsFrequencies;
+    //! Time resolution of the data [s]
+    double itsSampleTime;
+    //! [trial] Dispersion measures [pc/cm^3]
+    std::vector<double> itsTrials;
+    //! Number of threads
+    unsigned int itsNofThreads;
+    //! [channel,trial] Delays [samples]
+    std::vector<unsigned int> itsDelays;
+    //! Largest delay [samples]
+    unsigned int itsMaxDelay;
+    //! [channel,sample] Rolling buffer of the input data
+    std::vector<float> itsBuffer;
+    //! Number of samples per channel the buffer is able to hold
+    unsigned int itsStride;
+    //! Number of samples per channel currently in the buffer
+    unsigned int itsFill;
+    //! Number of input samples processed
+    unsigned long itsNofSamplesIn;
+    //! Number of output samples produced
+    unsigned long itsNofSamplesOut;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Argumented constructor
+    BF_Dedispersion (std::vector<double> const &frequencies,
+		     double const &sampleTime,
+		     std::vector<double> const &trials,
+		     unsigned int const &nofThreads=1);
+
+    // === Parameter access =====================================================
+
+    //! Get the number of frequency channels
+    inline unsigned int nofChannels () const {
+      return itsFrequencies.size();
+    }
+
+    //! Get the frequencies of the channels [Hz]
+    inline std::vector<double> frequencies () const {
+      return itsFrequencies;
+    }
+
+    //! Get the reference frequency, i.e. the highest channel frequency [Hz]
+    double referenceFrequency () const;
+
+    //! Get the time resolution of the data [s]
+    inline double sampleTime () const {
+      return itsSampleTime;
+    }
+
+    //! Get the number of trial dispersion measures
+    inline unsigned int nofTrials () const {
+      return itsTrials.size();
+    }
+
+    //! Get the trial dispersion measures [pc/cm^3]
+    inline std::vector<double> trials () const {
+      return itsTrials;
+    }
+
+    //! Get the number of threads
+    inline unsigned int nofThreads () const {
+      return itsNofThreads;
+    }
+
+    //! Set the number of threads
+    inline void setNofThreads (unsigned int const &nofThreads) {
+      itsNofThreads = nofThreads>0 ? nofThreads : 1;
+    }
+
+    //! Get the delay [samples] of a channel for a trial
+    inline unsigned int delay (unsigned int const &trial,
+			       unsigned int const &channel) const {
+      return itsDelays[channel*itsTrials.size()+trial];
+    }
+
+    //! Get the largest delay [samples], i.e. the length of the rolling buffer
+    inline unsigned int maxDelay () const {
+      return itsMaxDelay;
+    }
+
+    //! Get the number of input samples processed
+    inline unsigned long nofSamplesIn () const {
+      return itsNofSamplesIn;
+    }
+
+    //! Get the number of output samples produced
+    inline unsigned long nofSamplesOut () const {
+      return itsNofSamplesOut;
+    }
+
+    /*!
+      \brief Get the name of the class
+      \return className -- The name of the class, BF_Dedispersion.
+    */
+    inline std::string className () const {
+      return "BF_Dedispersion";
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    // === Methods ==============================================================
+
+    //! Dedisperse the next block of [time,channel] data
+    unsigned int process (float const *data,
+			  unsigned int const &nofSamples,
+			  std::vector<float> &plane);
+
+    //! Dedisperse a Stokes dataset into a new [time,trial] dataset
+    bool process (BF_StokesDataset &stokes,
+		  hid_t const &location,
+		  std::string const &name,
+		  unsigned int const &blocksize=8192);
+
+    //! Discard the buffered data and reset the counters
+    void reset ();
+
+    // === Static methods =======================================================
+
+    //! Get the dispersion delay [s] between a frequency and a reference frequency
+    static double dispersionDelay (double const &dm,
+				   double const &frequency,
+				   double const &reference);
+
+    //! Get a list of equidistant trial dispersion measures
+    static std::vector<double> trials (double const &min,
+				       double const &max,
+				       unsigned int const &nofTrials);
+
+    //! Get the frequencies of the channels of a Stokes dataset in a beam group
+    static bool channelFrequencies (hid_t const &beamGroup,
+				    BF_StokesDataset &stokes,
+				    std::vector<double> &frequencies);
+
+  private:
+
+    //! Compute the delays of all channels and trials
+    void setDelays ();
+
+    //! Entry point of the threads computing a range of trials
+    static void * startTrialRange (void *range)
+    {
+      TrialRange *r = reinterpret_cast<TrialRange *>(range);
+      r->This->dedisperse (r->first, r->last, r->nofSamples, r->plane);
+      return NULL;
+    }
+
+    //! Compute a range of trials of the DM-time plane
+    void dedisperse (unsigned int const &first,
+		     unsigned int const &last,
+		     unsigned int const &nofSamples,
+		     float *plane);
+
+    //! Read an attribute, converted to double
+    static bool readAttribute (hid_t const &location,
+			       std::string const &name,
+			       std::vector<double> &values);
+
+  }; // Class BF_Dedispersion -- end
+
+} // Namespace DAL -- end
+
+#endif /* BF_DEDISPERSION_H */
+
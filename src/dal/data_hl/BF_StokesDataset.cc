@@ -94,6 +94,7 @@ namespace DAL { // Namespace DAL -- begin
   {
     itsName     = getName(index);
     itsDatatype = datatype;
+    itsStoragePolicy.setAccessPattern (HDF5StoragePolicy::TimeMajor);
 
     std::cout << "[BF_StokesDataset(hid_t,string,uint,uint,Stokes::Component,hid_t]"
 	      << std::endl;
@@ -127,6 +128,7 @@ namespace DAL { // Namespace DAL -- begin
   {
     itsName     = getName(index);
     itsDatatype = datatype;
+    itsStoragePolicy.setAccessPattern (HDF5StoragePolicy::TimeMajor);
 
     open (location,
 	  component,
@@ -156,6 +158,7 @@ namespace DAL { // Namespace DAL -- begin
   {
     itsName     = getName(index);
     itsDatatype = datatype;
+    itsStoragePolicy.setAccessPattern (HDF5StoragePolicy::TimeMajor);
 
     open (location,
     	  component,
@@ -183,6 +186,7 @@ namespace DAL { // Namespace DAL -- begin
   {
     itsName     = getName(index);
     itsDatatype = datatype;
+    itsStoragePolicy.setAccessPattern (HDF5StoragePolicy::TimeMajor);
 
     std::vector<unsigned int> nofChannels (1, shape[1]);
 
@@ -344,7 +348,7 @@ namespace DAL { // Namespace DAL -- begin
     if (H5Iis_valid(itsLocation)) {
       std::string stokesComponent;
       unsigned int nofSubbands;
-      unsigned int nofChannels;
+      std::vector<unsigned int> nofChannels;
       
       if ( h5get_attribute (itsLocation, "STOKES_COMPONENT", stokesComponent) ) {
 	itsStokesComponent.setType(stokesComponent);
@@ -353,9 +357,10 @@ namespace DAL { // Namespace DAL -- begin
       if ( h5get_attribute (itsLocation, "NOF_SUBBANDS", nofSubbands) ) {
 	/* Store the number of sub-bands */
 	itsNofChannels.resize(nofSubbands);
-	/* Reyrieve number of channels per sub-band */
-	if ( h5get_attribute (itsLocation, "NOF_CHANNELS", nofChannels) ) {
-	  itsNofChannels = std::vector<unsigned int>(nofSubbands,nofChannels);
+	/* Retrieve number of channels per sub-band, stored as array */
+	if ( HDF5Attribute::read (itsLocation, "NOF_CHANNELS", nofChannels)
+	     && nofChannels.size() == nofSubbands ) {
+	  itsNofChannels = nofChannels;
 	}
       }
       
@@ -464,6 +469,7 @@ namespace DAL { // Namespace DAL -- begin
     } else {
       itsNofChannels.clear();
       itsNofChannels = nofChannels;
+      shape[1]       = 0;
       for (unsigned int n(0); n<nofChannels.size(); ++n) {
 	shape[1] += nofChannels[n];
       }
@@ -111,6 +111,10 @@ namespace DAL { // Namespace DAL -- begin
     - the number of sub-bands (\c NOF_SUBBANDS),
     - the number of channels per sub-band (\c NOF_CHANNELS)
 
+    As the data are written one time step after the other, a newly created
+    dataset is chunked along full rows of channels
+    (HDF5StoragePolicy::TimeMajor).
+
     Mapping of input variables onto internal parameters describing organization
     and shape of the dataset:
 
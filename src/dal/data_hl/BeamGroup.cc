@@ -83,6 +83,15 @@ namespace DAL {
     for (uint n(0); n<subbands_p.size(); n++) {
       delete subbands_p[n];
     }
+    
+    for (uint n(0); n<tableTypes_p.size(); n++) {
+      H5Tclose (tableTypes_p[n]);
+    }
+    
+    std::map<std::string,hid_t>::iterator it;
+    for (it=columnTypes_p.begin(); it!=columnTypes_p.end(); ++it) {
+      H5Tclose (it->second);
+    }
   }
   
   // ============================================================================
@@ -177,6 +186,7 @@ namespace DAL {
       if (nofSubbands>0)
 	{
 	  subbands_p.clear();
+	  tableTypes_p.clear();
 	  for (unsigned int n(0); n<nofSubbands; n++)
 	    {
 	      std::string tableName = "/" + groupName() + "/" + tableNames[n];
@@ -185,6 +195,8 @@ namespace DAL {
 	      /* Create new sub-band object from table */
 	      BeamSubband * band = new BeamSubband (table);
 	      subbands_p.push_back(band);
+	      /* Keep the datatype of the table, to look up its columns */
+	      tableTypes_p.push_back (H5Dget_type (band->tableID()));
 	    }
 	}
     }
@@ -462,39 +474,24 @@ namespace DAL {
     \param subband Subband to get the data from.
     \param start Start number of the cell in the column.
     \param length The number of cells to retrieve.
-    \return intensities Array of intensities
+    \return intensities Array of intensities, to be released by the caller
+            using <tt>delete []</tt>; \c NULL in case of an error.
   */
   float *
   BeamGroup::getIntensity (int &subband,
                            int &start,
                            int &length)
   {
-    dalTable * table;
-    dalColumn * col;
-    dalData * data;
-    
-    std::vector<std::string> memberNames = group_p->getMemberNames();
+    float * values = new float[length];
     
-    table = dataset_p.openTable(memberNames[ subband ],group_p->getName());
-    if ( !table ) {
-      std::cerr << "[BeamGroup::getIntensity] Subband " << subband
-		<< " does not exist for this beam."
+    if (!readSubband (subband, "TOTAL_INTENSITY", start, length, H5T_FLOAT, sizeof(float), values)) {
+      std::cerr << "[BeamGroup::getIntensity]"
+		<< " Unable to read column TOTAL_INTENSITY of subband " << subband
 		<< std::endl;
+      delete [] values;
       return NULL;
     }
     
-    col = table->getColumn_Float32("TOTAL_INTENSITY");
-    data = col->data( start, length );
-    if ( !data ) {
-     std::cerr << "[BeamGroup::getIntensity]"
-	       << " Column TOTAL_INTENSITY does not exist for this subband"
-	       << std::endl;
-      return NULL;
-    }
-    
-    float * values;
-    values = (float*)data->data;
-    
     return values;
   }
   
@@ -505,35 +502,22 @@ namespace DAL {
    \param subband Subband to get the data from.
    \param start Start number of the cell in the column.
    \param length The number of cells to retrieve.
-   \return intensities squared Array of intensities squared
+   \return intensities squared Array of intensities squared, to be released by
+           the caller using <tt>delete []</tt>; \c NULL in case of an error.
    */
   float * BeamGroup::getIntensitySquared( int &subband,
 					  int &start,
 					  int &length )
   {
-    dalTable * table;
-    dalColumn * col;
-    dalData * data;
-    
-    std::vector<std::string> memberNames = group_p->getMemberNames();
+    float * values = new float[length];
     
-    table = dataset_p.openTable(memberNames[ subband ],group_p->getName());
-    if ( !table )
-      {
-	printf("ERROR: Subband %d does not exist for this beam\n", subband);
-	return NULL;
-      }
-    
-    col = table->getColumn_Float32("TOTAL_INTENSITY_SQUARED");
-    data = col->data( start, length );
-    if ( !data )
-      {
-	printf("ERROR: Column TOTAL_INTENSITY_SQUARED does not exist for this subband\n");
-	return NULL;
-      }
-    
-    float * values;
-    values = (float*)data->data;
+    if (!readSubband (subband, "TOTAL_INTENSITY_SQUARED", start, length, H5T_FLOAT, sizeof(float), values)) {
+      std::cerr << "[BeamGroup::getIntensitySquared]"
+		<< " Unable to read column TOTAL_INTENSITY_SQUARED of subband " << subband
+		<< std::endl;
+      delete [] values;
+      return NULL;
+    }
     
     return values;
   }	  
@@ -545,41 +529,22 @@ namespace DAL {
     \param subband -- Subband to get the data from.
     \param start   -- Start number of the cell in the column.
     \param length  -- The number of cells to retrieve.
-    \retval values -- Vector with the extracted values
+    \retval values -- Vector to which the extracted values are appended
   */
   void BeamGroup::getSubbandData_X( int &subband,
                                     int &start,
                                     int &length,
                                     std::vector< std::complex<short> > &values )
   {
-    std::complex<short> * xx             = NULL;
-    dalTable * table                     = NULL;
-    dalColumn * col                      = NULL;
-    dalData * data                       = NULL;
-    std::vector<std::string> memberNames = group_p->getMemberNames();
-
-    table = dataset_p.openTable(memberNames[ subband ],group_p->getName());
-    if ( !table )
-      {
-        printf("ERROR: Subband %d does not exist for this beam\n", subband);
-      }
+    size_t offset = values.size();
 
-    col = table->getColumn_complexInt16("X");
-    data = col->data( start, length );
-    if ( !data )
-      {
-        std::cerr << "ERROR: Column X does not exist for this subband!" << std::endl;
-      }
-
-    for (int jj=0; jj < length; jj++)
-      {
-        xx = (std::complex<short>*)data->get(jj);
-        values.push_back(*xx);
-      }
-
-    delete data;
-    delete col;
-    delete table;
+    values.resize (offset+length);
+    if (!readSubband (subband, "X", start, length, H5T_COMPOUND, sizeof(std::complex<short>), &values[offset])) {
+      std::cerr << "[BeamGroup::getSubbandData_X]"
+		<< " Unable to read column X of subband " << subband
+		<< std::endl;
+      values.resize (offset);
+    }
   }
 
   //_____________________________________________________________________________
@@ -589,42 +554,22 @@ namespace DAL {
     \param subband Subband to get the data from.
     \param start Start number of the cell in the column.
     \param length The number of cells to retrieve.
-    \param Output character vector of values.
+    \param values Vector to which the extracted values are appended.
   */
   void BeamGroup::getSubbandData_Y (int &subband,
                                     int &start,
                                     int &length,
                                     std::vector< std::complex<short> > &values)
   {
-    std::complex<short> * yy             = NULL;
-    dalTable * table                     = NULL;
-    dalColumn * col                      = NULL;
-    dalData * data                       = NULL;
-    std::vector<std::string> memberNames = group_p->getMemberNames();
+    size_t offset = values.size();
 
-    table = dataset_p.openTable(memberNames[ subband ],group_p->getName());
-    if ( !table )
-      {
-        printf("ERROR: Subband %d does not exist for this beam\n", subband);
-      }
-
-    col = table->getColumn_complexInt16("Y");
-    data = col->data( start, length );
-    if ( !data )
-      {
-        printf("ERROR: Column Y does not exist for this subband\n");
-      }
-
-    for (int jj=0; jj < length; jj++)
-      {
-        yy = (std::complex<short>*)data->get(jj);
-        values.push_back(*yy);
-      }
-
-
-    delete data;
-    delete col;
-    delete table;
+    values.resize (offset+length);
+    if (!readSubband (subband, "Y", start, length, H5T_COMPOUND, sizeof(std::complex<short>), &values[offset])) {
+      std::cerr << "[BeamGroup::getSubbandData_Y]"
+		<< " Unable to read column Y of subband " << subband
+		<< std::endl;
+      values.resize (offset);
+    }
   }
 
   //_____________________________________________________________________________
@@ -647,4 +592,193 @@ namespace DAL {
     getSubbandData_Y( subband, start, length, values_y );
   }
 
+  //_____________________________________________________________________________
+  //                                                                     readData
+
+  /*!
+    \param column  -- Name of the column, e.g. <tt>TOTAL_INTENSITY</tt>.
+    \param start   -- Start number of the cell in the column.
+    \param length  -- The number of cells to retrieve per subband.
+    \retval values -- [subband,time] Buffer for nofSubbandTables()*length values,
+            into which the data of subband \e n are written starting at
+            <tt>values[n*length]</tt>.
+    \return status -- Status of the operation; returns \e false in case an
+            error was encountered, e.g. because the column is not of type float.
+  */
+  bool BeamGroup::readData (std::string const &column,
+                            int const &start,
+                            int const &length,
+                            float values[])
+  {
+    return readSubbands (column, start, length, H5T_FLOAT, sizeof(float), values);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     readData
+
+  /*!
+    \param column  -- Name of the column, e.g. <tt>X</tt>.
+    \param start   -- Start number of the cell in the column.
+    \param length  -- The number of cells to retrieve per subband.
+    \retval values -- [subband,time] Buffer for nofSubbandTables()*length values,
+            into which the data of subband \e n are written starting at
+            <tt>values[n*length]</tt>.
+    \return status -- Status of the operation; returns \e false in case an
+            error was encountered, e.g. because the column is not of type
+            complex short.
+  */
+  bool BeamGroup::readData (std::string const &column,
+                            int const &start,
+                            int const &length,
+                            std::complex<short> values[])
+  {
+    return readSubbands (column, start, length, H5T_COMPOUND, sizeof(std::complex<short>), values);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   columnType
+
+  /*!
+    \param column    -- Name of the column.
+    \param typeClass -- Class of the datatype of the column in memory.
+    \param size      -- Size of a single value of the column in memory.
+
+    \return memtype -- Compound datatype holding just the column, which
+            H5Dread() uses to extract it from the table; negative if the column
+            is not found or does not match \e typeClass and \e size. The
+            datatype is created upon the first request and is released with
+            the BeamGroup.
+  */
+  hid_t BeamGroup::columnType (std::string const &column,
+                               H5T_class_t const &typeClass,
+                               size_t const &size)
+  {
+    std::map<std::string,hid_t>::iterator it = columnTypes_p.find(column);
+    
+    if (it != columnTypes_p.end()) {
+      bool match = H5Tget_member_class(it->second,0) == typeClass
+	&& H5Tget_size(it->second) == size;
+      return match ? it->second : -1;
+    }
+    
+    for (unsigned int n(0); n<tableTypes_p.size(); n++) {
+      int index = H5Tget_member_index (tableTypes_p[n], column.c_str());
+      if (index < 0) {
+	continue;
+      }
+      hid_t fileType   = H5Tget_member_type (tableTypes_p[n], index);
+      hid_t nativeType = H5Tget_native_type (fileType, H5T_DIR_ASCEND);
+      hid_t memtype    = -1;
+      if (H5Tget_class(nativeType) == typeClass && H5Tget_size(nativeType) == size) {
+	memtype = H5Tcreate (H5T_COMPOUND, size);
+	H5Tinsert (memtype, column.c_str(), 0, nativeType);
+	columnTypes_p[column] = memtype;
+      }
+      H5Tclose (nativeType);
+      H5Tclose (fileType);
+      return memtype;
+    }
+    
+    return -1;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  readSubband
+
+  /*!
+    \param subband   -- Subband to get the data from.
+    \param column    -- Name of the column.
+    \param start     -- Start number of the cell in the column.
+    \param length    -- The number of cells to retrieve.
+    \param typeClass -- Class of the datatype of the column in memory.
+    \param size      -- Size of a single value of the column in memory.
+    \retval values   -- Buffer for \e length values.
+
+    \return status -- Status of the operation; returns \e false in case an
+            error was encountered.
+  */
+  bool BeamGroup::readSubband (unsigned int const &subband,
+                               std::string const &column,
+                               int const &start,
+                               int const &length,
+                               H5T_class_t const &typeClass,
+                               size_t const &size,
+                               void *values)
+  {
+    if (subband >= subbands_p.size()) {
+      std::cerr << "[BeamGroup::readSubband] Subband " << subband
+		<< " does not exist for this beam." << std::endl;
+      return false;
+    }
+    if (H5Tget_member_index (tableTypes_p[subband], column.c_str()) < 0) {
+      std::cerr << "[BeamGroup::readSubband] Column " << column
+		<< " does not exist for subband " << subband << std::endl;
+      return false;
+    }
+    
+    hid_t memtype = columnType (column, typeClass, size);
+    if (memtype < 0) {
+      std::cerr << "[BeamGroup::readSubband] Column " << column
+		<< " does not match the requested type." << std::endl;
+      return false;
+    }
+    
+    hid_t table     = subbands_p[subband]->tableID();
+    hid_t filespace = H5Dget_space (table);
+    hsize_t nofRows = 0;
+    hsize_t offset  = start;
+    hsize_t count   = length;
+    herr_t h5error  = -1;
+    
+    H5Sget_simple_extent_dims (filespace, &nofRows, NULL);
+    if (start < 0 || length < 0 || offset+count > nofRows) {
+      std::cerr << "[BeamGroup::readSubband] Cells [" << start << "," << start+length
+		<< ") out of range for subband " << subband
+		<< " with " << nofRows << " rows." << std::endl;
+    }
+    else if (count > 0) {
+      hid_t memspace = H5Screate_simple (1, &count, NULL);
+      H5Sselect_hyperslab (filespace, H5S_SELECT_SET, &offset, NULL, &count, NULL);
+      h5error = H5Dread (table, memtype, memspace, filespace, H5P_DEFAULT, values);
+      H5Sclose (memspace);
+    }
+    else {
+      h5error = 0;
+    }
+    H5Sclose (filespace);
+    
+    return h5error >= 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 readSubbands
+
+  /*!
+    \param column    -- Name of the column.
+    \param start     -- Start number of the cell in the column.
+    \param length    -- The number of cells to retrieve per subband.
+    \param typeClass -- Class of the datatype of the column in memory.
+    \param size      -- Size of a single value of the column in memory.
+    \retval values   -- [subband,time] Buffer for nofSubbandTables()*length values.
+
+    \return status -- Status of the operation; returns \e false in case an
+            error was encountered for any of the subbands.
+  */
+  bool BeamGroup::readSubbands (std::string const &column,
+                                int const &start,
+                                int const &length,
+                                H5T_class_t const &typeClass,
+                                size_t const &size,
+                                void *values)
+  {
+    bool status  = true;
+    char *buffer = static_cast<char *>(values);
+    
+    for (unsigned int n(0); n<subbands_p.size(); n++) {
+      status &= readSubband (n, column, start, length, typeClass, size, buffer + n*length*size);
+    }
+    
+    return status;
+  }
+
 } // end namespace DAL
@@ -21,6 +21,8 @@
 #ifndef BEAMGROUP_H
 #define BEAMGROUP_H
 
+#include <map>
+
 #include <data_hl/BeamSubband.h>
 
 namespace DAL
@@ -104,7 +106,21 @@ namespace DAL
       dataX = beam.getSubbandData_X (0,20,length);
       \endcode
       which will return values [20 .. 39] from the same table column accessed above.
+      <li>Retrieve a time window of a column from all sub-bands at once:
+      \code
+      int start (0);
+      int length (1024);
+      // [subband,time] Buffer into which the requested data are returned
+      std::vector<float> data (beam.nofSubbandTables()*length);
+      // Extract data values from the tables
+      beam.readData ("TOTAL_INTENSITY",start,length,&data[0]);
+      \endcode
       </ol>
+
+      The sub-band tables are opened once, when the beam group is set up; the
+      datatypes required to extract a single column are created upon first use
+      and kept for subsequent reads, which go straight into the buffer provided
+      by the caller.
   */
 
   class BeamGroup
@@ -122,6 +138,10 @@ namespace DAL
       dalDataset dataset_p;
       //! Vector of subband tables within the dataset
       std::vector<BeamSubband*> subbands_p;
+      //! HDF5 datatypes of the subband tables
+      std::vector<hid_t> tableTypes_p;
+      //! Memory datatypes for the extraction of a single column, by column name
+      std::map<std::string,hid_t> columnTypes_p;
 
     public:
 
@@ -163,6 +183,15 @@ namespace DAL
         {
           return group_p->getName();
         }
+      /*!
+        \brief Get the number of sub-band tables
+        \return nofTables -- The number of sub-band tables opened, i.e. the
+                number of rows of the buffers filled by readData().
+      */
+      inline unsigned int nofSubbandTables () const
+        {
+          return subbands_p.size();
+        }
 
       // ------------------------------------------------------- Methods
 
@@ -209,6 +238,16 @@ namespace DAL
 	  float *  getIntensitySquared( int &subband,
 							 int &start,
 						     int &length );
+      //! Get a time window of a column for all subbands
+      bool readData (std::string const &column,
+                     int const &start,
+                     int const &length,
+                     float values[]);
+      //! Get a time window of a column for all subbands
+      bool readData (std::string const &column,
+                     int const &start,
+                     int const &length,
+                     std::complex<short> values[]);
       //! Get a subband from the beam
       BeamSubband * getSubband( int subband );
       //! Get a subband from the beam
@@ -264,8 +303,34 @@ namespace DAL
       bpl::numeric::array getSubbandData_XY_boost( int subband,
           int start,
           int length );
+
+      bpl::numeric::array readData_boost( std::string const &column,
+          int start,
+          int length );
 #endif // end #ifdef PYTHON
 
+    private:
+
+      //! Get the memory datatype for the extraction of a single column
+      hid_t columnType (std::string const &column,
+                        H5T_class_t const &typeClass,
+                        size_t const &size);
+      //! Read a time window of a column from a single subband table
+      bool readSubband (unsigned int const &subband,
+                        std::string const &column,
+                        int const &start,
+                        int const &length,
+                        H5T_class_t const &typeClass,
+                        size_t const &size,
+                        void *values);
+      //! Read a time window of a column from all subband tables
+      bool readSubbands (std::string const &column,
+                         int const &start,
+                         int const &length,
+                         H5T_class_t const &typeClass,
+                         size_t const &size,
+                         void *values);
+
     }; // end BeamGroup class
 
 
@@ -112,31 +112,26 @@ namespace DAL {
     station.clear();
     rr           = 0;
     main_socket  = -1;
-    socklen      = sizeof(incoming_addr);
     status       = 0;
     stations.clear();
     stationGroup_p = NULL;
     dipoleArray_p  = NULL;
-    dipoles.clear();
-    dims.push_back(0);
-    offset_p   = 0;
-    cdims.push_back(CHUNK_SIZE);
+    stationGroups_p.assign (256, NULL);
+    dipoleStates_p.clear();
+    dipoleIndex_p.assign (64, -1);
+    dipole_p       = NULL;
+    storagePolicy_p = HDF5StoragePolicy();
     //stationstr = NULL;
     memset(uid,'-',10);
     payload_crc       = 0;
-    tran_sample.value = 0;
-    spec_sample.value = 0;
     size              = 0;
     memblock          = NULL;
-    rawfile_p         = NULL;
-    real_part         = 0;
-    imag_part         = 0;
 #ifdef USE_INPUT_BUFFER
-    inBufProcessID = inBufStorID = 0;
     maxWaitingFrames = 0;
-    noFramesDropped = 0;
-    inputBuffer_P = new char [(INPUT_BUFFER_SIZE*UDP_PACKET_BUFFER_SIZE)];
-    udpBuff_p = inputBuffer_P;
+    noFramesDropped  = 0;
+    inputRing_p      = new TBB_FrameRing (INPUT_BUFFER_SIZE, UDP_PACKET_BUFFER_SIZE);
+    holdingFrame_p   = false;
+    udpBuff_p        = NULL;
 #endif
     /* Initialization of public data */
 
@@ -175,30 +170,12 @@ namespace DAL {
 
   TBB::~TBB()
   {
-    if ( dipoleArray_p )
-      {
-        delete dipoleArray_p;
-        dipoleArray_p = 0;
-      }
-    if ( stationGroup_p )
-      {
-        delete stationGroup_p;
-        stationGroup_p = 0;
-      }
+    cleanup();
     delete dataset;
-    if (main_socket)
-      close(main_socket);
-    if (rawfile_p)
-      {
-        if (rawfile_p->is_open())
-          {
-            rawfile_p->close();
-          }
-        delete rawfile_p;
-        rawfile_p = 0;
-      }
+    ingest_p.close();
+    fileIngest_p.close();
 #ifdef USE_INPUT_BUFFER
-    delete [] inputBuffer_P;
+    delete inputRing_p;
 #endif
   }
 
@@ -280,6 +257,7 @@ namespace DAL {
     os << "-- Last sequence number : " << seqnrLast_p         << endl;
     os << "-- System is big endian : " << bigendian_p         << endl;
     os << "-- Sample time ........ : " << sampleTime_p        << endl;
+    os << "-- Open dipole datasets : " << nofOpenDipoles()    << endl;
     os << "-- Attributes attached to file root group:"        << endl;
     os << "   -- TELESCOPE        = " << telescope()          << endl;
     os << "   -- OBSERVER         = " << observer()           << endl;
@@ -320,40 +298,22 @@ namespace DAL {
         return;
       }
 
-    // Step 2: Create a socket
-    main_socket = socket(PF_INET, SOCK_DGRAM, 0);
-    if (main_socket<0)
+    // Step 2: Create a socket and bind it to the port
+    if (!ingest_p.open (port_number))
       {
-        perror("socket creation");
-        return;
-      }
-
-    // Step 3: Create a sockaddr_in to describe the local port
-    sockaddr_in local_info;
-    local_info.sin_family = AF_INET;
-    local_info.sin_addr.s_addr = htonl(INADDR_ANY);
-    local_info.sin_port = htons(port_number);
-
-    // Step 4: Bind the socket to the port
-    int rr = bind(main_socket, (sockaddr *) &local_info, sizeof(local_info));
-    if (rr<0)
-      {
-        perror("bind");
         return;
       }
+    main_socket = ingest_p.socket();
     printf("ready\n");
 
-    // Step 5: Start listening to the port
-    FD_ZERO(&readSet);
-    FD_SET(main_socket, &readSet);
-
+    // Step 3: Start listening to the port
     if (timeoutStart_p.tv_sec+timeoutStart_p.tv_usec > 0)
       {
-        select( main_socket + 1, &readSet, NULL, NULL, &timeoutStart_p );
+        ingest_p.waitForData (timeoutStart_p.tv_sec + 1e-6*timeoutStart_p.tv_usec);
       }
     else
       {
-        select( main_socket + 1, &readSet, NULL, NULL, NULL );
+        ingest_p.waitForData (-1);
       }
 
     // wait for up to "timeout" seconds for data to start showing up
@@ -371,9 +331,7 @@ namespace DAL {
   */
   bool TBB::openRawFile( const char* filename )
   {
-    delete rawfile_p;
-    rawfile_p = new std::fstream( filename, std::ios::binary|std::ios::in );
-    if ( !rawfile_p->is_open() )
+    if ( !fileIngest_p.open( filename ) )
       {
         std::cerr << "Error opening intput file: " << std::string(filename)
                   << std::endl;
@@ -381,7 +339,6 @@ namespace DAL {
       }
     else
       {
-        rawfile_p->seekg (0, std::ios::beg);  // move to start of file
         return true;
       }
   }
@@ -397,38 +354,28 @@ namespace DAL {
   int TBB::readsocket( unsigned int nbytes,
                        char* buf)
   {
-    FD_ZERO(&readSet);
-    FD_SET(main_socket, &readSet);
-
-    struct timeval readTimeout;
-    readTimeout = timeoutRead_p;
-
-    int status;
     // waits for up to N seconds for data appearing in the socket
-    if ( (status = select( main_socket + 1, &readSet, NULL, NULL, &readTimeout) ) )
-      {
-        rr = recvfrom( main_socket, buf, nbytes, 0,
-                       (sockaddr *) &incoming_addr, &socklen);
-#ifdef DAL_DEBUGGING_MESSAGES
-        cout << "readRawSocketBlockHeader: Frame with " << rr << " bytes." << endl;
-        if (rr == nbytes)
-          {
-            cout << "readRawSocketBlockHeader: Oversized packet received." << endl;
-          };
-#endif
-      }
-    else
+    int received = ingest_p.receive (buf, nbytes, 1,
+                                     timeoutRead_p.tv_sec + 1e-6*timeoutRead_p.tv_usec);
+    if (received == 0)
       {
         cout << "Data stopped coming" << endl;
         return FAIL;
       }
-
-    if (rr<0)
+    else if (received < 0)
       {
-        perror("recvfrom");
         return FAIL;
       }
 
+    rr = ingest_p.datagramSize(0);
+#ifdef DAL_DEBUGGING_MESSAGES
+    cout << "readRawSocketBlockHeader: Frame with " << rr << " bytes." << endl;
+    if (rr == (int)nbytes)
+      {
+        cout << "readRawSocketBlockHeader: Oversized packet received." << endl;
+      };
+#endif
+
     return SUCCESS;
   }
 #endif
@@ -437,74 +384,60 @@ namespace DAL {
 #ifdef USE_INPUT_BUFFER
   int TBB::readSocketBuffer()
   {
-    struct timeval readTimeout;
-    FD_ZERO(&readSet);
-    FD_SET(main_socket, &readSet);
-    int newBufID, nFramesWaiting = 0;
-
-    //set timeout to zero (don't wait, just poll)
-    readTimeout.tv_sec = readTimeout.tv_usec = 0;
-    while (select(main_socket + 1, &readSet, NULL, NULL, &readTimeout) > 0 )
+    char *slots;
+    int *sizes;
+    unsigned int nofSlots;
+    int nofReceived, nFramesWaiting = 0;
+
+    //hand the frame processed last back to the input buffer
+    if (holdingFrame_p)
       {
-        //there is a frame waiting in the vBuffer
-        newBufID = inBufStorID+1;
-        if (newBufID >= INPUT_BUFFER_SIZE)
+        inputRing_p->release(1);
+        holdingFrame_p = false;
+      };
+
+    //fetch everything waiting in the vBuffer (don't wait, just poll); if the
+    //input buffer is full the frames remain in the receive buffer of the socket
+    while ( (nofSlots = inputRing_p->writable(slots, sizes)) > 0 &&
+            (nofReceived = ingest_p.receive(slots, UDP_PACKET_BUFFER_SIZE, nofSlots, 0)) > 0 )
+      {
+        for (int n=0; n<nofReceived; n++)
           {
-            newBufID =0;
+            sizes[n] = ingest_p.datagramSize(n);
           }
-        if (newBufID == inBufProcessID)
-          {
-            //cerr << "TBB::readSocketBuffer: Buffer overflow! Overwriting last frame." << endl;
-            noFramesDropped++;
-            newBufID = inBufStorID;
-          };
-        //perform the actual read
-        rr = recvfrom( main_socket, (inputBuffer_P + (newBufID*UDP_PACKET_BUFFER_SIZE)),
-                       UDP_PACKET_BUFFER_SIZE, 0, (sockaddr *) &incoming_addr, &socklen);
-        nFramesWaiting++;
-        inBufStorID = newBufID;
+        inputRing_p->commit(nofReceived);
+        nFramesWaiting += nofReceived;
       };
     if (nFramesWaiting > maxWaitingFrames) {
       maxWaitingFrames = nFramesWaiting;
     };
-    if ( inBufStorID == inBufProcessID) {
+    noFramesDropped = ingest_p.nofKernelDrops();
+    if (inputRing_p->empty()) {
       // that means input buffer is empty
-      readTimeout.tv_sec = timeoutRead_p.tv_sec;
-      readTimeout.tv_usec = timeoutRead_p.tv_usec;
-      FD_ZERO(&readSet);
-      FD_SET(main_socket, &readSet);
-      status = select(main_socket + 1, &readSet, NULL, NULL, &readTimeout);
-      if (status) {
-	inBufStorID++;
-	if (inBufStorID >= INPUT_BUFFER_SIZE) {
-	  inBufStorID =0;
+      nofSlots    = inputRing_p->writable(slots, sizes);
+      nofReceived = ingest_p.receive(slots, UDP_PACKET_BUFFER_SIZE, nofSlots,
+				     timeoutRead_p.tv_sec + 1e-6*timeoutRead_p.tv_usec);
+      if (nofReceived > 0) {
+	for (int n=0; n<nofReceived; n++) {
+	  sizes[n] = ingest_p.datagramSize(n);
 	}
-	rr = recvfrom( main_socket, (inputBuffer_P+(inBufStorID*UDP_PACKET_BUFFER_SIZE)),
-		       UDP_PACKET_BUFFER_SIZE, 0, (sockaddr *) &incoming_addr, &socklen);
+	inputRing_p->commit(nofReceived);
       }
       else {
 	// we waited for "timeoutRead_p" but still no data -> end of data
 	cout << "TBB::readSocketBuffer: Data stopped coming" << endl;
-	cout << "TBB::readSocketBuffer: inBufProcessID: " << inBufProcessID
-	     << " inBufStorID: " << inBufStorID << " select-status:" << status
-	     << " remaining-sec: " << readTimeout.tv_sec << " -usec: " << readTimeout.tv_usec << endl;
+	cout << "TBB::readSocketBuffer: frames received: " << inputRing_p->nofFrames()
+	     << " receive-status:" << nofReceived << endl;
 	cout << "TBB::readSocketBuffer: Max no. of frames waiting: " << maxWaitingFrames
-	     << " number of discarded frames: " << noFramesDropped << endl;
+	     << " max. no. of frames in buffer: " << inputRing_p->highWaterMark()
+	     << " number of frames dropped by the kernel: " << noFramesDropped << endl;
 	return FAIL;
       };
     };
-#ifdef DAL_DEBUGGING_MESSAGES
-    if (inBufStorID == inBufProcessID) {
-      cerr << "TBB::readSocketBuffer: Empty buffer at end of method!" << endl;
-      return FAIL;
-    };
-#endif
-    inBufProcessID++;
-    if (inBufProcessID >= INPUT_BUFFER_SIZE)
-      {
-        inBufProcessID =0;
-      };
-    udpBuff_p = (inputBuffer_P + (inBufProcessID*UDP_PACKET_BUFFER_SIZE));
+    inputRing_p->readable(slots, sizes);
+    udpBuff_p      = slots;
+    rr             = sizes[0];
+    holdingFrame_p = true;
     return SUCCESS;
   };
 #endif
@@ -574,9 +507,23 @@ namespace DAL {
     -- TBB Design Description document, Wietse Poiesz (2006-10-3)
         Doc..id: LOFAR-ASTRON-SDD-047
   */
-  void TBB::readRawFileBlockHeader()
+  /*!
+    \return status -- Returns \e false if the file ended before a complete
+            header could be read.
+  */
+  bool TBB::readRawFileBlockHeader()
   {
-    rawfile_p->read(reinterpret_cast<char *>(&header), sizeof(header));
+    char *frame = fileIngest_p.read( sizeof(header) );
+    if ( frame == NULL )
+      {
+        if ( fileIngest_p.nofTruncated() )
+          {
+            cerr << "[TBB::readRawFileBlockHeader] Incomplete frame at the end of the file"
+                 << endl;
+          }
+        return false;
+      }
+    memcpy(&header, frame, sizeof(header));
     // set the headerpointer to the just read data
     headerp_p = &header;
 
@@ -602,6 +549,7 @@ namespace DAL {
     printRawHeader();
 #endif
 
+    return true;
   }
 
   //_____________________________________________________________________________
@@ -609,10 +557,7 @@ namespace DAL {
 
   bool TBB::eof()
   {
-    if ( rawfile_p->peek() == EOF )
-      return true;
-    else
-      return false;
+    return fileIngest_p.eof();
   }
 
   //_____________________________________________________________________________
@@ -634,30 +579,12 @@ namespace DAL {
     printf("\n");
   }
   
-  // Generic CRC16 method working on 16-bit unsigned data
-  // adapted from Python script by Gijs Schoonderbeek.
+  // Generic CRC16 method working on 16-bit unsigned data; kept for backwards
+  // compatibility, the computation is done by DAL::crc16.
   
   uint16_t TBB::CRC16(uint16_t * buffer, uint32_t length)
   {
-    uint16_t CRC = 0;
-    const uint32_t CRC_poly = 0x18005;
-    const uint16_t bits = 16;
-    uint32_t data = 0;
-    const uint32_t CRC_div = (CRC_poly & 0x7fffffff) << 15;
-    
-    data = (buffer[0] & 0x7fffffff) << 16;
-    for (uint32_t i=1; i<length; i++) {
-      data += buffer[i];
-      for (uint16_t j=0; j<bits; j++) {
-	if ((data & 0x80000000) != 0) {
-	  data ^= CRC_div;
-	}
-	data &= 0x7fffffff;
-	data <<= 1;
-      }
-    }
-    CRC = data >> 16;
-    return CRC;
+    return DAL::crc16(buffer, length);
   }
   
   //_____________________________________________________________________________
@@ -682,54 +609,172 @@ namespace DAL {
   //_____________________________________________________________________________
   // Check if the group for a given station exists within the HDF5 file
 
+  /*!
+    Sets up the station group and the dipole dataset the current frame is
+    written to. The handles are opened -- or created -- at the first frame of
+    a dipole only; the frames thereafter look up the write state of the dipole
+    in the hash index.
+  */
   void TBB::stationCheck()
   {
-    char stationstr[10];
-    char dipolestr[10];
-    memset(stationstr,'\0',10);
-    sprintf( stationstr, "Station%03d", headerp_p->stationid );
-    sprintf( dipolestr, "%03d%03d%03d", headerp_p->stationid, headerp_p->rspid, headerp_p->rcuid);
+    unsigned int key = dipoleKey (headerp_p->stationid,
+				  headerp_p->rspid,
+				  headerp_p->rcuid);
     first_sample = false;
 
-    /* Use std::string for the name of the station group */
-    std::string channelID (dipolestr);
+    /* Subsequent frames mostly belong to the same dipole */
+    if ( dipole_p != NULL && dipole_p->key == key )
+      {
+        return;
+      }
 
-    first_sample = false;
+    int index = findDipole (key);
+    if ( index < 0 )
+      {
+        index = openDipole (key);
+      }
+
+    dipole_p       = &dipoleStates_p[index];
+    stationGroup_p = stationGroups_p[headerp_p->stationid];
+    dipoleArray_p  = dipole_p->array;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   findDipole
+
+  /*!
+    \param key -- Key of the dipole, see dipoleKey().
+
+    \return index -- Index of the write state of the dipole within
+            dipoleStates_p; -1 if the dataset of the dipole has not been opened
+            yet.
+  */
+  int TBB::findDipole (unsigned int const &key)
+  {
+    unsigned int mask = dipoleIndex_p.size() - 1;
+
+    for ( unsigned int slot = dipoleSlot (key);
+	  dipoleIndex_p[slot] >= 0;
+	  slot = (slot+1) & mask )
+      {
+        if ( dipoleStates_p[dipoleIndex_p[slot]].key == key )
+          {
+            return dipoleIndex_p[slot];
+          }
+      }
+
+    return -1;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 insertDipole
+
+  /*!
+    \param state -- Write state of the dipole, which must not be in the index
+           yet.
 
-    // does the station exist?
-    if ( it_exists( stations, stringify(stationstr)) )
+    \return index -- Index of the write state within dipoleStates_p.
+  */
+  int TBB::insertDipole (DipoleState const &state)
+  {
+    unsigned int index = dipoleStates_p.size();
+    unsigned int first = index;
+
+    dipoleStates_p.push_back (state);
+
+    /* Keep the load of the index below 1/2, rebuilding it if required */
+    if ( 2*dipoleStates_p.size() > dipoleIndex_p.size() )
       {
+        dipoleIndex_p.assign (2*dipoleIndex_p.size(), -1);
+        first = 0;
+      }
+
+    unsigned int mask = dipoleIndex_p.size() - 1;
+    unsigned int slot = 0;
+
+    for ( unsigned int n=first; n<=index; ++n )
+      {
+        slot = dipoleSlot (dipoleStates_p[n].key);
+        while ( dipoleIndex_p[slot] >= 0 )
+          {
+            slot = (slot+1) & mask;
+          }
+        dipoleIndex_p[slot] = n;
+      }
 
-        // if the station group already exists, then open it
-        stationGroup_p = dataset->openGroup( stationstr );
+    return index;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   openDipole
+
+  /*!
+    Opens the station group and the dipole dataset of the current frame,
+    creating them if they do not exist in the file yet.
+
+    \param key -- Key of the dipole, see dipoleKey().
+
+    \return index -- Index of the write state of the dipole within
+            dipoleStates_p.
+  */
+  int TBB::openDipole (unsigned int const &key)
+  {
+    char stationstr[16];
+    char dipolestr[16];
+    memset(stationstr,'\0',16);
+    sprintf( stationstr, "Station%03d", headerp_p->stationid );
+    sprintf( dipolestr, "%03d%03d%03d", headerp_p->stationid, headerp_p->rspid, headerp_p->rcuid);
+
+    DipoleState state;
+    bool isNew = false;
+
+    state.key       = key;
+    state.time      = headerp_p->time;
+    state.sample_nr = headerp_p->sample_nr;
+    state.length    = 0;
+
+    stationGroup_p = stationGroups_p[headerp_p->stationid];
+
+    if ( stationGroup_p == NULL )
+      {
+        // does the station exist?
+        if ( it_exists( stations, stringify(stationstr)) )
+          {
+            // if the station group already exists, then open it
+            stationGroup_p = dataset->openGroup( stationstr );
+          }
+        else
+          {
+            //Station unknown, make new station group, which also makes a new dipole.
+            makeNewStation(stationstr, headerp_p);
+            isNew = true;
+          }
+        stationGroups_p[headerp_p->stationid] = stationGroup_p;
+      }
 
-        dipoles = stationGroup_p->getMemberNames();
+    if ( !isNew )
+      {
+        std::vector<std::string> dipoles = stationGroup_p->getMemberNames();
 
         // does the dipole exist?
         if ( it_exists( dipoles, stringify(dipolestr)) )
           {
             // if the dipole array already exists, then open it
             dipoleArray_p = dataset->openArray( dipolestr, stationGroup_p->getName() );
+            dipoleArray_p->getAttribute( attribute_name(TIME), state.time );
+            dipoleArray_p->getAttribute( attribute_name(SAMPLE_NUMBER), state.sample_nr );
+            state.length = dipoleArray_p->dims()[0];
           }
         else
           {
             //Need to generate a new dipole structure
             makeNewDipole(dipolestr, stationGroup_p, headerp_p);
           }
-
       }
-    else
-      {
-
-        //Station unknown, make new station group, which also makes a new dipole.
 
-        makeNewStation(stationstr, headerp_p);
-
-        dipoles = stationGroup_p->getMemberNames();
-      }
+    state.array = dipoleArray_p;
 
-    dims          = dipoleArray_p->dims();
-    offset_p      = dims[0];
+    return insertDipole (state);
   }
 
   // ---------------------------------------------------------- makeStationHeader
@@ -811,14 +856,14 @@ namespace DAL {
       dipoleArray_p = stationGroupPtr->createShortArray( newuid,
 							 firstdims,
 							 nodata,
-							 cdims );
+							 storagePolicy_p );
     }
     else {
       std::complex<Int16> nodata[0];
       dipoleArray_p = stationGroupPtr->createComplexShortArray( newuid,
 								firstdims,
 								nodata,
-								cdims );
+								storagePolicy_p );
       stationGroupPtr->setAttribute ("OBSERVATION_MODE",
 				     std::vector<std::string>(1,"Sub-band") );
     }
@@ -960,17 +1005,14 @@ namespace DAL {
       };
 
     //calculate the writeOffset from time of first block and this block
-    uint starttime, startsamplenum;
-    dipoleArray_p->getAttribute( attribute_name(TIME), starttime );
-    dipoleArray_p->getAttribute( attribute_name(SAMPLE_NUMBER), startsamplenum );
+    uint starttime      = dipole_p->time;
+    uint startsamplenum = dipole_p->sample_nr;
     int writeOffset= (headerp_p->time-starttime)*headerp_p->sample_freq*1000000 +
                      (headerp_p->sample_nr-startsamplenum);
 #ifdef DAL_DEBUGGING_MESSAGES
-    uint sid, rsp, rcu;
-    dipoleArray_p->getAttribute( attribute_name(STATION_ID), sid );
-    dipoleArray_p->getAttribute( attribute_name(RSP_ID), rsp );
-    dipoleArray_p->getAttribute( attribute_name(RCU_ID), rcu );
-    std::cout << "Station: " << sid << " RSP: " << rsp << " RCU: " << rcu
+    std::cout << "Station: " << uint(headerp_p->stationid)
+              << " RSP: " << uint(headerp_p->rspid)
+              << " RCU: " << uint(headerp_p->rcuid)
               << " Sequence-Nr: " << headerp_p->seqnr << endl;
     std::cout << " starttime:"<< starttime << " startsamplenum:" << startsamplenum
               << " writeOffset:" << writeOffset << endl;
@@ -979,18 +1021,12 @@ namespace DAL {
     // (don't extend the array to the front)
     if (writeOffset >= 0)
       {
-        //extend array if neccessary.
-        if ((writeOffset+ headerp_p->n_samples_per_frame)> dims[0])
+        //the append cursor extends the array if neccessary.
+        dipoleArray_p->append(writeOffset, sdata, headerp_p->n_samples_per_frame );
+        if ((writeOffset+ headerp_p->n_samples_per_frame)> dipole_p->length)
           {
-#ifdef DAL_DEBUGGING_MESSAGES
-            cout << "extending array to:" << writeOffset+ headerp_p->n_samples_per_frame
-                 << " from:" << dims << endl;
-#endif
-            dims[0] = writeOffset+ headerp_p->n_samples_per_frame;
-            dipoleArray_p->extend(dims);
+            dipole_p->length = writeOffset+ headerp_p->n_samples_per_frame;
           };
-        dipoleArray_p->write(writeOffset, sdata, headerp_p->n_samples_per_frame );
-        offset_p = dims[0];
 #ifdef DAL_DEBUGGING_MESSAGES
       }
     else
@@ -1012,40 +1048,35 @@ namespace DAL {
 
   void TBB::discardFileBytes(uint bytes)
   {
-    char discardbyte = 0;
-    for (uint n = 0; n < bytes; n++)
-      {
-        rawfile_p->read(&discardbyte, 1);
-      }
+    fileIngest_p.skip(bytes);
   }
   // ---------------------------------------------- processTransientFileDataBlock
 
   void TBB::processTransientFileDataBlock()
   {
-    short sdata[ headerp_p->n_samples_per_frame];
-    for (short zz=0; zz < headerp_p->n_samples_per_frame; zz++ )
+    // the payload is parsed in place within the buffer of the file reader
+    size_t payloadSize = headerp_p->n_samples_per_frame*sizeof(TransientSample);
+    char *payload      = fileIngest_p.read( payloadSize + sizeof(payload_crc) );
+    if ( payload == NULL )
       {
-        rawfile_p->read( reinterpret_cast<char *>(&tran_sample),
-                         sizeof(tran_sample) );
-
-        if ( bigendian_p )  // reverse fields if big endian
-          swapbytes( (char *)&tran_sample.value, 2 );
-
-        sdata[zz] = tran_sample.value;
+        cerr << "[TBB::processTransientFileDataBlock] Incomplete frame at the end of the file"
+             << endl;
+        return;
       }
+    short *sdata = reinterpret_cast<short *>(payload);
+
+    if ( bigendian_p )  // reverse fields if big endian
+      TBB_FileIngest::swap16( sdata, headerp_p->n_samples_per_frame );
 
     //calculate the writeOffset from time of first block and this block
-    uint starttime, startsamplenum;
-    dipoleArray_p->getAttribute( attribute_name(TIME), starttime );
-    dipoleArray_p->getAttribute( attribute_name(SAMPLE_NUMBER), startsamplenum );
+    uint starttime      = dipole_p->time;
+    uint startsamplenum = dipole_p->sample_nr;
     int writeOffset= (headerp_p->time-starttime)*headerp_p->sample_freq*1000000 +
                      (headerp_p->sample_nr-startsamplenum);
 #ifdef DAL_DEBUGGING_MESSAGES
-    uint sid, rsp, rcu;
-    dipoleArray_p->getAttribute( attribute_name(STATION_ID), sid );
-    dipoleArray_p->getAttribute( attribute_name(RSP_ID), rsp );
-    dipoleArray_p->getAttribute( attribute_name(RCU_ID), rcu );
-    std::cout << "Station: " << sid << " RSP: " << rsp << " RCU: " << rcu
+    std::cout << "Station: " << uint(headerp_p->stationid)
+              << " RSP: " << uint(headerp_p->rspid)
+              << " RCU: " << uint(headerp_p->rcuid)
               << " Sequence-Nr: " << headerp_p->seqnr << endl;
     std::cout << " starttime:"<< starttime << " startsamplenum:" << startsamplenum
               << " writeOffset:" << writeOffset << endl;
@@ -1055,14 +1086,12 @@ namespace DAL {
     // (don't extend the array to the front)
     if (writeOffset >= 0)
       {
-        //extend array if neccessary.
-        if ((writeOffset+ headerp_p->n_samples_per_frame)> dims[0])
+        //the append cursor extends the array if neccessary.
+        dipoleArray_p->append(writeOffset, sdata, headerp_p->n_samples_per_frame );
+        if ((writeOffset+ headerp_p->n_samples_per_frame)> dipole_p->length)
           {
-            dims[0] = writeOffset+ headerp_p->n_samples_per_frame;
-            dipoleArray_p->extend(dims);
+            dipole_p->length = writeOffset+ headerp_p->n_samples_per_frame;
           };
-        dipoleArray_p->write(writeOffset, sdata, headerp_p->n_samples_per_frame );
-        offset_p = dims[0];
 #ifdef DAL_DEBUGGING_MESSAGES
       }
     else
@@ -1071,8 +1100,7 @@ namespace DAL {
                   << " Block discarded!" << endl;
 #endif
       };
-    rawfile_p->read( reinterpret_cast<char *>(&payload_crc),
-                     sizeof(payload_crc) );
+    memcpy( &payload_crc, payload+payloadSize, sizeof(payload_crc) );
 
   }
 
@@ -1080,47 +1108,61 @@ namespace DAL {
 
   void TBB::processSpectralFileDataBlock()
   {
-    std::complex<Int16> csdata[ headerp_p->n_samples_per_frame];
-
-    for ( short zz=0; zz < headerp_p->n_samples_per_frame; zz++ )
+    // the payload is parsed in place within the buffer of the file reader
+    size_t payloadSize = headerp_p->n_samples_per_frame*sizeof(SpectralSample);
+    char *payload      = fileIngest_p.read( payloadSize + sizeof(payload_crc) );
+    if ( payload == NULL )
       {
-        rawfile_p->read( reinterpret_cast<char *>(&spec_sample),
-                         sizeof(spec_sample) );
-
-        real_part = real(spec_sample.value);
-        imag_part = imag(spec_sample.value);
-
-        if ( bigendian_p ) // reverse fields if big endian
-          {
-            swapbytes( (char *)&real_part, 2 );
-            swapbytes( (char *)&imag_part, 2 );
-          }
-
-        csdata[zz] = std::complex<Int16>( real_part, imag_part );
+        cerr << "[TBB::processSpectralFileDataBlock] Incomplete frame at the end of the file"
+             << endl;
+        return;
       }
+    std::complex<Int16> *csdata = reinterpret_cast<std::complex<Int16> *>(payload);
+
+    if ( bigendian_p ) // reverse fields if big endian
+      TBB_FileIngest::swap16( csdata, 2*headerp_p->n_samples_per_frame );
 
-    dims[0] += headerp_p->n_samples_per_frame;
-    dipoleArray_p->extend(dims);
-    dipoleArray_p->write(offset_p, csdata, headerp_p->n_samples_per_frame );
-    offset_p += headerp_p->n_samples_per_frame;
+    dipoleArray_p->append(dipole_p->length, csdata, headerp_p->n_samples_per_frame );
+    dipole_p->length += headerp_p->n_samples_per_frame;
 
-    rawfile_p->read( reinterpret_cast<char *>(&payload_crc),
-                     sizeof(payload_crc) );
+    memcpy( &payload_crc, payload+payloadSize, sizeof(payload_crc) );
 
   }
 
   //_____________________________________________________________________________
   //                                                                      cleanup
 
+  /*!
+    Writes the length of each dipole dataset to its \c DATA_LENGTH attribute
+    and closes the dipole datasets -- trimming them to the data written, see
+    dalArray::closeCursor() -- and the station groups. Frames processed
+    afterwards re-open the handles.
+  */
   void TBB::cleanup()
   {
-    stationGroup_p->close();
-    delete stationGroup_p;
-    stationGroup_p = NULL;
+    for ( unsigned int n=0; n<dipoleStates_p.size(); ++n )
+      {
+        DipoleState &state = dipoleStates_p[n];
+        state.array->setAttribute ("DATA_LENGTH", uint(state.length));
+        state.array->close();
+        delete state.array;
+      }
+    dipoleStates_p.clear();
+    dipoleIndex_p.assign (dipoleIndex_p.size(), -1);
 
-    dipoleArray_p->close();
-    delete dipoleArray_p;
-    dipoleArray_p = NULL;
+    for ( unsigned int n=0; n<stationGroups_p.size(); ++n )
+      {
+        if ( stationGroups_p[n] )
+          {
+            stationGroups_p[n]->close();
+            delete stationGroups_p[n];
+            stationGroups_p[n] = NULL;
+          }
+      }
+
+    stationGroup_p = NULL;
+    dipoleArray_p  = NULL;
+    dipole_p       = NULL;
   }
 
 } // end namespace DAL
@@ -30,10 +30,14 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <algorithm>
 #include <fstream>
 #include <string>
 
 #include <core/dalDataset.h>
+#include <data_hl/TBB_FileIngest.h>
+#include <data_hl/TBB_FrameRing.h>
+#include <data_hl/TBB_UDPIngest.h>
 
 #define ETHEREAL_HEADER_LENGTH = 46;
 #define FIRST_EXTRA_HDR_LENGTH = 40;
@@ -72,6 +76,13 @@ namespace DAL {
     
     <h3>Synopsis</h3>
 
+    The station groups and dipole datasets are opened -- or created -- at the
+    first frame of a dipole and then kept open, together with the time and
+    sample number of the first sample of the dipole, from which the position
+    of a frame within the dataset is computed. The write state of the dipoles
+    is looked up by (station, RSP, RCU) through a hash index; it is written
+    back, and the handles are closed, once by cleanup() at the end of the
+    conversion.
 
     <h3>Example(s)</h3>
 
@@ -145,6 +156,21 @@ namespace DAL {
       Int16 spare;
       UInt16 crc;
     };
+
+    //! Write state of a dipole dataset, kept for the whole conversion
+    struct DipoleState
+    {
+      //! Key of the dipole, combining station, RSP and RCU ID
+      unsigned int key;
+      //! Handle of the open dipole dataset
+      dalArray *array;
+      //! Time of the first sample of the dataset
+      unsigned int time;
+      //! Sample number of the first sample of the dataset
+      unsigned int sample_nr;
+      //! Number of samples covered by the data written so far
+      int length;
+    };
     
     //! Name of the output HDF5 file
     std::string name;
@@ -166,15 +192,13 @@ namespace DAL {
     time_t sampleTime_p;  // For date
     dalDataset * dataset;
     std::vector<dalGroup> station;
-    fd_set readSet;
     struct timeval timeoutStart_p;
     struct timeval timeoutRead_p;
 #ifdef USE_INPUT_BUFFER
-    //!pointers (array indices) for the last buffer processed and the last buffer written
-    int inBufProcessID,inBufStorID;
     //!the Input Buffer
-    //    char inputBuffer_P[INPUT_BUFFER_SIZE][UDP_PACKET_BUFFER_SIZE];
-    char * inputBuffer_P;
+    TBB_FrameRing * inputRing_p;
+    //!is the frame at udpBuff_p still to be released from the Input Buffer?
+    bool holdingFrame_p;
     //!pointer to the UDP-datagram
     char *udpBuff_p;
     //!maximum number of frames waiting in the vBuf while reading
@@ -189,16 +213,24 @@ namespace DAL {
     TBB_Header *headerp_p;
     int rr;
     int main_socket;
-    struct sockaddr_in incoming_addr;
-    unsigned int socklen;
+    //! Batched reception of the frames from the UDP port
+    TBB_UDPIngest ingest_p;
+    //! Names of the station groups in the file
     std::vector<std::string> stations;
+    //! Station group of the current frame
     dalGroup * stationGroup_p;
+    //! Dipole dataset of the current frame
     dalArray * dipoleArray_p;
-    std::vector<std::string> dipoles;
-    //! Definition of array dimensions (shape)
-    std::vector<int> dims;
-    int offset_p;
-    std::vector<int> cdims;
+    //! [station ID] Open station groups
+    std::vector<dalGroup *> stationGroups_p;
+    //! Write state of the open dipole datasets
+    std::vector<DipoleState> dipoleStates_p;
+    //! Open-addressing hash index into dipoleStates_p; -1 marks a free slot
+    std::vector<int> dipoleIndex_p;
+    //! Write state of the dipole of the current frame
+    DipoleState * dipole_p;
+    //! Chunking and filters of the dipole datasets
+    HDF5StoragePolicy storagePolicy_p;
     //! Name of the HDF5 group storing data for a station
     //char * stationstr;
     //! Unique identifier for an individual dipole
@@ -212,13 +244,11 @@ namespace DAL {
 		    char* buf);
 #endif
     UInt32 payload_crc;
-    TransientSample tran_sample;
-    SpectralSample spec_sample;
     // for file i/o
     std::ifstream::pos_type size;
     unsigned char * memblock;
-    std::fstream * rawfile_p;
-    Int16 real_part, imag_part;
+    //! Bulk buffered reading of the raw file
+    TBB_FileIngest fileIngest_p;
     
   public:
     
@@ -296,6 +326,14 @@ namespace DAL {
     inline void setObservation_id (std::string const &observation_id) {
       observation_id_p = observation_id;
     }
+    //! Get the chunking and filters of the dipole datasets
+    inline HDF5StoragePolicy storagePolicy () const {
+      return storagePolicy_p;
+    }
+    //! Set the chunking and filters of the dipole datasets created from now on
+    inline void setStoragePolicy (HDF5StoragePolicy const &policy) {
+      storagePolicy_p = policy;
+    }
     //! Set the telescope observation mode
     inline void setObservation_mode (std::string const &observation_mode) {
       observationMode_p = observation_mode;
@@ -351,7 +389,8 @@ namespace DAL {
       //! Open file containing data resulting from a TBB dump
       bool openRawFile( const char* filename );
       bool readRawSocketBlockHeader();
-      void readRawFileBlockHeader();
+      //! Read the header of the next frame from the raw file
+      bool readRawFileBlockHeader();
       //! Print the contents of a raw TBB frame header
       void printRawHeader();
       //! Check the CRC of a TBB frame header
@@ -375,7 +414,12 @@ namespace DAL {
       void discardFileBytes(uint bytes);
       void processTransientFileDataBlock();
       void processSpectralFileDataBlock();
+      //! Write back the state of the dipole datasets and close all handles
       void cleanup();
+      //! Get the number of dipole datasets currently kept open
+      inline unsigned int nofOpenDipoles () const {
+        return dipoleStates_p.size();
+      }
 
       //! Check for the end-of-file
       bool eof();
@@ -394,6 +438,25 @@ namespace DAL {
       void init ();
       //! Initialize the values within the TBB_Header struct
       void init_TBB_Header ();
+      //! Get the key of a dipole within the hash index
+      static inline unsigned int dipoleKey (unsigned int const &stationID,
+					    unsigned int const &rspID,
+					    unsigned int const &rcuID)
+      {
+        return (stationID << 16) | (rspID << 8) | rcuID;
+      }
+      //! Get the first slot of a dipole within the hash index
+      inline unsigned int dipoleSlot (unsigned int const &key) const
+      {
+        unsigned int hash = key * 2654435761u;
+        return (hash ^ (hash >> 16)) & (dipoleIndex_p.size() - 1);
+      }
+      //! Look up the write state of a dipole, returns -1 if not open yet
+      int findDipole (unsigned int const &key);
+      //! Open or create the dataset of the dipole of the current frame
+      int openDipole (unsigned int const &key);
+      //! Add the write state of a dipole to the hash index
+      int insertDipole (DipoleState const &state);
 
     }; // class TBB
 
@@ -19,6 +19,13 @@
  ***************************************************************************/
 
 #include <data_hl/TBB_DipoleDataset.h>
+#include <core/HDF5Dataset.h>
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using std::cerr;
 using std::cout;
@@ -37,10 +44,14 @@ namespace DAL {  // Namespace DAL -- begin
   
   TBB_DipoleDataset::TBB_DipoleDataset ()
   {
-    datatype_p  = -1;
-    dataspace_p = -1;
-    location_p  = -1;
-    shape_p     = std::vector<hsize_t>();
+    datatype_p     = -1;
+    dataspace_p    = -1;
+    location_p     = -1;
+    shape_p        = std::vector<hsize_t>();
+    mappedRegion_p = NULL;
+    mappedSize_p   = 0;
+    mappedData_p   = NULL;
+    mappedLength_p = 0;
   }
   
   //_____________________________________________________________________________
@@ -55,10 +66,14 @@ namespace DAL {  // Namespace DAL -- begin
                                         std::string const &name)
     : HDF5CommonInterface ()
   {
-    datatype_p  = -1;
-    dataspace_p = -1;
-    location_p  = -1;
-    shape_p     = std::vector<hsize_t>();
+    datatype_p     = -1;
+    dataspace_p    = -1;
+    location_p     = -1;
+    shape_p        = std::vector<hsize_t>();
+    mappedRegion_p = NULL;
+    mappedSize_p   = 0;
+    mappedData_p   = NULL;
+    mappedLength_p = 0;
     //
     open (location,name,false);
   }
@@ -78,10 +93,14 @@ namespace DAL {  // Namespace DAL -- begin
 					uint const &rspID,
 					uint const &rcuID)
   {
-    datatype_p  = -1;
-    dataspace_p = -1;
-    location_p  = -1;
-    shape_p     = std::vector<hsize_t>();
+    datatype_p     = -1;
+    dataspace_p    = -1;
+    location_p     = -1;
+    shape_p        = std::vector<hsize_t>();
+    mappedRegion_p = NULL;
+    mappedSize_p   = 0;
+    mappedData_p   = NULL;
+    mappedLength_p = 0;
     std::string name = dipoleName (stationID, rspID, rcuID);
 
     open (location,name,false);
@@ -107,10 +126,14 @@ namespace DAL {  // Namespace DAL -- begin
 					std::vector<hsize_t> const &shape,
 					hid_t const &datatype)
   {
-    datatype_p  = -1;
-    dataspace_p = -1;
-    location_p  = -1;
-    shape_p     = std::vector<hsize_t>();
+    datatype_p     = -1;
+    dataspace_p    = -1;
+    location_p     = -1;
+    shape_p        = std::vector<hsize_t>();
+    mappedRegion_p = NULL;
+    mappedSize_p   = 0;
+    mappedData_p   = NULL;
+    mappedLength_p = 0;
 
     open (location,
 	  stationID,
@@ -120,6 +143,28 @@ namespace DAL {  // Namespace DAL -- begin
 	  datatype);
   }
   
+  //_____________________________________________________________________________
+  //                                                            TBB_DipoleDataset
+  
+  /*!
+    The new object refers to the same dataset as <tt>other</tt>; the memory
+    mapping of <tt>other</tt>, if any, is not shared.
+
+    \param other -- Another TBB_DipoleDataset object from which to create this
+           new one.
+  */
+  TBB_DipoleDataset::TBB_DipoleDataset (TBB_DipoleDataset const &other)
+    : HDF5CommonInterface (other)
+  {
+    datatype_p     = other.datatype_p;
+    dataspace_p    = other.dataspace_p;
+    shape_p        = other.shape_p;
+    mappedRegion_p = NULL;
+    mappedSize_p   = 0;
+    mappedData_p   = NULL;
+    mappedLength_p = 0;
+  }
+  
   // ============================================================================
   //
   //  Destruction
@@ -138,6 +183,8 @@ namespace DAL {  // Namespace DAL -- begin
   {
     herr_t h5error;
 
+    unmapData ();
+
     if (datatype_p>0 && H5Iis_valid(datatype_p)) {
       h5error    = H5Tclose (datatype_p);
       datatype_p = 0;
@@ -489,6 +536,7 @@ namespace DAL {  // Namespace DAL -- begin
     os << "-- Dataspace ID ............ = " << dataspace_p    << std::endl;
     os << "-- Dataset datatype ........ = " << datatype_p     << std::endl;
     os << "-- Data array shape ........ = " << shape_p        << std::endl;
+    os << "-- Mapped into memory ...... = " << isMapped()     << std::endl;
     
     if (location_p>0) {
       /*
@@ -717,8 +765,7 @@ namespace DAL {  // Namespace DAL -- begin
     int dataEnd (start+nofSamples-1);
     int dataLength;
     int dataOffset;
-//     short *dataBuffer;
-    
+
     if (start<0) {
       if (dataEnd<0) {
 	for (int n(0); n<nofSamples; ++n) {
@@ -743,8 +790,14 @@ namespace DAL {  // Namespace DAL -- begin
       dataLength = nofSamples;
     }
 
-//     dataBuffer = new short[dataLength];
-//     dataBuffer = &data[dataOffset];
+    /* Copy straight from the mapped file, if the window lies within the data */
+
+    if (mappedData_p != NULL && hsize_t(dataStart+dataLength) <= mappedLength_p) {
+      memcpy (data+dataOffset,
+	      mappedData_p+dataStart,
+	      dataLength*sizeof(short));
+      return status;
+    }
 
     /* Start accessing the data within the HDF5 file */
     
@@ -822,7 +875,7 @@ namespace DAL {  // Namespace DAL -- begin
 			 memspaceID,
 			 dataspaceID,
 			 H5P_DEFAULT,
-			 data);
+			 data+dataOffset);
       // ... and indicate if there was an error during that procedure
       if (h5error < 0) {
 	cerr << "[TBB_DipoleDataset::readData]"
@@ -844,6 +897,139 @@ namespace DAL {  // Namespace DAL -- begin
     return status;
   }
   
+  //_____________________________________________________________________________
+  //                                                                      mapData
+
+  /*!
+    Mapping is possible for a one-dimensional dataset of native 16-bit integers,
+    stored contiguously and without filters in a file accessed through the
+    default (sec2) file driver; for any other dataset the object keeps reading
+    through the HDF5 library. Pending writes of the HDF5 library are flushed to
+    the file before it is mapped.
+
+    \return status -- Returns \e true if subsequent reads are served from the
+            mapping, \e false if the dataset is not suited for it or mapping
+            the file failed.
+  */
+  bool TBB_DipoleDataset::mapData ()
+  {
+    unmapData ();
+
+    if (location_p <= 0 || !H5Iis_valid(location_p)) {
+      return false;
+    }
+
+    /* Check the layout and datatype of the dataset */
+
+    bool suited      = false;
+    hid_t plist      = H5Dget_create_plist (location_p);
+    hid_t datatype   = H5Dget_type (location_p);
+    hsize_t length   = 0;
+    hid_t dataspace  = H5Dget_space (location_p);
+    haddr_t address  = HDF5Dataset::offset (location_p);
+
+    if (H5Sget_simple_extent_ndims (dataspace) == 1) {
+      H5Sget_simple_extent_dims (dataspace, &length, NULL);
+      suited = H5Pget_layout (plist) == H5D_CONTIGUOUS
+	&& H5Pget_nfilters (plist) == 0
+	&& H5Tequal (datatype, H5T_NATIVE_SHORT) > 0
+	&& address != HADDR_UNDEF
+	&& length > 0;
+    }
+
+    H5Sclose (dataspace);
+    H5Tclose (datatype);
+    H5Pclose (plist);
+
+    if (!suited) {
+      return false;
+    }
+
+    /* Locate the samples within the file */
+
+    hid_t fileID     = H5Iget_file_id (location_p);
+    hid_t fileAccess = H5Fget_access_plist (fileID);
+    hid_t fileCreate = H5Fget_create_plist (fileID);
+    hsize_t userblock = 0;
+    ssize_t nameLength = H5Fget_name (fileID, NULL, 0);
+    std::string filename;
+
+    suited = H5Pget_driver (fileAccess) == H5FD_SEC2
+      && H5Pget_userblock (fileCreate, &userblock) >= 0
+      && nameLength > 0
+      && H5Fflush (fileID, H5F_SCOPE_LOCAL) >= 0;
+
+    if (suited) {
+      std::vector<char> name (nameLength+1);
+      H5Fget_name (fileID, &name[0], name.size());
+      filename = &name[0];
+    }
+
+    H5Pclose (fileCreate);
+    H5Pclose (fileAccess);
+    H5Fclose (fileID);
+
+    if (!suited) {
+      return false;
+    }
+
+    /* Map the pages holding the samples */
+
+    off_t begin      = userblock + address;
+    size_t nofBytes  = length*sizeof(short);
+    long pageSize    = sysconf (_SC_PAGESIZE);
+    off_t pageOffset = begin % pageSize;
+    struct stat fileStatus;
+    int fd           = ::open (filename.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+      cerr << "[TBB_DipoleDataset::mapData] Failed to open file "
+	   << filename << endl;
+      return false;
+    }
+
+    if (fstat (fd, &fileStatus) == 0
+	&& begin + off_t(nofBytes) <= fileStatus.st_size) {
+      void *region = mmap (NULL,
+			   pageOffset + nofBytes,
+			   PROT_READ,
+			   MAP_SHARED,
+			   fd,
+			   begin - pageOffset);
+      if (region != MAP_FAILED) {
+	mappedRegion_p = region;
+	mappedSize_p   = pageOffset + nofBytes;
+	mappedData_p   = reinterpret_cast<short const*>(static_cast<char*>(region) + pageOffset);
+	mappedLength_p = length;
+      } else {
+	cerr << "[TBB_DipoleDataset::mapData] Failed to map file "
+	     << filename << endl;
+      }
+    } else {
+      cerr << "[TBB_DipoleDataset::mapData] Data reach beyond the end of file "
+	   << filename << endl;
+    }
+
+    ::close (fd);
+
+    return isMapped();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    unmapData
+
+  void TBB_DipoleDataset::unmapData ()
+  {
+    if (mappedRegion_p != NULL) {
+      munmap (mappedRegion_p, mappedSize_p);
+    }
+
+    mappedRegion_p = NULL;
+    mappedSize_p   = 0;
+    mappedData_p   = NULL;
+    mappedLength_p = 0;
+  }
+  
   // ============================================================================
   //
   //  Methods using casacore
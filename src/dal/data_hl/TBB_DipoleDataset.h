@@ -65,6 +65,20 @@ namespace DAL {  // Namespace DAL -- begin
 
     \image html TBB_DipoleDataset.png
 
+    <h3>Memory-mapped reading</h3>
+
+    Once a dump is complete, the dipole data are no longer changed but may be
+    read many times, e.g. in windows at random positions. If the dataset is
+    stored contiguously and without filters, mapData() maps its samples from
+    the file into memory, after which readData() copies the requested window
+    straight from the mapping instead of going through the hyperslab machinery
+    of the HDF5 library. Datasets written by the TBB and TBBraw classes are
+    chunked; the tool \t TBBrepack rewrites a finished dump into a file with
+    contiguous dipole datasets.
+
+    The mapping is not passed on to copies of the object and must not be used
+    while the dataset is still being written to.
+
     <h3>Example(s)</h3>
 
     <ul>
@@ -98,6 +112,14 @@ namespace DAL {  // Namespace DAL -- begin
     hid_t dataspace_p;
     //! Shape of the dataset
     std::vector<hsize_t> shape_p;    
+    //! Start of the memory-mapped region of the file
+    void *mappedRegion_p;
+    //! Size of the memory-mapped region [bytes]
+    size_t mappedSize_p;
+    //! First sample of the dataset within the mapped region
+    short const *mappedData_p;
+    //! Number of samples accessible through the mapping
+    hsize_t mappedLength_p;
     
   public:
 
@@ -120,6 +142,8 @@ namespace DAL {  // Namespace DAL -- begin
 		       uint const &rcuID,
 		       std::vector<hsize_t> const &shape,
 		       hid_t const &datatype=H5T_NATIVE_SHORT);
+    //! Copy constructor
+    TBB_DipoleDataset (TBB_DipoleDataset const &other);
     
     // === Destruction ==========================================================
     
@@ -143,6 +167,11 @@ namespace DAL {  // Namespace DAL -- begin
       return shape_p;
     }
 
+    //! Are the data served from a memory mapping of the file?
+    inline bool isMapped () const {
+      return mappedData_p != NULL;
+    }
+
     //! Get the time as Julian Day
     double julianDay (bool const &onlySeconds=false);
     
@@ -192,6 +221,10 @@ namespace DAL {  // Namespace DAL -- begin
     bool readData (int const &start,
 		   int const &nofSamples,
 		   short *data);
+    //! Serve subsequent reads from a memory mapping of the file
+    bool mapData ();
+    //! Release the memory mapping, reading through the HDF5 library again
+    void unmapData ();
     
     //! Get a number of data values as recorded for this dipole
     /*     bool readData (int const &start, */
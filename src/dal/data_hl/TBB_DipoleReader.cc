@@ -0,0 +1,316 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "TBB_DipoleReader.h"
+
+#include <time.h>
+
+using std::endl;
+
+namespace DAL {  // Namespace DAL -- begin
+
+#ifndef H5_HAVE_THREADSAFE
+  //! Serializes the HDF5 calls if the library is not thread-safe
+  static pthread_mutex_t hdf5Mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+  //! Seconds on the monotonic clock
+  static double monotonicTime ()
+  {
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return now.tv_sec + 1e-9*now.tv_nsec;
+  }
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                             TBB_DipoleReader
+
+  /*!
+    \param nofThreads -- Number of threads reading the data; with a single
+           thread no worker threads are started and the data are read by the
+           thread calling readData().
+  */
+  TBB_DipoleReader::TBB_DipoleReader (unsigned int const &nofThreads)
+  {
+    itsNofThreads   = nofThreads>0 ? nofThreads : 1;
+    itsShutdown     = false;
+    itsDatasets     = NULL;
+    itsStart        = NULL;
+    itsNofSamples   = 0;
+    itsData         = NULL;
+    itsStride       = 0;
+    itsReadFunction = NULL;
+    itsNext         = 0;
+    itsNofDone      = 0;
+    itsStatus       = true;
+    itsBatchTime    = 0;
+
+    pthread_mutex_init (&itsMutex, NULL);
+    pthread_cond_init (&itsWorkCondition, NULL);
+    pthread_cond_init (&itsDoneCondition, NULL);
+
+    if (itsNofThreads > 1) {
+      for (unsigned int n=0; n<itsNofThreads; ++n) {
+	pthread_t thread;
+	if (pthread_create (&thread, NULL, worker, this) == 0) {
+	  itsThreads.push_back (thread);
+	} else {
+	  std::cerr << "[TBB_DipoleReader] Failed to start worker thread "
+		    << n << endl;
+	}
+      }
+      itsNofThreads = itsThreads.empty() ? 1 : itsThreads.size();
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  TBB_DipoleReader::~TBB_DipoleReader ()
+  {
+    pthread_mutex_lock (&itsMutex);
+    itsShutdown = true;
+    pthread_cond_broadcast (&itsWorkCondition);
+    pthread_mutex_unlock (&itsMutex);
+
+    for (unsigned int n=0; n<itsThreads.size(); ++n) {
+      pthread_join (itsThreads[n], NULL);
+    }
+
+    pthread_cond_destroy (&itsDoneCondition);
+    pthread_cond_destroy (&itsWorkCondition);
+    pthread_mutex_destroy (&itsMutex);
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void TBB_DipoleReader::summary (std::ostream &os)
+  {
+    double total (0);
+    double slowest (0);
+
+    for (unsigned int n=0; n<itsReadTime.size(); ++n) {
+      total += itsReadTime[n];
+      if (itsReadTime[n] > slowest) {
+	slowest = itsReadTime[n];
+      }
+    }
+
+    os << "[TBB_DipoleReader] Summary of internal parameters." << endl;
+    os << "-- nof. threads             = " << itsNofThreads       << endl;
+    os << "-- nof. dipoles (last read) = " << itsReadTime.size()  << endl;
+    os << "-- Time of last read [s]    = " << itsBatchTime        << endl;
+    if (!itsReadTime.empty()) {
+      os << "-- Mean time per dipole [s] = " << total/itsReadTime.size() << endl;
+      os << "-- Max. time per dipole [s] = " << slowest           << endl;
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                    readBatch
+
+  /*!
+    \param datasets   -- Dipole datasets to read from.
+    \param start      -- Number of the sample at which to start reading, for
+           each of the datasets.
+    \param nofSamples -- Number of samples to read per dipole.
+    \retval data      -- Output array; the output of dipole <tt>n</tt> starts
+            at <tt>data+n*stride</tt>.
+    \param stride     -- Distance between the output of two dipoles [bytes].
+    \param function   -- Function reading a single dipole into its output.
+
+    \return status -- Status of the operation; returns \e false if any of the
+            reads failed.
+  */
+  bool TBB_DipoleReader::readBatch (std::vector<TBB_DipoleDataset*> const &datasets,
+				    std::vector<int> const &start,
+				    int const &nofSamples,
+				    char *data,
+				    size_t const &stride,
+				    ReadFunction function)
+  {
+    if (start.size() != datasets.size()) {
+      std::cerr << "[TBB_DipoleReader::readData]"
+		<< " Wrong length of vector with start positions!" << endl;
+      return false;
+    }
+
+    if (datasets.empty() || nofSamples < 1) {
+      itsReadTime.clear();
+      itsBatchTime = 0;
+      return true;
+    }
+
+    double start_t = monotonicTime();
+
+    pthread_mutex_lock (&itsMutex);
+
+    itsDatasets     = &datasets;
+    itsStart        = &start;
+    itsNofSamples   = nofSamples;
+    itsData         = data;
+    itsStride       = stride;
+    itsReadFunction = function;
+    itsNext         = 0;
+    itsNofDone      = 0;
+    itsStatus       = true;
+    itsReadTime.assign (datasets.size(), 0.0);
+
+    if (itsThreads.empty()) {
+      readDipoles ();
+    } else {
+      pthread_cond_broadcast (&itsWorkCondition);
+      while (itsNofDone < datasets.size()) {
+	pthread_cond_wait (&itsDoneCondition, &itsMutex);
+      }
+    }
+
+    bool status = itsStatus;
+    itsDatasets = NULL;
+    itsStart    = NULL;
+    itsData     = NULL;
+
+    pthread_mutex_unlock (&itsMutex);
+
+    itsBatchTime = monotonicTime() - start_t;
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      readRaw
+
+  /*!
+    \param dataset    -- Dipole dataset to read from.
+    \param start      -- Number of the sample at which to start reading.
+    \param nofSamples -- Number of samples to read.
+    \retval raw       -- [nofSamples] Array of raw ADC samples.
+
+    \return status -- Status of the operation; returns \e false in case an error
+            was encountered.
+  */
+  bool TBB_DipoleReader::readRaw (TBB_DipoleDataset &dataset,
+				  int const &start,
+				  int const &nofSamples,
+				  short *raw)
+  {
+#ifndef H5_HAVE_THREADSAFE
+    pthread_mutex_lock (&hdf5Mutex);
+#endif
+    bool status = dataset.readData (start, nofSamples, raw);
+#ifndef H5_HAVE_THREADSAFE
+    pthread_mutex_unlock (&hdf5Mutex);
+#endif
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       worker
+
+  /*!
+    \param reader -- The TBB_DipoleReader object owning the thread.
+  */
+  void * TBB_DipoleReader::worker (void *reader)
+  {
+    TBB_DipoleReader *self = static_cast<TBB_DipoleReader*>(reader);
+
+    pthread_mutex_lock (&self->itsMutex);
+
+    while (true) {
+      while (!self->itsShutdown
+	     && (self->itsDatasets == NULL
+		 || self->itsNext >= self->itsDatasets->size())) {
+	pthread_cond_wait (&self->itsWorkCondition, &self->itsMutex);
+      }
+      if (self->itsShutdown) {
+	break;
+      }
+      self->readDipoles ();
+    }
+
+    pthread_mutex_unlock (&self->itsMutex);
+
+    return NULL;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  readDipoles
+
+  /*!
+    Must be called with the mutex held; the mutex is released while a dipole is
+    being read and held again on return.
+  */
+  void TBB_DipoleReader::readDipoles ()
+  {
+    unsigned int nofDatasets = itsDatasets->size();
+
+    while (itsNext < nofDatasets) {
+      unsigned int n = itsNext++;
+      TBB_DipoleDataset *dataset = (*itsDatasets)[n];
+      int start                  = (*itsStart)[n];
+      int nofSamples             = itsNofSamples;
+      char *column               = itsData + n*itsStride;
+      ReadFunction function      = itsReadFunction;
+
+      pthread_mutex_unlock (&itsMutex);
+
+      double start_t = monotonicTime();
+      bool status    = function (*dataset, start, nofSamples, column);
+      double time    = monotonicTime() - start_t;
+
+      pthread_mutex_lock (&itsMutex);
+
+      itsReadTime[n] = time;
+      if (!status) {
+	itsStatus = false;
+      }
+      if (++itsNofDone == nofDatasets) {
+	pthread_cond_signal (&itsDoneCondition);
+      }
+    }
+  }
+
+} // Namespace DAL -- end
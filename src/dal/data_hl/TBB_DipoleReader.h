@@ -0,0 +1,350 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TBB_DIPOLEREADER_H
+#define TBB_DIPOLEREADER_H
+
+// Standard library header files
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include <data_hl/TBB_DipoleDataset.h>
+
+namespace DAL {  // Namespace DAL -- begin
+
+  /*!
+    \class TBB_DipoleReader
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Read the same window of samples from a set of dipole datasets
+
+    \author agent
+
+    \date 2026/10/17
+
+    \test tTBB_DipoleReader.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>TBB_DipoleDataset -- provides the read access to a single dipole.
+      <li>TBB_StationGroup, TBB_Timeseries -- collect the selected dipoles
+      into a batch for readData().
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    Reading a block of samples for all dipoles of one or more stations, as is
+    done e.g. by the cosmic-ray pipeline, amounts to one hyperslab read per
+    dipole. A reader distributes these reads onto a pool of worker threads,
+    which is started once and kept for the lifetime of the object; with a
+    single thread the reads are done directly by the calling thread.
+
+    The data are returned as array of shape [nofSamples,dipole], i.e. the
+    samples of a dipole are contiguous, as is the case for the columns of a
+    <tt>casa::Matrix<double></tt>; the distance between the first samples of
+    two dipoles can be set larger than <tt>nofSamples</tt>, e.g. to write into
+    a window of a larger array. The element type of the output is a template
+    parameter:
+    - <tt>short</tt> -- the raw ADC values are read straight into the output,
+      without any conversion;
+    - <tt>float</tt>, <tt>double</tt> -- the raw values are read into the
+      upper part of the dipole's output column and from there widened in
+      place, so no temporary buffer is involved. The widening is done in
+      chunks which do not overlap with the raw values still to be converted,
+      so that each chunk is a simple loop the compiler can vectorize.
+
+    The widening runs in parallel; the HDF5 calls themselves are serialized --
+    by the library if it has been built thread-safe, otherwise by a mutex held
+    during the read of a dipole.
+
+    The wall-clock time spent on each dipole of the last batch is available
+    through readTime().
+
+    <h3>Example(s)</h3>
+
+    \code
+    DAL::TBB_StationGroup group (fileID, "Station001");
+    DAL::TBB_DipoleReader reader (4);
+    std::vector<int> start (group.nofSelectedDatasets(), 0);
+    std::vector<float> data (nofSamples*group.nofSelectedDatasets());
+
+    group.readData (&data[0], start, nofSamples, reader);
+    reader.summary();
+    \endcode
+  */
+  class TBB_DipoleReader {
+
+    //! Read a single dipole into an output column of a given type
+    typedef bool (*ReadFunction) (TBB_DipoleDataset &dataset,
+				  int const &start,
+				  int const &nofSamples,
+				  void *data);
+
+    //! Number of threads reading the data
+    unsigned int itsNofThreads;
+    //! Worker threads
+    std::vector<pthread_t> itsThreads;
+    //! Mutex protecting the state of the current batch
+    pthread_mutex_t itsMutex;
+    //! Condition signaled when a batch is posted or the workers are stopped
+    pthread_cond_t itsWorkCondition;
+    //! Condition signaled when the last dipole of a batch has been read
+    pthread_cond_t itsDoneCondition;
+    //! Stop the worker threads?
+    bool itsShutdown;
+    //! Datasets of the current batch
+    std::vector<TBB_DipoleDataset*> const *itsDatasets;
+    //! Start positions of the current batch
+    std::vector<int> const *itsStart;
+    //! Number of samples per dipole of the current batch
+    int itsNofSamples;
+    //! Output array of the current batch
+    char *itsData;
+    //! Distance between the output columns of two dipoles [bytes]
+    size_t itsStride;
+    //! Function reading a single dipole of the current batch
+    ReadFunction itsReadFunction;
+    //! Index of the next dipole to be read
+    unsigned int itsNext;
+    //! Number of dipoles of the current batch that have been read
+    unsigned int itsNofDone;
+    //! Status of the current batch
+    bool itsStatus;
+    //! Wall-clock time spent on each dipole [s]
+    std::vector<double> itsReadTime;
+    //! Wall-clock time spent on the last batch [s]
+    double itsBatchTime;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Argumented constructor
+    TBB_DipoleReader (unsigned int const &nofThreads=1);
+
+    // === Destruction ==========================================================
+
+    //! Destructor
+    ~TBB_DipoleReader ();
+
+    // === Parameter access =====================================================
+
+    //! Number of threads reading the data
+    inline unsigned int nofThreads () const {
+      return itsNofThreads;
+    }
+
+    //! Wall-clock time spent on each dipole of the last batch [s]
+    inline std::vector<double> const & readTime () const {
+      return itsReadTime;
+    }
+
+    //! Wall-clock time spent on the last batch [s]
+    inline double batchTime () const {
+      return itsBatchTime;
+    }
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, TBB_DipoleReader.
+    */
+    inline std::string className () const {
+      return "TBB_DipoleReader";
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    // === Methods ==============================================================
+
+    /*!
+      \brief Read a block of samples for a set of dipoles
+
+      \param datasets   -- Dipole datasets to read from.
+      \param start      -- Number of the sample at which to start reading, for
+             each of the datasets.
+      \param nofSamples -- Number of samples to read per dipole.
+      \retval data      -- [nofSamples,dipole] Array of raw ADC samples; the
+              samples of dipole <tt>n</tt> start at <tt>data+n*stride</tt>.
+      \param stride     -- Distance between the first samples of two dipoles
+             in <tt>data</tt>; by default <tt>stride=nofSamples</tt>.
+
+      \return status -- Status of the operation; returns \e false if any of the
+              reads failed.
+    */
+    template <class T>
+      inline bool readData (std::vector<TBB_DipoleDataset*> const &datasets,
+			    std::vector<int> const &start,
+			    int const &nofSamples,
+			    T *data,
+			    size_t const &stride=0)
+      {
+	size_t columnStride = stride>0 ? stride : nofSamples;
+
+	if (columnStride < size_t(nofSamples)) {
+	  std::cerr << "[TBB_DipoleReader::readData]"
+		    << " Stride smaller than the number of samples!" << std::endl;
+	  return false;
+	}
+
+	return readBatch (datasets,
+			  start,
+			  nofSamples,
+			  reinterpret_cast<char*>(data),
+			  columnStride*sizeof(T),
+			  &readColumn<T>);
+      }
+
+    /*!
+      \brief Read a block of samples for a single dipole
+
+      \param dataset    -- Dipole dataset to read from.
+      \param start      -- Number of the sample at which to start reading.
+      \param nofSamples -- Number of samples to read.
+      \retval data      -- [nofSamples] Array of raw ADC samples.
+
+      \return status -- Status of the operation; returns \e false in case an
+              error was encountered.
+    */
+    template <class T>
+      static bool readData (TBB_DipoleDataset &dataset,
+			    int const &start,
+			    int const &nofSamples,
+			    T *data)
+      {
+	if (nofSamples < 1) {
+	  return true;
+	}
+
+	/* For T=short the raw values coincide with the output */
+	short *raw  = reinterpret_cast<short*>(data+nofSamples) - nofSamples;
+	bool status = readRaw (dataset, start, nofSamples, raw);
+
+	widen (raw, data, nofSamples);
+
+	return status;
+      }
+
+  private:
+
+    //! Read the raw values of a single dipole, serializing HDF5 if required
+    static bool readRaw (TBB_DipoleDataset &dataset,
+			 int const &start,
+			 int const &nofSamples,
+			 short *raw);
+
+    //! Read a single dipole into an output column of type T
+    template <class T>
+      static bool readColumn (TBB_DipoleDataset &dataset,
+			      int const &start,
+			      int const &nofSamples,
+			      void *data)
+      {
+	return readData (dataset, start, nofSamples, static_cast<T*>(data));
+      }
+
+    //! Convert non-overlapping arrays, in a loop the compiler can vectorize
+    template <class T>
+      static inline void convert (short const * __restrict src,
+				  T * __restrict dst,
+				  int const &nofSamples)
+      {
+	for (int n=0; n<nofSamples; ++n) {
+	  dst[n] = src[n];
+	}
+      }
+
+    /*!
+      \brief Widen the raw values in the upper part of <tt>data</tt> in place
+
+      The raw value of sample <tt>n</tt> is located behind the output value of
+      sample <tt>n</tt>, hence working upwards it is always converted before
+      its bytes are overwritten. Chunks are chosen such that they end before
+      the first raw value not yet converted; they shrink towards the end of
+      the array, so the last few samples are converted one at a time.
+    */
+    template <class T>
+      static void widen (short const *raw,
+			 T *data,
+			 int const &nofSamples)
+      {
+	char const *base = reinterpret_cast<char const*>(data);
+	int n (0);
+	short value;
+
+	while (nofSamples-n > 64) {
+	  size_t free = reinterpret_cast<char const*>(raw+n) - base;
+	  int chunk   = free/sizeof(T) - n;
+	  convert (raw+n, data+n, chunk);
+	  n += chunk;
+	}
+
+	/* Access the remaining raw values by memcpy, as they share memory with
+	   the output values */
+	for (; n<nofSamples; ++n) {
+	  memcpy (&value, raw+n, sizeof(short));
+	  data[n] = value;
+	}
+      }
+
+    //! Raw values are returned as they are
+    static inline void widen (short const *,
+			      short *,
+			      int const &)
+    {
+    }
+
+    //! Post a batch and wait for it to be completed
+    bool readBatch (std::vector<TBB_DipoleDataset*> const &datasets,
+		    std::vector<int> const &start,
+		    int const &nofSamples,
+		    char *data,
+		    size_t const &stride,
+		    ReadFunction function);
+
+    //! Entry point of the worker threads
+    static void * worker (void *reader);
+
+    //! Read dipoles of the current batch until none is left
+    void readDipoles ();
+
+    //! Unimplemented, the reader owns threads
+    TBB_DipoleReader (TBB_DipoleReader const &other);
+
+    //! Unimplemented, the reader owns threads
+    TBB_DipoleReader & operator= (TBB_DipoleReader const &other);
+
+  }; // Class TBB_DipoleReader -- end
+
+} // Namespace DAL -- end
+
+#endif /* TBB_DIPOLEREADER_H */
@@ -0,0 +1,304 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "TBB_FileIngest.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <unistd.h>
+
+using std::cerr;
+using std::endl;
+
+namespace DAL {  // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                               TBB_FileIngest
+
+  /*!
+    \param bufferSize -- Size of the buffer the file is read into [bytes]; this
+           also is the largest number of bytes a single call of read() is able
+           to hand out.
+  */
+  TBB_FileIngest::TBB_FileIngest (size_t const &bufferSize)
+  {
+    itsFile         = -1;
+    itsBufferSize   = bufferSize>0 ? bufferSize : DEFAULT_FILE_BUFFER_SIZE;
+    itsBuffer       = NULL;
+    itsPosition     = 0;
+    itsFill         = 0;
+    itsEndOfFile    = false;
+    itsNofBytesRead = 0;
+    itsNofBytesUsed = 0;
+    itsNofReads     = 0;
+    itsNofTruncated = 0;
+
+    void *buffer = NULL;
+    if (posix_memalign (&buffer, FILE_BUFFER_ALIGNMENT, itsBufferSize) != 0) {
+      cerr << "[TBB_FileIngest] Can't allocate buffer of " << itsBufferSize
+	   << " bytes" << endl;
+      itsBufferSize = 0;
+    }
+    itsBuffer = reinterpret_cast<char *>(buffer);
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  TBB_FileIngest::~TBB_FileIngest ()
+  {
+    close();
+    free (itsBuffer);
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         open
+
+  /*!
+    \param filename -- Name of the file to read.
+
+    \return status -- Returns \e true if the file was opened successfully.
+  */
+  bool TBB_FileIngest::open (std::string const &filename)
+  {
+    close();
+
+    if (itsBuffer == NULL) {
+      return false;
+    }
+
+    itsFile = ::open (filename.c_str(), O_RDONLY);
+    if (itsFile < 0) {
+      cerr << "[TBB_FileIngest::open] Can't open file " << filename << ": "
+	   << strerror(errno) << endl;
+      return false;
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise (itsFile, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    itsFilename     = filename;
+    itsPosition     = 0;
+    itsFill         = 0;
+    itsEndOfFile    = false;
+    itsNofBytesRead = 0;
+    itsNofBytesUsed = 0;
+    itsNofReads     = 0;
+    itsNofTruncated = 0;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        close
+
+  void TBB_FileIngest::close ()
+  {
+    if (itsFile >= 0) {
+      ::close (itsFile);
+    }
+    itsFile     = -1;
+    itsPosition = 0;
+    itsFill     = 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         fill
+
+  /*!
+    \param nofBytes -- Number of bytes which are required beyond the current
+           position.
+
+    \return status -- Returns \e true if the buffer holds at least
+            \e nofBytes bytes beyond the current position, \e false if the
+            file ended before.
+  */
+  bool TBB_FileIngest::fill (size_t const &nofBytes)
+  {
+    if (itsFill-itsPosition >= nofBytes) {
+      return true;
+    }
+    if (itsFile < 0 || itsEndOfFile) {
+      return false;
+    }
+    if (nofBytes > itsBufferSize) {
+      cerr << "[TBB_FileIngest::fill] Request for " << nofBytes
+	   << " bytes exceeds the buffer size " << itsBufferSize << endl;
+      return false;
+    }
+
+    /* Move the remaining bytes to the front of the buffer */
+    if (itsPosition > 0) {
+      memmove (itsBuffer, itsBuffer+itsPosition, itsFill-itsPosition);
+      itsFill    -= itsPosition;
+      itsPosition = 0;
+    }
+
+    /* Fill up the complete buffer */
+    while (itsFill < nofBytes) {
+      ssize_t nofRead = ::read (itsFile, itsBuffer+itsFill, itsBufferSize-itsFill);
+      if (nofRead < 0) {
+	if (errno == EINTR) {
+	  continue;
+	}
+	cerr << "[TBB_FileIngest::fill] Error reading " << itsFilename << ": "
+	     << strerror(errno) << endl;
+	itsEndOfFile = true;
+	return false;
+      }
+      ++itsNofReads;
+      if (nofRead == 0) {
+	itsEndOfFile = true;
+	return false;
+      }
+      itsFill         += nofRead;
+      itsNofBytesRead += nofRead;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          eof
+
+  /*!
+    \return eof -- Returns \e true if all bytes of the file have been handed
+            out or skipped.
+  */
+  bool TBB_FileIngest::eof ()
+  {
+    return !fill (1);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         read
+
+  /*!
+    \param nofBytes -- Number of bytes to get.
+
+    \return data -- Pointer to the next \e nofBytes bytes of the file, which
+            stays valid until the next call of read(), skip() or eof();
+            \e NULL if fewer bytes are left in the file, in which case the
+            remaining bytes are discarded.
+  */
+  char * TBB_FileIngest::read (size_t const &nofBytes)
+  {
+    if (!fill (nofBytes)) {
+      if (itsFill > itsPosition) {
+	++itsNofTruncated;
+	itsNofBytesUsed += itsFill-itsPosition;
+	itsPosition      = itsFill;
+      }
+      return NULL;
+    }
+
+    char *data = itsBuffer+itsPosition;
+    itsPosition     += nofBytes;
+    itsNofBytesUsed += nofBytes;
+
+    return data;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         skip
+
+  /*!
+    \param nofBytes -- Number of bytes to discard.
+
+    \return status -- Returns \e false if the file ended before \e nofBytes
+            bytes could be discarded.
+  */
+  bool TBB_FileIngest::skip (size_t const &nofBytes)
+  {
+    size_t remaining = nofBytes;
+    size_t step      = 0;
+
+    while (remaining > 0) {
+      if (itsPosition == itsFill && !fill (1)) {
+	++itsNofTruncated;
+	return false;
+      }
+      step = itsFill-itsPosition;
+      if (step > remaining) {
+	step = remaining;
+      }
+      itsPosition     += step;
+      itsNofBytesUsed += step;
+      remaining       -= step;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       swap16
+
+  /*!
+    \param data      -- Values to convert, in place; the block must be aligned
+           to 16-bit values.
+    \param nofValues -- Number of 16-bit values.
+  */
+  void TBB_FileIngest::swap16 (void *data,
+			       size_t const &nofValues)
+  {
+    uint16_t *values = reinterpret_cast<uint16_t *>(data);
+
+    for (size_t n=0; n < nofValues; ++n) {
+      values[n] = static_cast<uint16_t>((values[n] >> 8) | (values[n] << 8));
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void TBB_FileIngest::summary (std::ostream &os)
+  {
+    os << "[TBB_FileIngest] Summary of internal parameters"         << endl;
+    os << "-- Filename ..................... : " << itsFilename     << endl;
+    os << "-- Buffer size [bytes] .......... : " << itsBufferSize   << endl;
+    os << "-- nof. bytes read .............. : " << itsNofBytesRead << endl;
+    os << "-- nof. bytes used .............. : " << itsNofBytesUsed << endl;
+    os << "-- nof. read calls .............. : " << itsNofReads     << endl;
+    os << "-- nof. truncated requests ...... : " << itsNofTruncated << endl;
+  }
+
+} // Namespace DAL -- end
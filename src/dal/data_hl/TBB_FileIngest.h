@@ -0,0 +1,213 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TBB_FILEINGEST_H
+#define TBB_FILEINGEST_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <sys/types.h>
+
+//! Default size of the buffer the raw file is read into [bytes]
+#define DEFAULT_FILE_BUFFER_SIZE 4194304
+//! Alignment of the buffer the raw file is read into [bytes]
+#define FILE_BUFFER_ALIGNMENT 4096
+
+namespace DAL {  // Namespace DAL -- begin
+
+  /*!
+    \class TBB_FileIngest
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Bulk buffered reading of raw TBB dumps from a file
+
+    \author agent
+
+    \date 2026/10/17
+
+    \test tTBB_FileIngest.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>TBB class -- the converter of raw TBB dumps, which uses this class in
+      file mode.
+      <li>TBB_UDPIngest -- the counterpart of this class for data arriving
+      from the network.
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    A TBB frame consists of a header of 88 bytes, the payload of
+    <tt>n_samples_per_frame</tt> 16-bit samples -- or complex pairs of them
+    in spectral mode -- and a 4-byte CRC. Reading such a frame sample by
+    sample through a <tt>std::ifstream</tt> costs a call per two bytes; this
+    class instead reads the file in large blocks into an aligned buffer and
+    hands out the pieces of the frames in place:
+    - read() returns a pointer to the next \e n bytes within the buffer;
+      whenever fewer than \e n bytes are left, the remainder is moved to the
+      front of the buffer and the buffer is filled up again with as few
+      <tt>read()</tt> calls as possible;
+    - skip() discards bytes without copying them;
+    - the kernel is told that the file is read sequentially
+      (<tt>POSIX_FADV_SEQUENTIAL</tt>), so that it reads ahead generously;
+    - swap16() converts a block of 16-bit values to the other byte order in
+      a single loop which the compiler vectorises -- since the frames of a
+      TBB are little-endian, this only is required on big-endian hosts.
+
+    The data pointed to by read() remain valid until the next call of read(),
+    skip() or eof(). As all parts of a TBB frame have an even size, the
+    pointers to the payload are aligned to 16-bit values.
+
+    Plain <tt>read()</tt> calls are used instead of mapping the file into
+    memory, such that the input may also be a pipe or a device.
+
+    <h3>Example(s)</h3>
+
+    \code
+    TBB_FileIngest ingest;
+
+    if (ingest.open (filename)) {
+      char *header;
+      while ((header = ingest.read (88))) {
+        // ... evaluate the header
+        short *samples = (short *) ingest.read (2*nofSamples+4);
+      }
+    }
+    \endcode
+  */
+  class TBB_FileIngest {
+
+    //! File descriptor
+    int itsFile;
+    //! Name of the file
+    std::string itsFilename;
+    //! Size of the buffer [bytes]
+    size_t itsBufferSize;
+    //! Buffer the file is read into
+    char *itsBuffer;
+    //! Position of the next byte to hand out within the buffer
+    size_t itsPosition;
+    //! Number of valid bytes in the buffer
+    size_t itsFill;
+    //! Has the end of the file been reached?
+    bool itsEndOfFile;
+    //! Number of bytes read from the file
+    unsigned long long itsNofBytesRead;
+    //! Number of bytes handed out or skipped
+    unsigned long long itsNofBytesUsed;
+    //! Number of read() system calls
+    unsigned long long itsNofReads;
+    //! Number of requests which could not be served since the file ended
+    unsigned long long itsNofTruncated;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    TBB_FileIngest (size_t const &bufferSize=DEFAULT_FILE_BUFFER_SIZE);
+
+    // === Destruction ==========================================================
+
+    //! Destructor, closes the file
+    ~TBB_FileIngest ();
+
+    // === Parameter access =====================================================
+
+    //! Is the file open?
+    inline bool isOpen () const {
+      return itsFile >= 0;
+    }
+
+    //! Name of the file
+    inline std::string filename () const {
+      return itsFilename;
+    }
+
+    //! Size of the buffer the file is read into [bytes]
+    inline size_t bufferSize () const {
+      return itsBufferSize;
+    }
+
+    //! Number of bytes read from the file
+    inline unsigned long long nofBytesRead () const {
+      return itsNofBytesRead;
+    }
+
+    //! Number of bytes handed out by read() or discarded by skip()
+    inline unsigned long long nofBytesUsed () const {
+      return itsNofBytesUsed;
+    }
+
+    //! Number of read() system calls issued
+    inline unsigned long long nofReads () const {
+      return itsNofReads;
+    }
+
+    //! Number of requests which failed because the file ended
+    inline unsigned long long nofTruncated () const {
+      return itsNofTruncated;
+    }
+
+    // === Methods ==============================================================
+
+    //! Open a file for reading
+    bool open (std::string const &filename);
+
+    //! Close the file
+    void close ();
+
+    //! Check for the end of the file
+    bool eof ();
+
+    //! Get a pointer to the next bytes of the file
+    char * read (size_t const &nofBytes);
+
+    //! Discard the next bytes of the file
+    bool skip (size_t const &nofBytes);
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    // === Static methods =======================================================
+
+    //! Swap the byte order of a block of 16-bit values in place
+    static void swap16 (void *data,
+			size_t const &nofValues);
+
+  private:
+
+    //! Fill up the buffer such that it holds at least \e nofBytes bytes
+    bool fill (size_t const &nofBytes);
+
+  }; // class TBB_FileIngest -- end
+
+} // Namespace DAL -- end
+
+#endif /* TBB_FILEINGEST_H */
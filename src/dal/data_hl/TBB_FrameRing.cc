@@ -0,0 +1,460 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "TBB_FrameRing.h"
+
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+using std::endl;
+
+//! Read a position published by the other side of the ring
+#define RING_LOAD(x)    __atomic_load_n (&(x), __ATOMIC_ACQUIRE)
+//! Publish a position to the other side of the ring
+#define RING_STORE(x,v) __atomic_store_n (&(x), (v), __ATOMIC_RELEASE)
+
+namespace DAL {  // Namespace DAL -- begin
+
+  //! Tell the CPU that we are in a spin loop
+  static inline void cpuRelax ()
+  {
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__ ("pause");
+#endif
+  }
+
+  //! Seconds on the monotonic clock
+  static double monotonicTime ()
+  {
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return now.tv_sec + 1e-9*now.tv_nsec;
+  }
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                TBB_FrameRing
+
+  /*!
+    \param capacity -- Number of slots.
+    \param slotSize -- Size of a slot [bytes].
+    \param strategy -- Strategy to wait for the other side of the ring.
+  */
+  TBB_FrameRing::TBB_FrameRing (unsigned int const &capacity,
+				size_t const &slotSize,
+				WaitStrategy const &strategy)
+  {
+    itsCapacity = capacity>0 ? capacity : 1;
+    itsSlotSize = slotSize;
+    itsSlots    = new char [itsCapacity*itsSlotSize];
+    itsSizes    = new int [itsCapacity];
+    itsStrategy = strategy;
+
+    itsHead            = 0;
+    itsTailCache       = 0;
+    itsNofFull         = 0;
+    itsHighWater       = 0;
+    itsClosed          = 0;
+    itsProducerWaiting = 0;
+
+    itsTail            = 0;
+    itsHeadCache       = 0;
+    itsNofEmpty        = 0;
+    itsConsumerWaiting = 0;
+
+    pthread_mutex_init (&itsMutex, NULL);
+    pthread_cond_init (&itsCondition, NULL);
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  TBB_FrameRing::~TBB_FrameRing ()
+  {
+    pthread_cond_destroy (&itsCondition);
+    pthread_mutex_destroy (&itsMutex);
+    delete [] itsSizes;
+    delete [] itsSlots;
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         size
+
+  unsigned int TBB_FrameRing::size () const
+  {
+    unsigned long long tail = RING_LOAD(itsTail);
+    unsigned long long head = RING_LOAD(itsHead);
+    return head - tail;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     isClosed
+
+  bool TBB_FrameRing::isClosed () const
+  {
+    return RING_LOAD(itsClosed) != 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    nofFrames
+
+  unsigned long long TBB_FrameRing::nofFrames () const
+  {
+    return RING_LOAD(itsHead);
+  }
+
+  // ============================================================================
+  //
+  //  Producer
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                     writable
+
+  /*!
+    \retval slots -- Pointer to the first free slot.
+    \retval sizes -- Pointer to the frame size of the first free slot.
+
+    \return nofSlots -- Number of free slots which can be filled consecutively;
+            0 if the ring is full.
+  */
+  unsigned int TBB_FrameRing::writable (char *&slots,
+					int *&sizes)
+  {
+    unsigned int position = itsHead%itsCapacity;
+    unsigned int toEnd    = itsCapacity-position;
+    unsigned int nofFree  = itsCapacity-(itsHead-itsTailCache);
+
+    /* Only look at the consumer's cache line if the own copy is limiting */
+    if (nofFree < toEnd) {
+      itsTailCache = RING_LOAD(itsTail);
+      nofFree      = itsCapacity-(itsHead-itsTailCache);
+    }
+    if (nofFree == 0) {
+      ++itsNofFull;
+      return 0;
+    }
+
+    slots = itsSlots + position*itsSlotSize;
+    sizes = itsSizes + position;
+
+    return nofFree<toEnd ? nofFree : toEnd;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       commit
+
+  /*!
+    \param n -- Number of slots, obtained through writable(), which have been
+           filled and are handed to the consumer.
+  */
+  void TBB_FrameRing::commit (unsigned int const &n)
+  {
+    if (n == 0) {
+      return;
+    }
+
+    unsigned long long head = itsHead+n;
+    RING_STORE(itsHead, head);
+
+    unsigned int fill = head-__atomic_load_n(&itsTail, __ATOMIC_RELAXED);
+    if (fill > itsHighWater) {
+      itsHighWater = fill;
+    }
+
+    notify (&itsConsumerWaiting);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 waitWritable
+
+  /*!
+    \param timeout -- Maximum time to wait [sec]; negative to wait indefinitely.
+
+    \return status -- \e true if there is a free slot, \e false if the time-out
+            expired.
+  */
+  bool TBB_FrameRing::waitWritable (double const &timeout)
+  {
+    return wait (&TBB_FrameRing::canWrite, &itsProducerWaiting, timeout);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        close
+
+  void TBB_FrameRing::close ()
+  {
+    RING_STORE(itsClosed, 1);
+    notify (&itsConsumerWaiting);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     canWrite
+
+  bool TBB_FrameRing::canWrite ()
+  {
+    itsTailCache = RING_LOAD(itsTail);
+    return itsHead-itsTailCache < itsCapacity;
+  }
+
+  // ============================================================================
+  //
+  //  Consumer
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                     readable
+
+  /*!
+    \retval slots -- Pointer to the first filled slot.
+    \retval sizes -- Pointer to the frame size of the first filled slot.
+
+    \return nofFrames -- Number of frames which can be processed consecutively;
+            0 if the ring is empty.
+  */
+  unsigned int TBB_FrameRing::readable (char *&slots,
+					int *&sizes)
+  {
+    unsigned int position = itsTail%itsCapacity;
+    unsigned int toEnd    = itsCapacity-position;
+    unsigned int nofReady = itsHeadCache-itsTail;
+
+    /* Only look at the producer's cache line if the own copy is limiting */
+    if (nofReady < toEnd) {
+      itsHeadCache = RING_LOAD(itsHead);
+      nofReady     = itsHeadCache-itsTail;
+    }
+    if (nofReady == 0) {
+      return 0;
+    }
+
+    slots = itsSlots + position*itsSlotSize;
+    sizes = itsSizes + position;
+
+    return nofReady<toEnd ? nofReady : toEnd;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      release
+
+  /*!
+    \param n -- Number of frames, obtained through readable(), which have been
+           processed; their slots are handed back to the producer.
+  */
+  void TBB_FrameRing::release (unsigned int const &n)
+  {
+    if (n == 0) {
+      return;
+    }
+
+    RING_STORE(itsTail, itsTail+n);
+
+    notify (&itsProducerWaiting);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 waitReadable
+
+  /*!
+    \param timeout -- Maximum time to wait [sec]; negative to wait indefinitely.
+
+    \return status -- \e true if there is at least one frame, \e false if the
+            time-out expired or the ring has been closed and is empty.
+  */
+  bool TBB_FrameRing::waitReadable (double const &timeout)
+  {
+    if (!canRead()) {
+      ++itsNofEmpty;
+      wait (&TBB_FrameRing::canRead, &itsConsumerWaiting, timeout);
+    }
+    return itsHeadCache != itsTail;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      canRead
+
+  bool TBB_FrameRing::canRead ()
+  {
+    /* The closed flag has to be read first: once it is set, the head no longer
+       changes and the final frames are guaranteed to be seen. */
+    int closed   = RING_LOAD(itsClosed);
+    itsHeadCache = RING_LOAD(itsHead);
+    return itsHeadCache != itsTail || closed;
+  }
+
+  // ============================================================================
+  //
+  //  Waiting
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                      backoff
+
+  /*!
+    The first calls spin, the following ones yield the processor, after that
+    the calling thread sleeps for intervals growing from 1 &mu;s to 1 ms.
+
+    \param round -- Number of times the caller has been waiting already; set
+           to zero once there is work again.
+  */
+  void TBB_FrameRing::backoff (unsigned int &round)
+  {
+    if (round < 64) {
+      cpuRelax ();
+    } else if (round < 80) {
+      sched_yield ();
+    } else {
+      unsigned int exponent = round-80;
+      usleep (1u << (exponent<10 ? exponent : 10));
+    }
+    if (round < 1000) {
+      ++round;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         wait
+
+  /*!
+    \param ready   -- Condition the calling side waits for.
+    \param waiting -- Flag of the calling side, announcing that it sleeps on
+           the condition variable.
+    \param timeout -- Maximum time to wait [sec]; negative to wait indefinitely.
+
+    \return status -- \e true if the condition was met.
+  */
+  bool TBB_FrameRing::wait (bool (TBB_FrameRing::*ready)(),
+			    int *waiting,
+			    double const &timeout)
+  {
+    double deadline   = timeout<0 ? 0 : monotonicTime()+timeout;
+    unsigned int round = 0;
+
+    while (!(this->*ready)()) {
+      double remaining = 0.01;
+      if (timeout >= 0) {
+	remaining = deadline-monotonicTime();
+	if (remaining <= 0) {
+	  return false;
+	} else if (remaining > 0.01) {
+	  remaining = 0.01;
+	}
+      }
+
+      switch (itsStrategy) {
+      case SpinWait:
+	cpuRelax ();
+	break;
+      case BackoffWait:
+	backoff (round);
+	break;
+      case BlockingWait:
+	{
+	  /* Sleep in slices of at most 10 ms, so that a time-out is honoured
+	     independent of the clock used by the condition variable. */
+	  struct timespec until;
+	  clock_gettime (CLOCK_REALTIME, &until);
+	  until.tv_nsec += long(remaining*1e9);
+	  if (until.tv_nsec >= 1000000000L) {
+	    until.tv_sec  += 1;
+	    until.tv_nsec -= 1000000000L;
+	  }
+	  pthread_mutex_lock (&itsMutex);
+	  RING_STORE(*waiting, 1);
+	  __atomic_thread_fence (__ATOMIC_SEQ_CST);
+	  if (!(this->*ready)()) {
+	    pthread_cond_timedwait (&itsCondition, &itsMutex, &until);
+	  }
+	  RING_STORE(*waiting, 0);
+	  pthread_mutex_unlock (&itsMutex);
+	}
+	break;
+      }
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       notify
+
+  /*!
+    \param waiting -- Flag of the other side, announcing that it sleeps on the
+           condition variable.
+  */
+  void TBB_FrameRing::notify (int *waiting)
+  {
+    if (itsStrategy != BlockingWait) {
+      return;
+    }
+    /* Pairs with the fence in wait(): either the other side sees the new
+       position, or we see its flag. */
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+    if (RING_LOAD(*waiting)) {
+      pthread_mutex_lock (&itsMutex);
+      pthread_cond_broadcast (&itsCondition);
+      pthread_mutex_unlock (&itsMutex);
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void TBB_FrameRing::summary (std::ostream &os)
+  {
+    os << "[TBB_FrameRing] Summary of internal parameters"       << endl;
+    os << "-- Capacity [slots] ............. : " << itsCapacity  << endl;
+    os << "-- Slot size [bytes] ............ : " << itsSlotSize  << endl;
+    os << "-- Wait strategy ................ : " << itsStrategy  << endl;
+    os << "-- nof. frames committed ........ : " << nofFrames()  << endl;
+    os << "-- nof. frames in the ring ...... : " << size()       << endl;
+    os << "-- High-water mark [frames] ..... : " << itsHighWater << endl;
+    os << "-- Producer found ring full ..... : " << itsNofFull   << endl;
+    os << "-- Consumer had to wait ......... : " << itsNofEmpty  << endl;
+  }
+
+} // Namespace DAL -- end
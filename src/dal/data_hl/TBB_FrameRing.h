@@ -0,0 +1,294 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TBB_FRAMERING_H
+#define TBB_FRAMERING_H
+
+// Standard library header files
+#include <iostream>
+#include <pthread.h>
+
+//! Size of a cache line [bytes], used to keep producer and consumer apart
+#define CACHE_LINE_SIZE 64
+
+namespace DAL {  // Namespace DAL -- begin
+
+  /*!
+    \class TBB_FrameRing
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Lock-free single-producer/single-consumer ring of frame slots
+
+    \author agent
+
+    \date 2026/10/17
+
+    \test tTBB_FrameRing.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>TBB_UDPIngest -- fills the slots of the ring straight from the socket.
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    Input buffer between the thread reading the frames of a port and the
+    thread processing them. Exactly one thread may act as producer, i.e. call
+    writable(), commit(), waitWritable() and close(), and exactly one thread as
+    consumer, i.e. call readable(), release() and waitReadable(); under this
+    condition no lock is needed:
+    - the write and read positions are monotonic 64-bit counters, each of them
+      written by one side only and published with release/acquire semantics;
+    - both positions live on cache lines of their own, together with a
+      private copy of the other side's position, so that the two threads only
+      touch each other's cache line when their copy runs out of date;
+    - frames are handed over in contiguous batches of slots, so that a batch
+      received by a single <tt>recvmmsg()</tt> costs one commit.
+
+    A full ring is never overwritten: the producer either waits for the
+    consumer (backpressure) or leaves the frames where they are, e.g. in the
+    kernel buffer of the socket. How often that happened is recorded, together
+    with the highest fill level reached, see summary().
+
+    When a side has to wait, the following strategies are available:
+    - <tt>SpinWait</tt> -- poll continuously (lowest latency, burns a core);
+    - <tt>BackoffWait</tt> -- spin briefly, then yield, then sleep for
+      exponentially growing intervals of up to 1 ms;
+    - <tt>BlockingWait</tt> -- sleep on a condition variable, which is only
+      signaled if the other side has announced that it is waiting.
+
+    <h3>Example(s)</h3>
+
+    Producer:
+    \code
+    char *slots;
+    int *sizes;
+    unsigned int nofSlots = ring.writable (slots, sizes);
+    int n = ingest.receive (slots, ring.slotSize(), nofSlots);
+    for (int i=0; i<n; ++i) sizes[i] = ingest.datagramSize(i);
+    ring.commit (n);
+    \endcode
+
+    Consumer:
+    \code
+    while (ring.waitReadable (timeout)) {
+      unsigned int n = ring.readable (slots, sizes);
+      for (unsigned int i=0; i<n; ++i) {
+        tbb.processTBBrawBlock (slots + i*ring.slotSize(), sizes[i]);
+      }
+      ring.release (n);
+    }
+    \endcode
+  */
+  class TBB_FrameRing {
+
+  public:
+
+    //! Strategy to wait for the other side of the ring
+    enum WaitStrategy {
+      //! Poll continuously
+      SpinWait,
+      //! Spin, yield, then sleep for growing intervals
+      BackoffWait,
+      //! Sleep on a condition variable
+      BlockingWait
+    };
+
+  private:
+
+    // --- Shared, read-only after construction --------------------------------
+
+    //! Number of slots
+    unsigned int itsCapacity;
+    //! Size of a slot [bytes]
+    size_t itsSlotSize;
+    //! The slots
+    char *itsSlots;
+    //! Size of the frame stored in each slot
+    int *itsSizes;
+    //! Strategy to wait for the other side
+    WaitStrategy itsStrategy;
+    //! Mutex protecting the condition variable (BlockingWait only)
+    pthread_mutex_t itsMutex;
+    //! Condition signaled on commit/release/close (BlockingWait only)
+    pthread_cond_t itsCondition;
+
+    char itsPad0[CACHE_LINE_SIZE];
+
+    // --- Written by the producer ---------------------------------------------
+
+    //! Number of frames committed so far (write position)
+    unsigned long long itsHead;
+    //! Producer's copy of the read position
+    unsigned long long itsTailCache;
+    //! Number of times the producer found the ring full
+    unsigned long long itsNofFull;
+    //! Highest number of frames held by the ring
+    unsigned int itsHighWater;
+    //! No more frames will be committed
+    int itsClosed;
+    //! Producer is sleeping on the condition variable
+    int itsProducerWaiting;
+
+    char itsPad1[CACHE_LINE_SIZE];
+
+    // --- Written by the consumer ---------------------------------------------
+
+    //! Number of frames released so far (read position)
+    unsigned long long itsTail;
+    //! Consumer's copy of the write position
+    unsigned long long itsHeadCache;
+    //! Number of times the consumer found the ring empty
+    unsigned long long itsNofEmpty;
+    //! Consumer is sleeping on the condition variable
+    int itsConsumerWaiting;
+
+    char itsPad2[CACHE_LINE_SIZE];
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Argumented constructor
+    TBB_FrameRing (unsigned int const &capacity,
+		   size_t const &slotSize,
+		   WaitStrategy const &strategy=BackoffWait);
+
+    // === Destruction ==========================================================
+
+    //! Destructor
+    ~TBB_FrameRing ();
+
+    // === Parameter access =====================================================
+
+    //! Number of slots
+    inline unsigned int capacity () const {
+      return itsCapacity;
+    }
+
+    //! Size of a slot [bytes]
+    inline size_t slotSize () const {
+      return itsSlotSize;
+    }
+
+    //! Strategy to wait for the other side
+    inline WaitStrategy waitStrategy () const {
+      return itsStrategy;
+    }
+
+    //! Number of frames currently held by the ring
+    unsigned int size () const;
+
+    //! Is the ring empty?
+    inline bool empty () const {
+      return size() == 0;
+    }
+
+    //! Has the producer closed the ring?
+    bool isClosed () const;
+
+    //! Number of frames committed since construction
+    unsigned long long nofFrames () const;
+
+    //! Highest number of frames held by the ring at once
+    inline unsigned int highWaterMark () const {
+      return itsHighWater;
+    }
+
+    //! Number of times the producer found the ring full
+    inline unsigned long long nofFull () const {
+      return itsNofFull;
+    }
+
+    //! Number of times the consumer found the ring empty
+    inline unsigned long long nofEmpty () const {
+      return itsNofEmpty;
+    }
+
+    // === Producer =============================================================
+
+    //! Get the free slots, contiguous from the write position
+    unsigned int writable (char *&slots,
+			   int *&sizes);
+
+    //! Publish the first \e n slots obtained through writable()
+    void commit (unsigned int const &n);
+
+    //! Wait until there is at least one free slot
+    bool waitWritable (double const &timeout);
+
+    //! Announce that no more frames will be committed
+    void close ();
+
+    // === Consumer =============================================================
+
+    //! Get the filled slots, contiguous from the read position
+    unsigned int readable (char *&slots,
+			   int *&sizes);
+
+    //! Hand the first \e n slots obtained through readable() back
+    void release (unsigned int const &n);
+
+    //! Wait until there is at least one frame
+    bool waitReadable (double const &timeout);
+
+    // === Methods ==============================================================
+
+    //! Wait a little longer with every call, reset \e round to start over
+    static void backoff (unsigned int &round);
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+  private:
+
+    //! Unimplemented, the ring cannot be copied
+    TBB_FrameRing (TBB_FrameRing const &other);
+
+    //! Unimplemented, the ring cannot be copied
+    TBB_FrameRing & operator= (TBB_FrameRing const &other);
+
+    //! Wait for the condition \e ready of the own side
+    bool wait (bool (TBB_FrameRing::*ready)(),
+	       int *waiting,
+	       double const &timeout);
+
+    //! Wake up the other side, if it is sleeping
+    void notify (int *waiting);
+
+    //! Producer: is there a free slot?
+    bool canWrite ();
+
+    //! Consumer: is there a frame (or has the ring been closed)?
+    bool canRead ();
+
+  }; // class TBB_FrameRing -- end
+
+} // Namespace DAL -- end
+
+#endif /* TBB_FRAMERING_H */
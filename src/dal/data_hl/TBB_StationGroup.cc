@@ -682,6 +682,48 @@ namespace DAL {  // Namespace DAL -- begin
   }
 #endif
 
+  //_____________________________________________________________________________
+  //                                                             selectedDatasets
+  
+  /*!
+    \return datasets -- Pointers to the selected dipole datasets, in the order
+            in which their data are returned by readData().
+  */
+  std::vector<TBB_DipoleDataset*> TBB_StationGroup::selectedDatasets ()
+  {
+    std::vector<TBB_DipoleDataset*> datasets;
+    std::map<std::string,iterDipoleDataset>::iterator it;
+
+    datasets.reserve (selectedDatasets_p.size());
+    for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
+      datasets.push_back (&(it->second->second));
+    }
+
+    return datasets;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      mapData
+  
+  /*!
+    \return nofMapped -- The number of selected dipole datasets whose data are
+            served from a memory mapping; the others, e.g. if they are stored
+            in chunks, continue to be read through the HDF5 library.
+  */
+  uint TBB_StationGroup::mapData ()
+  {
+    uint nofMapped (0);
+    std::map<std::string,iterDipoleDataset>::iterator it;
+
+    for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
+      if (it->second->second.mapData()) {
+	++nofMapped;
+      }
+    }
+
+    return nofMapped;
+  }
+
   // ============================================================================
   //
   //  Methods using casacore
@@ -703,6 +745,30 @@ namespace DAL {  // Namespace DAL -- begin
   bool TBB_StationGroup::readData (casa::Matrix<double> &data,
 				   casa::Vector<int> const &start,
 				   int const &nofSamples)
+  {
+    TBB_DipoleReader reader;
+
+    return readData (data,
+		     start,
+		     nofSamples,
+		     reader);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                     readData
+  
+  /*!
+    \retval data -- [nofSamples,dipole] Array of raw ADC samples representing
+            the electric field strength as function of time.
+    \param start      -- Number of the sample at which to start reading
+    \param nofSamples -- Number of samples to read, starting from the position
+           given by <tt>start</tt>.
+    \param reader     -- Reader performing the reads of the individual dipoles.
+  */
+  bool TBB_StationGroup::readData (casa::Matrix<double> &data,
+				   casa::Vector<int> const &start,
+				   int const &nofSamples,
+				   TBB_DipoleReader &reader)
   {
     uint nofDipoles = selectedDatasets_p.size();
     uint nelem      = start.nelements();
@@ -729,21 +795,17 @@ namespace DAL {  // Namespace DAL -- begin
 
     // Retrieve data from file _____________________________
     
-    bool status (true);
-    uint n (0);
-    casa::Vector<double> tmp (nofSamples);
-    std::map<std::string,iterDipoleDataset>::iterator it;
-    
-    /* Iterate over the selected dipoles */
-    for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
-      /* Retrieve dipole data */
-      tmp = (it->second)->second.readData(start(n),nofSamples);
-      /* Copy the data to the returned array */
-      data.column(n) = tmp;
-      /* Increment data array column counter */
-      ++n;
+    std::vector<int> startVect (nofDipoles);
+    for (uint n=0; n<nofDipoles; ++n) {
+      startVect[n] = start(n);
     }
 
+    /* The columns of the matrix are filled directly */
+    bool status = readData (data.data(),
+			    startVect,
+			    nofSamples,
+			    reader);
+
     // Feedback ____________________________________________
 
 #ifdef DAL_DEBUGGING_MESSAGES
@@ -34,6 +34,7 @@
 
 #include <data_common/HDF5CommonInterface.h>
 #include <data_hl/TBB_DipoleDataset.h>
+#include <data_hl/TBB_DipoleReader.h>
 #include <data_hl/TBB_StationTrigger.h>
 
 namespace DAL {   // Namespace DAL -- begin
@@ -299,6 +300,46 @@ namespace DAL {   // Namespace DAL -- begin
     std::vector<std::string> dipoleNames ();
     //! Retrieve the list of channels IDs contained within this group
     std::vector<int> dipoleNumbers ();
+    //! Get the selected dipole datasets
+    std::vector<TBB_DipoleDataset*> selectedDatasets ();
+    //! Serve reads of the selected dipoles from memory mappings of the file
+    uint mapData ();
+    
+    /*!
+      \brief Retrieve a block of ADC values for the dipoles in this station
+
+      \retval data -- [nofSamples,dipole] Array of raw ADC samples representing
+              the electric field strength as function of time, as
+              <tt>short</tt>, <tt>float</tt> or <tt>double</tt>; the samples
+              of the n-th selected dipole start at <tt>data+n*stride</tt>.
+      \param start      -- Number of the sample at which to start reading, for
+             each of the selected dipoles.
+      \param nofSamples -- Number of samples to read, starting from the position
+             given by <tt>start</tt>.
+      \param reader     -- Reader performing the reads of the individual
+             dipoles; the time spent per dipole can be retrieved from it
+             afterwards.
+      \param stride     -- Distance between the first samples of two dipoles in
+             <tt>data</tt>; by default <tt>stride=nofSamples</tt>.
+
+      \return status -- Status of the operation; returns \e false in case an
+              error was encountered.
+    */
+    template <class T>
+      inline bool readData (T *data,
+			    std::vector<int> const &start,
+			    int const &nofSamples,
+			    TBB_DipoleReader &reader,
+			    size_t const &stride=0)
+      {
+	if (start.size() != selectedDatasets_p.size()) {
+	  std::cerr << "[TBB_StationGroup::readData]"
+		    << " Wrong length of vector with start positions!"
+		    << std::endl;
+	  return false;
+	}
+	return reader.readData (selectedDatasets(), start, nofSamples, data, stride);
+      }
     
     /*!
       \brief Convert individual ID number to joint unique ID
@@ -349,6 +390,12 @@ namespace DAL {   // Namespace DAL -- begin
 		   casa::Vector<int> const &start,
 		   int const &nofSamples);
     
+    //! Retrieve a block of ADC values for the dipoles in this station
+    bool readData (casa::Matrix<double> &data,
+		   casa::Vector<int> const &start,
+		   int const &nofSamples,
+		   TBB_DipoleReader &reader);
+    
     //! Get a casa::Record containing the values of the attributes
     casa::Record attributes2record (bool const &recursive=false);
     
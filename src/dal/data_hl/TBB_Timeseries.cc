@@ -1157,6 +1157,31 @@ namespace DAL {  // Namespace DAL -- begin
   bool TBB_Timeseries::readData (casa::Matrix<double> &data,
 				 casa::Vector<int> const &start,
 				 int const &nofSamples)
+  {
+    TBB_DipoleReader reader;
+
+    return readData (data,
+		     start,
+		     nofSamples,
+		     reader);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                     readData
+  
+  /*!
+    \retval data -- [nofSamples,dipole] Array of raw ADC samples representing
+            the electric field strength as function of time.
+    \param start      -- Number of the sample at which to start reading, for
+           each of the selected dipoles.
+    \param nofSamples -- Number of samples to read, starting from the position
+           given by <tt>start</tt>.
+    \param reader     -- Reader performing the reads of the individual dipoles.
+  */
+  bool TBB_Timeseries::readData (casa::Matrix<double> &data,
+				 casa::Vector<int> const &start,
+				 int const &nofSamples,
+				 TBB_DipoleReader &reader)
   {
     uint sizeSelection = selectedDatasets_p.size();
     uint sizeStart     = start.nelements();
@@ -1183,21 +1208,17 @@ namespace DAL {  // Namespace DAL -- begin
     
     // Retrieve data from file _____________________________
     
-    bool status (true);
-    uint n (0);
-    casa::Vector<double> tmp (nofSamples);
-    std::map<std::string,iterDipoleDataset>::iterator it;
-    
-    /* Iterate over the selected dipoles */
-    for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
-      /* Retrieve dipole data */
-      tmp = (it->second)->second.readData(start(n),nofSamples);
-      /* Copy the data to the returned array */
-      data.column(n) = tmp;
-      /* Increment data array column counter */
-      ++n;
+    std::vector<int> startVect (sizeSelection);
+    for (uint n=0; n<sizeSelection; ++n) {
+      startVect[n] = start(n);
     }
 
+    /* The columns of the matrix are filled directly */
+    bool status = readData (data.data(),
+			    startVect,
+			    nofSamples,
+			    reader);
+
     // Feedback ____________________________________________
 
 #ifdef DAL_DEBUGGING_MESSAGES
@@ -1212,6 +1233,26 @@ namespace DAL {  // Namespace DAL -- begin
   
 #endif
   
+  //_____________________________________________________________________________
+  //                                                             selectedDatasets
+  
+  /*!
+    \return datasets -- Pointers to the selected dipole datasets, in the order
+            in which their data are returned by readData().
+  */
+  std::vector<TBB_DipoleDataset*> TBB_Timeseries::selectedDatasets ()
+  {
+    std::vector<TBB_DipoleDataset*> datasets;
+    std::map<std::string,iterDipoleDataset>::iterator it;
+
+    datasets.reserve (selectedDatasets_p.size());
+    for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
+      datasets.push_back (&(it->second->second));
+    }
+
+    return datasets;
+  }
+
   // ============================================================================
   //
   //  Methods using casacore
@@ -367,6 +367,44 @@ namespace DAL {  // Namespace DAL -- begin
     std::vector<int> channelID ();
     //! Get the Nyquist zone for the A/D conversion
     std::vector<uint> nyquist_zone ();
+    //! Get the selected dipole datasets
+    std::vector<TBB_DipoleDataset*> selectedDatasets ();
+    
+    /*!
+      \brief Retrieve a block of ADC values per dipole
+
+      \retval data -- [nofSamples,dipole] Array of raw ADC samples representing
+              the electric field strength as function of time, as
+              <tt>short</tt>, <tt>float</tt> or <tt>double</tt>; the samples
+              of the n-th selected dipole start at <tt>data+n*stride</tt>.
+      \param start      -- Number of the sample at which to start reading, for
+             each of the selected dipoles.
+      \param nofSamples -- Number of samples to read, starting from the position
+             given by <tt>start</tt>.
+      \param reader     -- Reader performing the reads of the individual
+             dipoles; the time spent per dipole can be retrieved from it
+             afterwards.
+      \param stride     -- Distance between the first samples of two dipoles in
+             <tt>data</tt>; by default <tt>stride=nofSamples</tt>.
+
+      \return status -- Status of the operation; returns \e false in case an
+              error was encountered.
+    */
+    template <class T>
+      inline bool readData (T *data,
+			    std::vector<int> const &start,
+			    int const &nofSamples,
+			    TBB_DipoleReader &reader,
+			    size_t const &stride=0)
+      {
+	if (start.size() != selectedDatasets_p.size()) {
+	  std::cerr << "[TBB_Timeseries::readData]"
+		    << " Wrong length of vector with start positions!"
+		    << std::endl;
+	  return false;
+	}
+	return reader.readData (selectedDatasets(), start, nofSamples, data, stride);
+      }
 
 #ifdef DAL_WITH_CASA
     //! Retrieve a block of ADC values per dipole
@@ -377,6 +415,11 @@ namespace DAL {  // Namespace DAL -- begin
     bool readData (casa::Matrix<double> &data,
 		   casa::Vector<int> const &start,
 		   int const &nofSamples=1);
+    //! Retrieve a block of ADC values per dipole
+    bool readData (casa::Matrix<double> &data,
+		   casa::Vector<int> const &start,
+		   int const &nofSamples,
+		   TBB_DipoleReader &reader);
     
     //  Parameter access - dipole dataset __________________
     
@@ -0,0 +1,359 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "TBB_UDPIngest.h"
+
+#include <cmath>
+#include <cstring>
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <arpa/inet.h>
+
+using std::cerr;
+using std::endl;
+
+namespace DAL {  // Namespace DAL -- begin
+
+  //! Size of the ancillary data buffer attached to a single datagram
+  static const size_t controlSize = CMSG_SPACE(sizeof(struct timespec))
+    + CMSG_SPACE(sizeof(uint32_t));
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                TBB_UDPIngest
+
+  /*!
+    \param batchSize -- Maximum number of datagrams fetched by a single call
+           of receive().
+  */
+  TBB_UDPIngest::TBB_UDPIngest (unsigned int const &batchSize)
+  {
+    itsSocket            = -1;
+    itsPort              = 0;
+    itsReceiveBufferSize = 0;
+    itsTimestamps        = false;
+    itsBatchSize         = batchSize>0 ? batchSize : 1;
+    itsNofDatagrams      = 0;
+    itsNofBatches        = 0;
+    itsNofTruncated      = 0;
+    itsMaxBatch          = 0;
+    itsDrops             = 0;
+
+    itsMessages.resize      (itsBatchSize);
+    itsIOVectors.resize     (itsBatchSize);
+    itsControl.resize       (itsBatchSize*controlSize);
+    itsDatagramSizes.resize (itsBatchSize, 0);
+    itsTimes.resize         (itsBatchSize);
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  TBB_UDPIngest::~TBB_UDPIngest ()
+  {
+    close();
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         open
+
+  /*!
+    \param port              -- UDP port to bind to; for port 0 the system
+           picks a free port, which can be retrieved through port().
+    \param receiveBufferSize -- Size of the kernel receive buffer to request
+           [bytes]; for values \f$ \leq 0 \f$ the system default is kept.
+    \param timestamps        -- Record the kernel receive time of every
+           datagram?
+
+    \return status -- Returns \e true if the socket was set up successfully.
+  */
+  bool TBB_UDPIngest::open (int const &port,
+			    int const &receiveBufferSize,
+			    bool const &timestamps)
+  {
+    close();
+
+    itsSocket = ::socket (PF_INET, SOCK_DGRAM, 0);
+    if (itsSocket < 0) {
+      cerr << "[TBB_UDPIngest::open] Failed to create socket: "
+	   << strerror(errno) << endl;
+      return false;
+    }
+
+    /* Enlarge the kernel receive buffer; SO_RCVBUFFORCE may exceed the limit
+       set by the system (net.core.rmem_max), but requires privileges. */
+    if (receiveBufferSize > 0) {
+      bool ok = false;
+#ifdef SO_RCVBUFFORCE
+      ok = (setsockopt (itsSocket, SOL_SOCKET, SO_RCVBUFFORCE,
+			&receiveBufferSize, sizeof(receiveBufferSize)) == 0);
+#endif
+      if (!ok) {
+	setsockopt (itsSocket, SOL_SOCKET, SO_RCVBUF,
+		    &receiveBufferSize, sizeof(receiveBufferSize));
+      }
+    }
+    socklen_t optlen = sizeof(itsReceiveBufferSize);
+    getsockopt (itsSocket, SOL_SOCKET, SO_RCVBUF, &itsReceiveBufferSize, &optlen);
+
+    int on = 1;
+#ifdef SO_RXQ_OVFL
+    setsockopt (itsSocket, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on));
+#endif
+    itsTimestamps = false;
+    if (timestamps) {
+#ifdef SO_TIMESTAMPNS
+      itsTimestamps = (setsockopt (itsSocket, SOL_SOCKET, SO_TIMESTAMPNS,
+				   &on, sizeof(on)) == 0);
+#endif
+      if (!itsTimestamps) {
+	cerr << "[TBB_UDPIngest::open] Kernel timestamps not available." << endl;
+      }
+    }
+
+    sockaddr_in local_info;
+    memset (&local_info, 0, sizeof(local_info));
+    local_info.sin_family      = AF_INET;
+    local_info.sin_addr.s_addr = htonl(INADDR_ANY);
+    local_info.sin_port        = htons(port);
+    if (bind (itsSocket, (sockaddr *) &local_info, sizeof(local_info)) < 0) {
+      cerr << "[TBB_UDPIngest::open] Failed to bind to port " << port << ": "
+	   << strerror(errno) << endl;
+      close();
+      return false;
+    }
+
+    optlen = sizeof(local_info);
+    getsockname (itsSocket, (sockaddr *) &local_info, &optlen);
+    itsPort = ntohs(local_info.sin_port);
+
+    itsNofDatagrams = 0;
+    itsNofBatches   = 0;
+    itsNofTruncated = 0;
+    itsMaxBatch     = 0;
+    itsDrops        = 0;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        close
+
+  void TBB_UDPIngest::close ()
+  {
+    if (itsSocket >= 0) {
+      ::close (itsSocket);
+    }
+    itsSocket = -1;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  waitForData
+
+  /*!
+    \param timeout -- Time to wait for data [sec]; a negative value waits
+           indefinitely, zero only polls the socket.
+
+    \return status -- Returns \e true if there is data waiting at the socket,
+            \e false if the time-out expired or the socket is not open.
+  */
+  bool TBB_UDPIngest::waitForData (double const &timeout)
+  {
+    if (itsSocket < 0) {
+      return false;
+    }
+
+    fd_set readSet;
+    FD_ZERO (&readSet);
+    FD_SET (itsSocket, &readSet);
+
+    if (timeout < 0) {
+      return select (itsSocket+1, &readSet, NULL, NULL, NULL) > 0;
+    }
+
+    struct timeval wait;
+    wait.tv_sec  = (time_t) floor(timeout);
+    wait.tv_usec = (suseconds_t) ((timeout-wait.tv_sec)*1e6);
+
+    return select (itsSocket+1, &readSet, NULL, NULL, &wait) > 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      receive
+
+  /*!
+    \retval slots    -- Buffer of (at least) \e nofSlots slots of \e slotSize
+            bytes each; datagram \e n of the batch is stored in slot \e n.
+    \param slotSize  -- Size of a slot [bytes]; datagrams larger than this
+            are truncated.
+    \param nofSlots  -- Number of free slots in the buffer; at most
+            batchSize() datagrams are fetched at once.
+    \param timeout   -- Time to wait for the first datagram [sec]; a negative
+            value waits indefinitely, zero only takes what is waiting.
+
+    \return nofDatagrams -- The number of datagrams received, 0 if no data
+            arrived within the time-out, -1 in case of an error. Size and
+            receive time of the datagrams can be retrieved through
+            datagramSize() and timestamp().
+  */
+  int TBB_UDPIngest::receive (char *slots,
+			      size_t const &slotSize,
+			      unsigned int const &nofSlots,
+			      double const &timeout)
+  {
+    if (itsSocket < 0) {
+      return -1;
+    }
+    if (nofSlots == 0) {
+      return 0;
+    }
+    if (timeout != 0 && !waitForData(timeout)) {
+      return 0;
+    }
+
+    unsigned int nofMessages = nofSlots<itsBatchSize ? nofSlots : itsBatchSize;
+
+    for (unsigned int n=0; n<nofMessages; ++n) {
+      itsIOVectors[n].iov_base = slots + n*slotSize;
+      itsIOVectors[n].iov_len  = slotSize;
+      struct msghdr &hdr = itsMessages[n].msg_hdr;
+      memset (&hdr, 0, sizeof(hdr));
+      hdr.msg_iov        = &itsIOVectors[n];
+      hdr.msg_iovlen     = 1;
+      hdr.msg_control    = &itsControl[n*controlSize];
+      hdr.msg_controllen = controlSize;
+      itsMessages[n].msg_len = 0;
+    }
+
+    int nofReceived = 0;
+#ifdef __linux__
+    nofReceived = recvmmsg (itsSocket, &itsMessages[0], nofMessages, MSG_DONTWAIT, NULL);
+#else
+    while (nofReceived < int(nofMessages)) {
+      ssize_t size = recvmsg (itsSocket, &itsMessages[nofReceived].msg_hdr, MSG_DONTWAIT);
+      if (size < 0) {
+	break;
+      }
+      itsMessages[nofReceived].msg_len = size;
+      ++nofReceived;
+    }
+    if (nofReceived == 0) {
+      nofReceived = -1;
+    }
+#endif
+
+    if (nofReceived < 0) {
+      if (errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR) {
+	return 0;
+      }
+      cerr << "[TBB_UDPIngest::receive] " << strerror(errno) << endl;
+      return -1;
+    }
+
+    for (int n=0; n<nofReceived; ++n) {
+      itsDatagramSizes[n] = itsMessages[n].msg_len;
+      if (itsMessages[n].msg_hdr.msg_flags & MSG_TRUNC) {
+	++itsNofTruncated;
+      }
+      parseControl (n);
+    }
+
+    if (nofReceived > 0) {
+      ++itsNofBatches;
+      itsNofDatagrams += nofReceived;
+      if (unsigned(nofReceived) > itsMaxBatch) {
+	itsMaxBatch = nofReceived;
+      }
+    }
+
+    return nofReceived;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 parseControl
+
+  /*!
+    \param n -- Index of the datagram within the last batch.
+  */
+  void TBB_UDPIngest::parseControl (unsigned int const &n)
+  {
+    struct msghdr *hdr = &itsMessages[n].msg_hdr;
+
+    itsTimes[n].tv_sec  = 0;
+    itsTimes[n].tv_nsec = 0;
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr);
+	 cmsg != NULL;
+	 cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+      if (cmsg->cmsg_level != SOL_SOCKET) {
+	continue;
+      }
+#ifdef SCM_TIMESTAMPNS
+      if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+	memcpy (&itsTimes[n], CMSG_DATA(cmsg), sizeof(struct timespec));
+      }
+#endif
+#ifdef SO_RXQ_OVFL
+      if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+	uint32_t drops;
+	memcpy (&drops, CMSG_DATA(cmsg), sizeof(drops));
+	itsDrops = drops;
+      }
+#endif
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void TBB_UDPIngest::summary (std::ostream &os)
+  {
+    os << "[TBB_UDPIngest] Summary of internal parameters"              << endl;
+    os << "-- UDP port ..................... : " << itsPort              << endl;
+    os << "-- Receive buffer size [bytes] .. : " << itsReceiveBufferSize << endl;
+    os << "-- Max. datagrams per call ...... : " << itsBatchSize         << endl;
+    os << "-- Kernel timestamps ............ : " << itsTimestamps        << endl;
+    os << "-- nof. received datagrams ...... : " << itsNofDatagrams      << endl;
+    os << "-- nof. receive calls with data . : " << itsNofBatches        << endl;
+    os << "-- Max. datagrams in one call ... : " << itsMaxBatch          << endl;
+    os << "-- nof. truncated datagrams ..... : " << itsNofTruncated      << endl;
+    os << "-- nof. datagrams dropped (kernel): " << nofKernelDrops()     << endl;
+  }
+
+} // Namespace DAL -- end
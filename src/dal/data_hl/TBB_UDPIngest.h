@@ -0,0 +1,255 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TBB_UDPINGEST_H
+#define TBB_UDPINGEST_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+//! Default number of datagrams fetched by a single receive call
+#define DEFAULT_INGEST_BATCH_SIZE 64
+//! Default size of the kernel receive buffer requested for the socket [bytes]
+#define DEFAULT_RECEIVE_BUFFER_SIZE 33554432
+
+#ifndef __linux__
+//! Message header of a batch receive, as provided by Linux for recvmmsg()
+struct mmsghdr {
+  struct msghdr msg_hdr;
+  unsigned int msg_len;
+};
+#endif
+
+namespace DAL {  // Namespace DAL -- begin
+
+  /*!
+    \class TBB_UDPIngest
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Batched reception of TBB frames from an UDP port
+
+    \author agent
+
+    \date 2026/10/17
+
+    \test tTBB_UDPIngest.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>TBB class, TBBraw2h5 -- the two readers of TBB data from the network
+      which use this class.
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    During a full-rate dump a single station sends about 55000 frames per
+    second; doing one <tt>select()</tt> plus one <tt>recvfrom()</tt> per
+    frame costs two system calls per 2140 bytes and is what makes the
+    readers fall behind. This class bundles the socket handling of the
+    readers:
+    - the socket is bound to the local port and its kernel receive buffer is
+      enlarged (<tt>SO_RCVBUF</tt>, or <tt>SO_RCVBUFFORCE</tt> where
+      permitted), so that short stalls of the reader do not cost frames;
+    - receive() fetches all waiting datagrams -- up to the number of free
+      slots offered by the caller -- with a single <tt>recvmmsg()</tt> call,
+      directly into the slots of the caller's input buffer;
+    - optionally the kernel receive time of every datagram
+      (<tt>SO_TIMESTAMPNS</tt>) is recorded;
+    - the number of datagrams dropped by the kernel because the receive
+      buffer was full (<tt>SO_RXQ_OVFL</tt>) is tracked, so that losses
+      before the datagrams ever reach the application become visible.
+
+    On systems without <tt>recvmmsg()</tt> the batch is collected with a
+    loop of non-blocking <tt>recvfrom()</tt> calls.
+
+    <h3>Example(s)</h3>
+
+    \code
+    TBB_UDPIngest ingest;
+    std::vector<char> slots (nofSlots*UDP_PACKET_BUFFER_SIZE);
+
+    if (ingest.open (port)) {
+      int nofFrames;
+      while ((nofFrames = ingest.receive (&slots[0],
+                                          UDP_PACKET_BUFFER_SIZE,
+                                          nofSlots,
+                                          timeout)) > 0) {
+        for (int n=0; n<nofFrames; ++n) {
+          tbb.processTBBrawBlock (&slots[n*UDP_PACKET_BUFFER_SIZE],
+                                  ingest.datagramSize(n));
+        }
+      }
+    }
+    \endcode
+  */
+  class TBB_UDPIngest {
+
+    //! Socket descriptor
+    int itsSocket;
+    //! Port to which the socket is bound
+    int itsPort;
+    //! Size of the kernel receive buffer as granted by the system [bytes]
+    int itsReceiveBufferSize;
+    //! Record the kernel receive time of the datagrams?
+    bool itsTimestamps;
+    //! Maximum number of datagrams fetched by a single call
+    unsigned int itsBatchSize;
+    //! Message headers for the batch
+    std::vector<struct mmsghdr> itsMessages;
+    //! Scatter/gather descriptors for the batch
+    std::vector<struct iovec> itsIOVectors;
+    //! Control (ancillary data) buffers for the batch
+    std::vector<char> itsControl;
+    //! Size of the datagrams of the last batch
+    std::vector<int> itsDatagramSizes;
+    //! Kernel receive times of the datagrams of the last batch
+    std::vector<struct timespec> itsTimes;
+    //! Number of datagrams received
+    unsigned long long itsNofDatagrams;
+    //! Number of receive calls returning data
+    unsigned long long itsNofBatches;
+    //! Number of datagrams truncated because they did not fit into a slot
+    unsigned long long itsNofTruncated;
+    //! Largest number of datagrams fetched by a single call
+    unsigned int itsMaxBatch;
+    //! Last value reported for the kernel drop counter of the socket
+    unsigned int itsDrops;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    TBB_UDPIngest (unsigned int const &batchSize=DEFAULT_INGEST_BATCH_SIZE);
+
+    // === Destruction ==========================================================
+
+    //! Destructor, closes the socket
+    ~TBB_UDPIngest ();
+
+    // === Parameter access =====================================================
+
+    //! Socket descriptor, -1 if not open
+    inline int socket () const {
+      return itsSocket;
+    }
+
+    //! Is the socket open?
+    inline bool isOpen () const {
+      return itsSocket >= 0;
+    }
+
+    //! Port to which the socket is bound
+    inline int port () const {
+      return itsPort;
+    }
+
+    //! Size of the kernel receive buffer granted by the system [bytes]
+    inline int receiveBufferSize () const {
+      return itsReceiveBufferSize;
+    }
+
+    //! Maximum number of datagrams fetched by a single call
+    inline unsigned int batchSize () const {
+      return itsBatchSize;
+    }
+
+    //! Number of datagrams received since the socket was opened
+    inline unsigned long long nofDatagrams () const {
+      return itsNofDatagrams;
+    }
+
+    //! Number of receive calls that returned data
+    inline unsigned long long nofBatches () const {
+      return itsNofBatches;
+    }
+
+    //! Number of datagrams which had to be truncated
+    inline unsigned long long nofTruncated () const {
+      return itsNofTruncated;
+    }
+
+    //! Largest number of datagrams fetched by a single call
+    inline unsigned int maxBatch () const {
+      return itsMaxBatch;
+    }
+
+    //! Number of datagrams dropped by the kernel since the socket was opened
+    inline unsigned int nofKernelDrops () const {
+      return itsDrops;
+    }
+
+    //! Size of datagram \e n of the last batch [bytes]
+    inline int datagramSize (unsigned int const &n) const {
+      return itsDatagramSizes[n];
+    }
+
+    //! Kernel receive time of datagram \e n of the last batch
+    inline struct timespec const & timestamp (unsigned int const &n) const {
+      return itsTimes[n];
+    }
+
+    // === Methods ==============================================================
+
+    //! Create the socket and bind it to a local port
+    bool open (int const &port,
+	       int const &receiveBufferSize=DEFAULT_RECEIVE_BUFFER_SIZE,
+	       bool const &timestamps=false);
+
+    //! Close the socket
+    void close ();
+
+    //! Wait for data to arrive at the socket
+    bool waitForData (double const &timeout);
+
+    //! Receive a batch of datagrams into consecutive slots of a buffer
+    int receive (char *slots,
+		 size_t const &slotSize,
+		 unsigned int const &nofSlots,
+		 double const &timeout=0);
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+  private:
+
+    //! Evaluate the ancillary data of datagram \e n of the last batch
+    void parseControl (unsigned int const &n);
+
+  }; // class TBB_UDPIngest -- end
+
+} // Namespace DAL -- end
+
+#endif /* TBB_UDPINGEST_H */
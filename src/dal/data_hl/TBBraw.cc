@@ -87,8 +87,23 @@ namespace DAL {  // Namespace DAL -- begin
     do_dataCRC_p       = false;
 
     fixTimes_p           = 2;
+    oddSecond_p          = false;
     nofDiscardedHeader_p = 0;
+    nofDiscardedData_p   = 0;
     nofProcessed_p       = 0;
+    frameBufferSize_p    = DEFAULT_FRAME_BUFFER_SIZE;
+    nofWrites_p          = 0;
+    nofSpectral_p        = 0;
+    nofDiscardedBands_p  = 0;
+    storagePolicy_p      = HDF5StoragePolicy();
+    hdf5Mutex_p          = NULL;
+
+    //datatype of the complex samples in spectral mode
+    complexType_p = H5Tcreate (H5T_COMPOUND, sizeof(DAL::Complex_Int16));
+    H5Tinsert (complexType_p, "real", HOFFSET(DAL::Complex_Int16,real),
+               H5T_NATIVE_SHORT);
+    H5Tinsert (complexType_p, "imag", HOFFSET(DAL::Complex_Int16,imag),
+               H5T_NATIVE_SHORT);
 
     //initialize the buffers
     int i;
@@ -103,6 +118,10 @@ namespace DAL {  // Namespace DAL -- begin
       {
         dipoleBuf[i].ID = 0;
         dipoleBuf[i].array = NULL;
+        dipoleBuf[i].spectrum = NULL;
+        dipoleBuf[i].spectrumSpace = 0;
+        dipoleBuf[i].nofSlices = 0;
+        dipoleBuf[i].startslice = 0;
       };
     
   }
@@ -185,6 +204,8 @@ namespace DAL {  // Namespace DAL -- begin
   void TBBraw::destroy()
   {
     int i;
+    flush();
+    HDF5Lock lock (hdf5Mutex_p);
     for (i=0; i<MAX_NO_DIPOLES; i++)
       {
         if ( dipoleBuf[i].array != NULL )
@@ -192,6 +213,11 @@ namespace DAL {  // Namespace DAL -- begin
             dipoleBuf[i].array->close();
             delete dipoleBuf[i].array;
           };
+        if ( dipoleBuf[i].spectrum != NULL )
+          {
+            H5Sclose(dipoleBuf[i].spectrumSpace);
+            delete dipoleBuf[i].spectrum;
+          };
       };
     for (i=0; i<MAX_NO_STATIONS; i++)
       {
@@ -208,6 +234,7 @@ namespace DAL {  // Namespace DAL -- begin
       };
     delete [] stationBuf;
     delete [] dipoleBuf;
+    H5Tclose(complexType_p);
   }
   
   // ============================================================================
@@ -230,7 +257,7 @@ namespace DAL {  // Namespace DAL -- begin
         cout << "TBBraw::processTBBrawBlock: Big endian support is untested! "
              << "If you actually need it, test it first!!!" << endl;
       };
-    if (datalen < TBB_FRAME_SIZE)
+    if (datalen < (int)sizeof(TBB_Header))
       {
         cerr << "TBBraw::processTBBrawBlock: Block too small! datalen: " << datalen << endl;
         return false;
@@ -255,13 +282,12 @@ namespace DAL {  // Namespace DAL -- begin
         return false;
       };
 
+    //the time-stamp fixes apply to the sample numbers of transient data only
     if (headerp->n_freq_bands != 0)
       {
-        cerr << "TBBraw::processTBBrawBlock: Can only process raw(=transient) data!" << endl;
-        return false;
-      };
-
-    if (fixTimes_p==2)
+        nofSpectral_p++;
+      }
+    else if (fixTimes_p==2)
       {
         fixDateNew(headerp);
       }
@@ -296,11 +322,66 @@ namespace DAL {  // Namespace DAL -- begin
     os << "-- Check the header-CRC ......... : " << do_headerCRC_p       << endl;
     os << "-- Check the data-CRC ........... : " << do_dataCRC_p         << endl;
     os << "-- Fix broken time-stamps ....... : " << fixTimes_p           << endl;
+    os << "-- Frame buffer size [bytes] .... : " << frameBufferSize_p    << endl;
+    os << "-- Chunk size [bytes] ........... : " << storagePolicy_p.chunkBytes() << endl;
+    os << "-- nof. filters on the chunks ... : " << storagePolicy_p.nofFilters() << endl;
     // Processing statistics
     os << "-- nof. processed data blocks ... : " << nofProcessed_p       << endl;
     os << "-- nof. blocks with broken header : " << nofDiscardedHeader_p << endl;
+    os << "-- nof. blocks with broken data . : " << nofDiscardedData_p   << endl;
+    os << "-- nof. blocks with changed bands : " << nofDiscardedBands_p  << endl;
+    os << "-- nof. blocks with sub-band data : " << nofSpectral_p        << endl;
     os << "-- nof. blocks written to file .. : "
-       << (nofProcessed_p-nofDiscardedHeader_p) << endl;
+       << (nofProcessed_p-nofDiscardedHeader_p-nofDiscardedData_p-nofDiscardedBands_p) << endl;
+    os << "-- nof. write operations ........ : " << nofWrites_p          << endl;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        flush
+  
+  bool TBBraw::flush ()
+  {
+    bool status = true;
+
+    for (int i=0; i<MAX_NO_DIPOLES; i++)
+      {
+        if (dipoleBuf[i].array == NULL && dipoleBuf[i].spectrum == NULL)
+          {
+            break;
+          };
+        status &= flushDipole(i);
+      };
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                          decodeBandSelection
+  
+  int TBBraw::decodeBandSelection (char const *bandsel,
+                                   std::vector<int> &bands)
+  {
+    bands.clear();
+    for (int band=0; band<MAX_NO_BANDS; band++)
+      {
+        if (bandsel[band/8] & (1 << (band%8)))
+          {
+            bands.push_back(band);
+          };
+      };
+    return bands.size();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    frameSize
+  
+  int TBBraw::frameSize (char *inbuff)
+  {
+    TBB_Header *headerp = (TBB_Header*)inbuff;
+    //complex samples in spectral mode
+    int nofValues = headerp->n_samples_per_frame * (headerp->n_freq_bands ? 2 : 1);
+
+    return sizeof(TBB_Header) + nofValues*sizeof(short) + sizeof(UInt32);
   }
 
   // ============================================================================
@@ -328,12 +409,37 @@ namespace DAL {  // Namespace DAL -- begin
     return (CRC == 0);
   }
 
+  //_____________________________________________________________________________
+  //                                                                 checkDataCRC
+  
+  /*!
+    Check the CRC of a TBB frame payload. Uses CRC32 over the samples; the
+    little-endian CRC word following the samples has its 16-bit halves
+    exchanged for the duration of the check, such that a valid frame yields
+    a remainder of zero. Returns TRUE if OK, FALSE otherwise.
+  */
+  bool TBBraw::checkDataCRC(TBB_Header *headerp)
+  {
+    uint16_t * dataBuf = reinterpret_cast<uint16_t*> (headerp+1);
+    //complex samples in spectral mode
+    uint32_t nofValues = headerp->n_samples_per_frame * (headerp->n_freq_bands ? 2 : 1);
+    uint16_t tmp;
+
+    tmp                      = dataBuf[nofValues];
+    dataBuf[nofValues]       = dataBuf[nofValues + 1];
+    dataBuf[nofValues + 1]   = tmp;
+    uint32_t CRC = DAL::crc32(dataBuf, nofValues + 2);
+    dataBuf[nofValues + 1]   = dataBuf[nofValues];
+    dataBuf[nofValues]       = tmp; // and set it back again
+
+    return (CRC == 0);
+  }
+
   //_____________________________________________________________________________
   //                                                                   fixDateOld
   
   void TBBraw::fixDateOld(TBB_Header *headerp)
   {
-    static bool oddSecond = false;
     if (headerp->sample_freq == 200)
       {
         if ((headerp->time%2)!=0)
@@ -345,17 +451,17 @@ namespace DAL {  // Namespace DAL -- begin
             else
               {
                 headerp->sample_nr += 512;
-                oddSecond = true;
+                oddSecond_p = true;
               };
           }
-        else if (oddSecond && (headerp->sample_nr == 199998464))
+        else if (oddSecond_p && (headerp->sample_nr == 199998464))
           {
             headerp->time -= 1;
             headerp->sample_nr += 512;
           }
         else
           {
-            oddSecond = false;
+            oddSecond_p = false;
           };
       }
     else if (headerp->sample_freq == 160)
@@ -392,6 +498,21 @@ namespace DAL {  // Namespace DAL -- begin
       };
   };
 
+  //_____________________________________________________________________________
+  //                                                                  sliceNumber
+  
+  /*!
+    The slices of 1024 ADC samples form a continuous grid, while the slice
+    numbers in the header count from the first slice starting within the
+    second; at 200 MHz sampling a second holds 195312.5 slices.
+  */
+  long long TBBraw::sliceNumber(TBB_Header *headerp)
+  {
+    long long sampleFreq = headerp->sample_freq*1000000LL;
+
+    return (headerp->time*sampleFreq + 1023)/1024 + (headerp->sample_nr >> 10);
+  };
+
   //_____________________________________________________________________________
   //                                                               getDipoleIndex
   
@@ -407,7 +528,7 @@ namespace DAL {  // Namespace DAL -- begin
 	dipoleIndex=i;
 	break;
       };
-      if (dipoleBuf[i].array == NULL) {
+      if (dipoleBuf[i].array == NULL && dipoleBuf[i].spectrum == NULL) {
 	break;
       };
     }
@@ -415,6 +536,7 @@ namespace DAL {  // Namespace DAL -- begin
       return dipoleIndex;
     }
     else {
+      HDF5Lock lock (hdf5Mutex_p);
       return createNewDipole(headerp);
     };
   };
@@ -455,7 +577,7 @@ namespace DAL {  // Namespace DAL -- begin
     // find an empty dipole index
     for (numDipole=0; numDipole<MAX_NO_DIPOLES; numDipole++)
       {
-        if (dipoleBuf[numDipole].array == NULL)
+        if (dipoleBuf[numDipole].array == NULL && dipoleBuf[numDipole].spectrum == NULL)
           {
             break;
           };
@@ -468,21 +590,60 @@ namespace DAL {  // Namespace DAL -- begin
     
     // Now we have the station and dipole index -> create the dipole
     
-    std::vector<int> firstdims(1,0);
-    std::vector<int> cdims(1,CHUNK_SIZE);
-    short nodata[0];
-    
+    dipoleBufElem &dipole = dipoleBuf[numDipole];
     char newDipoleIDstr[10];
     sprintf(newDipoleIDstr, "%03d%03d%03d", headerp->stationid, headerp->rspid, headerp->rcuid);
-    dipoleBuf[numDipole].array =  //see next line
-      stationBuf[stationIndex].group->createShortArray( newDipoleIDstr, firstdims, nodata, cdims );
+    hid_t location;
+
+    if (headerp->n_freq_bands == 0)
+      {
+        std::vector<int> firstdims(1,0);
+        short nodata[0];
+        
+        dipole.array =  //see next line
+          stationBuf[stationIndex].group->createShortArray( newDipoleIDstr, firstdims, nodata,
+                                                            storagePolicy_p );
+        location = dipole.array->getId();
+      }
+    else
+      {
+        // spectral mode: one column per selected sub-band
+        if (decodeBandSelection(headerp->bandsel, dipole.bands) != headerp->n_freq_bands)
+          {
+            cerr << "TBBraw::createNewDipole: Band selection does not match the number of bands "
+                 << headerp->n_freq_bands << "!" << endl;
+            return -1;
+          };
+        dipole.bandColumn.assign(MAX_NO_BANDS, -1);
+        for (size_t n=0; n<dipole.bands.size(); n++)
+          {
+            dipole.bandColumn[dipole.bands[n]] = n;
+          };
+        memcpy(dipole.bandsel, headerp->bandsel, sizeof(dipole.bandsel));
+
+        std::vector<hsize_t> shape (2, 0);
+        shape[1] = dipole.bands.size();
+        dipole.spectrum = new HDF5Dataset();
+        if (!dipole.spectrum->create(stationBuf[stationIndex].group->getId(), newDipoleIDstr,
+                                     shape, storagePolicy_p, complexType_p))
+          {
+            cerr << "TBBraw::createNewDipole: Failed to create spectral dataset "
+                 << newDipoleIDstr << "!" << endl;
+            delete dipole.spectrum;
+            dipole.spectrum = NULL;
+            return -1;
+          };
+        hsize_t maxdims[2] = { H5S_UNLIMITED, H5S_UNLIMITED };
+        dipole.spectrumSpace = H5Screate_simple(2, &shape[0], maxdims);
+        dipole.nofSlices     = 0;
+        dipole.startslice    = sliceNumber(headerp);
+        location = dipole.spectrum->objectID();
+      };
 
     dipoleID = headerp->stationid*1000000 + headerp->rspid*1000 + headerp->rcuid;
-    dipoleBuf[numDipole].ID = dipoleID;
-    dipoleBuf[numDipole].dimensions.resize(1);
-    dipoleBuf[numDipole].dimensions[0] = 1;
-    dipoleBuf[numDipole].starttime = headerp->time;
-    dipoleBuf[numDipole].startsamplenum = headerp->sample_nr;
+    dipole.ID = dipoleID;
+    dipole.starttime = headerp->time;
+    dipole.startsamplenum = headerp->sample_nr;
 
     unsigned int sid                 = headerp->stationid;
     unsigned int rsp                 = headerp->rspid;
@@ -493,34 +654,40 @@ namespace DAL {  // Namespace DAL -- begin
     std::vector<double> antenna_position_value (3, 0.0);
     std::vector<string> antenna_position_unit  (3, "m");
 
-    dipoleBuf[numDipole].array->setAttribute ("STATION_ID", &sid );
-    dipoleBuf[numDipole].array->setAttribute ("RSP_ID",     &rsp );
-    dipoleBuf[numDipole].array->setAttribute ("RCU_ID",     &rcu );
-    dipoleBuf[numDipole].array->setAttribute ("TIME",
-						&(dipoleBuf[numDipole].starttime) );
-    dipoleBuf[numDipole].array->setAttribute ("SAMPLE_NUMBER",
-						&(dipoleBuf[numDipole].startsamplenum) );
-    dipoleBuf[numDipole].array->setAttribute ("SAMPLES_PER_FRAME",
-						&samples_per_frame );
-    dipoleBuf[numDipole].array->setAttribute ("ANTENNA_POSITION_VALUE",
-						antenna_position_value );
-    dipoleBuf[numDipole].array->setAttribute ("ANTENNA_POSITION_UNIT",
-						antenna_position_unit );
-    dipoleBuf[numDipole].array->setAttribute( attribute_name(ANTENNA_POSITION_FRAME),
-						std::vector<string>(1,"ITRF") );
-    dipoleBuf[numDipole].array->setAttribute ("ANTENNA_ORIENTATION_VALUE",
-						antenna_position_value);
-    dipoleBuf[numDipole].array->setAttribute ("ANTENNA_ORIENTATION_UNIT",
-						antenna_position_unit );
-    dipoleBuf[numDipole].array->setAttribute( attribute_name(ANTENNA_ORIENTATION_FRAME),
-						std::vector<string>(1,"ITRF") );
-    dipoleBuf[numDipole].array->setAttribute( attribute_name(FEED),
-						std::vector<string>(1,"UNDEFINED") );
-    dipoleBuf[numDipole].array->setAttribute( attribute_name(NYQUIST_ZONE),
-        &nyquist_zone );
-    dipoleBuf[numDipole].array->setAttribute( attribute_name(SAMPLE_FREQUENCY_VALUE), &sf, 1 );
-    dipoleBuf[numDipole].array->setAttribute( attribute_name(SAMPLE_FREQUENCY_UNIT),
-        std::vector<string>(1,"MHz") );
+    HDF5Attribute::write (location, "STATION_ID", &sid, 1 );
+    HDF5Attribute::write (location, "RSP_ID",     &rsp, 1 );
+    HDF5Attribute::write (location, "RCU_ID",     &rcu, 1 );
+    HDF5Attribute::write (location, "TIME",       &(dipole.starttime), 1 );
+    if (dipole.spectrum == NULL)
+      {
+        HDF5Attribute::write (location, "SAMPLE_NUMBER", &(dipole.startsamplenum), 1 );
+      }
+    else
+      {
+        unsigned int slice_number = headerp->sample_nr >> 10;
+        HDF5Attribute::write (location, "SLICE_NUMBER",   &slice_number, 1 );
+        HDF5Attribute::write (location, "BAND_SELECTION", dipole.bands );
+      };
+    HDF5Attribute::write (location, "SAMPLES_PER_FRAME", &samples_per_frame, 1 );
+    HDF5Attribute::write (location, "ANTENNA_POSITION_VALUE",
+                          antenna_position_value );
+    HDF5Attribute::write (location, "ANTENNA_POSITION_UNIT",
+                          antenna_position_unit );
+    HDF5Attribute::write (location, attribute_name(ANTENNA_POSITION_FRAME),
+                          std::vector<string>(1,"ITRF") );
+    HDF5Attribute::write (location, "ANTENNA_ORIENTATION_VALUE",
+                          antenna_position_value);
+    HDF5Attribute::write (location, "ANTENNA_ORIENTATION_UNIT",
+                          antenna_position_unit );
+    HDF5Attribute::write (location, attribute_name(ANTENNA_ORIENTATION_FRAME),
+                          std::vector<string>(1,"ITRF") );
+    HDF5Attribute::write (location, attribute_name(FEED),
+                          std::vector<string>(1,"UNDEFINED") );
+    HDF5Attribute::write (location, attribute_name(NYQUIST_ZONE),
+                          &nyquist_zone, 1 );
+    HDF5Attribute::write (location, attribute_name(SAMPLE_FREQUENCY_VALUE), &sf, 1 );
+    HDF5Attribute::write (location, attribute_name(SAMPLE_FREQUENCY_UNIT),
+                          std::vector<string>(1,"MHz") );
 #ifdef DAL_DEBUGGING_MESSAGES
     /* Feedback */
     cout << "CREATED New dipole group: " << newDipoleIDstr << endl;
@@ -556,13 +723,13 @@ namespace DAL {  // Namespace DAL -- begin
       };
     
     // We got our stationIndex -> create the station group
-    char newStationIDstr[10];
+    char newStationIDstr[16];
     sprintf( newStationIDstr, "Station%03d", headerp->stationid );
     stationBuf[stationIndex].group = dataset_p->createGroup( newStationIDstr );
     
     stationBuf[stationIndex].ID = headerp->stationid;
     
-    std::vector<string> observationMode        (1, "Transient");
+    std::vector<string> observationMode        (1, headerp->n_freq_bands ? "Sub-band" : "Transient");
     std::vector<string> triggerType            (1, "UNDEFINED");
     std::vector<double> triggerOffset          (1, 0.0);
     std::vector<int> triggeredAntennas         (1, 0);
@@ -607,14 +774,27 @@ namespace DAL {  // Namespace DAL -- begin
   {
     int i;
     TBB_Header *headerp = (TBB_Header*)buffer;
-    if (bufflen < (int)(headerp->n_samples_per_frame*sizeof(short)+sizeof(TBB_Header)))
+    dipoleBufElem &dipole = dipoleBuf[index];
+    bool spectral = (headerp->n_freq_bands != 0);
+    //number of 16-bit values in the payload: complex samples in spectral mode
+    int nofValues = headerp->n_samples_per_frame * (spectral ? 2 : 1);
+
+    if (bufflen < (int)(nofValues*sizeof(short)+sizeof(TBB_Header)))
       {
         cerr << "TBBraw::addDataToDipole: Too few data read in! Aborting." << endl;
         cerr << "  block size: " << bufflen << " bytes, estimated size: "
-             << (headerp->n_samples_per_frame*sizeof(short)+sizeof(TBB_Header))
+             << (nofValues*sizeof(short)+sizeof(TBB_Header))
              << " bytes" << endl;
         return false;
       };
+    if ( spectral != (dipole.spectrum != NULL) ||
+         (spectral && memcmp(headerp->bandsel, dipole.bandsel, sizeof(dipole.bandsel))) )
+      {
+        cerr << "TBBraw::addDataToDipole: Mode or band selection of the dipole changed!"
+             << " Block discarded." << endl;
+        nofDiscardedBands_p++;
+        return false;
+      };
     
     //set sdata to the (hopefully correct) position in the udp-buffer
     char *tmpptr = buffer+sizeof(TBB_Header);
@@ -622,12 +802,53 @@ namespace DAL {  // Namespace DAL -- begin
     
     if ( bigendian_p != bigEndian )
       {
-        for ( i=0; i < headerp->n_samples_per_frame; i++ )
+        for ( i=0; i < nofValues; i++ )
           {
             swapbytes( (char *)&(sdata[i]), 2 );
           };
       };
 
+    if (do_dataCRC_p)
+      {
+        if (bufflen < (int)(nofValues*sizeof(short)+sizeof(TBB_Header)+sizeof(UInt32)))
+          {
+            cerr << "TBBraw::addDataToDipole: Frame too short to check the data-CRC!" << endl;
+            nofDiscardedData_p++;
+            return false;
+          };
+        if ( bigendian_p != bigEndian )
+          {
+            swapbytes( (char *)&(sdata[nofValues]), 2 );
+            swapbytes( (char *)&(sdata[nofValues+1]), 2 );
+          };
+        if (!checkDataCRC(headerp))
+          {
+            nofDiscardedData_p++;
+            return false;
+          };
+      };
+
+    if (spectral)
+      {
+        //position of the first sample within the rows of the [time,band] dataset
+        unsigned int band = headerp->sample_nr & 0x3FF;
+        if ( (band >= MAX_NO_BANDS) || (dipole.bandColumn[band] < 0) )
+          {
+            cerr << "TBBraw::addDataToDipole: First sample of the block belongs to"
+                 << " sub-band " << band << ", which is not selected!" << endl;
+            nofDiscardedBands_p++;
+            return false;
+          };
+        long long writeOffset = (sliceNumber(headerp)-dipole.startslice)*dipole.bands.size()
+          + dipole.bandColumn[band];
+        //as in transient mode, don't extend the dataset to the front
+        if (writeOffset >= 0)
+          {
+            return stageFrame(index, writeOffset, sdata, headerp->n_samples_per_frame);
+          };
+        return true;
+      };
+
     //calculate the writeOffset from time of first block and this block
     int writeOffset= (headerp->sample_nr-dipoleBuf[index].startsamplenum)+
                      ((headerp->time-dipoleBuf[index].starttime)*headerp->sample_freq*1000000);
@@ -645,17 +866,10 @@ namespace DAL {  // Namespace DAL -- begin
     // (don't extend the array to the front)
     if (writeOffset >= 0)
       {
-        //extend array if neccessary.
-        if ((writeOffset+ headerp->n_samples_per_frame)> dipoleBuf[index].dimensions[0])
+        if (!stageFrame(index, writeOffset, sdata, headerp->n_samples_per_frame))
           {
-#ifdef DAL_DEBUGGING_MESSAGES
-            cout << "extending array to:" << writeOffset+ headerp->n_samples_per_frame
-                 << " from:" << dipoleBuf[index].dimensions[0] << endl;
-#endif
-            dipoleBuf[index].dimensions[0] = writeOffset+ headerp->n_samples_per_frame;
-            dipoleBuf[index].array->extend(dipoleBuf[index].dimensions);
+            return false;
           };
-        dipoleBuf[index].array->write(writeOffset, sdata, headerp->n_samples_per_frame );
 #ifdef DAL_DEBUGGING_MESSAGES
       }
     else
@@ -665,13 +879,198 @@ namespace DAL {  // Namespace DAL -- begin
 #endif
       };
 
-    // That is not needed/used right now!
-    /*
-      tmpptr += headerp->n_samples_per_frame*sizeof(short);
-      UInt32 *payloadp = (UInt32 *)tmpptr;
-      payload_crc = *payloadp;
-    */
     return true;
   };
 
+  //_____________________________________________________________________________
+  //                                                                   stageFrame
+  
+  bool TBBraw::stageFrame (int index,
+			   long long offset,
+			   short *data,
+			   int length)
+  {
+    dipoleBufElem &dipole = dipoleBuf[index];
+    size_t capacity = frameBufferSize_p/sizeof(short);
+    //number of 16-bit values: complex samples in spectral mode
+    size_t nofValues = (dipole.spectrum != NULL) ? 2*length : length;
+
+    //make room in the buffer, or bypass it if the frame does not fit at all
+    if (dipole.stageData.size()+nofValues > capacity)
+      {
+        if (!flushDipole(index))
+          {
+            return false;
+          };
+        if (nofValues > capacity)
+          {
+            if (!writeRun(index, offset, data, length))
+              {
+                cerr << "TBBraw::stageFrame: Failed to write frame to dipole array!" << endl;
+                return false;
+              };
+            return true;
+          };
+      };
+    
+    if (dipole.stageData.capacity() < capacity)
+      {
+        dipole.stageData.reserve(capacity);
+      };
+
+    stagedFrame frame;
+    frame.offset   = offset;
+    frame.position = dipole.stageData.size();
+    frame.length   = length;
+    dipole.stageFrames.push_back(frame);
+    dipole.stageData.insert(dipole.stageData.end(), data, data+nofValues);
+
+    return true;
+  };
+
+  //_____________________________________________________________________________
+  //                                                                  flushDipole
+  
+  bool TBBraw::flushDipole (int index)
+  {
+    dipoleBufElem &dipole = dipoleBuf[index];
+    std::vector<stagedFrame> &frames = dipole.stageFrames;
+    //number of 16-bit values per sample: complex samples in spectral mode
+    size_t width = (dipole.spectrum != NULL) ? 2 : 1;
+    size_t n;
+
+    if (frames.empty())
+      {
+        return true;
+      };
+
+    //frames arrived in order and without gaps: write the buffer as it is
+    for (n=1; n<frames.size(); n++)
+      {
+        if (frames[n].offset != frames[n-1].offset+frames[n-1].length)
+          {
+            break;
+          };
+      };
+    if (n == frames.size())
+      {
+        if (!writeRun(index, frames[0].offset, &dipole.stageData[0],
+                      dipole.stageData.size()/width))
+          {
+            cerr << "TBBraw::flushDipole: Failed to write frames to dipole array!" << endl;
+            return false;
+          };
+        frames.clear();
+        dipole.stageData.clear();
+        return true;
+      };
+
+    //otherwise sort the frames and write every contiguous run in one go
+    std::stable_sort(frames.begin(), frames.end());
+    bool status = true;
+    long long runStart = frames[0].offset;
+    runBuf.clear();
+    for (n=0; n<=frames.size(); n++)
+      {
+        if ( (n == frames.size()) ||
+             (frames[n].offset != runStart+(long long)(runBuf.size()/width)) )
+          {
+            if (!writeRun(index, runStart, &runBuf[0], runBuf.size()/width))
+              {
+                cerr << "TBBraw::flushDipole: Failed to write frames to dipole array!" << endl;
+                status = false;
+              };
+            if (n == frames.size())
+              {
+                break;
+              };
+            runStart = frames[n].offset;
+            runBuf.clear();
+          };
+        short *samples = &dipole.stageData[frames[n].position];
+        runBuf.insert(runBuf.end(), samples, samples+frames[n].length*width);
+      };
+    
+    frames.clear();
+    dipole.stageData.clear();
+    return status;
+  };
+
+  //_____________________________________________________________________________
+  //                                                                     writeRun
+  
+  /*!
+    In transient mode the run is appended through the cursor of the dipole
+    array. In spectral mode the dataset is extended to hold the last row of
+    the run, and the run -- the end of its first row, the full rows in between
+    and the start of its last row -- is written by a single H5Dwrite() with
+    a union of (at most) three hyperslabs as file selection, which HDF5 fills
+    in row-major order.
+  */
+  bool TBBraw::writeRun (int index,
+                         long long offset,
+                         short *data,
+                         int length)
+  {
+    dipoleBufElem &dipole = dipoleBuf[index];
+    HDF5Lock lock (hdf5Mutex_p);
+
+    nofWrites_p++;
+
+    if (dipole.spectrum == NULL)
+      {
+        //the append cursor extends the array if neccessary.
+        return dipole.array->append(int(offset), data, length);
+      };
+
+    hid_t datasetID  = dipole.spectrum->objectID();
+    hsize_t nofBands = dipole.bands.size();
+    hsize_t first    = offset;
+    hsize_t last     = offset+length-1;
+    hsize_t start[2];
+    hsize_t count[2];
+
+    if (last/nofBands >= dipole.nofSlices)
+      {
+        hsize_t extent[2]  = { last/nofBands+1, nofBands };
+        hsize_t maxdims[2] = { H5S_UNLIMITED, H5S_UNLIMITED };
+        if (H5Dset_extent(datasetID, extent) < 0)
+          {
+            return false;
+          };
+        H5Sset_extent_simple(dipole.spectrumSpace, 2, extent, maxdims);
+        dipole.nofSlices = extent[0];
+      };
+
+    start[0] = first/nofBands;
+    start[1] = first%nofBands;
+    count[0] = 1;
+    count[1] = std::min<hsize_t>(nofBands-start[1], length);
+    H5Sselect_hyperslab(dipole.spectrumSpace, H5S_SELECT_SET, start, NULL, count, NULL);
+    if (last/nofBands > first/nofBands+1)
+      {
+        start[0] = first/nofBands+1;
+        start[1] = 0;
+        count[0] = last/nofBands-start[0];
+        count[1] = nofBands;
+        H5Sselect_hyperslab(dipole.spectrumSpace, H5S_SELECT_OR, start, NULL, count, NULL);
+      };
+    if (last/nofBands > first/nofBands)
+      {
+        start[0] = last/nofBands;
+        start[1] = 0;
+        count[0] = 1;
+        count[1] = last%nofBands+1;
+        H5Sselect_hyperslab(dipole.spectrumSpace, H5S_SELECT_OR, start, NULL, count, NULL);
+      };
+
+    hsize_t nofSamples = length;
+    hid_t memspace = H5Screate_simple(1, &nofSamples, NULL);
+    herr_t h5error = H5Dwrite(datasetID, complexType_p, memspace, dipole.spectrumSpace,
+                              H5P_DEFAULT, data);
+    H5Sclose(memspace);
+
+    return (h5error >= 0);
+  };
+
 } // Namespace DAL -- end
@@ -23,6 +23,7 @@
 #define TBBRAW_H
 
 // Standard library header files
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -33,6 +34,7 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <pthread.h>
 
 using std::string;
 using std::vector;
@@ -45,6 +47,7 @@ using std::vector;
 // DAL header files
 #include <core/dalCommon.h>
 #include <core/dalDataset.h>
+#include <core/HDF5Dataset.h>
 #include <data_common/CommonAttributes.h>
 
 namespace DAL {  // Namespace DAL -- begin
@@ -68,13 +71,46 @@ namespace DAL {  // Namespace DAL -- begin
     <h3>Synopsis</h3>
     
     This class generates new LOFAR TBB-Timeseries hdf5 files from TBB data
-    frames with raw-ADC (aka transient) data.
+    frames with raw-ADC (aka transient) data or with sub-band (aka spectral)
+    data.
 
     The data frames need to be read in by an application (or derived class) from
     a file or an UDP-port.
 
+    Frames are not written to the dipole datasets one by one, but collected in
+    a write-combining buffer per dipole (see setFrameBufferSize()). Once the
+    buffer of a dipole is full -- or the file is closed -- its frames are
+    sorted by their position within the dataset and every contiguous run of
+    frames is written by a single hyperslab write; frames arriving out of order
+    within the buffer window thereby cost no extra write operations.
+
+    The dipole datasets are chunked according to a HDF5StoragePolicy (see
+    setStoragePolicy()); by default a chunk holds 1 MiB of samples, i.e. the
+    contents of a full write-combining buffer.
+
+    Several TBBraw objects may be used by separate threads. If the HDF5 library
+    is not built thread-safe, all of them are given the same mutex (see
+    setHDF5Mutex()); it is then held only while the object calls into the HDF5
+    library -- creating a dipole or station, writing a run of frames, closing
+    the file -- while the frames are checked and buffered concurrently.
+
+    In spectral mode (<tt>n_freq_bands</tt> > 0) a frame carries
+    <tt>n_samples_per_frame</tt> complex samples of the sub-bands selected by
+    the 512-bit mask <tt>bandsel</tt> (bit \e n of byte \e k selects sub-band
+    8<i>k</i>+<i>n</i>), cycling through the selected sub-bands in increasing
+    order. The <tt>sample_nr</tt> of such a frame holds the sub-band of its
+    first sample in bits 0-9 and the number of the time slice -- 1024 ADC
+    samples, counted from the start of the second -- in bits 10-31. The data
+    of a dipole are stored in a 2-D dataset of complex 16-bit samples with
+    one row per time slice and one column per selected sub-band,
+    <tt>[time,band]</tt>; a frame thereby covers the end of one row, a number
+    of full rows and the start of another row. Spectral frames pass through
+    the same write-combining buffer as transient ones, and each contiguous
+    run of samples is written by a single H5Dwrite() selecting those rows.
+    The dataset carries the attributes <tt>SLICE_NUMBER</tt> (slice of the
+    first row) and <tt>BAND_SELECTION</tt> (sub-band of every column).
+
     <i>Future enhancements:</i>
-    - Suport for handling of TBB sub-band data needs to be added.
     - Support for big-endian systems is still untested.
 
     <h3>Example(s)</h3>
@@ -84,8 +120,11 @@ namespace DAL {  // Namespace DAL -- begin
     
     //!some internal definitions
 #define TBB_FRAME_SIZE 2140
+#define TBB_HEADER_SIZE 88
 #define MAX_NO_STATIONS 50
 #define MAX_NO_DIPOLES 1000
+#define DEFAULT_FRAME_BUFFER_SIZE 1048576
+#define MAX_NO_BANDS 512
     
   private:
     // ----------------------------------------------------------- Private Data
@@ -102,10 +141,28 @@ namespace DAL {  // Namespace DAL -- begin
     bool do_dataCRC_p;
     //! fix broken time-stamps?
     int fixTimes_p;
+    //! state of fixDateOld(): inside an odd second with shifted sample numbers
+    bool oddSecond_p;
     //! number of processed data block
     int nofProcessed_p;    
     //! number of discarded data blocks with broken crc
     int nofDiscardedHeader_p;
+    //! number of discarded data blocks with broken payload crc
+    int nofDiscardedData_p;
+    //! size of the write-combining buffer per dipole [bytes]
+    size_t frameBufferSize_p;
+    //! number of write operations into the dipole arrays
+    int nofWrites_p;
+    //! number of processed data blocks with sub-band data
+    int nofSpectral_p;
+    //! number of discarded data blocks with a changed band selection
+    int nofDiscardedBands_p;
+    //! memory datatype of the complex samples in spectral mode
+    hid_t complexType_p;
+    //! chunking and filters of the dipole datasets
+    HDF5StoragePolicy storagePolicy_p;
+    //! mutex held around the calls into the HDF5 library (NULL: none)
+    pthread_mutex_t *hdf5Mutex_p;
     //! am I big endian?
     bool bigendian_p;
     //! buffer for the stations
@@ -118,21 +175,54 @@ namespace DAL {  // Namespace DAL -- begin
     };
     struct stationBufElem *stationBuf;
     
+    //! frame held in the write-combining buffer of a dipole
+    struct stagedFrame
+    {
+      //! position of the first sample within the dipole array
+      long long offset;
+      //! position of the first sample within the buffer [values]
+      int position;
+      //! number of samples in the frame
+      int length;
+      //! order frames by their position within the dipole array
+      inline bool operator< (stagedFrame const &other) const {
+	return offset < other.offset;
+      }
+    };
+    
     //! buffer for the dipoles
     struct dipoleBufElem
     {
       //! ID of the dipole
       unsigned int ID;
-      //! pointer to the corresponding array
+      //! pointer to the corresponding array (transient mode)
       dalArray * array;
-      //! dimension (size) of the array
-      std::vector<int> dimensions;
+      //! pointer to the corresponding [time,band] dataset (spectral mode)
+      HDF5Dataset * spectrum;
+      //! dataspace of the spectral dataset, following its extent
+      hid_t spectrumSpace;
+      //! number of rows (time slices) of the spectral dataset
+      hsize_t nofSlices;
+      //! selected sub-bands, one per column of the spectral dataset
+      std::vector<int> bands;
+      //! column of every sub-band in the spectral dataset (-1 if not selected)
+      std::vector<int> bandColumn;
+      //! band selection of the first frame
+      char bandsel[64];
+      //! time slice of the first row of the spectral dataset (since the epoch)
+      long long startslice;
+      //! samples of the frames in the write-combining buffer
+      std::vector<short> stageData;
+      //! frames in the write-combining buffer
+      std::vector<stagedFrame> stageFrames;
       /*! time and samplenumer of the first element in the array
 	(used to calculate array offsets).
       */
       unsigned int starttime, startsamplenum;
     };
     struct dipoleBufElem *dipoleBuf;
+    //! scratch buffer to assemble contiguous runs of frames
+    std::vector<short> runBuf;
     
   protected:
     
@@ -174,6 +264,16 @@ namespace DAL {  // Namespace DAL -- begin
     */
     bool checkHeaderCRC (TBB_Header *headerp);
     
+    /*!
+      \brief check the data (payload) CRC.
+      
+      \param headerp -- pointer to the frame header, followed by the samples
+             and the CRC32 of the payload
+      
+      \return <tt>true</tt> if data-CRC is correct
+    */
+    bool checkDataCRC (TBB_Header *headerp);
+    
   public:
 
     // === Construction =========================================================
@@ -240,12 +340,84 @@ namespace DAL {  // Namespace DAL -- begin
     */
     inline void doDataCRC(const bool doit=true)
     {
-      if (doit) {
-	cout << "TBBraw::doDataCRC: Data CRC-checking not (yet) implemented!" << endl;
-	//      do_dataCRC_p=doit;
-      };
+      do_dataCRC_p=doit;
+    };
+    
+    /*!
+      \brief Set the size of the write-combining buffer per dipole
+      
+      \param nofBytes -- size of the buffer [bytes]; set to <tt>0</tt> to write
+             every frame as soon as it is processed (default 1 MiB)
+    */
+    inline void setFrameBufferSize(size_t const &nofBytes=DEFAULT_FRAME_BUFFER_SIZE)
+    {
+      frameBufferSize_p=nofBytes;
+    };
+    
+    //! Get the size of the write-combining buffer per dipole [bytes]
+    inline size_t frameBufferSize () const {
+      return frameBufferSize_p;
+    }
+    
+    /*!
+      \brief Set chunking and filters of the dipole datasets created from now on
+      
+      \param policy -- Storage policy for the dipole datasets
+    */
+    inline void setStoragePolicy (HDF5StoragePolicy const &policy) {
+      storagePolicy_p = policy;
+    }
+    
+    //! Get the chunking and filters of the dipole datasets
+    inline HDF5StoragePolicy storagePolicy () const {
+      return storagePolicy_p;
+    }
+    
+    /*!
+      \brief Set the mutex held around the calls into the HDF5 library
+      
+      \param mutex -- Mutex shared by all users of the HDF5 library, or
+             <tt>NULL</tt> to call it without locking (default)
+      
+      The mutex is used from the moment it is set, i.e. a file opened by the
+      constructor has to be created under the lock by the caller.
+    */
+    inline void setHDF5Mutex (pthread_mutex_t *mutex) {
+      hdf5Mutex_p = mutex;
+    }
+    
+    //! Get the mutex held around the calls into the HDF5 library
+    inline pthread_mutex_t * hdf5Mutex () const {
+      return hdf5Mutex_p;
+    }
+    
+    /*!
+      \brief Scoped lock of an optional mutex
+      
+      Locks the mutex on construction and unlocks it on destruction; does
+      nothing for a <tt>NULL</tt> mutex.
+    */
+    class HDF5Lock {
+      pthread_mutex_t *mutex_p;
+    public:
+      HDF5Lock (pthread_mutex_t *mutex) : mutex_p(mutex) {
+        if (mutex_p != NULL) pthread_mutex_lock(mutex_p);
+      }
+      ~HDF5Lock () {
+        if (mutex_p != NULL) pthread_mutex_unlock(mutex_p);
+      }
+    private:
+      HDF5Lock (HDF5Lock const &other);
+      HDF5Lock & operator= (HDF5Lock const &other);
     };
     
+    /*!
+      \brief Write the contents of the write-combining buffers to the file
+      
+      \return <tt>true</tt> if successful
+    */
+    bool flush ();
+    
     /*!
       \brief Fix broken time-stamps (new style fixing is default)
       
@@ -329,6 +501,27 @@ namespace DAL {  // Namespace DAL -- begin
     //! Provide a summary of the internal status and processing statistics
     void summary (std::ostream &os);
 
+    /*!
+      \brief Decode the band selection of a spectral-mode frame
+
+      \param bandsel -- 512-bit mask of the frame header
+      \retval bands  -- Numbers of the selected sub-bands, in increasing order
+
+      \return nofBands -- Number of selected sub-bands
+    */
+    static int decodeBandSelection (char const *bandsel,
+				    std::vector<int> &bands);
+
+    /*!
+      \brief Get the size of a data-frame from its header
+
+      \param inbuff -- pointer to one TBB data-frame (incl. header etc.), in
+             the byte order of this machine
+
+      \return the size of the frame including the payload CRC [bytes]
+    */
+    static int frameSize (char *inbuff);
+
     /*!
       \brief return the station-id of the data-frame
       
@@ -401,6 +594,15 @@ namespace DAL {  // Namespace DAL -- begin
     */
     int createNewStation(TBB_Header *headerp);
     
+    /*!
+      \brief Get the time slice of a spectral-mode frame
+      
+      \param headerp -- pointer to the frame header
+      
+      \return number of the time slice of the first sample since the epoch
+    */
+    static long long sliceNumber(TBB_Header *headerp);
+    
     /*!
       \brief Process one block of data and add it's contents to the output file
       
@@ -416,6 +618,46 @@ namespace DAL {  // Namespace DAL -- begin
 			  int bufflen,
 			  bool bigEndian=false);
     
+    /*!
+      \brief Add the samples of one frame to the write-combining buffer
+      
+      \param index  -- index of the entry in dipoleBuf to add the data to
+      \param offset -- position of the first sample within the dipole array;
+             in spectral mode the samples of the dataset are counted row by row
+      \param data   -- pointer to the samples (pairs of values in spectral mode)
+      \param length -- number of samples
+      
+      \return <tt>true</tt> if successful
+    */
+    bool stageFrame (int index,
+		     long long offset,
+		     short *data,
+		     int length);
+    
+    /*!
+      \brief Write a contiguous run of samples to the dataset of a dipole
+      
+      \param index  -- index of the entry in dipoleBuf to write to
+      \param offset -- position of the first sample within the dipole dataset
+      \param data   -- pointer to the samples
+      \param length -- number of samples
+      
+      \return <tt>true</tt> if successful
+    */
+    bool writeRun (int index,
+		   long long offset,
+		   short *data,
+		   int length);
+    
+    /*!
+      \brief Write the frames in the buffer of a dipole to its array
+      
+      \param index  -- index of the entry in dipoleBuf to flush
+      
+      \return <tt>true</tt> if successful
+    */
+    bool flushDipole (int index);
+    
   }; // class TBBraw -- end
   
 } // Namespace DAL -- end
@@ -0,0 +1,413 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <core/dalCommon.h>
+#include <data_hl/BFRawKernels.h>
+
+// Namespace usage
+using std::endl;
+using DAL::BFRawKernels;
+using DAL::wallTime;
+
+/*!
+  \file tBFRawKernels.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the DAL::BFRawKernels class
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  The total intensity computed by the kernels is compared with the loop
+  previously used by \t bf2h5, the four Stokes parameters are compared between
+  the implementations for the different instruction sets. Finally the rate at
+  which samples are processed is measured for all instruction sets and for the
+  original loop.
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tBFRawKernels [seconds per measurement]
+  \endverbatim
+*/
+
+//! Number of samples per subband
+const unsigned int nofSamples = 12289;
+
+//_______________________________________________________________________________
+//                                                                    makeSamples
+
+/*!
+  \brief Create a block of random samples
+
+  \param full -- Cover the full range of 16-bit integers? If \e false the value
+         -32768 is excluded, for which the original loop overflows.
+
+  \return samples -- [nofSamples] Input samples.
+*/
+std::vector<BFRawFormat::Sample> makeSamples (bool const &full=false)
+{
+  std::vector<BFRawFormat::Sample> samples (nofSamples);
+  int offset = full ? 32768 : 32767;
+  int range  = full ? 65536 : 65535;
+
+  srand (1);
+  for (unsigned int n=0; n<nofSamples; ++n) {
+    samples[n].xx = std::complex<int16_t> (rand()%range-offset, rand()%range-offset);
+    samples[n].yy = std::complex<int16_t> (rand()%range-offset, rand()%range-offset);
+  }
+
+  if (full) {
+    /* Extreme values, including the largest possible intensity */
+    for (unsigned int n=0; n<16; ++n) {
+      samples[n].xx = std::complex<int16_t> (-32768, n%2 ? -32768 : 32767);
+      samples[n].yy = std::complex<int16_t> (n%4 < 2 ? -32768 : 32767, -32768);
+    }
+  }
+
+  return samples;
+}
+
+//_______________________________________________________________________________
+//                                                                   originalLoop
+
+/*!
+  \brief Total intensity as computed by bf2h5 before the introduction of the kernels
+
+  \param input  -- [nofSamples] Input samples.
+  \param nofSamples -- Number of input samples.
+  \param factor -- Down-sampling factor.
+  \retval output -- [nofSamples/factor] Down-sampled total intensity.
+*/
+void originalLoop (BFRawFormat::Sample const *input,
+		   unsigned int const &nofSamples,
+		   unsigned int const &factor,
+		   float *output)
+{
+  uint32_t xx_intensity(0), yy_intensity(0);
+  uint64_t start(0);
+
+  for (uint32_t count=0; count<nofSamples/factor; ++count) {
+    output[count] = 0;
+    for (uint64_t idx=start; idx<start+factor; ++idx) {
+      xx_intensity = (uint32_t)(real(input[idx].xx) * real(input[idx].xx) +
+				imag(input[idx].xx) * imag(input[idx].xx));
+      yy_intensity = (uint32_t)(real(input[idx].yy) * real(input[idx].yy) +
+				imag(input[idx].yy) * imag(input[idx].yy));
+      output[count] += (float)xx_intensity + (float)yy_intensity;
+    }
+    start += factor;
+  }
+}
+
+//_______________________________________________________________________________
+//                                                                test_parameters
+
+/*!
+  \brief Test construction and the handling of the parameters
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_parameters ()
+{
+  std::cout << "\n[tBFRawKernels::test_parameters]\n" << endl;
+
+  int nofFailedTests (0);
+
+  std::cout << "[1] Testing default constructor ..." << endl;
+  try {
+    BFRawKernels kernels;
+    kernels.summary();
+    if (kernels.products() != BFRawKernels::StokesI
+	|| kernels.nofProducts() != 1
+	|| kernels.factor() != 1
+	|| kernels.instructionSet() != BFRawKernels::supportedInstructionSet()) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[2] Testing argumented constructor ..." << endl;
+  try {
+    BFRawKernels kernels (BFRawKernels::StokesI | BFRawKernels::StokesV, 16);
+    kernels.summary();
+    if (kernels.nofProducts() != 2
+	|| kernels.nofOutputValues(nofSamples) != 2*(nofSamples/16)) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[3] Testing selection of the instruction set ..." << endl;
+  try {
+    for (int set=BFRawKernels::Scalar; set<=BFRawKernels::AVX2; ++set) {
+      BFRawKernels kernels (BFRawKernels::StokesIQUV,
+			    1,
+			    BFRawKernels::InstructionSet(set));
+      std::cout << "-- " << BFRawKernels::name(BFRawKernels::InstructionSet(set))
+		<< "\t-> " << BFRawKernels::name(kernels.instructionSet()) << endl;
+      if (kernels.instructionSet() > BFRawKernels::supportedInstructionSet()) {
+	++nofFailedTests;
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[4] Testing names of the products ..." << endl;
+  try {
+    if (BFRawKernels::products("IQUV") != BFRawKernels::StokesIQUV
+	|| BFRawKernels::products("vi") != (BFRawKernels::StokesI | BFRawKernels::StokesV)
+	|| BFRawKernels::products("IX") != 0
+	|| BFRawKernels::products("") != 0
+	|| BFRawKernels::productNames(BFRawKernels::StokesQ | BFRawKernels::StokesU) != "QU"
+	|| BFRawKernels::productNames(BFRawKernels::products("VUQI")) != "IQUV") {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                   test_results
+
+/*!
+  \brief Test the results of the kernels for all instruction sets
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_results ()
+{
+  std::cout << "\n[tBFRawKernels::test_results]\n" << endl;
+
+  int nofFailedTests (0);
+  unsigned int factors[] = {1, 3, 16, 1500};
+  BFRawKernels::InstructionSet supported = BFRawKernels::supportedInstructionSet();
+
+  std::cout << "[1] Comparing total intensity with the original loop ..." << endl;
+  try {
+    std::vector<BFRawFormat::Sample> samples = makeSamples ();
+    for (unsigned int f=0; f<4; ++f) {
+      std::vector<float> expected (nofSamples/factors[f]);
+      originalLoop (&samples[0], nofSamples, factors[f], &expected[0]);
+      for (int set=BFRawKernels::Scalar; set<=supported; ++set) {
+	BFRawKernels kernels (BFRawKernels::StokesI,
+			      factors[f],
+			      BFRawKernels::InstructionSet(set));
+	std::vector<float> output (kernels.nofOutputValues(nofSamples));
+	kernels.process (&samples[0], nofSamples, &output[0]);
+	if (output != expected) {
+	  std::cerr << "-- Mismatch for " << BFRawKernels::name(kernels.instructionSet())
+		    << " , factor " << factors[f] << endl;
+	  ++nofFailedTests;
+	}
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[2] Comparing Stokes parameters between instruction sets ..." << endl;
+  try {
+    std::vector<BFRawFormat::Sample> samples = makeSamples (true);
+    for (unsigned int f=0; f<4; ++f) {
+      BFRawKernels reference (BFRawKernels::StokesIQUV, factors[f], BFRawKernels::Scalar);
+      std::vector<float> expected (reference.nofOutputValues(nofSamples));
+      reference.process (&samples[0], nofSamples, &expected[0]);
+      /* Second sample: all components -32768 */
+      if (factors[f] == 1 && expected[4] != 4294967296.0f) {
+	std::cerr << "-- Wrong maximum intensity " << expected[4] << endl;
+	++nofFailedTests;
+      }
+      for (int set=BFRawKernels::SSE2; set<=supported; ++set) {
+	BFRawKernels kernels (BFRawKernels::StokesIQUV,
+			      factors[f],
+			      BFRawKernels::InstructionSet(set));
+	std::vector<float> output (kernels.nofOutputValues(nofSamples));
+	kernels.process (&samples[0], nofSamples, &output[0]);
+	/* U and V may differ in rounding if multiply-adds are contracted */
+	for (unsigned int n=0; n<output.size(); ++n) {
+	  bool cross = n%4 > 1;
+	  if (cross ? std::fabs(output[n]-expected[n]) > 1e-6*std::fabs(expected[n])
+	      : output[n] != expected[n]) {
+	    std::cerr << "-- Mismatch for " << BFRawKernels::name(kernels.instructionSet())
+		      << " , factor " << factors[f] << " , value " << n << " : "
+		      << output[n] << " != " << expected[n] << endl;
+	    ++nofFailedTests;
+	    break;
+	  }
+	}
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[3] Checking Stokes parameters of a single sample ..." << endl;
+  try {
+    BFRawFormat::Sample sample;
+    sample.xx = std::complex<int16_t> (3, -4);
+    sample.yy = std::complex<int16_t> (1, 2);
+    /* X Y^* = (3-4i)(1-2i) = -5-10i */
+    float expected[] = {30, 20, -10, -20};
+    for (int set=BFRawKernels::Scalar; set<=supported; ++set) {
+      BFRawKernels kernels (BFRawKernels::StokesIQUV,
+			    1,
+			    BFRawKernels::InstructionSet(set));
+      std::vector<BFRawFormat::Sample> samples (8, sample);
+      std::vector<float> output (kernels.nofOutputValues(8));
+      kernels.process (&samples[0], 8, &output[0]);
+      for (unsigned int n=0; n<output.size(); ++n) {
+	if (output[n] != expected[n%4]) {
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[4] Selection of products ..." << endl;
+  try {
+    std::vector<BFRawFormat::Sample> samples = makeSamples (true);
+    BFRawKernels all (BFRawKernels::StokesIQUV, 3);
+    BFRawKernels some (BFRawKernels::StokesQ | BFRawKernels::StokesV, 3);
+    std::vector<float> outAll (all.nofOutputValues(nofSamples));
+    std::vector<float> outSome (some.nofOutputValues(nofSamples));
+    all.process (&samples[0], nofSamples, &outAll[0]);
+    some.process (&samples[0], nofSamples, &outSome[0]);
+    for (unsigned int n=0; n<nofSamples/3; ++n) {
+      if (outSome[2*n] != outAll[4*n+1] || outSome[2*n+1] != outAll[4*n+3]) {
+	++nofFailedTests;
+	break;
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                      benchmark
+
+/*!
+  \brief Measure the rate at which samples are processed
+
+  \param seconds -- Duration of a single measurement [s].
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int benchmark (double const &seconds)
+{
+  std::cout << "\n[tBFRawKernels::benchmark]\n" << endl;
+
+  int nofFailedTests (0);
+  unsigned int factors[] = {1, 16};
+  unsigned int products[] = {BFRawKernels::StokesI, BFRawKernels::StokesIQUV};
+  std::vector<BFRawFormat::Sample> samples = makeSamples ();
+  std::vector<float> output (4*nofSamples);
+  BFRawKernels::InstructionSet supported = BFRawKernels::supportedInstructionSet();
+
+  for (unsigned int f=0; f<2; ++f) {
+    /* Original loop */
+    unsigned long nofBlocks = 0;
+    double start_t          = wallTime();
+    double end_t            = start_t;
+    while (end_t-start_t < seconds) {
+      originalLoop (&samples[0], nofSamples, factors[f], &output[0]);
+      ++nofBlocks;
+      end_t = wallTime();
+    }
+    double reference = nofBlocks*nofSamples/(end_t-start_t);
+    std::cout << "-- factor " << factors[f] << "\t, original loop , I    : "
+	      << reference << " samples/s" << endl;
+
+    /* Kernels */
+    for (unsigned int p=0; p<2; ++p) {
+      for (int set=BFRawKernels::Scalar; set<=supported; ++set) {
+	BFRawKernels kernels (products[p],
+			      factors[f],
+			      BFRawKernels::InstructionSet(set));
+	nofBlocks = 0;
+	start_t   = wallTime();
+	end_t     = start_t;
+	while (end_t-start_t < seconds) {
+	  kernels.process (&samples[0], nofSamples, &output[0]);
+	  ++nofBlocks;
+	  end_t = wallTime();
+	}
+	double rate = nofBlocks*nofSamples/(end_t-start_t);
+	std::cout << "-- factor " << factors[f] << "\t, "
+		  << BFRawKernels::name(kernels.instructionSet()) << "\t, "
+		  << BFRawKernels::productNames(products[p]) << "\t: "
+		  << rate << " samples/s , speed-up " << rate/reference << endl;
+      }
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main (int argc, char *argv[])
+{
+  int nofFailedTests (0);
+  double seconds (0.2);
+
+  if (argc > 1) {
+    seconds = atof(argv[1]);
+  }
+
+  nofFailedTests += test_parameters ();
+  nofFailedTests += test_results ();
+  nofFailedTests += benchmark (seconds);
+
+  return nofFailedTests;
+}
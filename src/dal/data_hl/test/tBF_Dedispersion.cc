@@ -0,0 +1,540 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <core/dalCommon.h>
+#include <data_hl/BF_BeamGroup.h>
+#include <data_hl/BF_Dedispersion.h>
+
+// Namespace usage
+using std::endl;
+using DAL::BF_Dedispersion;
+using DAL::wallTime;
+
+/*!
+  \file tBF_Dedispersion.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the DAL::BF_Dedispersion class
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  The DM-time plane computed by the engine is compared with a straightforward
+  sum over the channels, for a single block, for a stream of blocks of varying
+  size and for several threads. A synthetic dispersed pulse is recovered at
+  its trial DM and arrival time, also when the data are streamed from a Stokes
+  dataset into a new HDF5 dataset. Finally the rate at which samples are
+  processed is measured, for increasing numbers of threads.
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tBF_Dedispersion [seconds per measurement]
+  \endverbatim
+
+  By default every measurement only lasts 20 ms, enough to check the results;
+  for timings pass a longer duration, e.g. <tt>tBF_Dedispersion 0.2</tt>.
+*/
+
+//! Number of subbands
+const unsigned int nofSubbands = 32;
+//! Number of channels per subband
+const unsigned int nofChannels = 4;
+//! Number of samples
+const unsigned int nofSamples = 6000;
+//! Time resolution [s]
+const double sampleTime = 1e-3;
+
+//_______________________________________________________________________________
+//                                                                 subbandCenters
+
+//! Get the center frequencies [Hz] of the subbands, from 120 to 180 MHz
+std::vector<double> subbandCenters ()
+{
+  std::vector<double> centers (nofSubbands);
+  double width = 60e6/nofSubbands;
+
+  for (unsigned int sb=0; sb<nofSubbands; ++sb) {
+    centers[sb] = 120e6 + (sb+0.5)*width;
+  }
+
+  return centers;
+}
+
+//_______________________________________________________________________________
+//                                                                    frequencies
+
+//! Get the frequencies [Hz] of the channels of all subbands
+std::vector<double> frequencies ()
+{
+  std::vector<double> centers = subbandCenters ();
+  std::vector<double> freq;
+  double width = 60e6/nofSubbands/nofChannels;
+
+  for (unsigned int sb=0; sb<nofSubbands; ++sb) {
+    for (unsigned int ch=0; ch<nofChannels; ++ch) {
+      freq.push_back (centers[sb] + (ch-0.5*(nofChannels-1))*width);
+    }
+  }
+
+  return freq;
+}
+
+//_______________________________________________________________________________
+//                                                                       makeData
+
+/*!
+  \brief Create [time,channel] data of small integer noise
+
+  The values are integers, so that the sums are exact regardless of the order
+  in which they are computed.
+*/
+std::vector<float> makeData ()
+{
+  unsigned int nofFrequencies = nofSubbands*nofChannels;
+  std::vector<float> data (nofSamples*nofFrequencies);
+
+  srand (1);
+  for (unsigned int n=0; n<data.size(); ++n) {
+    data[n] = rand()%16;
+  }
+
+  return data;
+}
+
+//_______________________________________________________________________________
+//                                                                      bruteForce
+
+/*!
+  \brief Straightforward computation of the DM-time plane
+
+  \param engine -- Engine providing the delays.
+  \param data   -- [time,channel] Input data.
+  \retval plane -- [time,trial] DM-time plane.
+*/
+void bruteForce (BF_Dedispersion const &engine,
+		 std::vector<float> const &data,
+		 std::vector<float> &plane)
+{
+  unsigned int nofFrequencies = engine.nofChannels();
+  unsigned int nofTrials      = engine.nofTrials();
+  unsigned int nofOut         = nofSamples - engine.maxDelay();
+
+  plane.assign (nofOut*nofTrials, 0);
+
+  for (unsigned int t=0; t<nofOut; ++t) {
+    for (unsigned int d=0; d<nofTrials; ++d) {
+      float sum = 0;
+      for (unsigned int c=0; c<nofFrequencies; ++c) {
+	sum += data[(t+engine.delay(d,c))*nofFrequencies + c];
+      }
+      plane[t*nofTrials+d] = sum;
+    }
+  }
+}
+
+//_______________________________________________________________________________
+//                                                                  addPulse
+
+/*!
+  \brief Add a dispersed pulse to the data
+
+  \param engine -- Engine providing the delays.
+  \param trial  -- Trial whose DM the pulse has.
+  \param time   -- Arrival time at the reference frequency [samples].
+  \retval data  -- [time,channel] Data to which the pulse is added.
+*/
+void addPulse (BF_Dedispersion const &engine,
+	       unsigned int const &trial,
+	       unsigned int const &time,
+	       std::vector<float> &data)
+{
+  unsigned int nofFrequencies = engine.nofChannels();
+
+  for (unsigned int c=0; c<nofFrequencies; ++c) {
+    data[(time+engine.delay(trial,c))*nofFrequencies + c] += 100;
+  }
+}
+
+//_______________________________________________________________________________
+//                                                                      findPeak
+
+//! Find the [time,trial] position of the maximum of a DM-time plane
+void findPeak (std::vector<float> const &plane,
+	       unsigned int const &nofTrials,
+	       unsigned int &time,
+	       unsigned int &trial)
+{
+  unsigned int peak = 0;
+
+  for (unsigned int n=1; n<plane.size(); ++n) {
+    if (plane[n] > plane[peak]) {
+      peak = n;
+    }
+  }
+
+  time  = peak / nofTrials;
+  trial = peak % nofTrials;
+}
+
+//_______________________________________________________________________________
+//                                                                test_parameters
+
+/*!
+  \brief Test construction and the computation of the delays
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_parameters ()
+{
+  std::cout << "\n[tBF_Dedispersion::test_parameters]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<double> freq = frequencies ();
+
+  std::cout << "[1] Testing argumented constructor ..." << endl;
+  try {
+    BF_Dedispersion engine (freq, sampleTime, BF_Dedispersion::trials (0, 10, 64));
+    engine.summary();
+    if (engine.nofChannels() != nofSubbands*nofChannels
+	|| engine.nofTrials() != 64
+	|| engine.referenceFrequency() != freq.back()
+	|| engine.trials()[63] != 10
+	|| engine.maxDelay() != engine.delay (63, 0)) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[2] Testing the delays ..." << endl;
+  try {
+    BF_Dedispersion engine (freq, sampleTime, BF_Dedispersion::trials (0, 10, 64));
+    unsigned int last = engine.nofChannels()-1;
+    /* 4.148808 ms for DM 1 between 1 GHz and infinity */
+    double delay = BF_Dedispersion::dispersionDelay (1, 1e9, 1e99);
+    std::cout << "-- Delay 1 GHz, DM 1 = " << delay << endl;
+    if (std::fabs (delay-4.148808e-3) > 1e-12) {
+      ++nofFailedTests;
+    }
+    for (unsigned int d=0; d<engine.nofTrials(); ++d) {
+      if (engine.delay (d, last) != 0 || (d == 0 && engine.delay (d, 0) != 0)) {
+	++nofFailedTests;
+      }
+      for (unsigned int c=1; c<engine.nofChannels(); ++c) {
+	if (engine.delay (d, c) > engine.delay (d, c-1)) {
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                   test_process
+
+/*!
+  \brief Test the DM-time plane computed from blocks of data in memory
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_process ()
+{
+  std::cout << "\n[tBF_Dedispersion::test_process]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<double> freq  = frequencies ();
+  std::vector<double> trials = BF_Dedispersion::trials (0, 10, 70);
+  std::vector<float> data    = makeData ();
+  std::vector<float> expected;
+
+  BF_Dedispersion reference (freq, sampleTime, trials);
+  bruteForce (reference, data, expected);
+
+  std::cout << "[1] Single block ..." << endl;
+  try {
+    BF_Dedispersion engine (freq, sampleTime, trials);
+    std::vector<float> plane;
+    unsigned int nofOut = engine.process (&data[0], nofSamples, plane);
+    if (nofOut != nofSamples-engine.maxDelay() || plane != expected) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[2] Stream of blocks of varying size, several threads ..." << endl;
+  try {
+    unsigned int blocksizes[] = {100, 777, 2048, 5000};
+    for (unsigned int threads=1; threads<=4; threads+=3) {
+      for (unsigned int b=0; b<4; ++b) {
+	BF_Dedispersion engine (freq, sampleTime, trials, threads);
+	std::vector<float> all;
+	std::vector<float> plane;
+	for (unsigned int t=0; t<nofSamples; t+=blocksizes[b]) {
+	  unsigned int n = std::min (blocksizes[b], nofSamples-t);
+	  engine.process (&data[t*freq.size()], n, plane);
+	  all.insert (all.end(), plane.begin(), plane.end());
+	}
+	if (all != expected
+	    || engine.nofSamplesIn() != nofSamples
+	    || engine.nofSamplesOut() != nofSamples-engine.maxDelay()) {
+	  std::cerr << "-- Mismatch for " << threads << " threads , block size "
+		    << blocksizes[b] << endl;
+	  ++nofFailedTests;
+	}
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[3] Recovering a dispersed pulse ..." << endl;
+  try {
+    BF_Dedispersion engine (freq, sampleTime, trials, 2);
+    unsigned int trial = 47;
+    unsigned int time  = 3000;
+    unsigned int peakTime;
+    unsigned int peakTrial;
+    std::vector<float> pulse (data);
+    std::vector<float> plane;
+    addPulse (engine, trial, time, pulse);
+    engine.process (&pulse[0], nofSamples, plane);
+    findPeak (plane, engine.nofTrials(), peakTime, peakTrial);
+    std::cout << "-- Pulse at DM " << trials[trial] << " , sample " << time
+	      << " -> found at DM " << trials[peakTrial] << " , sample " << peakTime
+	      << endl;
+    if (peakTime != time || peakTrial != trial) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                   test_dataset
+
+/*!
+  \brief Test dedispersion of a Stokes dataset into a new dataset
+
+  \param fileID -- HDF5 file to work with.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_dataset (hid_t const &fileID)
+{
+  std::cout << "\n[tBF_Dedispersion::test_dataset]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<double> freq   = frequencies ();
+  std::vector<double> trials = BF_Dedispersion::trials (0, 10, 32);
+  std::vector<float> data    = makeData ();
+  std::vector<float> expected;
+
+  BF_Dedispersion reference (freq, sampleTime, trials);
+  addPulse (reference, 20, 2000, data);
+  bruteForce (reference, data, expected);
+
+  DAL::BF_BeamGroup beam (fileID, 0, true);
+  hid_t location = beam.locationID();
+
+  std::cout << "[1] Writing the Stokes dataset ..." << endl;
+  try {
+    DAL::HDF5Attribute::write (location, "CENTER_FREQUENCY", subbandCenters());
+    DAL::BF_StokesDataset stokes (location,
+				  0,
+				  nofSamples,
+				  nofSubbands,
+				  nofChannels,
+				  DAL::Stokes::I);
+    std::vector<int> start (2,0);
+    std::vector<int> block (2);
+    block[0] = nofSamples;
+    block[1] = freq.size();
+    if (!stokes.writeData (&data[0], start, block)) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[2] Channel frequencies from the beam group ..." << endl;
+  try {
+    DAL::BF_StokesDataset stokes (location, "STOKES_0");
+    std::vector<double> channels;
+    if (!BF_Dedispersion::channelFrequencies (location, stokes, channels)
+	|| channels.size() != freq.size()) {
+      ++nofFailedTests;
+    } else {
+      for (unsigned int c=0; c<channels.size(); ++c) {
+	if (std::fabs (channels[c]-freq[c]) > 1e-3) {
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  std::cout << "[3] Dedispersing the Stokes dataset ..." << endl;
+  try {
+    DAL::BF_StokesDataset stokes (location, "STOKES_0");
+    BF_Dedispersion engine (freq, sampleTime, trials, 2);
+    if (!engine.process (stokes, location, "DM_TIME", 1000)) {
+      ++nofFailedTests;
+    }
+    engine.summary();
+
+    DAL::HDF5Dataset dataset (location, "DM_TIME");
+    std::vector<hsize_t> shape = dataset.shape();
+    std::vector<unsigned int> nofWritten;
+    DAL::HDF5Attribute::read (dataset.objectID(), "NOF_SAMPLES", nofWritten);
+    std::cout << "-- Shape of DM-time plane = " << shape << endl;
+    if (shape.size() != 2
+	|| shape[0] != nofSamples-engine.maxDelay()
+	|| shape[1] != trials.size()
+	|| nofWritten.size() != 1
+	|| nofWritten[0] != shape[0]) {
+      ++nofFailedTests;
+    } else {
+      std::vector<float> plane (shape[0]*shape[1]);
+      std::vector<int> block (2);
+      block[0] = shape[0];
+      block[1] = shape[1];
+      dataset.readData (&plane[0], block);
+      if (plane != expected) {
+	++nofFailedTests;
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                      benchmark
+
+/*!
+  \brief Measure the rate at which samples are processed
+
+  \param seconds -- Duration of a single measurement [s].
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int benchmark (double const &seconds)
+{
+  std::cout << "\n[tBF_Dedispersion::benchmark]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<double> freq   = frequencies ();
+  std::vector<double> trials = BF_Dedispersion::trials (0, 10, 64);
+  std::vector<float> data    = makeData ();
+  std::vector<float> plane;
+  unsigned int blocksize     = 2000;
+
+  /* Straightforward sum over the channels */
+  BF_Dedispersion reference (freq, sampleTime, trials);
+  double start_t = wallTime();
+  bruteForce (reference, data, plane);
+  double rate = (nofSamples-reference.maxDelay())/(wallTime()-start_t);
+  std::cout << "-- brute force\t: " << rate << " samples/s" << endl;
+
+  for (unsigned int threads=1; threads<=8; threads*=2) {
+    BF_Dedispersion engine (freq, sampleTime, trials, threads);
+    double end_t = start_t = wallTime();
+    while (end_t-start_t < seconds) {
+      for (unsigned int t=0; t+blocksize<=nofSamples; t+=blocksize) {
+	engine.process (&data[t*freq.size()], blocksize, plane);
+      }
+      end_t = wallTime();
+    }
+    double engineRate = engine.nofSamplesOut()/(end_t-start_t);
+    std::cout << "-- " << threads << " threads\t: " << engineRate
+	      << " samples/s , " << engineRate*trials.size()*freq.size()
+	      << " sums/s , speed-up " << engineRate/rate << endl;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main (int argc, char *argv[])
+{
+  int nofFailedTests (0);
+  double seconds (0.02);
+  std::string filename ("tBF_Dedispersion.h5");
+
+  if (argc > 1) {
+    seconds = atof(argv[1]);
+  }
+
+  nofFailedTests += test_parameters ();
+  nofFailedTests += test_process ();
+
+  hid_t fileID = H5Fcreate (filename.c_str(),
+			    H5F_ACC_TRUNC,
+			    H5P_DEFAULT,
+			    H5P_DEFAULT);
+  if (H5Iis_valid(fileID)) {
+    nofFailedTests += test_dataset (fileID);
+    H5Fclose (fileID);
+  } else {
+    std::cerr << "-- ERROR: Failed to open file " << filename << endl;
+    ++nofFailedTests;
+  }
+
+  nofFailedTests += benchmark (seconds);
+
+  return nofFailedTests;
+}
@@ -332,6 +332,80 @@ int test_methods (std::string const &filename,
 
 // ------------------------------------------------------------------------------
 
+/*!
+  \brief Test reading a column for all subbands at once
+
+  \param filename  -- Name of the input data file
+  \param groupName -- Name of the beam group to open and work with
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_readData (std::string const &filename,
+                   std::string const &groupName)
+{
+  cout << "\n[tBeamGroup::test_readData]\n" << endl;
+
+  int nofFailedTests (0);
+  int start (0);
+  int length (20);
+
+  DAL::dalDataset dataset;
+  dataset.open(filename.c_str());
+  DAL::BeamGroup group (dataset,groupName);
+  int nofSubbands (group.nofSubbandTables());
+
+  cout << "[1] Read column X of all subbands via readData() ..." << endl;
+  try
+    {
+      std::vector<std::complex<short> > data (nofSubbands*length);
+      if (!group.readData ("X",start,length,&data[0]))
+        {
+          nofFailedTests++;
+        }
+      /* Compare with the data returned for the individual subbands */
+      for (int n(0); n<nofSubbands; n++)
+        {
+          std::vector<std::complex<short> > dataX;
+          group.getSubbandData_X (n,start,length,dataX);
+          for (uint k(0); k<dataX.size(); k++)
+            {
+              if (dataX[k] != data[n*length+k])
+                {
+                  cout << "-- Mismatch in subband " << n
+                       << " at cell " << start+k << endl;
+                  nofFailedTests++;
+                  break;
+                }
+            }
+        }
+    }
+  catch (std::string message)
+    {
+      std::cerr << message << endl;
+      nofFailedTests++;
+    }
+
+  cout << "[2] Read a non-existing column ..." << endl;
+  try
+    {
+      std::vector<float> data (nofSubbands*length);
+      if (nofSubbands > 0 && group.readData ("NO_SUCH_COLUMN",start,length,&data[0]))
+        {
+          nofFailedTests++;
+        }
+    }
+  catch (std::string message)
+    {
+      std::cerr << message << endl;
+      nofFailedTests++;
+    }
+
+  return nofFailedTests;
+}
+
+// ------------------------------------------------------------------------------
+
 int main (int argc,char *argv[])
 {
   int nofFailedTests (0);
@@ -357,6 +431,7 @@ int main (int argc,char *argv[])
     {
       nofFailedTests += test_attributes(filename,groupName);
       nofFailedTests += test_methods(filename,groupName);
+      nofFailedTests += test_readData(filename,groupName);
     }
 
   return nofFailedTests;
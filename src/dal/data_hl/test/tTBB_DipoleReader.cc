@@ -0,0 +1,619 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstdlib>
+
+#include <core/dalCommon.h>
+#include <data_hl/TBB_DipoleReader.h>
+#include <data_hl/TBB_StationGroup.h>
+
+// Namespace usage
+using std::endl;
+using DAL::TBB_DipoleDataset;
+using DAL::TBB_DipoleReader;
+using DAL::TBB_StationGroup;
+using DAL::wallTime;
+
+/*!
+  \file tTBB_DipoleReader.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the DAL::TBB_DipoleReader class
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  A station group with 96 dipole datasets is created; the same window of
+  samples is read back for all dipoles, serially as done before and through
+  readers with 1 and 4 threads. The rate at which the output arrays of type
+  <tt>short</tt>, <tt>float</tt> and <tt>double</tt> are filled is measured
+  for 1 up to 96 dipoles. Finally the dipole datasets, being stored
+  contiguously, are mapped into memory and windows at random positions are
+  read with and without the mapping.
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tTBB_DipoleReader [seconds per measurement]
+  \endverbatim
+
+  By default every measurement only lasts 20 ms, enough to check the data
+  read; for timings pass a longer duration, e.g. <tt>tTBB_DipoleReader 0.5</tt>.
+*/
+
+//! Number of dipoles in the station
+const unsigned int nofDipoles = 96;
+//! Number of samples per dipole
+const int nofSamples          = 65536;
+
+//_______________________________________________________________________________
+//                                                                    sampleValue
+
+//! Value of sample <tt>n</tt> of dipole <tt>dipole</tt>
+inline short sampleValue (int const &n,
+			  unsigned int const &dipole)
+{
+  return (n + 37*dipole)%4096 - 2048;
+}
+
+//_______________________________________________________________________________
+//                                                                   createStation
+
+/*!
+  \brief Create a station group with nofDipoles dipole datasets
+
+  \param fileID -- Identifier of the file to work with.
+
+  \return status -- Status of the operation; returns \e false in case an error
+          was encountered.
+*/
+bool createStation (hid_t const &fileID)
+{
+  bool status (true);
+  std::vector<hsize_t> shape (1, nofSamples);
+  std::vector<short> data (nofSamples);
+  TBB_StationGroup group (fileID, 1, true);
+
+  for (unsigned int dipole=0; dipole<nofDipoles; ++dipole) {
+    TBB_DipoleDataset dataset (group.locationID(), 1, dipole/8, dipole%8, shape);
+    for (int n=0; n<nofSamples; ++n) {
+      data[n] = sampleValue (n, dipole);
+    }
+    if (H5Dwrite (dataset.locationID(), H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL,
+		  H5P_DEFAULT, &data[0]) < 0) {
+      status = false;
+    }
+  }
+
+  return status;
+}
+
+//_______________________________________________________________________________
+//                                                                       checkData
+
+/*!
+  \brief Check the data read for all dipoles
+
+  \param data      -- Data as returned by the reader.
+  \param start     -- Start positions of the dipoles.
+  \param blocksize -- Number of samples per dipole.
+  \param stride    -- Distance between the first samples of two dipoles;
+         defaults to <tt>blocksize</tt>.
+
+  \return nofErrors -- The number of dipoles with wrong values.
+*/
+template <class T>
+int checkData (std::vector<T> const &data,
+	       std::vector<int> const &start,
+	       int const &blocksize,
+	       int stride=0)
+{
+  int nofErrors (0);
+
+  if (stride == 0) {
+    stride = blocksize;
+  }
+
+  for (unsigned int dipole=0; dipole<start.size(); ++dipole) {
+    for (int n=0; n<blocksize; ++n) {
+      int sample = start[dipole] + n;
+      T expected = (sample < 0 || sample >= nofSamples) ? 0 : sampleValue (sample, dipole);
+      if (data[dipole*stride+n] != expected) {
+	std::cerr << "-- Wrong value for sample " << sample << " of dipole "
+		  << dipole << " : " << data[dipole*stride+n]
+		  << " != " << expected << endl;
+	++nofErrors;
+	break;
+      }
+    }
+  }
+
+  return nofErrors;
+}
+
+//_______________________________________________________________________________
+//                                                                    test_reading
+
+/*!
+  \brief Test reading the data of all dipoles of a station
+
+  \param fileID -- Identifier of the file to work with.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_reading (hid_t const &fileID)
+{
+  std::cout << "\n[tTBB_DipoleReader::test_reading]\n" << endl;
+
+  int nofFailedTests (0);
+  int blocksize (1024);
+  TBB_StationGroup group (fileID, "Station001");
+  std::vector<int> start (group.nofSelectedDatasets(), 1000);
+  std::vector<double> data (blocksize*group.nofSelectedDatasets());
+
+  if (group.nofSelectedDatasets() != nofDipoles) {
+    std::cerr << "-- Station group holds " << group.nofSelectedDatasets()
+	      << " instead of " << nofDipoles << " dipoles!" << endl;
+    return 1;
+  }
+
+  std::cout << "[1] Testing default constructor ..." << endl;
+  try {
+    TBB_DipoleReader reader;
+    reader.summary();
+    if (!group.readData (&data[0], start, blocksize, reader)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkData (data, start, blocksize);
+    reader.summary();
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[2] Read with 4 threads and individual start positions ..." << endl;
+  try {
+    TBB_DipoleReader reader (4);
+    for (unsigned int n=0; n<start.size(); ++n) {
+      start[n] = 100*n;
+    }
+    for (int round=0; round<10; ++round) {
+      if (!group.readData (&data[0], start, blocksize, reader)) {
+	++nofFailedTests;
+      }
+      nofFailedTests += checkData (data, start, blocksize);
+    }
+    reader.summary();
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[3] Read across the start of the data ..." << endl;
+  try {
+    TBB_DipoleReader reader (2);
+    std::vector<int> before (start.size(), -100);
+    group.readData (&data[0], before, blocksize, reader);
+    nofFailedTests += checkData (data, before, blocksize);
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[4] Read into short, float and double arrays ..." << endl;
+  try {
+    TBB_DipoleReader reader (2);
+    /* Odd block size, so the last chunks of the widening are exercised */
+    int size (1001);
+    std::vector<short> dataShort (size*start.size());
+    std::vector<float> dataFloat (size*start.size());
+    dataShort.assign (dataShort.size(), 1);
+    if (!group.readData (&dataShort[0], start, size, reader)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkData (dataShort, start, size);
+    if (!group.readData (&dataFloat[0], start, size, reader)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkData (dataFloat, start, size);
+    if (!group.readData (&data[0], start, size, reader)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkData (data, start, size);
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[5] Read into a window of a larger array ..." << endl;
+  try {
+    TBB_DipoleReader reader;
+    int size (500);
+    std::vector<float> dataFloat (blocksize*start.size(), -1);
+    if (!group.readData (&dataFloat[0], start, size, reader, blocksize)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkData (dataFloat, start, size, blocksize);
+    /* Samples beyond the window are untouched */
+    if (dataFloat[size] != -1 || dataFloat[blocksize-1] != -1) {
+      ++nofFailedTests;
+    }
+    /* A stride below the number of samples is rejected */
+    if (group.readData (&dataFloat[0], start, size, reader, size-1)) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[6] Reject mismatching start positions ..." << endl;
+  try {
+    TBB_DipoleReader reader;
+    std::vector<int> wrong (3, 0);
+    if (group.readData (&data[0], wrong, blocksize, reader)) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                 benchmark_reads
+
+/*!
+  \brief Compare the serial read with temporary buffer against the reader
+
+  \param fileID  -- Identifier of the file to work with.
+  \param seconds -- Duration of a single measurement.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int benchmark_reads (hid_t const &fileID,
+		     double const &seconds)
+{
+  std::cout << "\n[tTBB_DipoleReader::benchmark_reads]\n" << endl;
+
+  int nofFailedTests (0);
+  int sizes[] = {1024, 65536};
+  TBB_StationGroup group (fileID, "Station001");
+  std::vector<TBB_DipoleDataset*> datasets = group.selectedDatasets();
+
+  for (unsigned int s=0; s<2; ++s) {
+    int blocksize = sizes[s];
+    std::vector<int> start (datasets.size(), 0);
+    std::vector<double> data (blocksize*datasets.size());
+    std::vector<short> tmp (blocksize);
+    unsigned long nofReads = 0;
+    double start_t         = wallTime();
+    double end_t           = start_t;
+
+    /* Serial read through a temporary buffer, copied into the columns */
+    while (end_t-start_t < seconds) {
+      for (unsigned int d=0; d<datasets.size(); ++d) {
+	datasets[d]->readData (start[d], blocksize, &tmp[0]);
+	for (int n=0; n<blocksize; ++n) {
+	  data[d*blocksize+n] = tmp[n];
+	}
+      }
+      ++nofReads;
+      end_t = wallTime();
+    }
+    double rateSerial = nofReads/(end_t-start_t);
+    nofFailedTests += checkData (data, start, blocksize);
+
+    std::cout << "-- " << blocksize << " samples x " << datasets.size()
+	      << " dipoles\t: serial " << rateSerial << " reads/s";
+
+    unsigned int threads[] = {1, 4};
+    for (unsigned int t=0; t<2; ++t) {
+      TBB_DipoleReader reader (threads[t]);
+      data.assign (data.size(), 1);
+      nofReads = 0;
+      start_t  = wallTime();
+      end_t    = start_t;
+      while (end_t-start_t < seconds) {
+	reader.readData (datasets, start, blocksize, &data[0]);
+	++nofReads;
+	end_t = wallTime();
+      }
+      nofFailedTests += checkData (data, start, blocksize);
+      std::cout << " , " << threads[t] << " thread(s) "
+		<< nofReads/(end_t-start_t) << " reads/s";
+    }
+    std::cout << endl;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                    measureRate
+
+/*!
+  \brief Rate at which the reader fills an output array of type T
+
+  \return rate -- Output written per second [GB/s].
+*/
+template <class T>
+double measureRate (TBB_DipoleReader &reader,
+		    std::vector<TBB_DipoleDataset*> const &datasets,
+		    int const &blocksize,
+		    double const &seconds,
+		    int &nofFailedTests)
+{
+  std::vector<int> start (datasets.size(), 0);
+  std::vector<T> data (blocksize*datasets.size());
+  unsigned long nofReads = 0;
+  double start_t         = wallTime();
+  double end_t           = start_t;
+
+  while (end_t-start_t < seconds) {
+    if (!reader.readData (datasets, start, blocksize, &data[0])) {
+      ++nofFailedTests;
+      break;
+    }
+    ++nofReads;
+    end_t = wallTime();
+  }
+
+  nofFailedTests += checkData (data, start, blocksize);
+
+  return 1e-9*nofReads*data.size()*sizeof(T)/(end_t-start_t);
+}
+
+//_______________________________________________________________________________
+//                                                                 benchmark_types
+
+/*!
+  \brief Rate of filling output arrays of different types for 1 to 96 dipoles
+
+  \param fileID  -- Identifier of the file to work with.
+  \param seconds -- Duration of a single measurement.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int benchmark_types (hid_t const &fileID,
+		     double const &seconds)
+{
+  std::cout << "\n[tTBB_DipoleReader::benchmark_types]\n" << endl;
+
+  int nofFailedTests (0);
+  int blocksize (nofSamples);
+  unsigned int dipoles[] = {1, 8, 24, 48, 96};
+  TBB_StationGroup group (fileID, "Station001");
+  std::vector<TBB_DipoleDataset*> selection = group.selectedDatasets();
+  TBB_DipoleReader reader;
+
+  std::cout << "-- dipoles\tshort [GB/s]\tfloat [GB/s]\tdouble [GB/s]" << endl;
+
+  for (unsigned int d=0; d<5; ++d) {
+    std::vector<TBB_DipoleDataset*> datasets (selection.begin(),
+					      selection.begin()+dipoles[d]);
+    double rateShort  = measureRate<short> (reader, datasets, blocksize, seconds, nofFailedTests);
+    double rateFloat  = measureRate<float> (reader, datasets, blocksize, seconds, nofFailedTests);
+    double rateDouble = measureRate<double> (reader, datasets, blocksize, seconds, nofFailedTests);
+    std::cout << "-- " << dipoles[d]
+	      << "\t\t" << rateShort
+	      << "\t\t" << rateFloat
+	      << "\t\t" << rateDouble << endl;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                    test_mapping
+
+/*!
+  \brief Test reading the dipole data through a memory mapping of the file
+
+  \param fileID -- Identifier of the file to work with.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_mapping (hid_t const &fileID)
+{
+  std::cout << "\n[tTBB_DipoleReader::test_mapping]\n" << endl;
+
+  int nofFailedTests (0);
+  int blocksize (1024);
+  TBB_StationGroup group (fileID, "Station001");
+  std::vector<int> start (group.nofSelectedDatasets(), 0);
+  std::vector<short> data (blocksize*group.nofSelectedDatasets());
+
+  std::cout << "[1] Map the contiguous dipole datasets ..." << endl;
+  try {
+    TBB_DipoleReader reader (2);
+    if (group.mapData() != nofDipoles) {
+      ++nofFailedTests;
+    }
+    for (unsigned int n=0; n<start.size(); ++n) {
+      start[n] = 500*n - 700;
+    }
+    if (!group.readData (&data[0], start, blocksize, reader)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkData (data, start, blocksize);
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[2] Read beyond the end of a mapped dataset ..." << endl;
+  try {
+    TBB_DipoleDataset *dataset = group.selectedDatasets()[0];
+    std::vector<short> buffer (blocksize);
+    /* Same result as without the mapping: the HDF5 library rejects the read */
+    if (!dataset->isMapped()
+	|| dataset->readData (nofSamples-10, blocksize, &buffer[0])) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[3] Copies of a dataset do not share the mapping ..." << endl;
+  try {
+    TBB_DipoleDataset copy (*group.selectedDatasets()[1]);
+    if (copy.isMapped()) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  std::cout << "[4] Chunked dataset is read through the HDF5 library ..." << endl;
+  try {
+    hsize_t shape (nofSamples);
+    hsize_t chunk (4096);
+    std::vector<short> values (nofSamples);
+    std::vector<short> buffer (blocksize);
+    for (int n=0; n<nofSamples; ++n) {
+      values[n] = sampleValue (n, 0);
+    }
+    hid_t dataspace = H5Screate_simple (1, &shape, NULL);
+    hid_t plist     = H5Pcreate (H5P_DATASET_CREATE);
+    H5Pset_chunk (plist, 1, &chunk);
+    hid_t datasetID = H5Dcreate (fileID, "Chunked", H5T_NATIVE_SHORT, dataspace,
+				 H5P_DEFAULT, plist, H5P_DEFAULT);
+    H5Dwrite (datasetID, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &values[0]);
+    H5Dclose (datasetID);
+    H5Pclose (plist);
+    H5Sclose (dataspace);
+
+    TBB_DipoleDataset dataset (fileID, "Chunked");
+    if (dataset.mapData() || dataset.isMapped()) {
+      ++nofFailedTests;
+    }
+    if (!dataset.readData (100, blocksize, &buffer[0])
+	|| buffer[0] != sampleValue (100, 0)) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                               benchmark_mapping
+
+/*!
+  \brief Rate of reading windows at random positions, with and without mapping
+
+  \param fileID  -- Identifier of the file to work with.
+  \param seconds -- Duration of a single measurement.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int benchmark_mapping (hid_t const &fileID,
+		       double const &seconds)
+{
+  std::cout << "\n[tTBB_DipoleReader::benchmark_mapping]\n" << endl;
+
+  int nofFailedTests (0);
+  int sizes[] = {16, 1024, 16384};
+  double rate[2];
+
+  for (unsigned int s=0; s<3; ++s) {
+    int blocksize = sizes[s];
+    std::vector<short> data (blocksize);
+
+    for (int mapped=0; mapped<2; ++mapped) {
+      TBB_StationGroup group (fileID, "Station001");
+      std::vector<TBB_DipoleDataset*> datasets = group.selectedDatasets();
+      if (mapped && group.mapData() != nofDipoles) {
+	++nofFailedTests;
+      }
+      srand (1);
+      unsigned long nofReads = 0;
+      double start_t         = wallTime();
+      double end_t           = start_t;
+      while (end_t-start_t < seconds) {
+	unsigned int dipole = rand()%nofDipoles;
+	int start           = rand()%(nofSamples-blocksize);
+	if (!datasets[dipole]->readData (start, blocksize, &data[0])
+	    || data[0] != sampleValue (start, dipole)) {
+	  ++nofFailedTests;
+	  break;
+	}
+	++nofReads;
+	end_t = wallTime();
+      }
+      rate[mapped] = nofReads/(end_t-start_t);
+    }
+
+    std::cout << "-- " << blocksize << " samples\t: HDF5 " << rate[0]
+	      << " reads/s , mapped " << rate[1]
+	      << " reads/s , speed-up " << rate[1]/rate[0] << endl;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main (int argc, char *argv[])
+{
+  int nofFailedTests (0);
+  double seconds (0.02);
+
+  if (argc > 1) {
+    seconds = atof(argv[1]);
+  }
+
+  hid_t fileID = H5Fcreate ("tTBB_DipoleReader.h5",
+			    H5F_ACC_TRUNC,
+			    H5P_DEFAULT,
+			    H5P_DEFAULT);
+
+  if (fileID < 0 || !createStation (fileID)) {
+    std::cerr << "-- ERROR: Failed to create file tTBB_DipoleReader.h5" << endl;
+    return -1;
+  }
+
+  nofFailedTests += test_reading (fileID);
+  nofFailedTests += benchmark_reads (fileID, seconds);
+  nofFailedTests += benchmark_types (fileID, seconds);
+  nofFailedTests += test_mapping (fileID);
+  nofFailedTests += benchmark_mapping (fileID, seconds);
+
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
@@ -0,0 +1,501 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/dalCommon.h>
+#include <data_hl/TBB_FileIngest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::TBB_FileIngest;
+using DAL::wallTime;
+
+/*!
+  \file tTBB_FileIngest.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the TBB_FileIngest class
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  A file of TBB frames in transient and spectral mode is written and parsed
+  again through a buffer smaller than a few frames, such that frames straddle
+  the refills of the buffer. Finally a dump is replayed through the original
+  parser of the TBB class -- which read the payload sample by sample from a
+  <tt>std::ifstream</tt> -- and through TBB_FileIngest, reporting the rates
+  in MB/s.
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tTBB_FileIngest [size of the generated dump [MB] | raw TBB dump]
+  \endverbatim
+*/
+
+//! Size of the header of a TBB frame [bytes]
+const size_t headerSize = 88;
+//! Name of the file the frames are written to
+const char *filename    = "tTBB_FileIngest.dat";
+
+//_______________________________________________________________________________
+//                                                                     writeFrame
+
+/*!
+  \brief Write a TBB frame with numbered samples
+
+  \param outfile    -- Stream to write the frame to.
+  \param seqnr      -- Sequence number of the frame, also used as value of the
+         first sample.
+  \param nofSamples -- Number of samples in the frame.
+  \param spectral   -- Write complex samples of the spectral mode?
+*/
+void writeFrame (std::ofstream &outfile,
+		 uint32_t const &seqnr,
+		 uint16_t const &nofSamples,
+		 bool const &spectral)
+{
+  char header[headerSize];
+  uint16_t nofBands = spectral ? 1 : 0;
+  int nofValues     = spectral ? 2*nofSamples : nofSamples;
+  std::vector<int16_t> values (nofValues);
+  uint32_t crc      = ~seqnr;
+
+  memset (header, 0, headerSize);
+  header[0] = 1;
+  memcpy (header+4,  &seqnr,      sizeof(seqnr));
+  memcpy (header+16, &nofSamples, sizeof(nofSamples));
+  memcpy (header+18, &nofBands,   sizeof(nofBands));
+
+  for (int n=0; n<nofValues; ++n) {
+    values[n] = int16_t(seqnr+n);
+  }
+
+  outfile.write (header, headerSize);
+  outfile.write (reinterpret_cast<char *>(&values[0]), nofValues*sizeof(int16_t));
+  outfile.write (reinterpret_cast<char *>(&crc), sizeof(crc));
+}
+
+//_______________________________________________________________________________
+//                                                                      checkFrame
+
+/*!
+  \brief Parse a frame written by writeFrame() and check its contents
+
+  \param ingest -- Reader positioned at the start of a frame.
+  \param seqnr  -- Expected sequence number of the frame.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int checkFrame (TBB_FileIngest &ingest,
+		uint32_t const &seqnr)
+{
+  uint32_t number     = 0;
+  uint16_t nofSamples = 0;
+  uint16_t nofBands   = 0;
+  uint32_t crc        = 0;
+  char *header        = ingest.read (headerSize);
+
+  if (header == NULL) {
+    cerr << "-- Missing header of frame " << seqnr << endl;
+    return 1;
+  }
+  memcpy (&number,     header+4,  sizeof(number));
+  memcpy (&nofSamples, header+16, sizeof(nofSamples));
+  memcpy (&nofBands,   header+18, sizeof(nofBands));
+
+  int nofValues = nofBands ? 2*nofSamples : nofSamples;
+  char *payload = ingest.read (nofValues*sizeof(int16_t)+sizeof(crc));
+  if (payload == NULL) {
+    cerr << "-- Missing payload of frame " << seqnr << endl;
+    return 1;
+  }
+  int16_t *values = reinterpret_cast<int16_t *>(payload);
+  memcpy (&crc, payload+nofValues*sizeof(int16_t), sizeof(crc));
+
+  int nofFailedTests (0);
+  if (number != seqnr || crc != ~seqnr) {
+    cerr << "-- Wrong header or CRC of frame " << seqnr << endl;
+    ++nofFailedTests;
+  }
+  for (int n=0; n<nofValues; ++n) {
+    if (values[n] != int16_t(seqnr+n)) {
+      cerr << "-- Wrong sample " << n << " of frame " << seqnr << endl;
+      ++nofFailedTests;
+      break;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new TBB_FileIngest object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tTBB_FileIngest::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing default constructor ..." << endl;
+  {
+    TBB_FileIngest ingest;
+    if (ingest.isOpen() || ingest.bufferSize() != DEFAULT_FILE_BUFFER_SIZE) {
+      ++nofFailedTests;
+    }
+    ingest.summary();
+  }
+
+  cout << "[2] Testing argumented constructor ..." << endl;
+  {
+    TBB_FileIngest ingest (10000);
+    if (ingest.bufferSize() != 10000) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Opening a file which does not exist ..." << endl;
+  {
+    TBB_FileIngest ingest;
+    if (ingest.open ("tTBB_FileIngest.missing") || ingest.isOpen()) {
+      ++nofFailedTests;
+    }
+    if (!ingest.eof() || ingest.read (1) != NULL) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                      test_read
+
+/*!
+  \brief Test parsing the frames of a file
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_read ()
+{
+  cout << "\n[tTBB_FileIngest::test_read]\n" << endl;
+
+  int nofFailedTests (0);
+  uint32_t nofFrames (40);
+  size_t fileSize (0);
+
+  /* Frames of alternating mode and size, followed by an incomplete header */
+  {
+    std::ofstream outfile (filename, std::ios::binary);
+    for (uint32_t n=0; n<nofFrames; ++n) {
+      writeFrame (outfile, n, n%3 ? 1024 : 487, n%2);
+    }
+    outfile.write ("incomplete", 10);
+    fileSize = outfile.tellp();
+  }
+
+  cout << "[1] Parsing the frames through a small buffer ..." << endl;
+  {
+    TBB_FileIngest ingest (5000);
+
+    if (!ingest.open (filename)) {
+      return 1;
+    }
+    for (uint32_t n=0; n<nofFrames; ++n) {
+      nofFailedTests += checkFrame (ingest, n);
+    }
+    if (ingest.eof()) {
+      cerr << "-- Unexpected end of file" << endl;
+      ++nofFailedTests;
+    }
+    if (ingest.read (headerSize) != NULL || ingest.nofTruncated() != 1) {
+      cerr << "-- Incomplete header not detected" << endl;
+      ++nofFailedTests;
+    }
+    if (!ingest.eof() || ingest.nofBytesUsed() != fileSize
+	|| ingest.nofBytesRead() != fileSize) {
+      cerr << "-- Wrong number of bytes processed" << endl;
+      ++nofFailedTests;
+    }
+    ingest.summary();
+  }
+
+  cout << "[2] Skipping frames ..." << endl;
+  {
+    TBB_FileIngest ingest (5000);
+
+    ingest.open (filename);
+    nofFailedTests += checkFrame (ingest, 0);
+    /* Frames 1 and 2 are spectral with 1024 samples and transient with 1024 samples */
+    if (!ingest.skip (headerSize+4096+4 + headerSize+2048+4)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkFrame (ingest, 3);
+    if (ingest.skip (fileSize) || ingest.nofTruncated() != 1 || !ingest.eof()) {
+      cerr << "-- Skipping beyond the end of the file not detected" << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Request exceeding the buffer size ..." << endl;
+  {
+    TBB_FileIngest ingest (1000);
+
+    ingest.open (filename);
+    if (ingest.read (2000) != NULL) {
+      ++nofFailedTests;
+    }
+  }
+
+  remove (filename);
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                    test_swap16
+
+/*!
+  \brief Test the conversion of the byte order
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_swap16 ()
+{
+  cout << "\n[tTBB_FileIngest::test_swap16]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<uint16_t> values (1001);
+
+  for (unsigned int n=0; n<values.size(); ++n) {
+    values[n] = uint16_t(n*257+3);
+  }
+
+  TBB_FileIngest::swap16 (&values[0], values.size());
+  for (unsigned int n=0; n<values.size(); ++n) {
+    uint16_t value = uint16_t(n*257+3);
+    if (values[n] != uint16_t((value >> 8) | (value << 8))) {
+      ++nofFailedTests;
+    }
+  }
+
+  TBB_FileIngest::swap16 (&values[0], values.size());
+  for (unsigned int n=0; n<values.size(); ++n) {
+    if (values[n] != uint16_t(n*257+3)) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                   replayStream
+
+/*!
+  \brief Parse a dump the way the TBB class originally did
+
+  \param dump -- Name of the raw TBB dump.
+  \retval nofFrames -- Number of frames parsed.
+
+  \return sum -- Sum of all samples.
+*/
+long long replayStream (std::string const &dump,
+			unsigned long &nofFrames)
+{
+  std::fstream rawfile (dump.c_str(), std::ios::binary|std::ios::in);
+  char header[headerSize];
+  uint16_t nofSamples = 0;
+  uint16_t nofBands   = 0;
+  int16_t sample[2];
+  uint32_t crc        = 0;
+  long long sum       = 0;
+
+  nofFrames = 0;
+  while (rawfile.peek() != EOF) {
+    rawfile.read (header, headerSize);
+    memcpy (&nofSamples, header+16, sizeof(nofSamples));
+    memcpy (&nofBands,   header+18, sizeof(nofBands));
+    size_t sampleSize = nofBands ? 2*sizeof(int16_t) : sizeof(int16_t);
+    for (uint16_t n=0; n<nofSamples; ++n) {
+      rawfile.read (reinterpret_cast<char *>(sample), sampleSize);
+      sum += sample[0];
+    }
+    rawfile.read (reinterpret_cast<char *>(&crc), sizeof(crc));
+    ++nofFrames;
+  }
+
+  return sum;
+}
+
+//_______________________________________________________________________________
+//                                                                   replayIngest
+
+/*!
+  \brief Parse a dump through TBB_FileIngest
+
+  \param dump -- Name of the raw TBB dump.
+  \retval nofFrames -- Number of frames parsed.
+
+  \return sum -- Sum of all samples.
+*/
+long long replayIngest (std::string const &dump,
+			unsigned long &nofFrames)
+{
+  TBB_FileIngest ingest;
+  char *header        = NULL;
+  uint16_t nofSamples = 0;
+  uint16_t nofBands   = 0;
+  long long sum       = 0;
+
+  nofFrames = 0;
+  ingest.open (dump);
+  while ((header = ingest.read (headerSize))) {
+    memcpy (&nofSamples, header+16, sizeof(nofSamples));
+    memcpy (&nofBands,   header+18, sizeof(nofBands));
+    unsigned int step = nofBands ? 2 : 1;
+    int16_t *values   = reinterpret_cast<int16_t *>(ingest.read (step*nofSamples*sizeof(int16_t)+4));
+    if (values == NULL) {
+      break;
+    }
+    for (unsigned int n=0; n<step*nofSamples; n+=step) {
+      sum += values[n];
+    }
+    ++nofFrames;
+  }
+
+  return sum;
+}
+
+//_______________________________________________________________________________
+//                                                                      benchmark
+
+/*!
+  \brief Replay a dump through the original parser and through TBB_FileIngest
+
+  \param dump      -- Name of a raw TBB dump; if empty a dump of transient
+         frames is generated.
+  \param megabytes -- Size of the generated dump [MB].
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int benchmark (std::string const &dump,
+	       double const &megabytes)
+{
+  cout << "\n[tTBB_FileIngest::benchmark]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string replay (dump);
+
+  if (replay.empty()) {
+    replay = filename;
+    std::ofstream outfile (filename, std::ios::binary);
+    uint32_t nofFrames = uint32_t(megabytes*1048576/(headerSize+2048+4));
+    for (uint32_t n=0; n<nofFrames; ++n) {
+      writeFrame (outfile, n, 1024, false);
+    }
+  }
+
+  unsigned long nofFramesStream = 0;
+  unsigned long nofFramesIngest = 0;
+  double start_t          = wallTime();
+  long long sumStream     = replayStream (replay, nofFramesStream);
+  double end_t            = wallTime();
+  double rateStream       = 0;
+  double rateIngest       = 0;
+  std::ifstream infile (replay.c_str(), std::ios::binary|std::ios::ate);
+  double size             = double(infile.tellg())/1048576;
+
+  rateStream = size/(end_t-start_t);
+
+  start_t = wallTime();
+  long long sumIngest = replayIngest (replay, nofFramesIngest);
+  end_t   = wallTime();
+  rateIngest = size/(end_t-start_t);
+
+  cout << "-- Dump ................ : " << replay          << endl;
+  cout << "-- Size ................ : " << size            << " MB" << endl;
+  cout << "-- Frames .............. : " << nofFramesIngest << endl;
+  cout << "-- std::ifstream, sample : " << rateStream      << " MB/s" << endl;
+  cout << "-- TBB_FileIngest ...... : " << rateIngest      << " MB/s , speed-up "
+       << rateIngest/rateStream << endl;
+
+  if (sumStream != sumIngest || nofFramesStream != nofFramesIngest) {
+    cerr << "-- Parsers disagree on the contents of the dump" << endl;
+    ++nofFailedTests;
+  }
+
+  if (dump.empty()) {
+    remove (filename);
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main (int argc, char *argv[])
+{
+  int nofFailedTests (0);
+  std::string dump;
+  double megabytes (16);
+
+  if (argc > 1) {
+    char *end    = NULL;
+    double value = strtod (argv[1], &end);
+    if (*end == '\0') {
+      megabytes = value;
+    } else {
+      dump = argv[1];
+    }
+  }
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_read ();
+  nofFailedTests += test_swap16 ();
+  nofFailedTests += benchmark (dump, megabytes);
+
+  return nofFailedTests;
+}
@@ -0,0 +1,289 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <data_hl/TBB_FrameRing.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::TBB_FrameRing;
+
+/*!
+  \file tTBB_FrameRing.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the TBB_FrameRing class
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  Besides the bookkeeping of a ring used from a single thread, a stress test
+  runs a producer and a consumer thread which hand numbered frames over in
+  batches of random size; the consumer checks that every frame arrives exactly
+  once, in order and intact, for each of the wait strategies.
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tTBB_FrameRing [nofFrames]
+  \endverbatim
+*/
+
+//! Size of a slot
+const size_t slotSize = 2141;
+
+// -----------------------------------------------------------------------------
+
+//! Parameters of a producer thread
+struct producerArgs {
+  //! The ring to fill
+  TBB_FrameRing *ring;
+  //! Number of frames to produce
+  unsigned int nofFrames;
+};
+
+/*!
+  \brief Producer thread: commit numbered frames in batches of random size
+*/
+void * producer (void *args)
+{
+  producerArgs *p     = static_cast<producerArgs*>(args);
+  unsigned int number = 0;
+  unsigned int seed   = 12345;
+  char *slots;
+  int *sizes;
+
+  while (number < p->nofFrames) {
+    unsigned int n = p->ring->writable (slots, sizes);
+    if (n == 0) {
+      p->ring->waitWritable (-1);
+      continue;
+    }
+    unsigned int batch = 1 + rand_r(&seed)%64;
+    if (batch < n) n = batch;
+    if (p->nofFrames-number < n) n = p->nofFrames-number;
+    for (unsigned int i=0; i<n; ++i, ++number) {
+      char *frame = slots + i*slotSize;
+      memcpy (frame, &number, sizeof(number));
+      frame[slotSize-1] = char(number);
+      sizes[i] = int(number%2141);
+    }
+    p->ring->commit (n);
+  }
+  p->ring->close ();
+
+  return NULL;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test the bookkeeping of the ring from within a single thread
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_bookkeeping ()
+{
+  cout << "\n[tTBB_FrameRing::test_bookkeeping]\n" << endl;
+
+  int nofFailedTests (0);
+  char *slots;
+  int *sizes;
+
+  cout << "[1] Testing argumented constructor ..." << endl;
+  try {
+    TBB_FrameRing ring (10, slotSize);
+    ring.summary();
+    if (ring.capacity() != 10 || ring.slotSize() != slotSize
+	|| !ring.empty() || ring.isClosed()) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[2] Fill, drain and wrap around ..." << endl;
+  try {
+    TBB_FrameRing ring (10, slotSize);
+    /* Empty ring: all slots are free and contiguous */
+    if (ring.writable(slots,sizes) != 10 || ring.readable(slots,sizes) != 0) {
+      ++nofFailedTests;
+    }
+    ring.commit (7);
+    if (ring.readable(slots,sizes) != 7) {
+      ++nofFailedTests;
+    }
+    ring.release (5);
+    /* 2 frames left at slots 5,6; the free slots 7..9 are contiguous */
+    unsigned int nofFree = ring.writable (slots, sizes);
+    cout << "-- size = " << ring.size() << " , contiguous free = " << nofFree << endl;
+    if (ring.size() != 2 || nofFree != 3) {
+      ++nofFailedTests;
+    }
+    ring.commit (3);
+    /* After the wrap the slots 0..4 are free */
+    nofFree = ring.writable (slots, sizes);
+    cout << "-- contiguous free after wrap = " << nofFree << endl;
+    if (nofFree != 5) {
+      ++nofFailedTests;
+    }
+    ring.commit (5);
+    if (ring.writable(slots,sizes) != 0 || ring.nofFull() != 1
+	|| ring.highWaterMark() != 10) {
+      ++nofFailedTests;
+    }
+    /* The consumer sees the slots up to the end first */
+    unsigned int nofReady = ring.readable (slots, sizes);
+    cout << "-- contiguous ready = " << nofReady << endl;
+    if (nofReady != 5) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[3] Time-outs and closing ..." << endl;
+  try {
+    TBB_FrameRing ring (4, slotSize, TBB_FrameRing::BlockingWait);
+    if (ring.waitReadable (0.01)) {
+      ++nofFailedTests;
+    }
+    ring.commit (4);
+    if (ring.waitWritable (0.01) || !ring.waitReadable (0.01)) {
+      ++nofFailedTests;
+    }
+    ring.close();
+    ring.release (4);
+    if (!ring.isClosed() || ring.waitReadable (-1)) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Hand frames from a producer to a consumer thread
+
+  \param nofFrames -- Number of frames to pass through the ring.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_stress (unsigned int const &nofFrames)
+{
+  cout << "\n[tTBB_FrameRing::test_stress]\n" << endl;
+
+  int nofFailedTests (0);
+  TBB_FrameRing::WaitStrategy strategies[] = {TBB_FrameRing::SpinWait,
+					      TBB_FrameRing::BackoffWait,
+					      TBB_FrameRing::BlockingWait};
+  std::string names[] = {"SpinWait", "BackoffWait", "BlockingWait"};
+
+  for (int s=0; s<3; ++s) {
+    cout << "[" << s+1 << "] " << names[s] << " ..." << endl;
+
+    TBB_FrameRing ring (1000, slotSize, strategies[s]);
+    producerArgs args;
+    args.ring      = &ring;
+    args.nofFrames = nofFrames;
+
+    struct timeval start, end;
+    gettimeofday (&start, NULL);
+
+    pthread_t thread;
+    pthread_create (&thread, NULL, producer, &args);
+
+    unsigned int expected = 0;
+    unsigned int nofWrong = 0;
+    unsigned int seed     = 54321;
+    char *slots;
+    int *sizes;
+
+    while (ring.waitReadable (-1)) {
+      unsigned int n = ring.readable (slots, sizes);
+      /* Consume in batches of random size as well */
+      unsigned int batch = 1 + rand_r(&seed)%64;
+      if (batch < n) n = batch;
+      for (unsigned int i=0; i<n; ++i, ++expected) {
+	unsigned int number;
+	char *frame = slots + i*slotSize;
+	memcpy (&number, frame, sizeof(number));
+	if (number != expected || frame[slotSize-1] != char(number)
+	    || sizes[i] != int(number%2141)) {
+	  ++nofWrong;
+	}
+      }
+      ring.release (n);
+    }
+    pthread_join (thread, NULL);
+
+    gettimeofday (&end, NULL);
+    double seconds = (end.tv_sec-start.tv_sec) + 1e-6*(end.tv_usec-start.tv_usec);
+
+    cout << "-- nof. frames received .. = " << expected              << endl;
+    cout << "-- nof. wrong frames ..... = " << nofWrong              << endl;
+    cout << "-- High-water mark ....... = " << ring.highWaterMark()  << endl;
+    cout << "-- Producer found full ... = " << ring.nofFull()        << endl;
+    cout << "-- Consumer had to wait .. = " << ring.nofEmpty()       << endl;
+    cout << "-- Frames/s .............. = " << expected/seconds      << endl;
+
+    if (expected != nofFrames || nofWrong > 0 || !ring.empty()) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+int main (int argc, char *argv[])
+{
+  int nofFailedTests (0);
+  unsigned int nofFrames (200000);
+
+  if (argc>1) {
+    nofFrames = atoi(argv[1]);
+  }
+
+  nofFailedTests += test_bookkeeping ();
+  nofFailedTests += test_stress (nofFrames);
+
+  return nofFailedTests;
+}
@@ -0,0 +1,237 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <data_hl/TBB_UDPIngest.h>
+
+#include <cstring>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::TBB_UDPIngest;
+
+/*!
+  \file tTBB_UDPIngest.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the TBB_UDPIngest class
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  Datagrams of the size of a TBB frame are sent through the loopback interface
+  to a port picked by the system and fetched again in batches.
+*/
+
+//! Size of a TBB frame
+const int frameSize = 2140;
+//! Size of a slot in the input buffer
+const int slotSize  = 2141;
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Send a number of numbered datagrams to a local port
+
+  \param port      -- Port to send the datagrams to.
+  \param nofFrames -- Number of datagrams to send.
+  \param size      -- Size of the datagrams [bytes].
+  \param first     -- Number of the first datagram.
+*/
+void send_frames (int const &port,
+		  int const &nofFrames,
+		  int const &size,
+		  int const &first=0)
+{
+  int sock = socket (PF_INET, SOCK_DGRAM, 0);
+  sockaddr_in remote;
+  memset (&remote, 0, sizeof(remote));
+  remote.sin_family      = AF_INET;
+  remote.sin_port        = htons(port);
+  remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  std::vector<char> frame (size);
+  for (int n=0; n<nofFrames; ++n) {
+    int number = first+n;
+    memset (&frame[0], number&0xff, size);
+    memcpy (&frame[0], &number, sizeof(number));
+    sendto (sock, &frame[0], size, 0, (sockaddr *) &remote, sizeof(remote));
+  }
+  close (sock);
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test constructors for a new TBB_UDPIngest object
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tTBB_UDPIngest::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing default constructor ..." << endl;
+  try {
+    TBB_UDPIngest ingest;
+    if (ingest.isOpen() || ingest.batchSize() != DEFAULT_INGEST_BATCH_SIZE) {
+      ++nofFailedTests;
+    }
+    ingest.summary();
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[2] Testing argumented constructor ..." << endl;
+  try {
+    TBB_UDPIngest ingest (16);
+    if (ingest.batchSize() != 16) {
+      ++nofFailedTests;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test the reception of datagrams
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_receive ()
+{
+  cout << "\n[tTBB_UDPIngest::test_receive]\n" << endl;
+
+  int nofFailedTests (0);
+  int nofFrames (200);
+  TBB_UDPIngest ingest (64);
+  std::vector<char> slots (nofFrames*slotSize);
+
+  cout << "[1] Open socket on a port picked by the system ..." << endl;
+  if (!ingest.open (0, 4*1024*1024, true)) {
+    cerr << "-- Failed to open socket!" << endl;
+    return ++nofFailedTests;
+  }
+  cout << "-- Port ..................... = " << ingest.port()              << endl;
+  cout << "-- Receive buffer [bytes] ... = " << ingest.receiveBufferSize() << endl;
+
+  cout << "[2] Time-out without data ..." << endl;
+  if (ingest.receive (&slots[0], slotSize, 10, 0.05) != 0) {
+    ++nofFailedTests;
+  }
+
+  cout << "[3] Receive frames in batches ..." << endl;
+  {
+    int nofReceived (0);
+    int nofCalls (0);
+    int nofWrong (0);
+    send_frames (ingest.port(), nofFrames, frameSize);
+    while (nofReceived < nofFrames) {
+      int n = ingest.receive (&slots[nofReceived*slotSize], slotSize,
+			      nofFrames-nofReceived, 1.0);
+      if (n <= 0) {
+	break;
+      }
+      for (int i=0; i<n; ++i) {
+	int number;
+	memcpy (&number, &slots[(nofReceived+i)*slotSize], sizeof(number));
+	if (number != nofReceived+i
+	    || ingest.datagramSize(i) != frameSize
+	    || slots[(nofReceived+i)*slotSize+frameSize-1] != char(number&0xff)) {
+	  ++nofWrong;
+	}
+	if (ingest.timestamp(i).tv_sec == 0) {
+	  ++nofWrong;
+	}
+      }
+      nofReceived += n;
+      ++nofCalls;
+    }
+    cout << "-- nof. received frames ..... = " << nofReceived << endl;
+    cout << "-- nof. receive calls ....... = " << nofCalls    << endl;
+    cout << "-- nof. wrong frames ........ = " << nofWrong    << endl;
+    if (nofReceived != nofFrames || nofWrong || nofCalls >= nofFrames) {
+      ++nofFailedTests;
+    }
+    if (ingest.maxBatch() > ingest.batchSize()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[4] Limit the batch to the free slots ..." << endl;
+  {
+    send_frames (ingest.port(), 10, frameSize, 1000);
+    int n1 = ingest.receive (&slots[0], slotSize, 3, 1.0);
+    int n2 = ingest.receive (&slots[3*slotSize], slotSize, 100, 1.0);
+    int number;
+    memcpy (&number, &slots[3*slotSize], sizeof(number));
+    cout << "-- nof. frames per call ..... = " << n1 << " , " << n2 << endl;
+    if (n1 != 3 || n2 != 7 || number != 1003) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[5] Oversized datagrams are truncated ..." << endl;
+  {
+    send_frames (ingest.port(), 1, frameSize+100);
+    int n = ingest.receive (&slots[0], slotSize, 1, 1.0);
+    cout << "-- Datagram size ............ = " << ingest.datagramSize(0) << endl;
+    if (n != 1 || ingest.datagramSize(0) != slotSize || ingest.nofTruncated() != 1) {
+      ++nofFailedTests;
+    }
+  }
+
+  ingest.summary();
+  ingest.close();
+
+  if (ingest.isOpen() || ingest.receive (&slots[0], slotSize, 1) != -1) {
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+int main ()
+{
+  int nofFailedTests (0);
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_receive ();
+
+  return nofFailedTests;
+}
@@ -0,0 +1,743 @@
+/***************************************************************************
+ *   Copyright (C) 2026                                                    *
+ *   agent (agent@local)                                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/dalCommon.h>
+#include <data_hl/TBBraw.h>
+#include <data_hl/TBB_FileIngest.h>
+#include <data_hl/TBB_UDPIngest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <unistd.h>
+#include <pthread.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::TBBraw;
+using DAL::TBB_FileIngest;
+using DAL::TBB_UDPIngest;
+using DAL::wallTime;
+
+/*!
+  \file tTBBraw.cc
+
+  \ingroup DAL
+
+  \brief A collection of test routines for the TBBraw class
+
+  \author agent
+
+  \date 2026/10/17
+
+  <h3>Synopsis</h3>
+
+  A synthetic TBB dump -- transient frames with valid header and payload CRCs
+  for a number of dipoles of a single station -- is generated in memory and
+  converted to HDF5 a number of times, comparing the throughput and the
+  resulting datasets for different settings of the write-combining buffer.
+
+  The same is done for a dump of spectral (sub-band) frames, crossing the
+  boundary of a second, whose [time,band] datasets are checked sample by
+  sample. Finally the spectral dump is replayed from a file and through the
+  loopback interface, to measure the rate at which sub-band data can be
+  recorded.
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tTBBraw [nofFrames]
+  \endverbatim
+
+  By default the dumps hold 100 frames per dipole, enough to check the
+  generated datasets; for timings pass a larger number, e.g. <tt>tTBBraw 1000</tt>.
+*/
+
+//! Number of dipoles in the synthetic dump
+const int nofDipoles = 8;
+//! Number of samples per frame
+const int nofSamples = 1024;
+//! Number of bytes in the frame header
+const int headerSize = 88;
+//! Sub-bands selected in the synthetic spectral dump
+const int spectralBands[] = {0, 3, 100, 101, 102, 103, 104, 105, 106, 107, 108, 511};
+//! Number of sub-bands selected in the synthetic spectral dump
+const int nofSpectralBands = 12;
+//! Number of complex samples per spectral frame
+const int nofSpectralSamples = 487;
+//! Size of a spectral frame [bytes]
+const int spectralFrameSize = headerSize+4*nofSpectralSamples+4;
+//! Time of the first spectral frame, an odd second
+const uint32_t spectralTime = 1300000001;
+//! Time slice of the first spectral frame, shortly before the end of the second
+const uint32_t spectralSlice = 195300;
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Set up a synthetic TBB transient frame
+
+  \retval frame   -- Buffer of TBB_FRAME_SIZE bytes to hold the frame.
+  \param rcu      -- RCU number of the dipole.
+  \param frameNum -- Number of the frame within the dump of the dipole.
+*/
+void make_frame (char *frame,
+		 int const &rcu,
+		 int const &frameNum)
+{
+  memset (frame, 0, TBB_FRAME_SIZE);
+
+  /* Header: stationid, rspid, rcuid, sample_freq, seqnr, time, sample_nr,
+     n_samples_per_frame */
+  frame[0] = 1;
+  frame[1] = 0;
+  frame[2] = rcu;
+  frame[3] = (char)160;
+  uint32_t time         = 1300000000;
+  uint32_t sampleNumber = frameNum*nofSamples;
+  uint16_t nofSamplesPerFrame = nofSamples;
+  memcpy (frame+8,  &time, 4);
+  memcpy (frame+12, &sampleNumber, 4);
+  memcpy (frame+16, &nofSamplesPerFrame, 2);
+
+  uint16_t *header = reinterpret_cast<uint16_t*>(frame);
+  header[headerSize/2-1] = DAL::crc16 (header, headerSize/2);
+
+  /* Payload, followed by its CRC */
+  uint16_t *payload = reinterpret_cast<uint16_t*>(frame+headerSize);
+  for (int n=0; n<nofSamples; ++n) {
+    payload[n] = uint16_t((rcu*7 + frameNum*nofSamples + n) % 4096);
+  }
+  uint32_t crc = DAL::crc32 (payload, nofSamples+2);
+  memcpy (frame+headerSize+2*nofSamples, &crc, 4);
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Convert a synthetic dump into an HDF5 file
+
+  \param filename   -- Name of the output file.
+  \param frames     -- Frames of the dump, in the order in which to process them.
+  \param bufferSize -- Size of the write-combining buffer [bytes].
+  \param frameSize  -- Size of a frame [bytes].
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int convert_dump (std::string const &filename,
+		  std::vector<char> &frames,
+		  size_t const &bufferSize,
+		  int const &frameSize=TBB_FRAME_SIZE)
+{
+  int nofFailedTests (0);
+  int nofFrames = frames.size()/frameSize;
+
+  remove (filename.c_str());
+
+  clock_t start = clock();
+  {
+    TBBraw tbb (filename);
+    tbb.doDataCRC (true);
+    tbb.setFrameBufferSize (bufferSize);
+
+    for (int n=0; n<nofFrames; ++n) {
+      if (!tbb.processTBBrawBlock (&frames[size_t(n)*frameSize], frameSize)) {
+	++nofFailedTests;
+      }
+    }
+    tbb.flush();
+    tbb.summary();
+  }
+  double seconds = double(clock()-start)/CLOCKS_PER_SEC;
+
+  cout << "-- Frames/s = " << nofFrames/seconds << endl;
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+//! Parameters of a writer thread of test_frameBuffer
+struct WriterArgs {
+  std::string filename;
+  std::vector<char> *frames;
+  pthread_mutex_t *mutex;
+  int nofFailedTests;
+};
+
+/*!
+  \brief Convert a synthetic dump, holding a shared mutex around the HDF5 calls
+
+  \param args -- Pointer to the WriterArgs of the thread.
+*/
+void * convert_locked (void *args)
+{
+  WriterArgs *writer = static_cast<WriterArgs *>(args);
+  int nofFrames      = writer->frames->size()/TBB_FRAME_SIZE;
+
+  remove (writer->filename.c_str());
+  writer->nofFailedTests = 0;
+
+  TBBraw *tbb;
+  {
+    TBBraw::HDF5Lock lock (writer->mutex);
+    tbb = new TBBraw (writer->filename);
+  }
+  tbb->setHDF5Mutex (writer->mutex);
+  tbb->setFrameBufferSize (DEFAULT_FRAME_BUFFER_SIZE/8);
+
+  for (int n=0; n<nofFrames; ++n) {
+    if (!tbb->processTBBrawBlock (&(*writer->frames)[size_t(n)*TBB_FRAME_SIZE],
+				  TBB_FRAME_SIZE)) {
+      ++writer->nofFailedTests;
+    }
+  }
+  delete tbb;
+
+  return NULL;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Read the data of all dipoles from a file generated by convert_dump
+
+  \param filename -- Name of the file.
+
+  \return data -- Samples of all dipoles, concatenated.
+*/
+std::vector<short> read_dump (std::string const &filename)
+{
+  std::vector<short> data;
+  hid_t fileID = H5Fopen (filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+
+  for (int rcu=0; rcu<nofDipoles; ++rcu) {
+    char name[32];
+    sprintf (name, "Station001/001000%03d", rcu);
+    hid_t datasetID = H5Dopen (fileID, name, H5P_DEFAULT);
+    hid_t spaceID   = H5Dget_space (datasetID);
+    hsize_t nelem   = 0;
+    H5Sget_simple_extent_dims (spaceID, &nelem, NULL);
+    size_t pos = data.size();
+    data.resize (pos+nelem);
+    H5Dread (datasetID, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[pos]);
+    H5Sclose (spaceID);
+    H5Dclose (datasetID);
+  }
+
+  H5Fclose (fileID);
+  return data;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test the write-combining buffer
+
+  \param nofFrames -- Number of frames per dipole.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_frameBuffer (int const &nofFrames)
+{
+  cout << "\n[tTBBraw::test_frameBuffer]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<char> frames (size_t(nofFrames)*nofDipoles*TBB_FRAME_SIZE);
+
+  /* Frames of all dipoles interleaved, as sent by the station */
+  for (int n=0; n<nofFrames; ++n) {
+    for (int rcu=0; rcu<nofDipoles; ++rcu) {
+      make_frame (&frames[(size_t(n)*nofDipoles+rcu)*TBB_FRAME_SIZE], rcu, n);
+    }
+  }
+
+  cout << "[1] Write every frame directly ..." << endl;
+  nofFailedTests += convert_dump ("tTBBraw_direct.h5", frames, 0);
+
+  cout << "[2] Write frames through the write-combining buffer ..." << endl;
+  nofFailedTests += convert_dump ("tTBBraw_buffered.h5", frames,
+				  DEFAULT_FRAME_BUFFER_SIZE);
+
+  cout << "[3] Write out-of-order frames through the buffer ..." << endl;
+  {
+    std::vector<char> tmp (TBB_FRAME_SIZE);
+    int window = 64*nofDipoles;
+    int nofTotal = nofFrames*nofDipoles;
+    srand (42);
+    for (int n=0; n<nofTotal; ++n) {
+      int k = n - n%window + rand()%window;
+      if (k >= nofTotal) {
+	continue;
+      }
+      memcpy (&tmp[0], &frames[size_t(n)*TBB_FRAME_SIZE], TBB_FRAME_SIZE);
+      memcpy (&frames[size_t(n)*TBB_FRAME_SIZE], &frames[size_t(k)*TBB_FRAME_SIZE], TBB_FRAME_SIZE);
+      memcpy (&frames[size_t(k)*TBB_FRAME_SIZE], &tmp[0], TBB_FRAME_SIZE);
+    }
+    /* The very first frame of every dipole defines the start of its array */
+    for (int rcu=0; rcu<nofDipoles; ++rcu) {
+      make_frame (&tmp[0], rcu, 0);
+      for (int n=0; n<nofTotal; ++n) {
+	if (!memcmp (&tmp[0], &frames[size_t(n)*TBB_FRAME_SIZE], TBB_FRAME_SIZE)) {
+	  memcpy (&frames[size_t(n)*TBB_FRAME_SIZE], &frames[size_t(rcu)*TBB_FRAME_SIZE], TBB_FRAME_SIZE);
+	  memcpy (&frames[size_t(rcu)*TBB_FRAME_SIZE], &tmp[0], TBB_FRAME_SIZE);
+	  break;
+	}
+      }
+    }
+  }
+  nofFailedTests += convert_dump ("tTBBraw_unordered.h5", frames,
+				  DEFAULT_FRAME_BUFFER_SIZE);
+
+  cout << "[4] Compare the generated datasets ..." << endl;
+  {
+    std::vector<short> direct    = read_dump ("tTBBraw_direct.h5");
+    std::vector<short> buffered  = read_dump ("tTBBraw_buffered.h5");
+    std::vector<short> unordered = read_dump ("tTBBraw_unordered.h5");
+
+    cout << "-- nof. samples = " << direct.size() << endl;
+    if (direct.size() != size_t(nofFrames)*nofDipoles*nofSamples) {
+      ++nofFailedTests;
+    }
+    if (buffered != direct) {
+      cerr << "-- Buffered data differ from directly written data!" << endl;
+      ++nofFailedTests;
+    }
+    if (unordered != direct) {
+      cerr << "-- Out-of-order data differ from directly written data!" << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[5] Write two files from two threads sharing an HDF5 mutex ..." << endl;
+  {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    WriterArgs writers[2];
+    pthread_t threads[2];
+
+    for (int n=0; n<2; ++n) {
+      char name[32];
+      sprintf (name, "tTBBraw_thread%d.h5", n);
+      writers[n].filename = name;
+      writers[n].frames   = &frames;
+      writers[n].mutex    = &mutex;
+      pthread_create (&threads[n], NULL, convert_locked, &writers[n]);
+    }
+    for (int n=0; n<2; ++n) {
+      pthread_join (threads[n], NULL);
+      nofFailedTests += writers[n].nofFailedTests;
+    }
+
+    std::vector<short> direct = read_dump ("tTBBraw_direct.h5");
+    for (int n=0; n<2; ++n) {
+      if (read_dump (writers[n].filename) != direct) {
+	cerr << "-- Data of " << writers[n].filename
+	     << " differ from directly written data!" << endl;
+	++nofFailedTests;
+      }
+    }
+    /* The mutex has to be released by the writers */
+    if (pthread_mutex_trylock (&mutex) != 0) {
+      cerr << "-- HDF5 mutex still locked!" << endl;
+      ++nofFailedTests;
+    }
+    else {
+      pthread_mutex_unlock (&mutex);
+    }
+  }
+
+  return nofFailedTests;
+}
+
+/*!
+  \brief Get the first time slice of a second
+
+  \param time -- Second since the epoch.
+
+  \return slice -- Number of the first slice of 1024 samples at 200 MHz starting
+          within the second, counted since the epoch.
+*/
+long long first_slice (uint32_t const &time)
+{
+  return ((long long)time*200000000 + 1023)/1024;
+}
+
+//! Real and imaginary part of a sample of the synthetic spectral dump
+short spectral_value (int const &rcu,
+		      long long const &sample,
+		      int const &part)
+{
+  return part ? -short((rcu*5 + sample) % 2048) : short((rcu*7 + sample) % 4096);
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Set up a synthetic TBB spectral frame
+
+  The samples of all frames of a dipole form a continuous sequence, cycling
+  through the selected sub-bands; frame \e frameNum thereby starts with sample
+  <tt>frameNum*nofSpectralSamples</tt> of the sequence.
+
+  \retval frame   -- Buffer of spectralFrameSize bytes to hold the frame.
+  \param rcu      -- RCU number of the dipole.
+  \param frameNum -- Number of the frame within the dump of the dipole.
+*/
+void make_spectral_frame (char *frame,
+			  int const &rcu,
+			  int const &frameNum)
+{
+  memset (frame, 0, spectralFrameSize);
+
+  long long first = (long long)frameNum*nofSpectralSamples;
+  long long slice = first_slice(spectralTime) + spectralSlice + first/nofSpectralBands;
+  uint32_t time   = spectralTime;
+  while (slice >= first_slice(time+1)) {
+    ++time;
+  }
+
+  /* Header: time, band and slice number of the first sample, band selection */
+  frame[0] = 1;
+  frame[1] = 0;
+  frame[2] = rcu;
+  frame[3] = (char)200;
+  uint32_t bandSliceNumber = ((slice-first_slice(time)) << 10)
+    | spectralBands[first%nofSpectralBands];
+  uint16_t nofSamplesPerFrame = nofSpectralSamples;
+  uint16_t nofBands           = nofSpectralBands;
+  memcpy (frame+8,  &time, 4);
+  memcpy (frame+12, &bandSliceNumber, 4);
+  memcpy (frame+16, &nofSamplesPerFrame, 2);
+  memcpy (frame+18, &nofBands, 2);
+  for (int n=0; n<nofSpectralBands; ++n) {
+    frame[20+spectralBands[n]/8] |= 1 << (spectralBands[n]%8);
+  }
+
+  uint16_t *header = reinterpret_cast<uint16_t*>(frame);
+  header[headerSize/2-1] = DAL::crc16 (header, headerSize/2);
+
+  /* Payload of complex samples, followed by its CRC */
+  int16_t *payload = reinterpret_cast<int16_t*>(frame+headerSize);
+  for (int n=0; n<nofSpectralSamples; ++n) {
+    payload[2*n]   = spectral_value (rcu, first+n, 0);
+    payload[2*n+1] = spectral_value (rcu, first+n, 1);
+  }
+  uint32_t crc = DAL::crc32 (reinterpret_cast<uint16_t*>(payload), 2*nofSpectralSamples+2);
+  memcpy (frame+headerSize+4*nofSpectralSamples, &crc, 4);
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Check the spectral datasets of a file generated by convert_dump
+
+  \param filename  -- Name of the file.
+  \param nofFrames -- Number of frames per dipole.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int check_spectra (std::string const &filename,
+		   int const &nofFrames)
+{
+  int nofFailedTests (0);
+  long long nofSamples = (long long)nofFrames*nofSpectralSamples;
+  hsize_t nofRows      = (nofSamples+nofSpectralBands-1)/nofSpectralBands;
+  hid_t fileID         = H5Fopen (filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  hid_t complexType    = H5Tcreate (H5T_COMPOUND, 2*sizeof(short));
+  H5Tinsert (complexType, "real", 0,             H5T_NATIVE_SHORT);
+  H5Tinsert (complexType, "imag", sizeof(short), H5T_NATIVE_SHORT);
+
+  for (int rcu=0; rcu<nofDipoles; ++rcu) {
+    char name[32];
+    sprintf (name, "Station001/001000%03d", rcu);
+    hid_t datasetID = H5Dopen (fileID, name, H5P_DEFAULT);
+    hid_t spaceID   = H5Dget_space (datasetID);
+    hsize_t shape[2] = {0, 0};
+    H5Sget_simple_extent_dims (spaceID, shape, NULL);
+    if (shape[0] != nofRows || shape[1] != hsize_t(nofSpectralBands)) {
+      cerr << "-- Unexpected shape [" << shape[0] << "," << shape[1]
+	   << "] of " << name << endl;
+      ++nofFailedTests;
+    } else {
+      std::vector<short> data (2*nofRows*nofSpectralBands);
+      H5Dread (datasetID, complexType, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[0]);
+      for (long long n=0; n<nofSamples; ++n) {
+	if (data[2*n]   != spectral_value (rcu, n, 0) ||
+	    data[2*n+1] != spectral_value (rcu, n, 1)) {
+	  cerr << "-- Wrong sample " << n << " in " << name << endl;
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+    std::vector<int> bands;
+    DAL::HDF5Attribute::read (datasetID, "BAND_SELECTION", bands);
+    if (bands != std::vector<int>(spectralBands, spectralBands+nofSpectralBands)) {
+      cerr << "-- Wrong band selection attached to " << name << endl;
+      ++nofFailedTests;
+    }
+    H5Sclose (spaceID);
+    H5Dclose (datasetID);
+  }
+
+  H5Tclose (complexType);
+  H5Fclose (fileID);
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test the conversion of spectral (sub-band) frames
+
+  \param nofFrames -- Number of frames per dipole.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_spectral (int const &nofFrames)
+{
+  cout << "\n[tTBBraw::test_spectral]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<char> frames (size_t(nofFrames)*nofDipoles*spectralFrameSize);
+
+  for (int n=0; n<nofFrames; ++n) {
+    for (int rcu=0; rcu<nofDipoles; ++rcu) {
+      make_spectral_frame (&frames[(size_t(n)*nofDipoles+rcu)*spectralFrameSize], rcu, n);
+    }
+  }
+
+  cout << "[1] Decode the band selection ..." << endl;
+  {
+    std::vector<int> bands;
+    TBBraw::decodeBandSelection (&frames[20], bands);
+    if (bands != std::vector<int>(spectralBands, spectralBands+nofSpectralBands)) {
+      ++nofFailedTests;
+    }
+    if (TBBraw::frameSize (&frames[0]) != spectralFrameSize) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Write every spectral frame directly ..." << endl;
+  nofFailedTests += convert_dump ("tTBBraw_spectral_direct.h5", frames, 0,
+				  spectralFrameSize);
+  nofFailedTests += check_spectra ("tTBBraw_spectral_direct.h5", nofFrames);
+
+  cout << "[3] Write spectral frames through the write-combining buffer ..." << endl;
+  nofFailedTests += convert_dump ("tTBBraw_spectral_buffered.h5", frames,
+				  DEFAULT_FRAME_BUFFER_SIZE, spectralFrameSize);
+  nofFailedTests += check_spectra ("tTBBraw_spectral_buffered.h5", nofFrames);
+
+  cout << "[4] Write out-of-order spectral frames through the buffer ..." << endl;
+  {
+    /* Keep the very first frame of every dipole in place */
+    std::vector<char> tmp (spectralFrameSize);
+    int window = 64*nofDipoles;
+    int nofTotal = nofFrames*nofDipoles;
+    srand (42);
+    for (int n=nofDipoles; n<nofTotal; ++n) {
+      int k = n - n%window + rand()%window;
+      if (k < nofDipoles || k >= nofTotal) {
+	continue;
+      }
+      memcpy (&tmp[0], &frames[size_t(n)*spectralFrameSize], spectralFrameSize);
+      memcpy (&frames[size_t(n)*spectralFrameSize], &frames[size_t(k)*spectralFrameSize], spectralFrameSize);
+      memcpy (&frames[size_t(k)*spectralFrameSize], &tmp[0], spectralFrameSize);
+    }
+  }
+  nofFailedTests += convert_dump ("tTBBraw_spectral_unordered.h5", frames,
+				  DEFAULT_FRAME_BUFFER_SIZE, spectralFrameSize);
+  nofFailedTests += check_spectra ("tTBBraw_spectral_unordered.h5", nofFrames);
+
+  cout << "[5] Reject frames not matching the band selection ..." << endl;
+  {
+    std::vector<char> frame (spectralFrameSize);
+    remove ("tTBBraw_spectral_bands.h5");
+    TBBraw tbb ("tTBBraw_spectral_bands.h5");
+    make_spectral_frame (&frame[0], 0, 0);
+    if (!tbb.processTBBrawBlock (&frame[0], spectralFrameSize)) {
+      ++nofFailedTests;
+    }
+    /* Changed band selection */
+    make_spectral_frame (&frame[0], 0, 1);
+    frame[20+200/8] |= 1 << (200%8);
+    uint16_t *header = reinterpret_cast<uint16_t*>(&frame[0]);
+    header[headerSize/2-1] = 0;
+    header[headerSize/2-1] = DAL::crc16 (header, headerSize/2);
+    if (tbb.processTBBrawBlock (&frame[0], spectralFrameSize)) {
+      ++nofFailedTests;
+    }
+    /* Transient frame of a spectral dipole */
+    std::vector<char> transient (TBB_FRAME_SIZE);
+    make_frame (&transient[0], 0, 1);
+    if (tbb.processTBBrawBlock (&transient[0], TBB_FRAME_SIZE)) {
+      ++nofFailedTests;
+    }
+    tbb.summary();
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Benchmark the recording of spectral frames from a file and a socket
+
+  \param nofFrames -- Number of frames per dipole.
+
+  \return nofFailedTests -- The number of failed tests within this function.
+*/
+int test_spectralIngest (int const &nofFrames)
+{
+  cout << "\n[tTBBraw::test_spectralIngest]\n" << endl;
+
+  int nofFailedTests (0);
+  int nofTotal = nofFrames*nofDipoles;
+  std::vector<char> frames (size_t(nofTotal)*spectralFrameSize);
+  std::vector<char> frame (TBB_FRAME_SIZE);
+  double megabytes = frames.size()/1048576.0;
+
+  for (int n=0; n<nofFrames; ++n) {
+    for (int rcu=0; rcu<nofDipoles; ++rcu) {
+      make_spectral_frame (&frames[(size_t(n)*nofDipoles+rcu)*spectralFrameSize], rcu, n);
+    }
+  }
+
+  cout << "[1] Replay the spectral dump from a file ..." << endl;
+  {
+    std::ofstream outfile ("tTBBraw_spectral.dat", std::ios::binary);
+    outfile.write (&frames[0], frames.size());
+    outfile.close();
+
+    remove ("tTBBraw_spectral_file.h5");
+    int nofProcessed (0);
+    double start = wallTime();
+    {
+      TBBraw tbb ("tTBBraw_spectral_file.h5");
+      TBB_FileIngest ingest;
+      char *header;
+      ingest.open ("tTBBraw_spectral.dat");
+      while ((header = ingest.read (headerSize))) {
+	int size = TBBraw::frameSize (header);
+	memcpy (&frame[0], header, headerSize);
+	char *payload = ingest.read (size-headerSize);
+	if (payload == NULL) {
+	  break;
+	}
+	memcpy (&frame[headerSize], payload, size-headerSize);
+	if (tbb.processTBBrawBlock (&frame[0], size)) {
+	  ++nofProcessed;
+	}
+      }
+    }
+    double seconds = wallTime()-start;
+    cout << "-- nof. processed frames = " << nofProcessed << endl;
+    cout << "-- Frames/s ............ = " << nofProcessed/seconds << endl;
+    cout << "-- MB/s ................ = " << megabytes/seconds << endl;
+    if (nofProcessed != nofTotal) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += check_spectra ("tTBBraw_spectral_file.h5", nofFrames);
+    remove ("tTBBraw_spectral.dat");
+  }
+
+  cout << "[2] Replay the spectral dump through the loopback interface ..." << endl;
+  {
+    int batch (32);
+    TBB_UDPIngest ingest (batch);
+    std::vector<char> slots (batch*TBB_FRAME_SIZE);
+
+    if (!ingest.open (0, 4*1024*1024, false)) {
+      cerr << "-- Failed to open socket!" << endl;
+      return ++nofFailedTests;
+    }
+    int sock = socket (PF_INET, SOCK_DGRAM, 0);
+    sockaddr_in remote;
+    memset (&remote, 0, sizeof(remote));
+    remote.sin_family      = AF_INET;
+    remote.sin_port        = htons(ingest.port());
+    remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    remove ("tTBBraw_spectral_socket.h5");
+    int nofReceived (0);
+    int nofProcessed (0);
+    double start = wallTime();
+    {
+      TBBraw tbb ("tTBBraw_spectral_socket.h5");
+      /* Send the frames in batches small enough for the socket buffer */
+      for (int first=0; first<nofTotal; first+=batch) {
+	int nofSent = std::min (batch, nofTotal-first);
+	for (int n=0; n<nofSent; ++n) {
+	  sendto (sock, &frames[size_t(first+n)*spectralFrameSize], spectralFrameSize,
+		  0, (sockaddr *) &remote, sizeof(remote));
+	}
+	int n (0);
+	while (n < nofSent) {
+	  int nofFrames = ingest.receive (&slots[0], TBB_FRAME_SIZE, nofSent-n, 0.5);
+	  if (nofFrames <= 0) {
+	    break;
+	  }
+	  for (int i=0; i<nofFrames; ++i) {
+	    if (tbb.processTBBrawBlock (&slots[i*TBB_FRAME_SIZE], ingest.datagramSize(i))) {
+	      ++nofProcessed;
+	    }
+	  }
+	  n += nofFrames;
+	}
+	nofReceived += n;
+      }
+    }
+    double seconds = wallTime()-start;
+    close (sock);
+    cout << "-- nof. received frames  = " << nofReceived  << endl;
+    cout << "-- nof. processed frames = " << nofProcessed << endl;
+    cout << "-- Frames/s ............ = " << nofProcessed/seconds << endl;
+    cout << "-- MB/s ................ = " << megabytes/seconds << endl;
+    if (nofReceived == 0 || nofProcessed != nofReceived) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+int main (int argc, char *argv[])
+{
+  int nofFailedTests (0);
+  int nofFrames (100);
+
+  if (argc>1) {
+    nofFrames = atoi(argv[1]);
+  }
+
+  nofFailedTests += test_frameBuffer (nofFrames);
+  nofFailedTests += test_spectral (nofFrames);
+  nofFailedTests += test_spectralIngest (nofFrames);
+
+  return nofFailedTests;
+}
@@ -281,7 +281,7 @@ bool DAL::dalArray::setAttribute_string_vector (std::string attrname, bpl::list
 
 void export_dalArray ()
 {  
-  bpl::class_<dalArray>("dalArray")
+  bpl::class_<dalArray, boost::noncopyable>("dalArray")
     .def( "setAttribute_char", &dalArray::setAttribute_char,
 	  "Set a character attribute" )
     .def( "setAttribute_char", &dalArray::setAttribute_char_vector,
@@ -281,6 +281,30 @@ bpl::numeric::array BeamGroup::getSubbandData_XY_boost( int subband,
   return narray;
 }
 
+bpl::numeric::array BeamGroup::readData_boost( std::string const &column,
+					       int start,
+					       int length )
+{
+  std::vector<int> mydims;
+  mydims.push_back( nofSubbandTables() );
+
+  if (length <= 0) {
+    std::cerr << "[BeamGroup::readData] Invalid number of samples "
+	      << length << std::endl;
+    mydims.push_back( 0 );
+    return num_util::makeNum( mydims, PyArray_FLOAT );
+  }
+  mydims.push_back( length );
+
+  std::vector<float> values (nofSubbandTables()*length);
+  if (values.empty()) {
+    return num_util::makeNum( mydims, PyArray_FLOAT );
+  }
+  readData( column, start, length, &values[0] );
+  bpl::numeric::array narray = num_util::makeNum( &values[0], mydims );
+  return narray;
+}
+
 void export_BeamGroup ()
 {
   bpl::class_<BeamGroup>("BeamGroup")
@@ -305,6 +329,8 @@ void export_BeamGroup ()
 	  "Get a numpy array of values for a given subband")
     .def( "getSubbandData_XY", &BeamGroup::getSubbandData_XY_boost,
 	  "Get a numpy array of values for a given subband")
+    .def( "readData", &BeamGroup::readData_boost,
+	  "Get a [subband,time] numpy array of a float column for all subbands")
     ;
 }
 